@@ -487,6 +487,42 @@ int sr_session_stop(sr_session_ctx_t *session);
  */
 int sr_session_refresh(sr_session_ctx_t *session);
 
+/**
+ * @brief Returns the sequence number of the changes of the data of a module, to be passed to
+ * ::sr_module_change_wait. The number is read from the memory shared by all the processes
+ * accessing the data files, no request is sent to Sysrepo Engine.
+ *
+ * Available only on connections to the local Sysrepo Engine (library mode).
+ *
+ * @param[in] conn_ctx Connection context acquired with ::sr_connect call.
+ * @param[in] module_name Name of an installed module.
+ * @param[out] change_seq Sequence number of the changes of the module.
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_UNSUPPORTED if the connection is not in library mode
+ * or the changes of the module can not be tracked).
+ */
+int sr_module_change_seq(sr_conn_ctx_t *conn_ctx, const char *module_name, uint32_t *change_seq);
+
+/**
+ * @brief Blocks until a data file of the module is written by any process (library-mode application
+ * or Sysrepo daemon) or the timeout expires. An idle process can use it instead of polling with
+ * ::sr_session_refresh. The waiting process sleeps on a futex in the shared memory (Linux), no request
+ * is sent to Sysrepo Engine.
+ *
+ * To not miss a change, get the sequence number with ::sr_module_change_seq before reading the data.
+ *
+ * Available only on connections to the local Sysrepo Engine (library mode).
+ *
+ * @param[in] conn_ctx Connection context acquired with ::sr_connect call.
+ * @param[in] module_name Name of an installed module.
+ * @param[in] change_seq Sequence number returned by ::sr_module_change_seq.
+ * @param[in] timeout_ms Maximum time to wait in milliseconds.
+ *
+ * @return Error code (SR_ERR_OK if the module has changed since change_seq has been retrieved,
+ * SR_ERR_TIME_OUT if the timeout has expired, SR_ERR_UNSUPPORTED as in ::sr_module_change_seq).
+ */
+int sr_module_change_wait(sr_conn_ctx_t *conn_ctx, const char *module_name, uint32_t change_seq, uint32_t timeout_ms);
+
 /**
  * @brief Checks aliveness and validity of the session & connection tied to it.
  *
@@ -985,6 +1021,53 @@ int sr_delete_item(sr_session_ctx_t *session, const char *xpath, const sr_edit_o
  */
 int sr_move_item(sr_session_ctx_t *session, const char *xpath, const sr_move_position_t position, const char *relative_item);
 
+/**
+ * @brief Type of an operation within a batch edit (see ::sr_edit_batch).
+ */
+typedef enum sr_edit_op_type_e {
+    SR_EDIT_OP_SET,      /**< Same as ::sr_set_item. */
+    SR_EDIT_OP_SET_STR,  /**< Same as ::sr_set_item_str. */
+    SR_EDIT_OP_DELETE,   /**< Same as ::sr_delete_item. */
+    SR_EDIT_OP_MOVE,     /**< Same as ::sr_move_item. */
+} sr_edit_op_type_t;
+
+/**
+ * @brief One data manipulation operation within a batch edit (see ::sr_edit_batch).
+ */
+typedef struct sr_edit_op_s {
+    sr_edit_op_type_t type;        /**< Type of the operation. */
+    const char *xpath;             /**< @ref xp_page "Data Path" identifier of the data element. */
+    const sr_val_t *value;         /**< Value to be set (SR_EDIT_OP_SET), can be NULL. */
+    const char *str_value;         /**< Value to be set in string form (SR_EDIT_OP_SET_STR), can be NULL. */
+    sr_edit_options_t options;     /**< Options of SR_EDIT_OP_SET, SR_EDIT_OP_SET_STR and SR_EDIT_OP_DELETE. */
+    sr_move_position_t position;   /**< Requested move direction (SR_EDIT_OP_MOVE). */
+    const char *relative_item;     /**< Item used to determine relative position (SR_EDIT_OP_MOVE). */
+} sr_edit_op_t;
+
+/**
+ * @brief Applies an ordered array of set / delete / move operations with one request.
+ *
+ * The effect is the same as calling ::sr_set_item, ::sr_set_item_str, ::sr_delete_item and
+ * ::sr_move_item for each operation in the order of the array, but only one message is exchanged
+ * with Sysrepo Engine. Failed operations are not applied; the successful ones are applied
+ * even if another operation of the batch fails.
+ *
+ * @see Use ::sr_get_last_errors to retrieve the errors of all failed operations.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] ops Array of operations to be applied, may be NULL if op_cnt is 0.
+ * @param[in] op_cnt Number of operations in the array. An empty batch is a no-op that is not sent
+ * to Sysrepo Engine.
+ * @param[in] continue_on_error If false, processing stops on the first failed operation
+ * and the operations following it are not applied.
+ * @param[out] results (optional) Array of op_cnt elements filled with the result of each operation.
+ * Operations that were not applied because of a previous failure have SR_ERR_OPERATION_FAILED result.
+ *
+ * @return Error code (SR_ERR_OK if all operations succeeded, the error of the first failed operation otherwise).
+ */
+int sr_edit_batch(sr_session_ctx_t *session, const sr_edit_op_t *ops, size_t op_cnt, bool continue_on_error,
+        int *results);
+
 /**
  * @brief Perform the validation of changes made in current session, but do not
  * commit nor discard them.
@@ -1059,6 +1142,130 @@ int sr_copy_config(sr_session_ctx_t *session, const char *module_name,
         sr_datastore_t src_datastore, sr_datastore_t dst_datastore);
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Asynchronous Requests API
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Callback to be called when the response to an asynchronous request has been processed
+ * by ::sr_async_process.
+ *
+ * @param[in] session Session context that the request has been issued within.
+ * @param[in] token Token identifying the request, as returned by the *_async call.
+ * @param[in] result Result of the request (SR_ERR_OK on success).
+ * @param[in] value Retrieved value in case of ::sr_get_item_async (NULL otherwise, or in case of an error).
+ * Ownership is passed to the callback - the value should be freed by ::sr_free_val.
+ * @param[in] private_ctx Private context opaque to sysrepo, as passed to the *_async call.
+ */
+typedef void (*sr_async_cb)(sr_session_ctx_t *session, uint32_t token, int result, sr_val_t *value, void *private_ctx);
+
+/**
+ * @brief Asynchronous variant of ::sr_set_item. Sends the request and returns without waiting
+ * for the response, so that multiple requests can be outstanding within one session.
+ *
+ * Requests of a session are processed by sysrepo in the order in which they have been issued.
+ * The result of the request can be retrieved by ::sr_async_wait, or delivered to the callback
+ * by ::sr_async_process.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "Data Path" identifier of the data element to be set.
+ * @param[in] value Value to be set on specified xpath. Value will be copied - can be allocated on stack.
+ * @param[in] opts Options overriding default behavior of this call.
+ * @param[in] callback Callback to be called from ::sr_async_process once the request is completed (can be NULL).
+ * @param[in] private_ctx Private context passed to the callback.
+ * @param[out] token Token identifying the request within the session.
+ *
+ * @return Error code (SR_ERR_OK if the request has been sent).
+ */
+int sr_set_item_async(sr_session_ctx_t *session, const char *xpath, const sr_val_t *value, const sr_edit_options_t opts,
+        sr_async_cb callback, void *private_ctx, uint32_t *token);
+
+/**
+ * @brief Asynchronous variant of ::sr_set_item_str, see ::sr_set_item_async.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "Data Path" identifier of the data element to be set.
+ * @param[in] value String representation of the value to be set.
+ * @param[in] opts Options overriding default behavior of this call.
+ * @param[in] callback Callback to be called from ::sr_async_process once the request is completed (can be NULL).
+ * @param[in] private_ctx Private context passed to the callback.
+ * @param[out] token Token identifying the request within the session.
+ *
+ * @return Error code (SR_ERR_OK if the request has been sent).
+ */
+int sr_set_item_str_async(sr_session_ctx_t *session, const char *xpath, const char *value, const sr_edit_options_t opts,
+        sr_async_cb callback, void *private_ctx, uint32_t *token);
+
+/**
+ * @brief Asynchronous variant of ::sr_delete_item, see ::sr_set_item_async.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "Data Path" identifier of the data element to be deleted.
+ * @param[in] opts Options overriding default behavior of this call.
+ * @param[in] callback Callback to be called from ::sr_async_process once the request is completed (can be NULL).
+ * @param[in] private_ctx Private context passed to the callback.
+ * @param[out] token Token identifying the request within the session.
+ *
+ * @return Error code (SR_ERR_OK if the request has been sent).
+ */
+int sr_delete_item_async(sr_session_ctx_t *session, const char *xpath, const sr_edit_options_t opts,
+        sr_async_cb callback, void *private_ctx, uint32_t *token);
+
+/**
+ * @brief Asynchronous variant of ::sr_get_item, see ::sr_set_item_async. The value is returned
+ * by ::sr_async_wait, or passed to the callback.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath @ref xp_page "Data Path" identifier of the data element to be retrieved.
+ * @param[in] callback Callback to be called from ::sr_async_process once the request is completed (can be NULL).
+ * @param[in] private_ctx Private context passed to the callback.
+ * @param[out] token Token identifying the request within the session.
+ *
+ * @return Error code (SR_ERR_OK if the request has been sent).
+ */
+int sr_get_item_async(sr_session_ctx_t *session, const char *xpath, sr_async_cb callback, void *private_ctx,
+        uint32_t *token);
+
+/**
+ * @brief Blocks until the asynchronous request identified by the token is completed and returns
+ * its result. The callback of the request (if any) is not called.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] token Token of the request.
+ * @param[out] value Retrieved value in case of ::sr_get_item_async (can be NULL otherwise),
+ * should be freed by ::sr_free_val.
+ *
+ * @return Result of the request, SR_ERR_NOT_FOUND if there is no outstanding request with given token.
+ */
+int sr_async_wait(sr_session_ctx_t *session, uint32_t token, sr_val_t **value);
+
+/**
+ * @brief Processes the responses to asynchronous requests of the session that have arrived
+ * and calls the callbacks of the completed requests, in the order in which the requests have been issued.
+ *
+ * @note Responses of a connection arrive on the file descriptor returned by ::sr_async_get_fd.
+ * Applications using their own event loop can call this function with wait_all set to false
+ * whenever the file descriptor becomes readable.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] wait_all If true, blocks until all outstanding requests of the session are completed.
+ * @param[out] completed_cnt Number of completed requests (can be NULL).
+ *
+ * @return Error code (SR_ERR_OK on success, otherwise the result of the first failed request).
+ */
+int sr_async_process(sr_session_ctx_t *session, bool wait_all, size_t *completed_cnt);
+
+/**
+ * @brief Returns the file descriptor that the responses to asynchronous requests of the session arrive on.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[out] fd File descriptor to be monitored for readable events.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_async_get_fd(sr_session_ctx_t *session, int *fd);
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // Locking API
 ////////////////////////////////////////////////////////////////////////////////
@@ -1085,7 +1292,7 @@ int sr_lock_datastore(sr_session_ctx_t *session);
  * @brief Unlocks the datastore which the session is tied to.
  *
  * All data models within the datastore will be unlocked if they were locked
- * by this session.
+ * by this session, as well as the subtrees locked by ::sr_lock_subtree.
  *
  * @param[in] session Session context acquired with ::sr_session_start call.
  *
@@ -1125,6 +1332,37 @@ int sr_lock_module(sr_session_ctx_t *session, const char *module_name);
  */
 int sr_unlock_module(sr_session_ctx_t *session, const char *module_name);
 
+/**
+ * @brief Locks a subtree of a data module (typically a list instance) within the datastore
+ * which the session is tied to. Operation fails if the data module has been modified.
+ *
+ * The subtrees locked by different sessions can not overlap and the data module can not be locked
+ * as a whole (::sr_lock_module) while another session holds a lock of its subtree. A commit fails
+ * with ::SR_ERR_LOCKED if it changes a subtree locked by another session. A commit whose changes lie only
+ * in the subtrees locked by the session keeps the data module locked only while its data are loaded and written,
+ * not for the whole commit. Commits handled by one sysrepo daemon are still processed one at a time.
+ *
+ * Specified subtree will be locked until ::sr_unlock_subtree or ::sr_unlock_datastore is called or until
+ * the session is stopped or terminated for any reason.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath Absolute @ref xp_page "XPath" of the subtree root without wildcards,
+ * e.g. "/ietf-interfaces:interfaces/interface[name='eth0']".
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_lock_subtree(sr_session_ctx_t *session, const char *xpath);
+
+/**
+ * @brief Unlocks a subtree of a data module locked by ::sr_lock_subtree.
+ *
+ * @param[in] session Session context acquired with ::sr_session_start call.
+ * @param[in] xpath XPath of the subtree root passed to ::sr_lock_subtree.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_unlock_subtree(sr_session_ctx_t *session, const char *xpath);
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Change Notifications API
@@ -1184,6 +1422,14 @@ typedef enum sr_subscr_flag_e {
      * and replay has finished (::SR_EV_NOTIF_T_REPLAY_COMPLETE is delivered).
      */
     SR_SUBSCR_NOTIF_REPLAY_FIRST = 32,
+
+    /**
+     * @brief The changes are delivered together with each ::SR_EV_VERIFY, ::SR_EV_APPLY and ::SR_EV_ABORT
+     * notification of ::sr_module_change_subscribe and ::sr_subtree_change_subscribe subscriptions, so
+     * ::sr_get_changes_iter and ::sr_get_change_next called from the callback do not need to request
+     * them from the datastore.
+     */
+    SR_SUBSCR_INLINE_CHANGES = 64,
 } sr_subscr_flag_t;
 
 /**
@@ -28,6 +28,9 @@
 #include <pthread.h>
 
 #include "cl_common.h"
+#include "dm_version_table.h"
+
+#define CL_IN_BUF_MIN_SIZE 4096  /**< Minimal size of the input buffer of a connection. */
 
 /**
  * @brief Adds a new session to the session list of the connection.
@@ -71,6 +74,7 @@ static void
 cl_conn_remove_session(sr_conn_ctx_t *connection, sr_session_ctx_t *session)
 {
     sr_session_list_t *tmp = NULL, *prev = NULL;
+    cl_async_req_t *async_req = NULL;
 
     CHECK_NULL_ARG_VOID2(connection, session);
 
@@ -83,6 +87,15 @@ cl_conn_remove_session(sr_conn_ctx_t *connection, sr_session_ctx_t *session)
         tmp = tmp->next;
     }
 
+    /* drop outstanding asynchronous requests of the session */
+    while (NULL != session->async_first) {
+        async_req = session->async_first;
+        session->async_first = async_req->next;
+        cl_async_req_free(async_req);
+        connection->async_req_cnt--;
+    }
+    session->async_last = NULL;
+
     /* remove the session from linked-list */
     if (NULL != tmp) {
         if (NULL != prev) {
@@ -126,6 +139,29 @@ cl_conn_msg_buf_expand(sr_conn_ctx_t *conn_ctx, size_t required_size)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Expands input buffer of a connection to fit given size, if needed.
+ */
+static int
+cl_conn_in_buf_expand(sr_conn_ctx_t *conn_ctx, size_t required_size)
+{
+    uint8_t *tmp = NULL;
+
+    CHECK_NULL_ARG(conn_ctx);
+
+    if (conn_ctx->in_buf_size < required_size) {
+        tmp = realloc(conn_ctx->in_buf, required_size * sizeof(*tmp));
+        if (NULL == tmp) {
+            SR_LOG_ERR("Unable to expand input buffer of connection=%p.", (void*)conn_ctx);
+            return SR_ERR_NOMEM;
+        }
+        conn_ctx->in_buf = tmp;
+        conn_ctx->in_buf_size = required_size;
+    }
+
+    return SR_ERR_OK;
+}
+
 /**
  * @brief Sends a message via provided connection.
  */
@@ -175,67 +211,57 @@ cl_message_send(sr_conn_ctx_t *conn_ctx, Sr__Msg *msg)
     return SR_ERR_OK;
 }
 
-/*
- * @brief Receives a message on provided connection (blocks until a message is received).
+/**
+ * @brief Makes sure that the input buffer of the connection starts with a completely received
+ * message, receives more data if needed.
+ *
+ * @param[in] conn_ctx Connection context.
+ * @param[in] block Block until the message is received.
+ * @param[out] msg_size_p Size of the message (without the preamble).
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_NOT_FOUND if not blocking and there is no complete message yet).
  */
 static int
-cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_resp)
+cl_message_recv_raw(sr_conn_ctx_t *conn_ctx, bool block, size_t *msg_size_p)
 {
-    size_t len = 0, pos = 0;
+    ssize_t len = 0;
     size_t msg_size = 0;
-    sr_mem_ctx_t *sr_mem = sr_mem_resp;
-    int rc = 0;
+    int rc = SR_ERR_OK;
 
-    /* expand the buffer if needed */
-    rc = cl_conn_msg_buf_expand(conn_ctx, SR_MSG_PREAM_SIZE);
-    if (SR_ERR_OK != rc) {
-        SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
-        return rc;
-    }
+    while (true) {
+        if (conn_ctx->in_buf_len >= SR_MSG_PREAM_SIZE) {
+            msg_size = sr_buff_to_uint32(conn_ctx->in_buf);
 
-    /* read at least first 4 bytes with length of the message */
-    while (pos < SR_MSG_PREAM_SIZE) {
-        len = recv(conn_ctx->fd, conn_ctx->msg_buf, conn_ctx->msg_buf_size, 0);
-        if (-1 == len) {
-            if (errno == EINTR) {
-                continue;
+            /* check message size bounds */
+            if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
+                SR_LOG_ERR("Invalid message size in the message preamble (%zu).", msg_size);
+                return SR_ERR_MALFORMED_MSG;
             }
-            if (EAGAIN == errno || EWOULDBLOCK == errno) {
-                SR_LOG_ERR_MSG("While waiting for a response, timeout has expired.");
-                return SR_ERR_TIME_OUT;
+            if (conn_ctx->in_buf_len >= (msg_size + SR_MSG_PREAM_SIZE)) {
+                /* the message is completely received */
+                *msg_size_p = msg_size;
+                return SR_ERR_OK;
             }
-            SR_LOG_ERR("Error by receiving of the message: %s.", sr_strerror_safe(errno));
-            return SR_ERR_DISCONNECT;
+            rc = cl_conn_in_buf_expand(conn_ctx, (msg_size + SR_MSG_PREAM_SIZE));
+        } else {
+            rc = cl_conn_in_buf_expand(conn_ctx, CL_IN_BUF_MIN_SIZE);
         }
-        if (0 == len) {
-            SR_LOG_ERR_MSG("Sysrepo server disconnected.");
-            return SR_ERR_DISCONNECT;
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
+            return rc;
         }
-        pos += len;
-    }
-    msg_size = sr_buff_to_uint32(conn_ctx->msg_buf);
-
-    /* check message size bounds */
-    if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
-        SR_LOG_ERR("Invalid message size in the message preamble (%zu).", msg_size);
-        return SR_ERR_MALFORMED_MSG;
-    }
-
-    /* expand the buffer if needed */
-    rc = cl_conn_msg_buf_expand(conn_ctx, (msg_size + SR_MSG_PREAM_SIZE));
-    if (SR_ERR_OK != rc) {
-        SR_LOG_ERR_MSG("Cannot expand buffer for the message.");
-        return rc;
-    }
 
-    /* read the rest of the message */
-    while (pos < (msg_size + SR_MSG_PREAM_SIZE)) {
-        len = recv(conn_ctx->fd, (conn_ctx->msg_buf + pos), (conn_ctx->msg_buf_size - pos), 0);
+        /* read the data, possibly also including the following messages */
+        len = recv(conn_ctx->fd, (conn_ctx->in_buf + conn_ctx->in_buf_len), (conn_ctx->in_buf_size - conn_ctx->in_buf_len),
+                block ? 0 : MSG_DONTWAIT);
         if (-1 == len) {
             if (errno == EINTR) {
                 continue;
             }
             if (EAGAIN == errno || EWOULDBLOCK == errno) {
+                if (!block) {
+                    return SR_ERR_NOT_FOUND;
+                }
                 SR_LOG_ERR_MSG("While waiting for a response, timeout has expired.");
                 return SR_ERR_TIME_OUT;
             }
@@ -246,16 +272,25 @@ cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_res
             SR_LOG_ERR_MSG("Sysrepo server disconnected.");
             return SR_ERR_DISCONNECT;
         }
-        pos += len;
+        conn_ctx->in_buf_len += len;
     }
+}
+
+/**
+ * @brief Unpacks the message at the beginning of the input buffer of the connection.
+ */
+static int
+cl_message_unpack(sr_conn_ctx_t *conn_ctx, size_t msg_size, sr_mem_ctx_t *sr_mem_resp, Sr__Msg **msg)
+{
+    sr_mem_ctx_t *sr_mem = sr_mem_resp;
+    int rc = SR_ERR_OK;
 
-    /* unpack the message */
     if (NULL == sr_mem) {
         rc = sr_mem_new(msg_size, &sr_mem);
         CHECK_RC_MSG_RETURN(rc, "Failed to create a new Sysrepo memory context.");
     }
     ProtobufCAllocator allocator = sr_get_protobuf_allocator(sr_mem);
-    *msg = sr__msg__unpack(&allocator, msg_size, (const uint8_t*)(conn_ctx->msg_buf + SR_MSG_PREAM_SIZE));
+    *msg = sr__msg__unpack(&allocator, msg_size, (const uint8_t*)(conn_ctx->in_buf + SR_MSG_PREAM_SIZE));
     if (NULL == *msg) {
         if (NULL == sr_mem_resp) {
             sr_mem_free(sr_mem);
@@ -269,10 +304,191 @@ cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_res
         (*msg)->_sysrepo_mem_ctx = (uint64_t)sr_mem;
         ++sr_mem->obj_count;
     }
+    sr_gpb_msg_internal_reset(*msg);
 
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Removes the message at the beginning of the input buffer of the connection.
+ */
+static void
+cl_message_consume(sr_conn_ctx_t *conn_ctx, size_t msg_size)
+{
+    size_t size = msg_size + SR_MSG_PREAM_SIZE;
+
+    if (conn_ctx->in_buf_len > size) {
+        /* move the following data to the front of the buffer */
+        memmove(conn_ctx->in_buf, (conn_ctx->in_buf + size), (conn_ctx->in_buf_len - size));
+    }
+    conn_ctx->in_buf_len -= size;
+}
+
+/*
+ * @brief Receives a message on provided connection (blocks until a message is received).
+ */
+static int
+cl_message_recv(sr_conn_ctx_t *conn_ctx, Sr__Msg **msg, sr_mem_ctx_t *sr_mem_resp)
+{
+    size_t msg_size = 0;
+    int rc = SR_ERR_OK;
+
+    rc = cl_message_recv_raw(conn_ctx, true, &msg_size);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
+    rc = cl_message_unpack(conn_ctx, msg_size, sr_mem_resp, msg);
+    cl_message_consume(conn_ctx, msg_size);
+
+    return rc;
+}
+
+/**
+ * @brief Assigns a new request identifier (unique within the connection) to the request.
+ * Expects the connection lock to be held.
+ */
+static uint32_t
+cl_request_id_assign(sr_conn_ctx_t *conn_ctx, Sr__Msg *msg_req)
+{
+    if (0 == ++conn_ctx->last_req_id) {
+        ++conn_ctx->last_req_id; /* 0 is not a valid request identifier */
+    }
+    msg_req->request->req_id = conn_ctx->last_req_id;
+    msg_req->request->has_req_id = true;
+
+    return conn_ctx->last_req_id;
+}
+
+/**
+ * @brief Receives a message on the connection and hands it over to the request with the request
+ * identifier echoed in the message: either an outstanding asynchronous request of its session,
+ * or the synchronous request being processed (if any). Messages that do not belong to any
+ * of them are dropped. Expects the connection lock to be held.
+ *
+ * @param[in] conn_ctx Connection context.
+ * @param[in] sync_req_id Identifier of the synchronous request waiting for the response, 0 if none.
+ * @param[in] sr_mem_resp Memory context to use for the allocation of the synchronous response (can be NULL).
+ * @param[in] block Block until a message is received.
+ * @param[out] sync_resp Response to the synchronous request, NULL if the message was not the one.
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_NOT_FOUND if not blocking and there is no complete message yet).
+ */
+static int
+cl_response_recv(sr_conn_ctx_t *conn_ctx, uint32_t sync_req_id, sr_mem_ctx_t *sr_mem_resp,
+        bool block, Sr__Msg **sync_resp)
+{
+    sr_session_list_t *session_item = NULL;
+    cl_async_req_t *async_req = NULL;
+    Sr__Msg *msg = NULL;
+    size_t msg_size = 0;
+    uint32_t req_id = 0;
+    int rc = SR_ERR_OK;
+
+    *sync_resp = NULL;
+
+    rc = cl_message_recv_raw(conn_ctx, block, &msg_size);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
+    /* with no asynchronous requests, the response is unpacked right into the memory context of the synchronous one */
+    rc = cl_message_unpack(conn_ctx, msg_size, (0 == conn_ctx->async_req_cnt) ? sr_mem_resp : NULL, &msg);
+    if (SR_ERR_OK != rc) {
+        cl_message_consume(conn_ctx, msg_size);
+        return rc;
+    }
+    if (NULL != msg->response && msg->response->has_req_id) {
+        req_id = msg->response->req_id;
+    }
+
+    /* find the asynchronous request of the session with the echoed identifier */
+    if (0 != req_id && 0 != conn_ctx->async_req_cnt) {
+        for (session_item = conn_ctx->session_list; NULL != session_item; session_item = session_item->next) {
+            if (session_item->session->id == msg->session_id) {
+                async_req = session_item->session->async_first;
+                while (NULL != async_req && (req_id != async_req->token || NULL != async_req->msg_resp)) {
+                    async_req = async_req->next;
+                }
+                break;
+            }
+        }
+    }
+
+    if (NULL != async_req) {
+        async_req->msg_resp = msg;
+    } else if (0 != req_id && req_id == sync_req_id) {
+        if (0 != conn_ctx->async_req_cnt && NULL != sr_mem_resp) {
+            /* the response needs to be allocated from the provided memory context */
+            sr_msg_free(msg);
+            msg = NULL;
+            rc = cl_message_unpack(conn_ctx, msg_size, sr_mem_resp, &msg);
+        }
+        *sync_resp = msg;
+    } else {
+        SR_LOG_WRN("Unexpected message received (session id=%"PRIu32", request id=%"PRIu32"), dropping it.",
+                msg->session_id, req_id);
+        sr_msg_free(msg);
+    }
+    cl_message_consume(conn_ctx, msg_size);
+
+    return rc;
+}
+
+/**
+ * @brief Returns true if some asynchronous request of the session still waits for its response.
+ * Expects the connection lock to be held.
+ */
+static bool
+cl_async_pending(sr_session_ctx_t *session)
+{
+    for (cl_async_req_t *async_req = session->async_first; NULL != async_req; async_req = async_req->next) {
+        if (NULL == async_req->msg_resp) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Validates the response and checks the result of the operation.
+ */
+static int
+cl_response_check(sr_session_ctx_t *session, Sr__Operation req_operation, Sr__Msg *msg_resp,
+        const Sr__Operation expected_response_op)
+{
+    int rc = SR_ERR_OK;
+
+    /* validate the response */
+    rc = sr_gpb_msg_validate(msg_resp, SR__MSG__MSG_TYPE__RESPONSE, expected_response_op);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Malformed message with response received (session id=%"PRIu32", operation=%s).",
+                session->id, sr_gpb_operation_name(req_operation));
+        return rc;
+    }
+
+    /* check for errors */
+    if (SR_ERR_OK != msg_resp->response->result) {
+        if (NULL != msg_resp->response->error) {
+            /* set detailed error information into session */
+            rc = cl_session_set_error(session, msg_resp->response->error->message, msg_resp->response->error->xpath);
+        }
+        /* log the error (except expected ones) */
+        if (SR_ERR_NOT_FOUND != msg_resp->response->result &&
+                SR_ERR_VALIDATION_FAILED != msg_resp->response->result &&
+                SR_ERR_UNAUTHORIZED != msg_resp->response->result &&
+                SR_ERR_OPERATION_FAILED != msg_resp->response->result) {
+            SR_LOG_ERR("Error by processing of the %s request (session id=%"PRIu32"): %s.",
+                    sr_gpb_operation_name(req_operation), session->id,
+                (NULL != msg_resp->response->error && NULL != msg_resp->response->error->message) ?
+                        msg_resp->response->error->message : sr_strerror(msg_resp->response->result));
+        }
+        return msg_resp->response->result;
+    }
+
+    return rc;
+}
+
 int
 cl_connection_create(sr_conn_ctx_t **conn_ctx_p)
 {
@@ -311,8 +527,10 @@ cl_connection_cleanup(sr_conn_ctx_t *conn_ctx)
             cl_session_cleanup(tmp->session);
         }
 
+        dm_version_table_close(conn_ctx->version_table);
         pthread_mutex_destroy(&conn_ctx->lock);
         free(conn_ctx->msg_buf);
+        free(conn_ctx->in_buf);
         free((void*)conn_ctx->dst_address);
         if (-1 != conn_ctx->fd) {
             close(conn_ctx->fd);
@@ -486,15 +704,17 @@ int
 cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_resp,
         sr_mem_ctx_t *sr_mem_resp, const Sr__Operation expected_response_op)
 {
+    uint32_t req_id = 0;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(session, session->conn_ctx, msg_req, msg_resp);
+    CHECK_NULL_ARG5(session, session->conn_ctx, msg_req, msg_req->request, msg_resp);
 
     SR_LOG_DBG("Sending %s request.", sr_gpb_operation_name(expected_response_op));
 
     pthread_mutex_lock(&session->conn_ctx->lock);
 
     /* send the request */
+    req_id = cl_request_id_assign(session->conn_ctx, msg_req);
     rc = cl_message_send(session->conn_ctx, msg_req);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Unable to send the message with request (session id=%"PRIu32", operation=%s).",
@@ -505,8 +725,10 @@ cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_re
 
     SR_LOG_DBG("%s request sent, waiting for response.", sr_gpb_operation_name(expected_response_op));
 
-    /* receive the response */
-    rc = cl_message_recv(session->conn_ctx, msg_resp, sr_mem_resp);
+    /* receive the response, responses to asynchronous requests that arrive before it are stored */
+    do {
+        rc = cl_response_recv(session->conn_ctx, req_id, sr_mem_resp, true, msg_resp);
+    } while (SR_ERR_OK == rc && NULL == *msg_resp);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Unable to receive the message with response (session id=%"PRIu32", operation=%s).",
                 session->id, sr_gpb_operation_name(msg_req->request->operation));
@@ -518,36 +740,169 @@ cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_re
 
     SR_LOG_DBG("%s response received, processing.", sr_gpb_operation_name(expected_response_op));
 
-    /* validate the response */
-    rc = sr_gpb_msg_validate(*msg_resp, SR__MSG__MSG_TYPE__RESPONSE, expected_response_op);
+    return cl_response_check(session, msg_req->request->operation, *msg_resp, expected_response_op);
+}
+
+int
+cl_request_send_async(sr_session_ctx_t *session, Sr__Msg *msg_req, sr_async_cb callback,
+        void *private_ctx, uint32_t *token)
+{
+    cl_async_req_t *async_req = NULL;
+    sr_conn_ctx_t *conn_ctx = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(session, session->conn_ctx, msg_req, msg_req->request, token);
+
+    conn_ctx = session->conn_ctx;
+
+    async_req = calloc(1, sizeof(*async_req));
+    CHECK_NULL_NOMEM_RETURN(async_req);
+    async_req->operation = msg_req->request->operation;
+    async_req->callback = callback;
+    async_req->private_ctx = private_ctx;
+
+    SR_LOG_DBG("Sending asynchronous %s request.", sr_gpb_operation_name(async_req->operation));
+
+    pthread_mutex_lock(&conn_ctx->lock);
+
+    /* send the request */
+    async_req->token = cl_request_id_assign(conn_ctx, msg_req);
+    rc = cl_message_send(conn_ctx, msg_req);
     if (SR_ERR_OK != rc) {
-        SR_LOG_ERR("Malformed message with response received (session id=%"PRIu32", operation=%s).",
-                session->id, sr_gpb_operation_name(msg_req->request->operation));
+        SR_LOG_ERR("Unable to send the message with request (session id=%"PRIu32", operation=%s).",
+                session->id, sr_gpb_operation_name(async_req->operation));
+        pthread_mutex_unlock(&conn_ctx->lock);
+        free(async_req);
         return rc;
     }
 
-    /* check for errors */
-    if (SR_ERR_OK != (*msg_resp)->response->result) {
-        if (NULL != (*msg_resp)->response->error) {
-            /* set detailed error information into session */
-            rc = cl_session_set_error(session, (*msg_resp)->response->error->message, (*msg_resp)->response->error->xpath);
+    /* append the request to the outstanding requests of the session */
+    if (NULL == session->async_last) {
+        session->async_first = async_req;
+    } else {
+        session->async_last->next = async_req;
+    }
+    session->async_last = async_req;
+    ++conn_ctx->async_req_cnt;
+
+    pthread_mutex_unlock(&conn_ctx->lock);
+
+    *token = async_req->token;
+    return SR_ERR_OK;
+}
+
+int
+cl_async_wait(sr_session_ctx_t *session, uint32_t token, cl_async_req_t **async_req_p)
+{
+    cl_async_req_t *async_req = NULL, *prev = NULL;
+    sr_conn_ctx_t *conn_ctx = NULL;
+    Sr__Msg *msg = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(session, session->conn_ctx, async_req_p);
+
+    conn_ctx = session->conn_ctx;
+
+    pthread_mutex_lock(&conn_ctx->lock);
+
+    for (async_req = session->async_first; NULL != async_req && token != async_req->token; async_req = async_req->next) {
+        prev = async_req;
+    }
+    if (NULL == async_req) {
+        pthread_mutex_unlock(&conn_ctx->lock);
+        SR_LOG_ERR("No outstanding asynchronous request with token %"PRIu32" (session id=%"PRIu32").", token, session->id);
+        return SR_ERR_NOT_FOUND;
+    }
+
+    /* receive messages until the response arrives */
+    while (SR_ERR_OK == rc && NULL == async_req->msg_resp) {
+        rc = cl_response_recv(conn_ctx, 0, NULL, true, &msg);
+    }
+
+    if (SR_ERR_OK == rc) {
+        /* remove the request from the session */
+        if (NULL == prev) {
+            session->async_first = async_req->next;
+        } else {
+            prev->next = async_req->next;
         }
-        /* log the error (except expected ones) */
-        if (SR_ERR_NOT_FOUND != (*msg_resp)->response->result &&
-                SR_ERR_VALIDATION_FAILED != (*msg_resp)->response->result &&
-                SR_ERR_UNAUTHORIZED != (*msg_resp)->response->result &&
-                SR_ERR_OPERATION_FAILED != (*msg_resp)->response->result) {
-            SR_LOG_ERR("Error by processing of the %s request (session id=%"PRIu32"): %s.",
-                    sr_gpb_operation_name(msg_req->request->operation), session->id,
-                (NULL != (*msg_resp)->response->error && NULL != (*msg_resp)->response->error->message) ?
-                        (*msg_resp)->response->error->message : sr_strerror((*msg_resp)->response->result));
+        if (session->async_last == async_req) {
+            session->async_last = prev;
         }
-        return (*msg_resp)->response->result;
+        async_req->next = NULL;
+        --conn_ctx->async_req_cnt;
+        *async_req_p = async_req;
+    } else {
+        SR_LOG_ERR("Unable to receive the response to the asynchronous request (session id=%"PRIu32", operation=%s).",
+                session->id, sr_gpb_operation_name(async_req->operation));
     }
 
+    pthread_mutex_unlock(&conn_ctx->lock);
+
     return rc;
 }
 
+int
+cl_async_process(sr_session_ctx_t *session, bool wait_all, cl_async_req_t **completed)
+{
+    cl_async_req_t *first = NULL, *last = NULL;
+    sr_conn_ctx_t *conn_ctx = NULL;
+    Sr__Msg *msg = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(session, session->conn_ctx, completed);
+
+    conn_ctx = session->conn_ctx;
+
+    pthread_mutex_lock(&conn_ctx->lock);
+
+    /* if not waiting for all, process only the messages that have already arrived */
+    while (SR_ERR_OK == rc && cl_async_pending(session)) {
+        rc = cl_response_recv(conn_ctx, 0, NULL, wait_all, &msg);
+    }
+    if (!wait_all && SR_ERR_NOT_FOUND == rc) {
+        rc = SR_ERR_OK;
+    }
+
+    /* detach the completed requests */
+    while (NULL != session->async_first && NULL != session->async_first->msg_resp) {
+        if (NULL == last) {
+            first = session->async_first;
+        } else {
+            last->next = session->async_first;
+        }
+        last = session->async_first;
+        session->async_first = last->next;
+        last->next = NULL;
+        --conn_ctx->async_req_cnt;
+    }
+    if (NULL == session->async_first) {
+        session->async_last = NULL;
+    }
+
+    pthread_mutex_unlock(&conn_ctx->lock);
+
+    *completed = first;
+    return rc;
+}
+
+int
+cl_async_req_result(sr_session_ctx_t *session, cl_async_req_t *async_req)
+{
+    CHECK_NULL_ARG3(session, async_req, async_req->msg_resp);
+
+    return cl_response_check(session, async_req->operation, async_req->msg_resp, async_req->operation);
+}
+
+void
+cl_async_req_free(cl_async_req_t *async_req)
+{
+    if (NULL != async_req) {
+        sr_msg_free(async_req->msg_resp);
+        free(async_req);
+    }
+}
+
 int
 cl_session_set_error(sr_session_ctx_t *session, const char *error_message, const char *error_path)
 {
@@ -30,6 +30,11 @@
  */
 typedef struct cm_ctx_s cm_ctx_t;
 
+/**
+ * @brief Definition in dm_version_table.c
+ */
+typedef struct dm_version_table_s dm_version_table_t;
+
 /**
  * @brief Connection context used to identify a connection to sysrepo datastore.
  */
@@ -40,13 +45,34 @@ typedef struct sr_conn_ctx_s {
                                                   still the same process at the dst_address). */
     pthread_mutex_t lock;                    /**< Mutex of the connection to guarantee that requests on the
                                                   same connection are processed serially (one after another). */
-    uint8_t *msg_buf;                        /**< Buffer used for sending / receiving messages. */
+    uint8_t *msg_buf;                        /**< Buffer used for sending messages. */
     size_t msg_buf_size;                     /**< Length of the message buffer. */
+    uint8_t *in_buf;                         /**< Buffer used for receiving messages. */
+    size_t in_buf_size;                      /**< Length of the input buffer. */
+    size_t in_buf_len;                       /**< Length of the received data in the input buffer (may contain
+                                                  more than one message if there are some asynchronous requests). */
+    size_t async_req_cnt;                    /**< Number of asynchronous requests waiting for a response (over all sessions). */
+    uint32_t last_req_id;                    /**< Identifier assigned to the last request sent over the connection. */
     struct sr_session_list_s *session_list;  /**< Linked-list of associated sessions. */
     bool library_mode;                       /**< Determine if we are connected to sysrepo daemon
                                                   or our own sysrepo engine (library mode). */
+    dm_version_table_t *version_table;       /**< Version table of the data files, mapped on the first
+                                                  ::sr_module_change_seq call (library mode only). */
 } sr_conn_ctx_t;
 
+/**
+ * @brief Asynchronous request waiting for its response (or for its completion to be delivered).
+ * The response is matched with the request by the request identifier echoed in it.
+ */
+typedef struct cl_async_req_s {
+    uint32_t token;                 /**< Token identifying the request, equal to the request identifier sent on the wire. */
+    Sr__Operation operation;        /**< Operation of the request. */
+    sr_async_cb callback;           /**< Callback to be called once the response is processed (can be NULL). */
+    void *private_ctx;              /**< Private context passed to the callback. */
+    Sr__Msg *msg_resp;              /**< Response to the request, NULL until received. */
+    struct cl_async_req_s *next;    /**< Next request of the session. */
+} cl_async_req_t;
+
 /**
  * @brief Session context used to identify a configuration session.
  */
@@ -60,6 +86,10 @@ typedef struct sr_session_ctx_s {
     size_t error_cnt;             /**< Number of errors that occurred within last API call. */
     bool notif_session;           /**< Distinguishes internal notification session from other ones. */
     uint32_t commit_id;           /**< ID of the commit in case that this is a notification session (0 otherwise). */
+    Sr__ChangeSet *inline_changes;/**< Changes delivered with the notification being processed in case that this is
+                                       a notification session of a subscription with inline changes (NULL otherwise). */
+    cl_async_req_t *async_first;  /**< First outstanding asynchronous request (guarded by the connection lock). */
+    cl_async_req_t *async_last;   /**< Last outstanding asynchronous request (guarded by the connection lock). */
 } sr_session_ctx_t;
 
 /**
@@ -137,6 +167,64 @@ int cl_version_verify(sr_conn_ctx_t *connection);
 int cl_request_process(sr_session_ctx_t *session, Sr__Msg *msg_req, Sr__Msg **msg_resp,
         sr_mem_ctx_t *sr_mem_resp, const Sr__Operation expected_response_op);
 
+/**
+ * @brief Sends the request over the connection without waiting for the response.
+ * The response is later retrieved by ::cl_async_wait or ::cl_async_process.
+ *
+ * @param[in] session Session context acquired by ::cl_session_create call.
+ * @param[in] msg_req GPB message with the request to be sent.
+ * @param[in] callback Callback to be called once the response is processed (can be NULL).
+ * @param[in] private_ctx Private context passed to the callback.
+ * @param[out] token Token identifying the request within the session.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cl_request_send_async(sr_session_ctx_t *session, Sr__Msg *msg_req, sr_async_cb callback,
+        void *private_ctx, uint32_t *token);
+
+/**
+ * @brief Waits for the response to given asynchronous request. Responses to other asynchronous
+ * requests that arrive in the meantime are stored until they are processed.
+ *
+ * @param[in] session Session context acquired by ::cl_session_create call.
+ * @param[in] token Token of the request returned by ::cl_request_send_async.
+ * @param[out] async_req Completed request with the response, to be released by ::cl_async_req_free.
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_NOT_FOUND if there is no such outstanding request).
+ */
+int cl_async_wait(sr_session_ctx_t *session, uint32_t token, cl_async_req_t **async_req);
+
+/**
+ * @brief Receives the responses to the asynchronous requests of the session and returns
+ * the completed requests in the order in which they have been sent.
+ *
+ * @param[in] session Session context acquired by ::cl_session_create call.
+ * @param[in] wait_all If TRUE, blocks until all outstanding requests of the session are completed,
+ * otherwise only processes the responses that have already arrived.
+ * @param[out] completed Linked-list of completed requests, each to be released by ::cl_async_req_free.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cl_async_process(sr_session_ctx_t *session, bool wait_all, cl_async_req_t **completed);
+
+/**
+ * @brief Checks the result of a completed asynchronous request, sets detailed error information
+ * into the session context in case of an error.
+ *
+ * @param[in] session Session context acquired by ::cl_session_create call.
+ * @param[in] async_req Completed asynchronous request.
+ *
+ * @return Result of the request.
+ */
+int cl_async_req_result(sr_session_ctx_t *session, cl_async_req_t *async_req);
+
+/**
+ * @brief Releases a completed asynchronous request including its response.
+ *
+ * @param[in] async_req Asynchronous request.
+ */
+void cl_async_req_free(cl_async_req_t *async_req);
+
 /**
  * @brief Sets detailed error information into session context.
  *
@@ -41,6 +41,7 @@
 
 #define CL_SM_IN_BUFF_MIN_SPACE 512  /**< Minimal empty space in the input buffer. */
 #define CL_SM_BUFF_ALLOC_CHUNK 1024  /**< Chunk size for buffer expansions. */
+#define CL_SM_OUT_BUFF_FLUSH_SIZE 65536  /**< Amount of pending output data that is flushed without waiting for the end of input processing. */
 
 #define CL_SM_SUBSCRIPTION_ID_INVALID 0         /**< Invalid value of subscription id. */
 #define CL_SM_SUBSCRIPTION_ID_MAX_ATTEMPTS 100  /**< Maximum number of attempts to generate unused random subscription id. */
@@ -98,6 +99,11 @@ typedef struct cl_sm_ctx_s {
     ev_async server_ctx_watcher;
     /** Blocking synchronization of processing of all pending events */
     sr_fd_sm_terminated_cb local_watcher_terminate_cb;
+
+    /** Number of messages written into output buffers of the connections. */
+    uint64_t msg_sent_cnt;
+    /** Number of send calls issued to flush the output buffers. */
+    uint64_t send_call_cnt;
 } cl_sm_ctx_t;
 
 /**
@@ -407,6 +413,7 @@ cl_sm_conn_out_buff_flush(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn)
     do {
         /* try to send all data */
         written = send(conn->fd, (buff->data + buff_pos), (buff_size - buff_pos), 0);
+        sm_ctx->send_call_cnt++;
         if (written > 0) {
             SR_LOG_DBG("%d bytes of data sent.", written);
             buff_pos += written;
@@ -621,9 +628,13 @@ cl_sm_msg_send_connection(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *
         /* write the message */
         sr__msg__pack(msg, (buff->data + buff->pos));
         buff->pos += msg_size;
+        sm_ctx->msg_sent_cnt++;
 
-        /* flush the buffer */
-        rc = cl_sm_conn_out_buff_flush(sm_ctx, conn);
+        /* flush the buffer only if there is a lot of data, otherwise the messages produced
+         * by processing of the input buffer are coalesced and flushed together afterwards */
+        if ((buff->pos - buff->start) >= CL_SM_OUT_BUFF_FLUSH_SIZE) {
+            rc = cl_sm_conn_out_buff_flush(sm_ctx, conn);
+        }
         if ((conn->close_requested) || (SR_ERR_OK != rc)) {
             /* do not close the connection right here - since send is always a consequence of receive,
              * it will be closed in receive code path */
@@ -646,6 +657,7 @@ cl_sm_notif_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *msg)
     sr_session_ctx_t *data_session = NULL;
     Sr__Msg *ack_msg = NULL;
     sr_mem_ctx_t *sr_mem = NULL;
+    ProtobufCBinaryData *changes = NULL;
     const char *errmsg = NULL;
     int rc = SR_ERR_OK, rc_tmp = SR_ERR_OK;
 
@@ -686,6 +698,23 @@ cl_sm_notif_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *msg)
             goto ack;
         }
         cl_session_clear_errors(data_session);
+
+        /* changes delivered with the notification are iterated locally by the data session */
+        if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == msg->notification->type &&
+                msg->notification->module_change_notif->has_changes) {
+            changes = &msg->notification->module_change_notif->changes;
+        }
+        if (SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == msg->notification->type &&
+                msg->notification->subtree_change_notif->has_changes) {
+            changes = &msg->notification->subtree_change_notif->changes;
+        }
+        if (NULL != changes) {
+            data_session->inline_changes = sr__change_set__unpack(NULL, changes->len, changes->data);
+            if (NULL == data_session->inline_changes) {
+                SR_LOG_WRN("Unable to unpack the changes delivered for subscription id=%"PRIu32", "
+                        "they will be requested from the datastore.", subscription->id);
+            }
+        }
     }
 
     switch (msg->notification->type) {
@@ -737,6 +766,11 @@ cl_sm_notif_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *msg)
             rc = SR_ERR_INVAL_ARG;
     }
 
+    if (NULL != data_session && NULL != data_session->inline_changes) {
+        sr__change_set__free_unpacked(data_session->inline_changes, NULL);
+        data_session->inline_changes = NULL;
+    }
+
 ack:
     /* send notification ACK */
     if ((SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == msg->notification->type) ||
@@ -928,6 +962,7 @@ cl_sm_rpc_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, Sr__Msg *msg)
     CHECK_RC_LOG_GOTO(rc, cleanup, "Allocation of %s response failed.", op_name);
 
     resp->response->result = op_rc;
+    sr_gpb_resp_set_req_id(msg, resp);
     resp->response->rpc_resp->action = action;
     sr_mem_edit_string(sr_mem_resp, &resp->response->rpc_resp->xpath, msg->request->rpc_req->xpath);
     resp->response->rpc_resp->orig_api_variant = msg->request->rpc_req->orig_api_variant;
@@ -1078,6 +1113,7 @@ cl_sm_conn_msg_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn, uint8_t *msg
         msg->_sysrepo_mem_ctx = (uint64_t)sr_mem;
         ++sr_mem->obj_count;
     }
+    sr_gpb_msg_internal_reset(msg);
 
     /* check the message */
     if (SR__MSG__MSG_TYPE__NOTIFICATION == msg->type) {
@@ -1131,7 +1167,7 @@ cl_sm_conn_in_buff_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn)
             /* invalid message size */
             SR_LOG_ERR("Invalid message size in the message preamble (%zu).", msg_size);
             return SR_ERR_MALFORMED_MSG;
-        } else if ((buff_size - buff_pos) >= msg_size) {
+        } else if ((buff_size - buff_pos) >= (SR_MSG_PREAM_SIZE + msg_size)) {
             /* the message is completely retrieved, parse it */
             SR_LOG_DBG("New message of size %zu bytes received.", msg_size);
             rc = cl_sm_conn_msg_process(sm_ctx, conn,
@@ -1139,6 +1175,8 @@ cl_sm_conn_in_buff_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn)
             buff_pos += SR_MSG_PREAM_SIZE + msg_size;
             if (SR_ERR_OK != rc) {
                 SR_LOG_ERR_MSG("Error by processing of the message.");
+                /* deliver responses to the already processed messages */
+                cl_sm_conn_out_buff_flush(sm_ctx, conn);
                 return rc;
             }
         } else {
@@ -1157,6 +1195,11 @@ cl_sm_conn_in_buff_process(cl_sm_ctx_t *sm_ctx, cl_sm_conn_ctx_t *conn)
         buff->pos = buff_size - buff_pos;
     }
 
+    /* flush all responses produced by processing of the messages at once */
+    if (SR_ERR_OK == rc && !conn->close_requested) {
+        rc = cl_sm_conn_out_buff_flush(sm_ctx, conn);
+    }
+
     return rc;
 }
 
@@ -1802,6 +1845,10 @@ cl_sm_cleanup(cl_sm_ctx_t *sm_ctx, bool join)
             }
         }
 
+        SR_LOG_DBG("Client Subscription Manager sent %"PRIu64" messages with %"PRIu64" send calls (%.2f syscalls per message).",
+                sm_ctx->msg_sent_cnt, sm_ctx->send_call_cnt,
+                (sm_ctx->msg_sent_cnt > 0) ? ((double)sm_ctx->send_call_cnt / sm_ctx->msg_sent_cnt) : 0.0);
+
         free(sm_ctx);
 
         SR_LOG_INF_MSG("Client Subscription Manager successfully destroyed.");
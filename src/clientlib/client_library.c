@@ -35,6 +35,7 @@
 #include "cl_subscription_manager.h"
 #include "cl_common.h"
 #include "trees_internal.h"
+#include "dm_version_table.h"
 
 /**
  * @brief Maximum number of *not-yet-loaded* levels of any subtree chunk sent by the operation
@@ -81,6 +82,7 @@ typedef struct sr_change_iter_s {
     sr_val_t **old_values;          /**< Buffered old values. */
     size_t index;                   /**< Index into buff_values pointing to the value to be returned by next call. */
     size_t count;                   /**< Number of elements currently buffered. */
+    bool local;                     /**< All the changes are buffered, they have been delivered with the notification. */
 } sr_change_iter_t;
 
 static int connections_cnt = 0;               /**< Number of active connections to the Sysrepo Engine. */
@@ -625,6 +627,69 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+/**
+ * @brief Returns the versions of the data files of the module in the version table shared by the processes,
+ * maps the table if needed.
+ */
+static int
+cl_module_versions_get(sr_conn_ctx_t *conn_ctx, const char *module_name, dm_module_versions_t **versions)
+{
+    int rc = SR_ERR_OK;
+
+    if (!conn_ctx->library_mode) {
+        SR_LOG_ERR_MSG("Changes of the modules can be waited for only in library mode.");
+        return SR_ERR_UNSUPPORTED;
+    }
+
+    pthread_mutex_lock(&conn_ctx->lock);
+    if (NULL == conn_ctx->version_table) {
+        rc = dm_version_table_open(SR_DATA_SEARCH_DIR, &conn_ctx->version_table);
+    }
+    if (SR_ERR_OK == rc) {
+        *versions = dm_version_table_get(conn_ctx->version_table, module_name);
+        if (NULL == *versions) {
+            SR_LOG_ERR("Changes of the module '%s' can not be tracked.", module_name);
+            rc = SR_ERR_UNSUPPORTED;
+        }
+    }
+    pthread_mutex_unlock(&conn_ctx->lock);
+
+    return rc;
+}
+
+int
+sr_module_change_seq(sr_conn_ctx_t *conn_ctx, const char *module_name, uint32_t *change_seq)
+{
+    dm_module_versions_t *versions = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(conn_ctx, module_name, change_seq);
+
+    rc = cl_module_versions_get(conn_ctx, module_name, &versions);
+    if (SR_ERR_OK == rc) {
+        *change_seq = dm_version_change_seq(versions);
+    }
+
+    return rc;
+}
+
+int
+sr_module_change_wait(sr_conn_ctx_t *conn_ctx, const char *module_name, uint32_t change_seq, uint32_t timeout_ms)
+{
+    dm_module_versions_t *versions = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(conn_ctx, module_name);
+
+    rc = cl_module_versions_get(conn_ctx, module_name, &versions);
+    if (SR_ERR_OK == rc) {
+        /* the table stays mapped until the connection is closed */
+        rc = dm_version_wait(versions, change_seq, timeout_ms);
+    }
+
+    return rc;
+}
+
 int
 sr_session_check(sr_session_ctx_t *session)
 {
@@ -2000,6 +2065,150 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+/**
+ * @brief Converts sysrepo edit operation type to GPB.
+ */
+static Sr__EditOperation__EditOperationType
+cl_edit_op_type_sr_to_gpb(sr_edit_op_type_t type)
+{
+    switch (type) {
+        case SR_EDIT_OP_SET:
+            return SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__SET;
+        case SR_EDIT_OP_SET_STR:
+            return SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__SET_STR;
+        case SR_EDIT_OP_DELETE:
+            return SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__DELETE;
+        case SR_EDIT_OP_MOVE:
+            /* fall through */
+        default:
+            return SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__MOVE;
+    }
+}
+
+int
+sr_edit_batch(sr_session_ctx_t *session, const sr_edit_op_t *ops, size_t op_cnt, bool continue_on_error,
+        int *results)
+{
+    Sr__Msg *msg_req = NULL, *msg_resp = NULL;
+    Sr__EditBatchReq *batch_req = NULL;
+    Sr__EditBatchResp *batch_resp = NULL;
+    Sr__EditOperation *op = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    sr_val_t value = { 0, };
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(session, session->conn_ctx);
+
+    cl_session_clear_errors(session);
+
+    if (0 == op_cnt) {
+        /* nothing to apply */
+        return SR_ERR_OK;
+    }
+    CHECK_NULL_ARG(ops);
+
+    /* prepare edit_batch message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__EDIT_BATCH, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    batch_req = msg_req->request->edit_batch_req;
+    batch_req->continue_on_error = continue_on_error;
+
+    if (op_cnt > 0) {
+        batch_req->operations = sr_calloc(sr_mem, op_cnt, sizeof(*batch_req->operations));
+        CHECK_NULL_NOMEM_GOTO(batch_req->operations, rc, cleanup);
+    }
+
+    /* fill in the operations */
+    for (size_t i = 0; i < op_cnt; i++) {
+        CHECK_NULL_ARG_NORET(rc, ops[i].xpath);
+        if (SR_ERR_OK != rc) {
+            goto cleanup;
+        }
+        op = sr_calloc(sr_mem, 1, sizeof(*op));
+        CHECK_NULL_NOMEM_GOTO(op, rc, cleanup);
+        sr__edit_operation__init(op);
+        batch_req->operations[batch_req->n_operations++] = op;
+
+        op->type = cl_edit_op_type_sr_to_gpb(ops[i].type);
+        sr_mem_edit_string(sr_mem, &op->xpath, ops[i].xpath);
+        CHECK_NULL_NOMEM_GOTO(op->xpath, rc, cleanup);
+
+        switch (ops[i].type) {
+            case SR_EDIT_OP_SET:
+                if (NULL != ops[i].value) {
+                    /* duplicate the value into the memory context of the message */
+                    value = *ops[i].value;
+                    value._sr_mem = sr_mem;
+                    rc = sr_dup_val_t_to_gpb(&value, &op->value);
+                    CHECK_RC_MSG_GOTO(rc, cleanup, "value duplication failed.");
+                }
+                op->has_options = true;
+                op->options = ops[i].options;
+                break;
+            case SR_EDIT_OP_SET_STR:
+                if (NULL != ops[i].str_value) {
+                    sr_mem_edit_string(sr_mem, &op->str_value, ops[i].str_value);
+                    CHECK_NULL_NOMEM_GOTO(op->str_value, rc, cleanup);
+                }
+                op->has_options = true;
+                op->options = ops[i].options;
+                break;
+            case SR_EDIT_OP_DELETE:
+                op->has_options = true;
+                op->options = ops[i].options;
+                break;
+            case SR_EDIT_OP_MOVE:
+                op->has_position = true;
+                op->position = sr_move_position_sr_to_gpb(ops[i].position);
+                if (NULL != ops[i].relative_item) {
+                    sr_mem_edit_string(sr_mem, &op->relative_item, ops[i].relative_item);
+                    CHECK_NULL_NOMEM_GOTO(op->relative_item, rc, cleanup);
+                }
+                break;
+            default:
+                SR_LOG_ERR("Invalid type of edit operation %zu.", i);
+                rc = SR_ERR_INVAL_ARG;
+                goto cleanup;
+        }
+    }
+
+    /* send the request and receive the response */
+    rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__EDIT_BATCH);
+    if (SR_ERR_OK != rc && (NULL == msg_resp || NULL == msg_resp->response ||
+            NULL == msg_resp->response->edit_batch_resp)) {
+        SR_LOG_ERR_MSG("Error by processing of edit_batch request.");
+        goto cleanup;
+    }
+
+    batch_resp = msg_resp->response->edit_batch_resp;
+
+    if (NULL != results) {
+        for (size_t i = 0; i < op_cnt; i++) {
+            results[i] = (i < batch_resp->n_results) ? batch_resp->results[i] : SR_ERR_OPERATION_FAILED;
+        }
+    }
+
+    /* store errors of all failed operations within the session */
+    if (SR_ERR_OK != rc && batch_resp->n_errors > 0) {
+        SR_LOG_ERR("Edit batch failed with %zu error(s).", batch_resp->n_errors);
+        cl_session_set_errors(session, batch_resp->errors, batch_resp->n_errors);
+    }
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    if (NULL != msg_resp) {
+        sr_msg_free(msg_resp);
+    }
+    return cl_session_return(session, rc);
+}
+
 int
 sr_validate(sr_session_ctx_t *session)
 {
@@ -2194,19 +2403,269 @@ cleanup:
 }
 
 int
-sr_lock_datastore(sr_session_ctx_t *session)
+sr_set_item_async(sr_session_ctx_t *session, const char *xpath, const sr_val_t *value, const sr_edit_options_t opts,
+        sr_async_cb callback, void *private_ctx, uint32_t *token)
 {
-    return sr_lock_module(session, NULL);
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    sr_mem_snapshot_t snapshot = { 0, };
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, token);
+
+    cl_session_clear_errors(session);
+
+    /* prepare set_item message */
+    if (NULL != value) {
+        sr_mem = value->_sr_mem;
+        sr_mem_snapshot(sr_mem, &snapshot);
+    } else {
+        rc = sr_mem_new(0, &sr_mem);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    }
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__SET_ITEM, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path and options */
+    sr_mem_edit_string(sr_mem, &msg_req->request->set_item_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->set_item_req->xpath, rc, cleanup);
+
+    msg_req->request->set_item_req->options = opts;
+
+    /* duplicate the content of sr_val_t to gpb */
+    if (NULL != value) {
+        rc = sr_dup_val_t_to_gpb(value, &msg_req->request->set_item_req->value);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "value duplication failed.");
+    }
+
+    /* send the request */
+    rc = cl_request_send_async(session, msg_req, callback, private_ctx, token);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+cleanup:
+    if (NULL != sr_mem) {
+        if (NULL != value) {
+            sr_mem_restore(&snapshot);
+        } else {
+            if (NULL != msg_req) {
+                sr_msg_free(msg_req);
+            } else {
+                sr_mem_free(sr_mem);
+            }
+        }
+    } else {
+        sr_msg_free(msg_req);
+    }
+    return cl_session_return(session, rc);
 }
 
 int
-sr_unlock_datastore(sr_session_ctx_t *session)
+sr_set_item_str_async(sr_session_ctx_t *session, const char *xpath, const char *value, const sr_edit_options_t opts,
+        sr_async_cb callback, void *private_ctx, uint32_t *token)
 {
-    return sr_unlock_module(session, NULL);
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, token);
+
+    cl_session_clear_errors(session);
+
+    /* prepare set_item_str message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__SET_ITEM_STR, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path and options */
+    sr_mem_edit_string(sr_mem, &msg_req->request->set_item_str_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->set_item_str_req->xpath, rc, cleanup);
+
+    msg_req->request->set_item_str_req->options = opts;
+
+    /* duplicate the value to gpb */
+    if (NULL != value) {
+        sr_mem_edit_string(sr_mem, &msg_req->request->set_item_str_req->value, value);
+        CHECK_NULL_NOMEM_GOTO(msg_req->request->set_item_str_req->value, rc, cleanup);
+    }
+
+    /* send the request */
+    rc = cl_request_send_async(session, msg_req, callback, private_ctx, token);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    return cl_session_return(session, rc);
 }
 
 int
-sr_lock_module(sr_session_ctx_t *session, const char *module_name)
+sr_delete_item_async(sr_session_ctx_t *session, const char *xpath, const sr_edit_options_t opts,
+        sr_async_cb callback, void *private_ctx, uint32_t *token)
+{
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, token);
+
+    cl_session_clear_errors(session);
+
+    /* prepare delete_item message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__DELETE_ITEM, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path and options */
+    sr_mem_edit_string(sr_mem, &msg_req->request->delete_item_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->delete_item_req->xpath, rc, cleanup);
+
+    msg_req->request->delete_item_req->options = opts;
+
+    /* send the request */
+    rc = cl_request_send_async(session, msg_req, callback, private_ctx, token);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    return cl_session_return(session, rc);
+}
+
+int
+sr_get_item_async(sr_session_ctx_t *session, const char *xpath, sr_async_cb callback, void *private_ctx,
+        uint32_t *token)
+{
+    Sr__Msg *msg_req = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(session, session->conn_ctx, xpath, token);
+
+    cl_session_clear_errors(session);
+
+    /* prepare get_item message */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_req_alloc(sr_mem, SR__OPERATION__GET_ITEM, session->id, &msg_req);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot allocate GPB message.");
+
+    /* fill in the path */
+    sr_mem_edit_string(sr_mem, &msg_req->request->get_item_req->xpath, xpath);
+    CHECK_NULL_NOMEM_GOTO(msg_req->request->get_item_req->xpath, rc, cleanup);
+
+    /* send the request */
+    rc = cl_request_send_async(session, msg_req, callback, private_ctx, token);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Error by sending of the request.");
+
+cleanup:
+    if (NULL != msg_req) {
+        sr_msg_free(msg_req);
+    } else {
+        sr_mem_free(sr_mem);
+    }
+    return cl_session_return(session, rc);
+}
+
+/**
+ * @brief Returns the result of a completed asynchronous request, and the retrieved value
+ * in case of a get-item request.
+ */
+static int
+cl_async_req_complete(sr_session_ctx_t *session, cl_async_req_t *async_req, sr_val_t **value)
+{
+    int rc = SR_ERR_OK;
+
+    rc = cl_async_req_result(session, async_req);
+    if (SR_ERR_OK == rc && SR__OPERATION__GET_ITEM == async_req->operation && NULL != value) {
+        /* duplicate the content of gpb to sr_val_t */
+        rc = sr_dup_gpb_to_val_t((sr_mem_ctx_t *)async_req->msg_resp->_sysrepo_mem_ctx,
+                async_req->msg_resp->response->get_item_resp->value, value);
+        CHECK_RC_MSG_RETURN(rc, "Value duplication failed.");
+    }
+
+    return rc;
+}
+
+int
+sr_async_wait(sr_session_ctx_t *session, uint32_t token, sr_val_t **value)
+{
+    cl_async_req_t *async_req = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(session, session->conn_ctx);
+
+    cl_session_clear_errors(session);
+
+    rc = cl_async_wait(session, token, &async_req);
+    if (SR_ERR_OK == rc) {
+        rc = cl_async_req_complete(session, async_req, value);
+        cl_async_req_free(async_req);
+    }
+
+    return cl_session_return(session, rc);
+}
+
+int
+sr_async_process(sr_session_ctx_t *session, bool wait_all, size_t *completed_cnt)
+{
+    cl_async_req_t *completed = NULL, *async_req = NULL;
+    sr_val_t *value = NULL;
+    size_t cnt = 0;
+    int rc = SR_ERR_OK, rc_req = SR_ERR_OK;
+
+    CHECK_NULL_ARG2(session, session->conn_ctx);
+
+    cl_session_clear_errors(session);
+
+    rc = cl_async_process(session, wait_all, &completed);
+
+    /* deliver the completions (without any lock held, callbacks may issue new requests) */
+    while (NULL != completed) {
+        async_req = completed;
+        completed = completed->next;
+        value = NULL;
+        rc_req = cl_async_req_complete(session, async_req, (NULL != async_req->callback) ? &value : NULL);
+        if (SR_ERR_OK == rc && SR_ERR_OK != rc_req) {
+            rc = rc_req;
+        }
+        if (NULL != async_req->callback) {
+            async_req->callback(session, async_req->token, rc_req, value, async_req->private_ctx);
+        }
+        cl_async_req_free(async_req);
+        ++cnt;
+    }
+
+    if (NULL != completed_cnt) {
+        *completed_cnt = cnt;
+    }
+
+    return cl_session_return(session, rc);
+}
+
+int
+sr_async_get_fd(sr_session_ctx_t *session, int *fd)
+{
+    CHECK_NULL_ARG3(session, session->conn_ctx, fd);
+
+    *fd = session->conn_ctx->fd;
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Locks the datastore, a module or its subtree (if xpath is set).
+ */
+static int
+cl_lock_internal(sr_session_ctx_t *session, const char *module_name, const char *xpath)
 {
     Sr__Msg *msg_req = NULL, *msg_resp = NULL;
     sr_mem_ctx_t *sr_mem = NULL;
@@ -2227,6 +2686,10 @@ sr_lock_module(sr_session_ctx_t *session, const char *module_name)
         sr_mem_edit_string(sr_mem, &msg_req->request->lock_req->module_name, module_name);
         CHECK_NULL_NOMEM_GOTO(msg_req->request->lock_req->module_name, rc, cleanup);
     }
+    if (NULL != xpath) {
+        sr_mem_edit_string(sr_mem, &msg_req->request->lock_req->xpath, xpath);
+        CHECK_NULL_NOMEM_GOTO(msg_req->request->lock_req->xpath, rc, cleanup);
+    }
 
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__LOCK);
@@ -2249,8 +2712,11 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
-int
-sr_unlock_module(sr_session_ctx_t *session, const char *module_name)
+/**
+ * @brief Unlocks the datastore, a module or its subtree (if xpath is set).
+ */
+static int
+cl_unlock_internal(sr_session_ctx_t *session, const char *module_name, const char *xpath)
 {
     Sr__Msg *msg_req = NULL, *msg_resp = NULL;
     sr_mem_ctx_t *sr_mem = NULL;
@@ -2271,6 +2737,10 @@ sr_unlock_module(sr_session_ctx_t *session, const char *module_name)
         sr_mem_edit_string(sr_mem, &msg_req->request->unlock_req->module_name, module_name);
         CHECK_NULL_NOMEM_GOTO(msg_req->request->unlock_req->module_name, rc, cleanup);
     }
+    if (NULL != xpath) {
+        sr_mem_edit_string(sr_mem, &msg_req->request->unlock_req->xpath, xpath);
+        CHECK_NULL_NOMEM_GOTO(msg_req->request->unlock_req->xpath, rc, cleanup);
+    }
 
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__UNLOCK);
@@ -2293,6 +2763,44 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+int
+sr_lock_datastore(sr_session_ctx_t *session)
+{
+    return cl_lock_internal(session, NULL, NULL);
+}
+
+int
+sr_unlock_datastore(sr_session_ctx_t *session)
+{
+    return cl_unlock_internal(session, NULL, NULL);
+}
+
+int
+sr_lock_module(sr_session_ctx_t *session, const char *module_name)
+{
+    return cl_lock_internal(session, module_name, NULL);
+}
+
+int
+sr_unlock_module(sr_session_ctx_t *session, const char *module_name)
+{
+    return cl_unlock_internal(session, module_name, NULL);
+}
+
+int
+sr_lock_subtree(sr_session_ctx_t *session, const char *xpath)
+{
+    CHECK_NULL_ARG(xpath);
+    return cl_lock_internal(session, NULL, xpath);
+}
+
+int
+sr_unlock_subtree(sr_session_ctx_t *session, const char *xpath)
+{
+    CHECK_NULL_ARG(xpath);
+    return cl_unlock_internal(session, NULL, xpath);
+}
+
 int
 sr_get_last_error(sr_session_ctx_t *session, const sr_error_info_t **error_info)
 {
@@ -2538,6 +3046,8 @@ sr_module_change_subscribe(sr_session_ctx_t *session, const char *module_name, s
     msg_req->request->subscribe_req->enable_running = !(opts & SR_SUBSCR_PASSIVE);
     msg_req->request->subscribe_req->has_enable_event = true;
     msg_req->request->subscribe_req->enable_event = (opts & SR_SUBSCR_EV_ENABLED);
+    msg_req->request->subscribe_req->has_inline_changes = true;
+    msg_req->request->subscribe_req->inline_changes = (opts & SR_SUBSCR_INLINE_CHANGES);
 
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__SUBSCRIBE);
@@ -2611,6 +3121,8 @@ sr_subtree_change_subscribe(sr_session_ctx_t *session, const char *xpath, sr_sub
     msg_req->request->subscribe_req->enable_running = !(opts & SR_SUBSCR_PASSIVE);
     msg_req->request->subscribe_req->has_enable_event = true;
     msg_req->request->subscribe_req->enable_event = (opts & SR_SUBSCR_EV_ENABLED);
+    msg_req->request->subscribe_req->has_inline_changes = true;
+    msg_req->request->subscribe_req->inline_changes = (opts & SR_SUBSCR_INLINE_CHANGES);
 
     /* send the request and receive the response */
     rc = cl_request_process(session, msg_req, &msg_resp, NULL, SR__OPERATION__SUBSCRIBE);
@@ -2639,6 +3151,175 @@ cleanup:
     return cl_session_return(session, rc);
 }
 
+/**
+ * @brief Parses the next node of the xpath, skips its predicates. Returns the rest of the xpath,
+ * NULL if the xpath can not be parsed.
+ */
+static const char *
+cl_xpath_next_node(const char *xpath, const char **module, size_t *module_len, const char **name, size_t *name_len)
+{
+    const char *id = NULL, *colon = NULL;
+    char quote = 0;
+
+    if ('/' != xpath[0] || '/' == xpath[1]) {
+        return NULL;
+    }
+    id = ++xpath;
+    while ('\0' != *xpath && '/' != *xpath && '[' != *xpath) {
+        xpath++;
+    }
+    colon = memchr(id, ':', xpath - id);
+    if (NULL != colon) {
+        *module = id;
+        *module_len = colon - id;
+        id = colon + 1;
+    } else {
+        *module = NULL;
+        *module_len = 0;
+    }
+    *name = id;
+    *name_len = xpath - id;
+    if (0 == *name_len) {
+        return NULL;
+    }
+
+    while ('[' == *xpath) {
+        for (xpath++; '\0' != *xpath && (quote || ']' != *xpath); xpath++) {
+            if (quote) {
+                quote = (*xpath == quote) ? 0 : quote;
+            } else if ('\'' == *xpath || '"' == *xpath) {
+                quote = *xpath;
+            }
+        }
+        if ('\0' == *xpath) {
+            return NULL;
+        }
+        xpath++;
+    }
+    return xpath;
+}
+
+/**
+ * @brief Tests whether the changed node identified by the xpath lies in the selection. As the datastore
+ * compares the schema nodes, the predicates are not taken into account. Returns SR_ERR_UNSUPPORTED
+ * if the selection can not be evaluated locally.
+ */
+static int
+cl_change_in_selection(const char *selection, const char *xpath, bool *match)
+{
+    const char *sel_module = NULL, *module = NULL, *node_module = NULL, *sel_name = NULL, *name = NULL;
+    size_t sel_module_len = 0, module_len = 0, node_module_len = 0, sel_name_len = 0, name_len = 0;
+
+    *match = false;
+    while ('\0' != *selection) {
+        selection = cl_xpath_next_node(selection, &node_module, &node_module_len, &sel_name, &sel_name_len);
+        if (NULL == selection) {
+            return SR_ERR_UNSUPPORTED;
+        }
+        if (NULL != node_module) {
+            sel_module = node_module;
+            sel_module_len = node_module_len;
+        }
+        if (NULL == sel_module || ('*' == sel_name[0] && ('\0' != *selection || 1 != sel_name_len))) {
+            return SR_ERR_UNSUPPORTED;
+        }
+        if ('\0' == *xpath) {
+            /* the selection is deeper than the changed node */
+            return SR_ERR_OK;
+        }
+        xpath = cl_xpath_next_node(xpath, &node_module, &node_module_len, &name, &name_len);
+        if (NULL == xpath) {
+            return SR_ERR_UNSUPPORTED;
+        }
+        if (NULL != node_module) {
+            module = node_module;
+            module_len = node_module_len;
+        }
+        if (NULL == module || module_len != sel_module_len || 0 != strncmp(module, sel_module, module_len)) {
+            return SR_ERR_OK;
+        }
+        if ('*' == sel_name[0]) {
+            /* all the changes of the module */
+            break;
+        }
+        if (name_len != sel_name_len || 0 != strncmp(name, sel_name, name_len)) {
+            return SR_ERR_OK;
+        }
+    }
+
+    *match = true;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Creates the changes iterator from the changes delivered with the notification being processed.
+ * Returns SR_ERR_UNSUPPORTED if the changes have to be requested from the datastore.
+ */
+static int
+cl_get_changes_iter_local(sr_session_ctx_t *session, const char *xpath, sr_change_iter_t **iter)
+{
+    Sr__ChangeSet *changes = session->inline_changes;
+    Sr__Value *value = NULL;
+    sr_change_iter_t *it = NULL;
+    bool match = false;
+    int rc = SR_ERR_OK;
+
+    it = calloc(1, sizeof(*it));
+    CHECK_NULL_NOMEM_RETURN(it);
+    it->local = true;
+
+    it->xpath = strdup(xpath);
+    CHECK_NULL_NOMEM_GOTO(it->xpath, rc, cleanup);
+
+    if (changes->n_changes > 0) {
+        it->operations = calloc(changes->n_changes, sizeof(*it->operations));
+        CHECK_NULL_NOMEM_GOTO(it->operations, rc, cleanup);
+
+        it->old_values = calloc(changes->n_changes, sizeof(*it->old_values));
+        CHECK_NULL_NOMEM_GOTO(it->old_values, rc, cleanup);
+
+        it->new_values = calloc(changes->n_changes, sizeof(*it->new_values));
+        CHECK_NULL_NOMEM_GOTO(it->new_values, rc, cleanup);
+    }
+
+    for (size_t i = 0; i < changes->n_changes; i++) {
+        value = (NULL != changes->changes[i]->new_value) ? changes->changes[i]->new_value : changes->changes[i]->old_value;
+        if (NULL == value || NULL == value->xpath) {
+            continue;
+        }
+        rc = cl_change_in_selection(xpath, value->xpath, &match);
+        if (SR_ERR_OK != rc || !match) {
+            if (SR_ERR_UNSUPPORTED == rc) {
+                SR_LOG_DBG("Changes of '%s' can not be selected locally.", xpath);
+                goto cleanup;
+            }
+            continue;
+        }
+        if (NULL != changes->changes[i]->new_value) {
+            rc = sr_dup_gpb_to_val_t(NULL, changes->changes[i]->new_value, &it->new_values[it->count]);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Copying from gpb to sr_val_t failed");
+        }
+        if (NULL != changes->changes[i]->old_value) {
+            rc = sr_dup_gpb_to_val_t(NULL, changes->changes[i]->old_value, &it->old_values[it->count]);
+            if (SR_ERR_OK != rc) {
+                sr_free_val(it->new_values[it->count]);
+                SR_LOG_ERR_MSG("Copying from gpb to sr_val_t failed");
+                goto cleanup;
+            }
+        }
+        it->operations[it->count] = sr_change_op_gpb_to_sr(changes->changes[i]->changeoperation);
+        it->count++;
+    }
+    it->offset = it->count;
+
+    *iter = it;
+    return SR_ERR_OK;
+
+cleanup:
+    sr_free_change_iter(it);
+    return rc;
+}
+
 int
 sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_iter_t **iter)
 {
@@ -2650,6 +3331,13 @@ sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath, sr_change_iter
 
     cl_session_clear_errors(session);
 
+    if (NULL != session->inline_changes) {
+        rc = cl_get_changes_iter_local(session, xpath, iter);
+        if (SR_ERR_UNSUPPORTED != rc) {
+            return cl_session_return(session, rc);
+        }
+    }
+
     rc = cl_send_get_changes(session, xpath, 0, SR_GET_ITEMS_FETCH_LIMIT, &msg_resp);
     if (SR_ERR_NOT_FOUND == rc) {
         SR_LOG_DBG("No items found for xpath '%s'", xpath);
@@ -2731,6 +3419,11 @@ sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter, sr_change_
         *old_value = iter->old_values[iter->index];
         *new_value = iter->new_values[iter->index];
         iter->index++;
+    } else if (iter->local) {
+        /* All the changes have been read */
+        *new_value = NULL;
+        *old_value = NULL;
+        return SR_ERR_NOT_FOUND;
     } else {
         /* Fetch more items */
         rc = cl_send_get_changes(session, iter->xpath, iter->offset,
@@ -600,3 +600,17 @@ sm_session_get_index(const sm_ctx_t *sm_ctx, uint32_t index, sm_session_t **sess
 
     return SR_ERR_OK;
 }
+
+int
+sm_connection_get_dst_index(const sm_ctx_t *sm_ctx, uint32_t index, sm_connection_t **connection)
+{
+    CHECK_NULL_ARG2(sm_ctx, connection);
+
+    *connection = sr_btree_get_at(sm_ctx->connection_dst_btree, index);
+
+    if (NULL == *connection) {
+        return SR_ERR_NOT_FOUND;
+    }
+
+    return SR_ERR_OK;
+}
@@ -262,6 +262,22 @@ int sm_connection_find_dst(const sm_ctx_t *sm_ctx, const char *dst_address, sm_c
  */
 int sm_session_get_index(const sm_ctx_t *sm_ctx, uint32_t index, sm_session_t **session);
 
+/**
+ * @brief Returns connection with assigned destination address at given index (position)
+ * in a list (starting from index 0, in increments of 1).
+ *
+ * It can be used to iterate over all subscriber connections, by incrementing the index
+ * starting from 0 until SR_ERR_NOT_FOUND is returned.
+ *
+ * @param[in] sm_ctx Session Manager context.
+ * @param[in] index Index of the connection in the list, starting from 0.
+ * @param[out] connection Connection context stored at provided index in the list.
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_NOT_FOUND if the connection
+ * on provided index does not exist).
+ */
+int sm_connection_get_dst_index(const sm_ctx_t *sm_ctx, uint32_t index, sm_connection_t **connection);
+
 /**@} sm */
 
 #endif /* CM_SESSION_MANAGER_H_ */
@@ -23,8 +23,15 @@
 #include "sr_data_structs.h"
 #include <fcntl.h>
 #include <unistd.h>
+#include <errno.h>
+#include <limits.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <sys/stat.h>
+#ifdef HAVE_LINUX_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 
 #ifdef USE_AVL_LIB
@@ -34,6 +41,7 @@
 #endif
 
 #define SR_LIST_INIT_SIZE 4  /**< Initial size of the sysrepo list (in number of elements). */
+#define SR_CACHE_LINE_SIZE 64  /**< Expected size of a CPU cache line, used to avoid false sharing. */
 
 int
 sr_llist_init(sr_llist_t **llist_p)
@@ -561,6 +569,276 @@ sr_cbuff_items_in_queue(sr_cbuff_t *buffer)
     }
 }
 
+/**
+ * @brief Header of a cell of the lock-free queue (element data follow the header).
+ */
+typedef struct sr_mpmc_cell_s {
+    atomic_size_t sequence;  /**< Sequence number used to synchronize producers and consumers on the cell. */
+} sr_mpmc_cell_t;
+
+/**
+ * @brief Bounded lock-free multi-producer / multi-consumer FIFO queue context.
+ *
+ * Each cell carries a sequence number telling whether it is ready to be written
+ * by the producer claiming position `pos` (sequence == pos) or read by the consumer
+ * claiming position `pos` (sequence == pos + 1). Producers and consumers claim
+ * positions by CAS on enqueue_pos / dequeue_pos, which are kept on separate cache lines.
+ */
+typedef struct sr_mpmc_queue_s {
+    uint8_t *cells;                /**< Array of cells. */
+    size_t cell_size;              /**< Size of one cell (header + element data, aligned). */
+    size_t elem_size;              /**< Size of one element. */
+    size_t mask;                   /**< Capacity - 1 (capacity is a power of two). */
+    uint8_t pad1[SR_CACHE_LINE_SIZE];
+    atomic_size_t enqueue_pos;     /**< Next position to be claimed by a producer. */
+    uint8_t pad2[SR_CACHE_LINE_SIZE];
+    atomic_size_t dequeue_pos;     /**< Next position to be claimed by a consumer. */
+    uint8_t pad3[SR_CACHE_LINE_SIZE];
+    atomic_uint event;             /**< Event counter (futex word) incremented by each notification. */
+    atomic_uint waiters;           /**< Number of threads waiting for a notification. */
+#ifndef HAVE_LINUX_FUTEX
+    pthread_mutex_t wait_mutex;    /**< Mutex used for waiting if futex is not available. */
+    pthread_cond_t wait_cv;        /**< Condition variable used for waiting if futex is not available. */
+#endif
+} sr_mpmc_queue_t;
+
+/**
+ * @brief Returns the cell of the lock-free queue at given position.
+ */
+static inline sr_mpmc_cell_t *
+sr_mpmc_queue_cell(sr_mpmc_queue_t *queue, size_t pos)
+{
+    return (sr_mpmc_cell_t *)(queue->cells + ((pos & queue->mask) * queue->cell_size));
+}
+
+int
+sr_mpmc_queue_init(const size_t capacity, const size_t elem_size, sr_mpmc_queue_t **queue_p)
+{
+    sr_mpmc_queue_t *queue = NULL;
+    size_t real_capacity = 1;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(queue_p);
+
+    if (0 == capacity || 0 == elem_size) {
+        SR_LOG_ERR_MSG("Lock-free queue capacity and element size must be non-zero.");
+        return SR_ERR_INVAL_ARG;
+    }
+    while (real_capacity < capacity) {
+        real_capacity <<= 1;
+    }
+
+    SR_LOG_DBG("Initiating lock-free queue for %zu elements.", real_capacity);
+
+    queue = calloc(1, sizeof(*queue));
+    CHECK_NULL_NOMEM_RETURN(queue);
+
+    /* keep element data aligned the same way as malloc does */
+    queue->cell_size = sizeof(sr_mpmc_cell_t) + elem_size;
+    queue->cell_size = ((queue->cell_size + sizeof(max_align_t) - 1) / sizeof(max_align_t)) * sizeof(max_align_t);
+    queue->elem_size = elem_size;
+    queue->mask = real_capacity - 1;
+
+    queue->cells = calloc(real_capacity, queue->cell_size);
+    CHECK_NULL_NOMEM_GOTO(queue->cells, rc, cleanup);
+
+    for (size_t i = 0; i < real_capacity; i++) {
+        atomic_init(&sr_mpmc_queue_cell(queue, i)->sequence, i);
+    }
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    atomic_init(&queue->event, 0);
+    atomic_init(&queue->waiters, 0);
+#ifndef HAVE_LINUX_FUTEX
+    pthread_mutex_init(&queue->wait_mutex, NULL);
+    pthread_cond_init(&queue->wait_cv, NULL);
+#endif
+
+    *queue_p = queue;
+    return SR_ERR_OK;
+
+cleanup:
+    free(queue);
+    return rc;
+}
+
+void
+sr_mpmc_queue_cleanup(sr_mpmc_queue_t *queue)
+{
+    if (NULL != queue) {
+#ifndef HAVE_LINUX_FUTEX
+        pthread_mutex_destroy(&queue->wait_mutex);
+        pthread_cond_destroy(&queue->wait_cv);
+#endif
+        free(queue->cells);
+        free(queue);
+    }
+}
+
+int
+sr_mpmc_queue_enqueue(sr_mpmc_queue_t *queue, const void *item)
+{
+    sr_mpmc_cell_t *cell = NULL;
+    size_t pos = 0, seq = 0;
+    intptr_t diff = 0;
+
+    CHECK_NULL_ARG2(queue, item);
+
+    pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        cell = sr_mpmc_queue_cell(queue, pos);
+        seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)pos;
+        if (0 == diff) {
+            /* the cell is free, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                    memory_order_seq_cst, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* the cell has not been consumed yet - the queue is full */
+            return SR_ERR_OPERATION_FAILED;
+        } else {
+            /* another producer has claimed the cell, retry */
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy((uint8_t *)cell + sizeof(*cell), item, queue->elem_size);
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+
+    return SR_ERR_OK;
+}
+
+bool
+sr_mpmc_queue_dequeue(sr_mpmc_queue_t *queue, void *item)
+{
+    sr_mpmc_cell_t *cell = NULL;
+    size_t pos = 0, seq = 0;
+    intptr_t diff = 0;
+
+    if (NULL == queue || NULL == item) {
+        return false;
+    }
+
+    pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        cell = sr_mpmc_queue_cell(queue, pos);
+        seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (0 == diff) {
+            /* the cell has been written, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                    memory_order_seq_cst, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* the cell has not been written yet - the queue is empty */
+            return false;
+        } else {
+            /* another consumer has claimed the cell, retry */
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(item, (uint8_t *)cell + sizeof(*cell), queue->elem_size);
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+
+    return true;
+}
+
+size_t
+sr_mpmc_queue_items_in_queue(sr_mpmc_queue_t *queue)
+{
+    size_t enqueue_pos = 0, dequeue_pos = 0;
+
+    if (NULL == queue) {
+        return 0;
+    }
+
+    dequeue_pos = atomic_load(&queue->dequeue_pos);
+    enqueue_pos = atomic_load(&queue->enqueue_pos);
+
+    /* consumers may have moved forward since dequeue_pos was read */
+    return (enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0;
+}
+
+int
+sr_mpmc_queue_wait(sr_mpmc_queue_t *queue, uint32_t timeout_ms, atomic_size_t *pending_cnt)
+{
+    unsigned event = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(queue);
+
+    /* register as a waiter before checking the queue, so that no notification can be missed */
+    atomic_fetch_add(&queue->waiters, 1);
+    event = atomic_load(&queue->event);
+
+    if (0 == sr_mpmc_queue_items_in_queue(queue) && (NULL == pending_cnt || 0 == atomic_load(pending_cnt))) {
+#ifdef HAVE_LINUX_FUTEX
+        struct timespec ts = { 0 };
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+        if (-1 == syscall(SYS_futex, &queue->event, FUTEX_WAIT_PRIVATE, event, (0 != timeout_ms) ? &ts : NULL, NULL, 0) &&
+                ETIMEDOUT == errno) {
+            rc = SR_ERR_TIME_OUT;
+        }
+#else
+        struct timespec ts = { 0 };
+        int ret = 0;
+        sr_clock_get_time(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeout_ms / 1000;
+        ts.tv_nsec += (timeout_ms % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec += 1;
+            ts.tv_nsec -= 1000000000L;
+        }
+        pthread_mutex_lock(&queue->wait_mutex);
+        while (0 == ret && event == atomic_load(&queue->event)) {
+            if (0 != timeout_ms) {
+                ret = pthread_cond_timedwait(&queue->wait_cv, &queue->wait_mutex, &ts);
+            } else {
+                ret = pthread_cond_wait(&queue->wait_cv, &queue->wait_mutex);
+            }
+        }
+        pthread_mutex_unlock(&queue->wait_mutex);
+        if (ETIMEDOUT == ret) {
+            rc = SR_ERR_TIME_OUT;
+        }
+#endif
+    }
+
+    atomic_fetch_sub(&queue->waiters, 1);
+    return rc;
+}
+
+void
+sr_mpmc_queue_notify(sr_mpmc_queue_t *queue, bool all)
+{
+    if (NULL == queue) {
+        return;
+    }
+
+    atomic_fetch_add(&queue->event, 1);
+    if (0 == atomic_load(&queue->waiters)) {
+        /* nobody is waiting, save the system call */
+        return;
+    }
+
+#ifdef HAVE_LINUX_FUTEX
+    syscall(SYS_futex, &queue->event, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0);
+#else
+    pthread_mutex_lock(&queue->wait_mutex);
+    if (all) {
+        pthread_cond_broadcast(&queue->wait_cv);
+    } else {
+        pthread_cond_signal(&queue->wait_cv);
+    }
+    pthread_mutex_unlock(&queue->wait_mutex);
+#endif
+}
+
 /**
  * @brief Holds binary tree with filename -> fd maping. This structure
  * is used to check file locks inside of the process and to avoid
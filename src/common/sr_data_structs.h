@@ -27,12 +27,14 @@
  * @ingroup common
  * @{
  *
- * @brief Data structures used in sysrepo (list, linked-list, self-balanced binary tree, circular buffer).
+ * @brief Data structures used in sysrepo (list, linked-list, self-balanced binary tree, circular buffer,
+ * lock-free queue).
  */
 
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 
 /**
  * @brief Doubly linked list node structure.
@@ -337,6 +339,104 @@ bool sr_cbuff_search(sr_cbuff_t *buffer, void *item);
  */
 size_t sr_cbuff_items_in_queue(sr_cbuff_t *buffer);
 
+/**
+ * @brief Bounded lock-free multi-producer / multi-consumer FIFO queue context.
+ */
+typedef struct sr_mpmc_queue_s sr_mpmc_queue_t;
+
+/**
+ * @brief Initializes a bounded lock-free multi-producer / multi-consumer
+ * FIFO queue of elements with given size.
+ *
+ * Enqueue and dequeue operations never take a lock, so the queue can be used
+ * concurrently from any number of threads. Unlike ::sr_cbuff_t, the queue does
+ * not grow - its capacity is fixed at initialization time.
+ *
+ * @param[in] capacity Capacity of the queue in number of elements
+ * (rounded up to the nearest power of two).
+ * @param[in] elem_size Size of one element (in bytes).
+ * @param[out] queue Queue context, it is supposed to be freed by ::sr_mpmc_queue_cleanup.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_mpmc_queue_init(const size_t capacity, const size_t elem_size, sr_mpmc_queue_t **queue);
+
+/**
+ * @brief Cleans up the queue.
+ *
+ * All memory allocated within provided queue context will be freed.
+ * Must not be called while other threads still use the queue.
+ *
+ * @param[in] queue Queue context.
+ */
+void sr_mpmc_queue_cleanup(sr_mpmc_queue_t *queue);
+
+/**
+ * @brief Enqueues an element into the queue.
+ *
+ * @note O(1), lock-free, thread safe.
+ *
+ * @param[in] queue Queue context.
+ * @param[in] item The element to be enqueued (pointer to memory from where
+ * the data will be copied to the queue).
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_OPERATION_FAILED if the queue is full).
+ */
+int sr_mpmc_queue_enqueue(sr_mpmc_queue_t *queue, const void *item);
+
+/**
+ * @brief Dequeues an element from the queue.
+ *
+ * @note O(1), lock-free, thread safe.
+ *
+ * @param[in] queue Queue context.
+ * @param[out] item Pointer to memory where dequeued data will be copied.
+ *
+ * @return TRUE if an element was dequeued, FALSE if the queue is empty.
+ */
+bool sr_mpmc_queue_dequeue(sr_mpmc_queue_t *queue, void *item);
+
+/**
+ * @brief Returns number of elements currently stored in the queue.
+ *
+ * @note O(1), lock-free, thread safe. The value is only a snapshot
+ * if other threads are accessing the queue concurrently.
+ *
+ * @param[in] queue Queue context.
+ *
+ * @return Number of elements currently stored in the queue.
+ */
+size_t sr_mpmc_queue_items_in_queue(sr_mpmc_queue_t *queue);
+
+/**
+ * @brief Blocks the calling thread until ::sr_mpmc_queue_notify is called
+ * or the timeout expires. Returns immediately if the queue is not empty
+ * or if there are some pending items kept outside of the queue.
+ *
+ * Uses a futex where available, so that no lock is shared with the producers.
+ * Spurious wake-ups are possible, the caller is supposed to re-check the queue.
+ *
+ * @param[in] queue Queue context.
+ * @param[in] timeout_ms Timeout in milliseconds, 0 means no timeout.
+ * @param[in] pending_cnt (optional) Number of the items the caller keeps outside of the queue
+ * (e.g. in an overflow queue). It is checked together with the queue after the thread has been
+ * registered as a waiter, so an item added there by a producer that skips ::sr_mpmc_queue_notify
+ * is not missed.
+ *
+ * @return Error code (SR_ERR_OK on wake-up, SR_ERR_TIME_OUT if the timeout has expired).
+ */
+int sr_mpmc_queue_wait(sr_mpmc_queue_t *queue, uint32_t timeout_ms, atomic_size_t *pending_cnt);
+
+/**
+ * @brief Wakes up threads waiting in ::sr_mpmc_queue_wait.
+ *
+ * Does not issue any system call if there are no waiting threads.
+ *
+ * @param[in] queue Queue context.
+ * @param[in] all TRUE to wake up all waiting threads, FALSE to wake up only one of them.
+ */
+void sr_mpmc_queue_notify(sr_mpmc_queue_t *queue, bool all);
+
 /**
  * @brief Locking set context.
  */
@@ -591,6 +591,12 @@ sr_msg_free(Sr__Msg *msg)
 
     sr_mem_ctx_t *sr_mem = (sr_mem_ctx_t *)msg->_sysrepo_mem_ctx;
 
+    if (NULL != msg->request && NULL != msg->request->event_notif_req && msg->request->event_notif_req->has__shared_body) {
+        /* release the event notification data shared with other messages */
+        sr_gpb_shared_body_release((sr_gpb_shared_body_t *) (uintptr_t) msg->request->event_notif_req->_shared_body);
+        msg->request->event_notif_req->has__shared_body = false;
+    }
+
     if (sr_mem) {
         if (0 == --sr_mem->obj_count) {
             sr_mem_free(sr_mem);
@@ -67,6 +67,8 @@ sr_gpb_operation_name(Sr__Operation operation)
         return "delete-item";
     case SR__OPERATION__MOVE_ITEM:
         return "move-item";
+    case SR__OPERATION__EDIT_BATCH:
+        return "edit-batch";
     case SR__OPERATION__VALIDATE:
         return "validate";
     case SR__OPERATION__COMMIT:
@@ -270,6 +272,12 @@ sr_gpb_req_alloc(sr_mem_ctx_t *sr_mem, const Sr__Operation operation, const uint
             sr__move_item_req__init((Sr__MoveItemReq*)sub_msg);
             req->move_item_req = (Sr__MoveItemReq*)sub_msg;
             break;
+        case SR__OPERATION__EDIT_BATCH:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__EditBatchReq));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__edit_batch_req__init((Sr__EditBatchReq*)sub_msg);
+            req->edit_batch_req = (Sr__EditBatchReq*)sub_msg;
+            break;
         case SR__OPERATION__VALIDATE:
             sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__ValidateReq));
             CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
@@ -538,6 +546,12 @@ sr_gpb_resp_alloc(sr_mem_ctx_t *sr_mem, const Sr__Operation operation, const uin
             sr__move_item_resp__init((Sr__MoveItemResp*)sub_msg);
             resp->move_item_resp = (Sr__MoveItemResp*)sub_msg;
             break;
+        case SR__OPERATION__EDIT_BATCH:
+            sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__EditBatchResp));
+            CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
+            sr__edit_batch_resp__init((Sr__EditBatchResp*)sub_msg);
+            resp->edit_batch_resp = (Sr__EditBatchResp*)sub_msg;
+            break;
         case SR__OPERATION__VALIDATE:
             sub_msg = sr_calloc(sr_mem, 1, sizeof(Sr__ValidateResp));
             CHECK_NULL_NOMEM_GOTO(sub_msg, rc, error);
@@ -963,6 +977,9 @@ sr_gpb_msg_validate(const Sr__Msg *msg, const Sr__Msg__MsgType type, const Sr__O
             case SR__OPERATION__MOVE_ITEM:
                 CHECK_NULL_RETURN(msg->request->move_item_req, SR_ERR_MALFORMED_MSG);
                 break;
+            case SR__OPERATION__EDIT_BATCH:
+                CHECK_NULL_RETURN(msg->request->edit_batch_req, SR_ERR_MALFORMED_MSG);
+                break;
             case SR__OPERATION__VALIDATE:
                 CHECK_NULL_RETURN(msg->request->validate_req, SR_ERR_MALFORMED_MSG);
                 break;
@@ -1079,6 +1096,9 @@ sr_gpb_msg_validate(const Sr__Msg *msg, const Sr__Msg__MsgType type, const Sr__O
             case SR__OPERATION__MOVE_ITEM:
                 CHECK_NULL_RETURN(msg->response->move_item_resp, SR_ERR_MALFORMED_MSG);
                 break;
+            case SR__OPERATION__EDIT_BATCH:
+                CHECK_NULL_RETURN(msg->response->edit_batch_resp, SR_ERR_MALFORMED_MSG);
+                break;
             case SR__OPERATION__VALIDATE:
                 CHECK_NULL_RETURN(msg->response->validate_resp, SR_ERR_MALFORMED_MSG);
                 break;
@@ -2812,3 +2832,210 @@ sr_gpb_fill_errors(sr_error_info_t *sr_errors, size_t sr_error_cnt, sr_mem_ctx_t
 
     return SR_ERR_OK;
 }
+
+/**
+ * @brief Returns the size of the base 128 varint encoding of the value.
+ */
+static size_t
+sr_gpb_varint_size(uint64_t value)
+{
+    size_t size = 1;
+
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+/**
+ * @brief Encodes the value as base 128 varint into the buffer, returns the number of bytes written.
+ */
+static size_t
+sr_gpb_varint_pack(uint64_t value, uint8_t *buf)
+{
+    size_t size = 0;
+
+    while (value >= 0x80) {
+        buf[size++] = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+    buf[size++] = (uint8_t) value;
+    return size;
+}
+
+/**
+ * @brief Returns the key of the length-delimited (embedded message) field of the message.
+ */
+static uint64_t
+sr_gpb_msg_field_key(const ProtobufCMessageDescriptor *descriptor, const char *field_name)
+{
+    const ProtobufCFieldDescriptor *field = protobuf_c_message_descriptor_get_field_by_name(descriptor, field_name);
+
+    return ((uint64_t) field->id << 3) | PROTOBUF_C_WIRE_TYPE_LENGTH_PREFIXED;
+}
+
+/**
+ * @brief Returns the shared body attached to the message, NULL if there is none.
+ */
+static sr_gpb_shared_body_t *
+sr_gpb_msg_shared_body(const Sr__Msg *msg)
+{
+    if (NULL != msg->request && NULL != msg->request->event_notif_req && msg->request->event_notif_req->has__shared_body) {
+        return (sr_gpb_shared_body_t *) (uintptr_t) msg->request->event_notif_req->_shared_body;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sizes of the parts of a message with a shared body.
+ */
+typedef struct sr_gpb_shared_sizes_s {
+    size_t event_notif_req;     /**< Size of the event notification request (shared body and the own fields). */
+    size_t request;             /**< Size of the request including the event notification request. */
+    size_t msg;                 /**< Size of the whole message. */
+} sr_gpb_shared_sizes_t;
+
+/**
+ * @brief Computes the sizes of the parts of a message with a shared body. The embedded messages are detached
+ * from their parents for a while, so that the own fields of each level can be measured.
+ */
+static void
+sr_gpb_shared_msg_sizes(Sr__Msg *msg, const sr_gpb_shared_body_t *body, sr_gpb_shared_sizes_t *sizes)
+{
+    Sr__Request *request = msg->request;
+    Sr__EventNotifReq *event_notif_req = request->event_notif_req;
+
+    event_notif_req->has__shared_body = false;
+    sizes->event_notif_req = body->size + sr__event_notif_req__get_packed_size(event_notif_req);
+    event_notif_req->has__shared_body = true;
+
+    request->event_notif_req = NULL;
+    sizes->request = sr__request__get_packed_size(request) +
+            sr_gpb_varint_size(sr_gpb_msg_field_key(&sr__request__descriptor, "event_notif_req")) +
+            sr_gpb_varint_size(sizes->event_notif_req) + sizes->event_notif_req;
+    request->event_notif_req = event_notif_req;
+
+    msg->request = NULL;
+    sizes->msg = sr__msg__get_packed_size(msg) +
+            sr_gpb_varint_size(sr_gpb_msg_field_key(&sr__msg__descriptor, "request")) +
+            sr_gpb_varint_size(sizes->request) + sizes->request;
+    msg->request = request;
+}
+
+int
+sr_gpb_shared_body_pack(const Sr__EventNotifReq *event_notif_req, sr_gpb_shared_body_t **body_p)
+{
+    sr_gpb_shared_body_t *body = NULL;
+
+    CHECK_NULL_ARG2(event_notif_req, body_p);
+
+    body = calloc(1, sizeof *body);
+    CHECK_NULL_NOMEM_RETURN(body);
+
+    body->size = sr__event_notif_req__get_packed_size(event_notif_req);
+    body->data = malloc(body->size);
+    if (NULL == body->data) {
+        free(body);
+        SR_LOG_ERR_MSG("Unable to allocate memory for the shared event notification body.");
+        return SR_ERR_NOMEM;
+    }
+    sr__event_notif_req__pack(event_notif_req, body->data);
+    atomic_init(&body->ref_cnt, 1);
+
+    *body_p = body;
+    return SR_ERR_OK;
+}
+
+void
+sr_gpb_shared_body_attach(Sr__Msg *msg, sr_gpb_shared_body_t *body)
+{
+    if (NULL == msg || NULL == msg->request || NULL == msg->request->event_notif_req || NULL == body) {
+        return;
+    }
+
+    atomic_fetch_add(&body->ref_cnt, 1);
+    msg->request->event_notif_req->_shared_body = (uint64_t) (uintptr_t) body;
+    msg->request->event_notif_req->has__shared_body = true;
+}
+
+void
+sr_gpb_shared_body_release(sr_gpb_shared_body_t *body)
+{
+    if (NULL != body && 1 == atomic_fetch_sub(&body->ref_cnt, 1)) {
+        free(body->data);
+        free(body);
+    }
+}
+
+void
+sr_gpb_msg_internal_reset(Sr__Msg *msg)
+{
+    if (NULL != msg && NULL != msg->request && NULL != msg->request->event_notif_req) {
+        msg->request->event_notif_req->_shared_body = 0;
+        msg->request->event_notif_req->has__shared_body = false;
+    }
+}
+
+void
+sr_gpb_resp_set_req_id(const Sr__Msg *req, Sr__Msg *resp)
+{
+    if (NULL != req && NULL != req->request && NULL != resp && NULL != resp->response) {
+        resp->response->req_id = req->request->req_id;
+        resp->response->has_req_id = req->request->has_req_id;
+    }
+}
+
+size_t
+sr_gpb_msg_get_packed_size(Sr__Msg *msg)
+{
+    sr_gpb_shared_body_t *body = sr_gpb_msg_shared_body(msg);
+    sr_gpb_shared_sizes_t sizes = { 0, };
+
+    if (NULL == body) {
+        return sr__msg__get_packed_size(msg);
+    }
+    sr_gpb_shared_msg_sizes(msg, body, &sizes);
+    return sizes.msg;
+}
+
+size_t
+sr_gpb_msg_pack(Sr__Msg *msg, uint8_t *buf)
+{
+    sr_gpb_shared_body_t *body = sr_gpb_msg_shared_body(msg);
+    Sr__Request *request = NULL;
+    Sr__EventNotifReq *event_notif_req = NULL;
+    sr_gpb_shared_sizes_t sizes = { 0, };
+    uint8_t *p = buf;
+
+    if (NULL == body) {
+        return sr__msg__pack(msg, buf);
+    }
+    sr_gpb_shared_msg_sizes(msg, body, &sizes);
+    request = msg->request;
+    event_notif_req = request->event_notif_req;
+
+    /* own fields of the message followed by the request */
+    msg->request = NULL;
+    p += sr__msg__pack(msg, p);
+    msg->request = request;
+    p += sr_gpb_varint_pack(sr_gpb_msg_field_key(&sr__msg__descriptor, "request"), p);
+    p += sr_gpb_varint_pack(sizes.request, p);
+
+    /* own fields of the request followed by the event notification request */
+    request->event_notif_req = NULL;
+    p += sr__request__pack(request, p);
+    request->event_notif_req = event_notif_req;
+    p += sr_gpb_varint_pack(sr_gpb_msg_field_key(&sr__request__descriptor, "event_notif_req"), p);
+    p += sr_gpb_varint_pack(sizes.event_notif_req, p);
+
+    /* shared body followed by the own fields (subscriber details) of the event notification request,
+     * repeated scalar fields are overridden by the latter occurrence when unpacked */
+    memcpy(p, body->data, body->size);
+    p += body->size;
+    event_notif_req->has__shared_body = false;
+    p += sr__event_notif_req__pack(event_notif_req, p);
+    event_notif_req->has__shared_body = true;
+
+    return p - buf;
+}
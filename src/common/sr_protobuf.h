@@ -22,6 +22,8 @@
 #ifndef SR_PROTOBUF_H_
 #define SR_PROTOBUF_H_
 
+#include <stdatomic.h>
+
 #include "sysrepo.pb-c.h"
 #include "sr_common.h"
 
@@ -450,6 +452,80 @@ int sr_gpb_fill_error(const char *error_message, const char *error_path, sr_mem_
 int sr_gpb_fill_errors(sr_error_info_t *sr_errors, size_t sr_error_cnt, sr_mem_ctx_t *sr_mem, Sr__Error ***gpb_errors,
         size_t *gpb_error_cnt);
 
+/**
+ * @brief Event notification data packed once and shared by the messages delivering the notification
+ * to the individual subscribers. Each message holds a reference, released by ::sr_msg_free.
+ */
+typedef struct sr_gpb_shared_body_s {
+    uint8_t *data;          /**< Packed event notification request without the subscriber details. */
+    size_t size;            /**< Size of the packed data. */
+    atomic_uint ref_cnt;    /**< Number of the references. */
+} sr_gpb_shared_body_t;
+
+/**
+ * @brief Packs the event notification request (type, xpath, timestamp, values or trees) into a shared body.
+ *
+ * @param[in] event_notif_req Event notification request to be packed.
+ * @param[out] body Allocated shared body with one reference held by the caller.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int sr_gpb_shared_body_pack(const Sr__EventNotifReq *event_notif_req, sr_gpb_shared_body_t **body);
+
+/**
+ * @brief Attaches the shared body to the event notification request message, the message takes a new reference.
+ * The values and trees of the message are not packed anymore, the shared body is sent in their place.
+ *
+ * @param[in] msg Event notification request message.
+ * @param[in] body Shared body.
+ */
+void sr_gpb_shared_body_attach(Sr__Msg *msg, sr_gpb_shared_body_t *body);
+
+/**
+ * @brief Releases a reference to the shared body, frees it when the last one is released.
+ *
+ * @param[in] body Shared body, can be NULL.
+ */
+void sr_gpb_shared_body_release(sr_gpb_shared_body_t *body);
+
+/**
+ * @brief Clears the internal fields of a message unpacked from the data received from a peer. Their values
+ * are pointers valid only within the process that has created the message and must not be trusted.
+ * To be called right after each message is unpacked.
+ *
+ * @param[in] msg Unpacked message.
+ */
+void sr_gpb_msg_internal_reset(Sr__Msg *msg);
+
+/**
+ * @brief Copies the request identifier of the request into its response, so that
+ * the client can match the response with the request it belongs to.
+ *
+ * @param[in] req Request message.
+ * @param[in,out] resp Response message.
+ */
+void sr_gpb_resp_set_req_id(const Sr__Msg *req, Sr__Msg *resp);
+
+/**
+ * @brief Returns the packed size of the message, including the shared body if attached.
+ *
+ * @param[in] msg Message to be packed.
+ *
+ * @return Size of the packed message.
+ */
+size_t sr_gpb_msg_get_packed_size(Sr__Msg *msg);
+
+/**
+ * @brief Packs the message into the buffer. A shared body attached to the message is copied into the
+ * packed event notification request, followed by the fields of the message itself.
+ *
+ * @param[in] msg Message to be packed.
+ * @param[out] buf Buffer of at least ::sr_gpb_msg_get_packed_size bytes.
+ *
+ * @return Size of the packed message.
+ */
+size_t sr_gpb_msg_pack(Sr__Msg *msg, uint8_t *buf);
+
 /**@} gpb_wrappers */
 
 #endif /* SR_PROTOBUF_H_ */
@@ -22,6 +22,8 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <inttypes.h>
@@ -664,60 +666,143 @@ sr_lys_node_get_data_parent(struct lys_node *node, bool augment)
     return node;
 }
 
-struct lyd_node *
-sr_lyd_parse_fd(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options)
+/**
+ * @brief Recognizes the format of the data file based on its first character.
+ */
+static LYD_FORMAT
+sr_data_file_format_by_char(char c)
+{
+    switch (c) {
+    case '<':
+        return LYD_XML;
+    case '{':
+        return LYD_JSON;
+    case 'l':
+        return LYD_LYB;
+    default:
+        return LYD_UNKNOWN;
+    }
+}
+
+int
+sr_get_data_file_format(int fd, LYD_FORMAT *format)
 {
-    struct lyd_node *node;
-    ssize_t ret;
-    char c;
+    CHECK_NULL_ARG(format);
+    ssize_t ret = 0;
+    char c = 0;
 
-    node = lyd_parse_fd(ctx, fd, format, options);
-    if (!node) {
-        /* we will attempt to load the file in different format and then convert it based on the first character */
-        ret = read(fd, &c, 1);
-        if (ret < 1) {
-            return NULL;
-        } else {
-            lseek(fd, 0, SEEK_SET);
-        }
+    *format = LYD_UNKNOWN;
 
-        switch (c) {
-        case '<':
-            /* XML */
-            if (format == LYD_XML) {
-                return NULL;
-            }
+    ret = pread(fd, &c, 1, 0);
+    if (-1 == ret) {
+        SR_LOG_ERR("Reading of the data file failed: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+    if (1 == ret) {
+        *format = sr_data_file_format_by_char(c);
+    }
 
-            SR_LOG_WRN("Attempting data file conversion from \"xml\" to \"%s\".", SR_FILE_FORMAT_EXT);
-            node = lyd_parse_fd(ctx, fd, LYD_XML, options);
-            break;
-        case '{':
-            /* JSON */
-            if (format == LYD_JSON) {
-                return NULL;
-            }
+    return SR_ERR_OK;
+}
 
-            SR_LOG_WRN("Attempting data file conversion from \"json\" to \"%s\".", SR_FILE_FORMAT_EXT);
-            node = lyd_parse_fd(ctx, fd, LYD_JSON, options);
-            break;
-        case 'l':
-            /* LYB */
-            if (format == LYD_LYB) {
-                return NULL;
-            }
+int
+sr_mmap_file(int fd, void **addr, size_t *length)
+{
+    CHECK_NULL_ARG2(addr, length);
+    struct stat st = {0};
+    size_t pagesize = (size_t) sysconf(_SC_PAGESIZE);
+    void *map = MAP_FAILED;
 
-            SR_LOG_WRN("Attempting data file conversion from \"lyb\" to \"%s\".", SR_FILE_FORMAT_EXT);
-            node = lyd_parse_fd(ctx, fd, LYD_LYB, options);
-            break;
-        default:
-            return NULL;
+    *addr = NULL;
+    *length = 0;
+
+    if (-1 == fstat(fd, &st)) {
+        SR_LOG_ERR("Unable to stat the file: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+    if (0 == st.st_size) {
+        return SR_ERR_OK;
+    }
+
+    if (0 == st.st_size % pagesize) {
+        /* the content fills the pages completely, reserve one more zeroed page for the terminating NUL byte */
+        map = mmap(NULL, st.st_size + pagesize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED != map && MAP_FAILED == mmap(map, st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0)) {
+            munmap(map, st.st_size + pagesize);
+            map = MAP_FAILED;
         }
+    } else {
+        /* the rest of the last page is zeroed */
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (MAP_FAILED == map) {
+        SR_LOG_ERR("Unable to map the file: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
 
-        if (!node) {
-            return NULL;
+    *addr = map;
+    *length = st.st_size;
+    return SR_ERR_OK;
+}
+
+void
+sr_munmap_file(void *addr, size_t length)
+{
+    if (NULL != addr) {
+        /* includes the page reserved for the terminating NUL byte if there is one */
+        munmap(addr, length + 1);
+    }
+}
+
+struct lyd_node *
+sr_lyd_parse_fd_any(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options, LYD_FORMAT *file_format)
+{
+    struct lyd_node *node = NULL;
+    LYD_FORMAT detected = LYD_UNKNOWN;
+    void *data = NULL;
+    size_t length = 0;
+
+    if (NULL != file_format) {
+        *file_format = format;
+    }
+
+    /* parse directly from the mapped file instead of reading it into a buffer first */
+    if (SR_ERR_OK != sr_mmap_file(fd, &data, &length)) {
+        ly_errno = LY_ESYS;
+        return NULL;
+    }
+    if (NULL == data) {
+        /* empty file */
+        return NULL;
+    }
+
+    node = lyd_parse_mem(ctx, (const char *) data, format, options);
+    if (NULL == node) {
+        /* the file might be stored in a different format */
+        detected = sr_data_file_format_by_char(((const char *) data)[0]);
+        if (LYD_UNKNOWN != detected && format != detected) {
+            ly_errno = LY_SUCCESS;
+            node = lyd_parse_mem(ctx, (const char *) data, detected, options);
+            if (NULL != node && NULL != file_format) {
+                *file_format = detected;
+            }
         }
+    }
+
+    sr_munmap_file(data, length);
+    return node;
+}
+
+struct lyd_node *
+sr_lyd_parse_fd(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options)
+{
+    struct lyd_node *node = NULL;
+    LYD_FORMAT file_format = format;
 
+    node = sr_lyd_parse_fd_any(ctx, fd, format, options, &file_format);
+    if (NULL != node && file_format != format) {
         /* now store it in the new format */
+        SR_LOG_WRN("Converting data file to \"%s\".", SR_FILE_FORMAT_EXT);
         if ((ftruncate(fd, 0) == -1) || (lseek(fd, 0, SEEK_SET) == -1)) {
             SR_LOG_ERR("Preparing conversion data fd failed (%s).", strerror(errno));
         } else if (lyd_print_fd(fd, node, format, LYP_WITHSIBLINGS | LYP_FORMAT)) {
@@ -3243,6 +3328,65 @@ cleanup:
     return rc;
 }
 
+uint32_t
+sr_crc32(const void *data, size_t size)
+{
+    const unsigned char *p = data;
+    uint32_t crc = 0xFFFFFFFFU;
+
+    for (size_t i = 0; i < size; ++i) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; ++b) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+int
+sr_pread_full(int fd, void *data, size_t size, off_t offset)
+{
+    CHECK_NULL_ARG(data);
+    char *p = data;
+    ssize_t ret = 0;
+
+    while (size > 0) {
+        ret = pread(fd, p, size, offset);
+        if (ret <= 0) {
+            if (-1 == ret && EINTR == errno) {
+                continue;
+            }
+            return SR_ERR_IO;
+        }
+        p += ret;
+        size -= ret;
+        offset += ret;
+    }
+    return SR_ERR_OK;
+}
+
+int
+sr_pwrite_full(int fd, const void *data, size_t size, off_t offset)
+{
+    CHECK_NULL_ARG(data);
+    const char *p = data;
+    ssize_t ret = 0;
+
+    while (size > 0) {
+        ret = pwrite(fd, p, size, offset);
+        if (-1 == ret) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return SR_ERR_IO;
+        }
+        p += ret;
+        size -= ret;
+        offset += ret;
+    }
+    return SR_ERR_OK;
+}
+
 int sr_features_clone(const struct lys_module *module_src, const struct lys_module *module_tgt)
 {
     int i, j;
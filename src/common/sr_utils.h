@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <time.h>
+#include <sys/types.h>
 
 #include <libyang/libyang.h>
 
@@ -372,6 +373,47 @@ bool sr_lys_data_node(struct lys_node *node);
  */
 struct lys_node *sr_lys_node_get_data_parent(struct lys_node *node, bool augment);
 
+/**
+ * @brief Detects the format of the data file from its content.
+ *
+ * @param [in] fd
+ * @param [out] format Format of the file, LYD_UNKNOWN if the file is empty or the format has not been recognized.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int sr_get_data_file_format(int fd, LYD_FORMAT *format);
+
+/**
+ * @brief Maps the content of the file into memory read-only. The mapped content is followed by a NUL byte,
+ * so that it can be parsed as a string. The file must not be truncated while it is mapped (it has to be locked).
+ *
+ * @param [in] fd
+ * @param [out] addr Mapped content, NULL if the file is empty.
+ * @param [out] length Length of the content.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int sr_mmap_file(int fd, void **addr, size_t *length);
+
+/**
+ * @brief Unmaps the file content mapped by ::sr_mmap_file.
+ *
+ * @param [in] addr Mapped content, can be NULL.
+ * @param [in] length Length of the content.
+ */
+void sr_munmap_file(void *addr, size_t length);
+
+/**
+ * @brief Parses the data tree directly from the mapped file (see ::sr_mmap_file). If the file is not stored
+ * in the expected format, it is parsed in the format detected from its content. Unlike ::sr_lyd_parse_fd,
+ * the file is not converted.
+ *
+ * @param [in] ctx
+ * @param [in] fd
+ * @param [in] format Expected format.
+ * @param [in] options Parser options, options requiring additional arguments are not supported.
+ * @param [out] file_format Format the file is stored in, can be NULL.
+ */
+struct lyd_node *sr_lyd_parse_fd_any(struct ly_ctx *ctx, int fd, LYD_FORMAT format, int options, LYD_FORMAT *file_format);
+
 /**
  * @brief Wrapper for lyd_parse_fd() that performs file format conversion if required.
  *
@@ -803,6 +845,40 @@ int sr_time_to_str(time_t time, char *buff, size_t buff_size);
  */
 int sr_str_to_time(char *time_str, time_t *time);
 
+/**
+ * @brief Computes CRC-32 (IEEE 802.3) checksum of the data.
+ *
+ * @param [in] data Data to be checksummed.
+ * @param [in] size Size of the data.
+ *
+ * @return Checksum of the data.
+ */
+uint32_t sr_crc32(const void *data, size_t size);
+
+/**
+ * @brief Reads given number of bytes from the offset of the file. Interrupted and short reads are retried.
+ *
+ * @param [in] fd File descriptor.
+ * @param [out] data Buffer the data are read into.
+ * @param [in] size Number of bytes to be read.
+ * @param [in] offset Offset in the file.
+ *
+ * @return Error code (SR_ERR_OK on success), SR_ERR_IO if the read failed or the end of the file has been reached.
+ */
+int sr_pread_full(int fd, void *data, size_t size, off_t offset);
+
+/**
+ * @brief Writes given number of bytes at the offset of the file. Interrupted and short writes are retried.
+ *
+ * @param [in] fd File descriptor.
+ * @param [in] data Data to be written.
+ * @param [in] size Number of bytes to be written.
+ * @param [in] offset Offset in the file.
+ *
+ * @return Error code (SR_ERR_OK on success), SR_ERR_IO if the write failed.
+ */
+int sr_pwrite_full(int fd, const void *data, size_t size, off_t offset);
+
 /**@} utils */
 
 /**
@@ -31,6 +31,7 @@
 #include <fcntl.h>
 #include <pthread.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <arpa/inet.h>
 #include <ev.h>
 
@@ -41,12 +42,46 @@
 
 #define CM_IN_BUFF_MIN_SPACE 512  /**< Minimal empty space in the input buffer. */
 #define CM_BUFF_ALLOC_CHUNK 1024  /**< Chunk size for buffer expansions. */
+#define CM_IN_SLAB_MIN_MSG_SIZE 16384  /**< Minimal size of a message that is received directly into an input slab. */
+#define CM_OUT_BUFF_FLUSH_SIZE 65536   /**< Amount of pending output data that is flushed without waiting for the coalescing window. */
+#define CM_OUT_BUFF_NOTIF_LIMIT (4 * CM_OUT_BUFF_FLUSH_SIZE)  /**< Amount of unsent data of a subscriber connection above which
+                                                                   event notifications wait in the notification queue. */
 
 #define CM_INIT_MSG_QUEUE_SIZE 10      /**< Initial size of the message queue. */
 #define CM_INIT_SESS_REQ_QUEUE_SIZE 2  /**< Initial size of the request queue buffer. */
 
 #define CM_MAX_SIGNAL_WATCHERS 2  /**< Maximum number of signals that Connection Manager can watch for. */
 
+#define CM_INIT_CONN_QUEUE_SIZE 4  /**< Initial size of the queue of connections handed over to an I/O loop. */
+#define CM_INIT_NOTIF_QUEUE_SIZE 16  /**< Initial size of the queue of event notifications waiting for a slow subscriber. */
+#define CM_IO_THREAD_LIMIT 64      /**< Maximum number of I/O threads. */
+
+/**
+ * @brief I/O event loop running in a dedicated thread, handles a shard of client connections.
+ */
+typedef struct cm_io_loop_s {
+    /** Connection Manager context. */
+    struct cm_ctx_s *cm_ctx;
+    /** Thread where the event loop is running. */
+    pthread_t thread;
+    /** The thread has been started. */
+    bool started;
+
+    /** Event loop context. */
+    struct ev_loop *event_loop;
+    /** Watcher for stop request events. */
+    ev_async stop_watcher;
+    /** Watcher for message / connection enqueue events. */
+    ev_async msg_queue_watcher;
+
+    /** Queue of messages to be sent over the connections handled by this loop. */
+    sr_cbuff_t *msg_queue;
+    /** Queue of newly accepted connections to be handled by this loop. */
+    sr_cbuff_t *conn_queue;
+    /** Mutex guarding both queues. */
+    pthread_mutex_t queue_mutex;
+} cm_io_loop_t;
+
 /**
  * @brief Connection Manager context.
  */
@@ -74,9 +109,36 @@ typedef struct cm_ctx_s {
     /** Linked-list of all delayed requests (to be sent to the Request Processor after some timeout). */
     struct cm_delayed_request_ctx_s *delayed_requests;
 
+    /** Lock guarding Session Manager and all CM session & connection data shared by the event loops.
+     *  Not held while reading from / writing to the sockets and (un)packing the messages. */
+    pthread_mutex_t lock;
+
     /** Thread where event loop will be running in case of library mode. */
     pthread_t event_loop_thread;
 
+    /** I/O loops that client connections are distributed across (if empty, handled by the main loop). */
+    cm_io_loop_t *io_loops;
+    /** Number of running I/O loops. */
+    size_t io_loop_cnt;
+    /** I/O loop that will handle the next accepted connection. */
+    size_t io_loop_next;
+    /** Number of I/O threads to be started by ::cm_start. */
+    size_t io_thread_cnt;
+
+    /** Number of messages written into output buffers of the connections. */
+    atomic_uint_fast64_t msg_sent_cnt;
+    /** Number of send calls issued to flush the output buffers. */
+    atomic_uint_fast64_t send_call_cnt;
+
+    /** Maximum number of event notifications waiting for delivery to one subscriber (guarded by CM lock). */
+    size_t notif_queue_size;
+    /** Policy applied when the notification queue of a subscriber is full (guarded by CM lock). */
+    cm_notif_overflow_policy_t notif_overflow_policy;
+    /** Condition signalled (with CM lock) when some notifications have left a full notification queue. */
+    pthread_cond_t notif_queue_cv;
+    /** Number of senders waiting on notif_queue_cv. */
+    atomic_uint notif_queue_waiters;
+
     /** Event loop context. */
     struct ev_loop *event_loop;
     /** Watcher for events on server unix-domain socket. */
@@ -101,6 +163,28 @@ typedef struct cm_buffer_s {
     size_t pos;     /**< Current position in the buffer. */
 } cm_buffer_t;
 
+/**
+ * @brief Input slab - a large message being received directly into the memory context
+ * that the message will be unpacked into. The raw data are released together with the
+ * unpacked message, i.e. once Request Processor has finished with it.
+ */
+typedef struct cm_slab_s {
+    sr_mem_ctx_t *sr_mem;  /**< Memory context of the slab (NULL if Sysrepo memory management is disabled). */
+    uint8_t *data;         /**< Raw message data (without the preamble), allocated from sr_mem. */
+    size_t size;           /**< Size of the message. */
+    size_t pos;            /**< Number of bytes received so far. */
+} cm_slab_t;
+
+/**
+ * @brief Queue (ring buffer) of event notifications waiting for delivery to a slow subscriber.
+ */
+typedef struct cm_notif_queue_s {
+    Sr__Msg **msgs;   /**< Queued messages. */
+    size_t capacity;  /**< Number of allocated items in msgs. */
+    size_t head;      /**< Index of the oldest message. */
+    size_t count;     /**< Number of queued messages. */
+} cm_notif_queue_t;
+
 /**
  * @brief Context used to store session-related data managed by Connection Manager.
  */
@@ -117,11 +201,22 @@ typedef struct cm_session_ctx_s {
  * @brief Context used to store connection-related data managed by Connection Manager.
  */
 typedef struct cm_connection_ctx_s {
-    cm_ctx_t *cm_ctx;      /**< Connection Manager context related to this connection. */
-    cm_buffer_t in_buff;   /**< Input buffer. If not empty, there is some received data to be processed. */
-    cm_buffer_t out_buff;  /**< Output buffer. If not empty, there is some data to be sent when receiver is ready. */
-    ev_io read_watcher;    /**< Watcher for readable events on connection's socket. */
-    ev_io write_watcher;   /**< Watcher for writable events on connection's socket. */
+    cm_ctx_t *cm_ctx;            /**< Connection Manager context related to this connection. */
+    cm_io_loop_t *io_loop;       /**< I/O loop handling this connection (NULL in case of the main loop). */
+    struct ev_loop *event_loop;  /**< Event loop handling this connection. Only its thread touches the buffers and watchers. */
+    cm_buffer_t in_buff;         /**< Input buffer. If not empty, there is some received data to be processed. */
+    cm_slab_t in_slab;           /**< Input slab. If data is not NULL, a large message is being received into it. */
+    cm_buffer_t out_buff;        /**< Output buffer. If not empty, there is some data to be sent when receiver is ready. */
+    ev_io read_watcher;          /**< Watcher for readable events on connection's socket. */
+    ev_io write_watcher;         /**< Watcher for writable events on connection's socket. */
+    ev_timer flush_timer;        /**< Timer for flushing the output buffer after the coalescing window. */
+    bool flush_scheduled;        /**< Flush of the output buffer has been scheduled (write watcher or flush timer started). */
+    cm_notif_queue_t notif_queue;  /**< Event notifications waiting until the subscriber reads the data sent so far.
+                                        Modified with CM lock held, only by the thread of the main event loop. */
+    cm_notif_drop_cnt_t *notif_drops;  /**< Drop counters of the subscriptions that have lost some notifications (guarded by CM lock). */
+    size_t notif_drop_subscr_cnt;      /**< Number of items in notif_drops. */
+    bool notif_block_expired;          /**< A sender has timed out waiting for the subscriber, the next senders do not wait until
+                                            the notification queue drains below the limit (guarded by CM lock). */
 } cm_connection_ctx_t;
 
 /**
@@ -222,6 +317,84 @@ cm_server_cleanup(cm_ctx_t *cm_ctx)
     }
 }
 
+/**
+ * @brief Appends a message to the notification queue, enlarges the queue if needed.
+ */
+static int
+cm_notif_queue_add(cm_notif_queue_t *queue, Sr__Msg *msg)
+{
+    Sr__Msg **tmp = NULL;
+    size_t capacity = 0;
+
+    CHECK_NULL_ARG2(queue, msg);
+
+    if (queue->count == queue->capacity) {
+        capacity = (0 == queue->capacity) ? CM_INIT_NOTIF_QUEUE_SIZE : (2 * queue->capacity);
+        tmp = calloc(capacity, sizeof(*tmp));
+        CHECK_NULL_NOMEM_RETURN(tmp);
+        for (size_t i = 0; i < queue->count; i++) {
+            tmp[i] = queue->msgs[(queue->head + i) % queue->capacity];
+        }
+        free(queue->msgs);
+        queue->msgs = tmp;
+        queue->capacity = capacity;
+        queue->head = 0;
+    }
+
+    queue->msgs[(queue->head + queue->count) % queue->capacity] = msg;
+    queue->count += 1;
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Returns the message at given position in the notification queue (0 is the oldest one).
+ */
+static inline Sr__Msg *
+cm_notif_queue_at(cm_notif_queue_t *queue, size_t index)
+{
+    return queue->msgs[(queue->head + index) % queue->capacity];
+}
+
+/**
+ * @brief Removes the message at given position from the notification queue (0 is the oldest one), the younger
+ * messages keep their order.
+ */
+static Sr__Msg *
+cm_notif_queue_remove(cm_notif_queue_t *queue, size_t index)
+{
+    Sr__Msg *msg = NULL;
+
+    if (index >= queue->count) {
+        return NULL;
+    }
+
+    msg = cm_notif_queue_at(queue, index);
+    if (0 == index) {
+        queue->head = (queue->head + 1) % queue->capacity;
+    } else {
+        for (size_t i = index; i < queue->count - 1; i++) {
+            queue->msgs[(queue->head + i) % queue->capacity] = cm_notif_queue_at(queue, i + 1);
+        }
+    }
+    queue->count -= 1;
+
+    return msg;
+}
+
+/**
+ * @brief Releases all messages in the notification queue and the queue itself.
+ */
+static void
+cm_notif_queue_cleanup(cm_notif_queue_t *queue)
+{
+    while (queue->count > 0) {
+        sr_msg_free(cm_notif_queue_remove(queue, 0));
+    }
+    free(queue->msgs);
+    memset(queue, 0, sizeof(*queue));
+}
+
 /**
  * @brief Cleans up Connection Manager-related session data. Automatically called from Session Manager.
  */
@@ -240,6 +413,20 @@ cm_session_data_cleanup(void *session)
     }
 }
 
+/**
+ * @brief Releases an input slab that has not been handed over to an unpacked message.
+ */
+static void
+cm_conn_slab_release(cm_slab_t *slab)
+{
+    if (NULL != slab->sr_mem) {
+        sr_mem_free(slab->sr_mem);
+    } else {
+        free(slab->data);
+    }
+    memset(slab, 0, sizeof(*slab));
+}
+
 /**
  * @brief Cleans up Connection Manager-related connection data. Automatically called from Session Manager.
  */
@@ -249,7 +436,10 @@ cm_connection_data_cleanup(void *connection)
     sm_connection_t *sm_connection = (sm_connection_t*)connection;
     if ((NULL != sm_connection) && (NULL != sm_connection->cm_data)) {
         free(sm_connection->cm_data->in_buff.data);
+        cm_conn_slab_release(&sm_connection->cm_data->in_slab);
         free(sm_connection->cm_data->out_buff.data);
+        cm_notif_queue_cleanup(&sm_connection->cm_data->notif_queue);
+        free(sm_connection->cm_data->notif_drops);
         free(sm_connection->cm_data);
         sm_connection->cm_data = NULL;
     }
@@ -271,6 +461,8 @@ cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
 
     CHECK_NULL_ARG_VOID3(req, req->cm_ctx, req->msg);
 
+    pthread_mutex_lock(&req->cm_ctx->lock);
+
     if (NULL != req->session) {
         /* check if the session is still active */
         rc = sm_session_find_id(req->cm_ctx->sm_ctx, req->msg->session_id, &sm_session);
@@ -304,6 +496,8 @@ cm_delayed_request_cb(struct ev_loop *loop, ev_timer *w, int revents)
         }
     }
 
+    pthread_mutex_unlock(&req->cm_ctx->lock);
+
     if (ignore) {
         sr_msg_free(req->msg);
     }
@@ -394,8 +588,105 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Flush contents of the output buffer of the given connection.
+ */
+static int
+cm_conn_out_buff_flush(cm_ctx_t *cm_ctx, sm_connection_t *connection)
+{
+    cm_buffer_t *buff = NULL;
+    int written = 0;
+    size_t buff_size = 0, buff_pos = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, connection, connection->cm_data);
+
+    buff = &connection->cm_data->out_buff;
+    buff_size = buff->pos;
+    buff_pos = connection->cm_data->out_buff.start;
+
+    if (buff_size - buff_pos == 0) {
+        return rc;
+    }
+
+    SR_LOG_DBG("Sending %zu bytes of data.", (buff_size - buff_pos));
+
+    /* any scheduled flush is done now */
+    if (connection->cm_data->flush_scheduled) {
+        ev_timer_stop(connection->cm_data->event_loop, &connection->cm_data->flush_timer);
+        ev_io_stop(connection->cm_data->event_loop, &connection->cm_data->write_watcher);
+        connection->cm_data->flush_scheduled = false;
+    }
+
+    do {
+        /* try to send all data */
+        written = send(connection->fd, (buff->data + buff_pos), (buff_size - buff_pos), 0);
+        atomic_fetch_add(&cm_ctx->send_call_cnt, 1);
+        if (written > 0) {
+            SR_LOG_DBG("%d bytes of data sent.", written);
+            buff_pos += written;
+        } else {
+            if ((EWOULDBLOCK == errno) || (EAGAIN == errno)) {
+                /* no more data can be sent now */
+                SR_LOG_DBG("fd %d would block", connection->fd);
+                /* mark the position where the unsent data start */
+                connection->cm_data->out_buff.start = buff_pos;
+                /* monitor fd for writable event */
+                ev_io_start(connection->cm_data->event_loop, &connection->cm_data->write_watcher);
+                break;
+            } else {
+                /* error by writing - close the connection due to an error */
+                SR_LOG_ERR("Error by writing data to fd %d: %s.", connection->fd, sr_strerror_safe(errno));
+                connection->close_requested = true;
+                break;
+            }
+        }
+    } while ((buff_pos < buff_size) && (written > 0));
+
+    if (buff_size == buff_pos) {
+        /* no more data left in the buffer */
+        buff->pos = 0;
+        connection->cm_data->out_buff.start = 0;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Schedules flush of the output buffer of the given connection, so that all messages
+ * written within the coalescing window are sent with one send call. With zero window the buffer
+ * is flushed as soon as the socket is writable in the next event loop iteration.
+ */
+static int
+cm_conn_out_buff_flush_schedule(cm_ctx_t *cm_ctx, sm_connection_t *connection)
+{
+    cm_connection_ctx_t *cm_data = NULL;
+
+    CHECK_NULL_ARG3(cm_ctx, connection, connection->cm_data);
+
+    cm_data = connection->cm_data;
+
+    if ((cm_data->out_buff.pos - cm_data->out_buff.start) >= CM_OUT_BUFF_FLUSH_SIZE) {
+        /* enough data to be sent right away */
+        return cm_conn_out_buff_flush(cm_ctx, connection);
+    }
+
+    if (!cm_data->flush_scheduled) {
+        if (SR_OUT_MSG_COALESCE_WINDOW > 0) {
+            ev_timer_set(&cm_data->flush_timer, SR_OUT_MSG_COALESCE_WINDOW / 1000000., 0.);
+            ev_timer_start(cm_data->event_loop, &cm_data->flush_timer);
+        } else {
+            ev_io_start(cm_data->event_loop, &cm_data->write_watcher);
+        }
+        cm_data->flush_scheduled = true;
+    }
+
+    return SR_ERR_OK;
+}
+
 /**
  * @brief Close the connection inside of Connection Manager and Request Processor.
+ * Expects CM lock to be held, must be called from the thread of the event loop handling the connection.
  */
 static int
 cm_conn_close(cm_ctx_t *cm_ctx, sm_connection_t *conn)
@@ -408,8 +699,13 @@ cm_conn_close(cm_ctx_t *cm_ctx, sm_connection_t *conn)
     SR_LOG_INF("Closing the connection %p.", (void*)conn);
 
     if (NULL != conn->cm_data) {
-        ev_io_stop(cm_ctx->event_loop, &conn->cm_data->read_watcher);
-        ev_io_stop(cm_ctx->event_loop, &conn->cm_data->write_watcher);
+        /* best effort to deliver the pending output (e.g. an error response preceding the close) */
+        if (!conn->close_requested && conn->cm_data->out_buff.pos > conn->cm_data->out_buff.start) {
+            cm_conn_out_buff_flush(cm_ctx, conn);
+        }
+        ev_io_stop(conn->cm_data->event_loop, &conn->cm_data->read_watcher);
+        ev_io_stop(conn->cm_data->event_loop, &conn->cm_data->write_watcher);
+        ev_timer_stop(conn->cm_data->event_loop, &conn->cm_data->flush_timer);
     }
     close(conn->fd);
 
@@ -451,6 +747,11 @@ cm_conn_close(cm_ctx_t *cm_ctx, sm_connection_t *conn)
     /* cleanup connection, pointers to the connection from outstanding sessions will be set to NULL */
     sm_connection_stop(cm_ctx->sm_ctx, conn);
 
+    if (atomic_load(&cm_ctx->notif_queue_waiters) > 0) {
+        /* the senders waiting for the subscriber do not have to wait anymore */
+        pthread_cond_broadcast(&cm_ctx->notif_queue_cv);
+    }
+
     return SR_ERR_OK;
 }
 
@@ -485,56 +786,45 @@ cm_conn_buffer_expand(const sm_connection_t *conn, cm_buffer_t *buff, size_t req
 }
 
 /**
- * @brief Flush contents of the output buffer of the given connection.
+ * @brief Packs the message into the output buffer of the connection and flushes it.
+ * Does not need CM lock, must be called from the thread of the event loop handling the connection.
  */
 static int
-cm_conn_out_buff_flush(cm_ctx_t *cm_ctx, sm_connection_t *connection)
+cm_conn_msg_write(cm_ctx_t *cm_ctx, sm_connection_t *connection, Sr__Msg *msg, bool *close_conn)
 {
     cm_buffer_t *buff = NULL;
-    int written = 0;
-    size_t buff_size = 0, buff_pos = 0;
+    size_t msg_size = 0;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(cm_ctx, connection, connection->cm_data);
+    CHECK_NULL_ARG5(cm_ctx, connection, connection->cm_data, msg, close_conn);
+
+    *close_conn = false;
 
     buff = &connection->cm_data->out_buff;
-    buff_size = buff->pos;
-    buff_pos = connection->cm_data->out_buff.start;
 
-    if (buff_size - buff_pos == 0) {
-        return rc;
+    /* find out required message size */
+    msg_size = sr_gpb_msg_get_packed_size(msg);
+    if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
+        SR_LOG_ERR("Unable to send the message of size %zuB.", msg_size);
+        return SR_ERR_INTERNAL;
     }
 
-    SR_LOG_DBG("Sending %zu bytes of data.", (buff_size - buff_pos));
+    /* expand the buffer if needed */
+    rc = cm_conn_buffer_expand(connection, buff, SR_MSG_PREAM_SIZE + msg_size);
 
-    do {
-        /* try to send all data */
-        written = send(connection->fd, (buff->data + buff_pos), (buff_size - buff_pos), 0);
-        if (written > 0) {
-            SR_LOG_DBG("%d bytes of data sent.", written);
-            buff_pos += written;
-        } else {
-            if ((EWOULDBLOCK == errno) || (EAGAIN == errno)) {
-                /* no more data can be sent now */
-                SR_LOG_DBG("fd %d would block", connection->fd);
-                /* mark the position where the unsent data start */
-                connection->cm_data->out_buff.start = buff_pos;
-                /* monitor fd for writable event */
-                ev_io_start(cm_ctx->event_loop, &connection->cm_data->write_watcher);
-                break;
-            } else {
-                /* error by writing - close the connection due to an error */
-                SR_LOG_ERR("Error by writing data to fd %d: %s.", connection->fd, sr_strerror_safe(errno));
-                connection->close_requested = true;
-                break;
-            }
-        }
-    } while ((buff_pos < buff_size) && (written > 0));
+    if (SR_ERR_OK == rc) {
+        /* write the pramble */
+        sr_uint32_to_buff(msg_size, (buff->data + buff->pos));
+        buff->pos += SR_MSG_PREAM_SIZE;
 
-    if (buff_size == buff_pos) {
-        /* no more data left in the buffer */
-        buff->pos = 0;
-        connection->cm_data->out_buff.start = 0;
+        /* write the message */
+        sr_gpb_msg_pack(msg, (buff->data + buff->pos));
+        buff->pos += msg_size;
+        atomic_fetch_add(&cm_ctx->msg_sent_cnt, 1);
+
+        /* flush the buffer, or let more messages coalesce into it */
+        rc = cm_conn_out_buff_flush_schedule(cm_ctx, connection);
+        *close_conn = ((connection->close_requested) || (SR_ERR_OK != rc));
     }
 
     return rc;
@@ -542,45 +832,182 @@ cm_conn_out_buff_flush(cm_ctx_t *cm_ctx, sm_connection_t *connection)
 
 /**
  * @brief Sends a message to the recipient identified by session context.
+ * Expects CM lock to be held.
  */
 static int
 cm_msg_send_connection(cm_ctx_t *cm_ctx, sm_connection_t *connection, Sr__Msg *msg)
 {
-    cm_buffer_t *buff = NULL;
-    size_t msg_size = 0;
+    bool close_conn = false;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(cm_ctx, connection, connection->cm_data, msg);
+    rc = cm_conn_msg_write(cm_ctx, connection, msg, &close_conn);
+    if (close_conn) {
+        cm_conn_close(cm_ctx, connection);
+    }
 
-    buff = &connection->cm_data->out_buff;
+    return rc;
+}
 
-    /* find out required message size */
-    msg_size = sr__msg__get_packed_size(msg);
-    if ((msg_size <= 0) || (msg_size > SR_MAX_MSG_SIZE)) {
-        SR_LOG_ERR("Unable to send the message of size %zuB.", msg_size);
-        return SR_ERR_INTERNAL;
+/**
+ * @brief Counts an event notification that is not going to be delivered to the subscriber and releases it.
+ * Expects CM lock to be held.
+ */
+static void
+cm_conn_notif_drop(sm_connection_t *connection, Sr__Msg *msg)
+{
+    cm_connection_ctx_t *cm_data = connection->cm_data;
+    cm_notif_drop_cnt_t *tmp = NULL;
+    uint32_t subscription_id = msg->request->event_notif_req->subscription_id;
+    size_t i = 0;
+
+    for (i = 0; i < cm_data->notif_drop_subscr_cnt; i++) {
+        if (subscription_id == cm_data->notif_drops[i].subscription_id) {
+            break;
+        }
+    }
+    if (i == cm_data->notif_drop_subscr_cnt) {
+        SR_LOG_WRN("Subscriber at '%s' does not keep up with event notifications, dropping notifications "
+                "of the subscription id=%"PRIu32".", connection->dst_address, subscription_id);
+        tmp = realloc(cm_data->notif_drops, (i + 1) * sizeof(*tmp));
+        if (NULL != tmp) {
+            cm_data->notif_drops = tmp;
+            cm_data->notif_drops[i].subscription_id = subscription_id;
+            cm_data->notif_drops[i].dropped_cnt = 0;
+            cm_data->notif_drop_subscr_cnt += 1;
+        }
+    }
+    if (i < cm_data->notif_drop_subscr_cnt) {
+        cm_data->notif_drops[i].dropped_cnt += 1;
     }
 
-    /* expand the buffer if needed */
-    rc = cm_conn_buffer_expand(connection, buff, SR_MSG_PREAM_SIZE + msg_size);
+    SR_LOG_DBG("Event notification '%s' for subscriber at '%s' dropped.",
+            msg->request->event_notif_req->xpath, connection->dst_address);
+    sr_msg_free(msg);
+}
 
-    if (SR_ERR_OK == rc) {
-        /* write the pramble */
-        sr_uint32_to_buff(msg_size, (buff->data + buff->pos));
-        buff->pos += SR_MSG_PREAM_SIZE;
+/**
+ * @brief Puts an event notification into the notification queue of a slow subscriber, applies the overflow
+ * policy if the queue is full. Takes over the message. Expects CM lock to be held, must be called from the thread
+ * of the main event loop.
+ */
+static void
+cm_conn_notif_enqueue(cm_ctx_t *cm_ctx, sm_connection_t *connection, Sr__Msg *msg)
+{
+    cm_notif_queue_t *queue = &connection->cm_data->notif_queue;
+    Sr__EventNotifReq *notif = msg->request->event_notif_req, *queued = NULL;
+    size_t limit = cm_ctx->notif_queue_size, i = 0;
+    Sr__Msg *dropped = NULL;
+
+    if (CM_NOTIF_OVERFLOW_BLOCK == cm_ctx->notif_overflow_policy) {
+        /* the senders wait for some space in the queue, only the notifications being sent in the meantime
+         * can exceed the limit */
+        limit *= 2;
+    }
+
+    if (queue->count >= limit) {
+        switch (cm_ctx->notif_overflow_policy) {
+            case CM_NOTIF_OVERFLOW_COALESCE:
+                for (i = 0; i < queue->count; i++) {
+                    queued = cm_notif_queue_at(queue, i)->request->event_notif_req;
+                    if (queued->subscription_id == notif->subscription_id && queued->type == notif->type &&
+                            0 == strcmp(queued->xpath, notif->xpath)) {
+                        break;
+                    }
+                }
+                /* the new notification is appended, so that the order of the notifications is preserved */
+                dropped = cm_notif_queue_remove(queue, (i < queue->count) ? i : 0);
+                break;
+            case CM_NOTIF_OVERFLOW_DROP_OLDEST:
+                dropped = cm_notif_queue_remove(queue, 0);
+                break;
+            default:
+                dropped = msg;
+                msg = NULL;
+                break;
+        }
+        cm_conn_notif_drop(connection, dropped);
+    }
 
-        /* write the message */
-        sr__msg__pack(msg, (buff->data + buff->pos));
-        buff->pos += msg_size;
+    if (NULL != msg && SR_ERR_OK != cm_notif_queue_add(queue, msg)) {
+        cm_conn_notif_drop(connection, msg);
+    }
+}
 
-        /* flush the buffer */
-        rc = cm_conn_out_buff_flush(cm_ctx, connection);
-        if ((connection->close_requested) || (SR_ERR_OK != rc)) {
-            cm_conn_close(cm_ctx, connection);
+/**
+ * @brief Writes the event notifications waiting in the notification queue into the output buffer of the connection,
+ * as long as the subscriber keeps up with reading them. Wakes up the senders waiting for some space in the queue.
+ * Expects CM lock to be held, must be called from the thread of the main event loop.
+ */
+static int
+cm_conn_notif_queue_drain(cm_ctx_t *cm_ctx, sm_connection_t *connection)
+{
+    cm_connection_ctx_t *cm_data = NULL;
+    Sr__Msg *msg = NULL;
+    size_t count = 0;
+    bool close_conn = false;
+
+    CHECK_NULL_ARG3(cm_ctx, connection, connection->cm_data);
+
+    cm_data = connection->cm_data;
+    count = cm_data->notif_queue.count;
+
+    while (!close_conn && (cm_data->notif_queue.count > 0) &&
+            ((cm_data->out_buff.pos - cm_data->out_buff.start) < CM_OUT_BUFF_NOTIF_LIMIT)) {
+        msg = cm_notif_queue_remove(&cm_data->notif_queue, 0);
+        cm_conn_msg_write(cm_ctx, connection, msg, &close_conn);
+        sr_msg_free(msg);
+    }
+
+    if (cm_data->notif_queue.count < cm_ctx->notif_queue_size) {
+        /* the subscriber keeps up again, the senders may wait for it */
+        cm_data->notif_block_expired = false;
+    }
+    if ((cm_data->notif_queue.count < count) && (atomic_load(&cm_ctx->notif_queue_waiters) > 0)) {
+        pthread_cond_broadcast(&cm_ctx->notif_queue_cv);
+    }
+
+    return close_conn ? SR_ERR_DISCONNECT : SR_ERR_OK;
+}
+
+/**
+ * @brief Waits until the notification queue of the destination of an event notification has some space
+ * (::CM_NOTIF_OVERFLOW_BLOCK policy). If it does not happen within ::SR_NOTIF_BLOCK_TIMEOUT, the notification
+ * is dropped and the next notifications for the destination are dropped without waiting until its queue drains
+ * below the limit, so that a stalled subscriber holds up the sender for one timeout only, not for each notification.
+ * Expects CM lock to be held, must not be called from the thread of the main event loop.
+ *
+ * @return true if the notification can be sent, false if it has been dropped.
+ */
+static bool
+cm_notif_queue_wait(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+{
+    sm_connection_t *connection = NULL;
+    struct timespec ts = { 0, };
+    int ret = 0;
+
+    sr_clock_get_time(CLOCK_REALTIME, &ts);
+    ts.tv_sec += SR_NOTIF_BLOCK_TIMEOUT / 1000;
+    ts.tv_nsec += (SR_NOTIF_BLOCK_TIMEOUT % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    while (CM_NOTIF_OVERFLOW_BLOCK == cm_ctx->notif_overflow_policy &&
+            SR_ERR_OK == sm_connection_find_dst(cm_ctx->sm_ctx, msg->request->event_notif_req->subscriber_address,
+                    &connection) &&
+            NULL != connection->cm_data && connection->cm_data->notif_queue.count >= cm_ctx->notif_queue_size) {
+        if (ETIMEDOUT == ret || connection->cm_data->notif_block_expired) {
+            connection->cm_data->notif_block_expired = true;
+            cm_conn_notif_drop(connection, msg);
+            return false;
         }
+        atomic_fetch_add(&cm_ctx->notif_queue_waiters, 1);
+        ret = pthread_cond_timedwait(&cm_ctx->notif_queue_cv, &cm_ctx->lock, &ts);
+        atomic_fetch_sub(&cm_ctx->notif_queue_waiters, 1);
     }
 
-    return rc;
+    return true;
 }
 
 /**
@@ -661,6 +1088,7 @@ cm_session_start_req_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, Sr__Msg *m
         SR_LOG_ERR("Cannot allocate the response for session_start request (conn=%p).", (void*)conn);
         return SR_ERR_NOMEM;
     }
+    sr_gpb_resp_set_req_id(msg_in, msg);
 
     /* start the session */
     rc = cm_session_start_internal(cm_ctx, conn, msg_in->request->session_start_req->user_name,
@@ -713,6 +1141,7 @@ cm_session_stop_req_process(cm_ctx_t *cm_ctx, sm_session_t *session, Sr__Msg *ms
         SR_LOG_ERR("Cannot allocate the response for session_stop request (session id=%"PRIu32").", session->id);
         return SR_ERR_NOMEM;
     }
+    sr_gpb_resp_set_req_id(msg_in, msg_out);
 
     if (SR_ERR_OK == rc) {
         /* validate provided session id */
@@ -790,6 +1219,7 @@ cm_session_check_req_process(cm_ctx_t *cm_ctx, sm_session_t *session, Sr__Msg *m
         SR_LOG_ERR("Cannot allocate the response for session_check request (session id=%"PRIu32").", session->id);
         return SR_ERR_NOMEM;
     }
+    sr_gpb_resp_set_req_id(msg_in, msg);
 
     msg->session_id = session->id;
 
@@ -826,6 +1256,7 @@ cm_verify_version_req_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, Sr__Msg *
         sr_mem_free(sr_mem);
         return SR_ERR_NOMEM;
     }
+    sr_gpb_resp_set_req_id(msg_in, msg);
 
     /* verify versions (soname) */
     if (NULL == msg_in->request->version_verify_req->soname ||
@@ -996,35 +1427,14 @@ cleanup:
 }
 
 /**
- * @brief Processes a message received on connection.
+ * @brief Dispatches an unpacked message received on connection. Expects CM lock to be held.
  */
 static int
-cm_conn_msg_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, uint8_t *msg_data, size_t msg_size)
+cm_conn_msg_dispatch(cm_ctx_t *cm_ctx, sm_connection_t *conn, Sr__Msg *msg)
 {
-    Sr__Msg *msg = NULL;
     sm_session_t *session = NULL;
-    sr_mem_ctx_t *sr_mem = NULL;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG3(cm_ctx, conn, msg_data);
-
-    /* unpack the message */
-    rc = sr_mem_new(msg_size, &sr_mem);
-    CHECK_RC_MSG_RETURN(rc, "Failed to instantiate a Sysrepo memory context.");
-    ProtobufCAllocator allocator = sr_get_protobuf_allocator(sr_mem);
-    msg = sr__msg__unpack(&allocator, msg_size, msg_data);
-    if (NULL == msg) {
-        SR_LOG_ERR("Unable to unpack the message (conn=%p).", (void*)conn);
-        rc = SR_ERR_INTERNAL;
-        goto cleanup;
-    }
-    if (NULL != sr_mem) {
-        msg->_sysrepo_mem_ctx = (uint64_t)sr_mem;
-        ++sr_mem->obj_count;
-    } else {
-        msg->_sysrepo_mem_ctx = (uint64_t) NULL;
-    }
-
     /* NULL check according to message type */
     if (((SR__MSG__MSG_TYPE__REQUEST == msg->type) && (NULL == msg->request)) ||
             ((SR__MSG__MSG_TYPE__RESPONSE == msg->type) && (NULL == msg->response))) {
@@ -1092,11 +1502,108 @@ cm_conn_msg_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, uint8_t *msg_data,
     return rc;
 
 cleanup:
-    if (msg) {
-        sr_msg_free(msg);
-    } else {
+    sr_msg_free(msg);
+    return rc;
+}
+
+/**
+ * @brief Processes a message received on connection.
+ *
+ * @param[in] sr_mem Memory context of the input slab that holds msg_data, the message
+ * is unpacked into the same context and takes over its ownership. NULL if msg_data
+ * points into the input buffer of the connection.
+ */
+static int
+cm_conn_msg_process(cm_ctx_t *cm_ctx, sm_connection_t *conn, sr_mem_ctx_t *sr_mem, uint8_t *msg_data, size_t msg_size)
+{
+    Sr__Msg *msg = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, conn, msg_data);
+
+    /* unpack the message (outside of the CM lock, I/O loops unpack in parallel) */
+    if (NULL == sr_mem) {
+        rc = sr_mem_new(msg_size, &sr_mem);
+        CHECK_RC_MSG_RETURN(rc, "Failed to instantiate a Sysrepo memory context.");
+    }
+    ProtobufCAllocator allocator = sr_get_protobuf_allocator(sr_mem);
+    msg = sr__msg__unpack(&allocator, msg_size, msg_data);
+    if (NULL == msg) {
+        SR_LOG_ERR("Unable to unpack the message (conn=%p).", (void*)conn);
         sr_mem_free(sr_mem);
+        return SR_ERR_INTERNAL;
     }
+    msg->_sysrepo_mem_ctx = (uint64_t)sr_mem;
+    ++sr_mem->obj_count;
+    /* the internal fields may have been set by the peer */
+    sr_gpb_msg_internal_reset(msg);
+
+    pthread_mutex_lock(&cm_ctx->lock);
+    rc = cm_conn_msg_dispatch(cm_ctx, conn, msg);
+    pthread_mutex_unlock(&cm_ctx->lock);
+
+    return rc;
+}
+
+/**
+ * @brief Starts receiving of a large message directly into an input slab of the connection.
+ * The slab is allocated from a memory context big enough to hold also the unpacked message.
+ */
+static int
+cm_conn_slab_start(sm_connection_t *conn, const uint8_t *data, size_t data_size, size_t msg_size)
+{
+    cm_slab_t *slab = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(conn, conn->cm_data, data);
+
+    slab = &conn->cm_data->in_slab;
+
+    /* raw data + unpacked message, which is usually a bit smaller than its raw data */
+    rc = sr_mem_new(2 * msg_size, &slab->sr_mem);
+    CHECK_RC_MSG_RETURN(rc, "Failed to instantiate a Sysrepo memory context.");
+
+    slab->data = sr_malloc(slab->sr_mem, msg_size);
+    if (NULL == slab->data) {
+        SR_LOG_ERR("Cannot allocate input slab of %zu bytes for fd=%d.", msg_size, conn->fd);
+        cm_conn_slab_release(slab);
+        return SR_ERR_NOMEM;
+    }
+    slab->size = msg_size;
+    slab->pos = data_size;
+    memcpy(slab->data, data, data_size);
+
+    SR_LOG_DBG("Receiving message of size %zu bytes on fd=%d into an input slab.", msg_size, conn->fd);
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Processes the message in the input slab of a connection, if it has been completely received.
+ */
+static int
+cm_conn_slab_process(cm_ctx_t *cm_ctx, sm_connection_t *conn)
+{
+    cm_slab_t slab = { 0 };
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, conn, conn->cm_data);
+
+    if ((NULL == conn->cm_data->in_slab.data) || (conn->cm_data->in_slab.pos < conn->cm_data->in_slab.size)) {
+        return SR_ERR_OK; /* nothing to process so far */
+    }
+
+    /* detach the slab from the connection, its memory context is handed over to the message */
+    slab = conn->cm_data->in_slab;
+    memset(&conn->cm_data->in_slab, 0, sizeof(conn->cm_data->in_slab));
+
+    SR_LOG_DBG("New message of size %zu bytes received.", slab.size);
+    rc = cm_conn_msg_process(cm_ctx, conn, slab.sr_mem, slab.data, slab.size);
+    if (NULL == slab.sr_mem) {
+        /* Sysrepo memory management disabled, the message does not reference the raw data */
+        free(slab.data);
+    }
+
     return rc;
 }
 
@@ -1127,16 +1634,25 @@ cm_conn_in_buff_process(cm_ctx_t *cm_ctx, sm_connection_t *conn)
             /* invalid message size */
             SR_LOG_ERR("Invalid message size in the message preamble (%zu).", msg_size);
             return SR_ERR_MALFORMED_MSG;
-        } else if ((buff_size - buff_pos) >= msg_size) {
+        } else if ((buff_size - buff_pos) >= (SR_MSG_PREAM_SIZE + msg_size)) {
             /* the message is completely retrieved, parse it */
             SR_LOG_DBG("New message of size %zu bytes received.", msg_size);
-            rc = cm_conn_msg_process(cm_ctx, conn,
+            rc = cm_conn_msg_process(cm_ctx, conn, NULL,
                     (buff->data + buff_pos + SR_MSG_PREAM_SIZE), msg_size);
             buff_pos += SR_MSG_PREAM_SIZE + msg_size;
             if (SR_ERR_OK != rc) {
                 SR_LOG_ERR_MSG("Error by processing of the message.");
                 return rc;
             }
+        } else if (msg_size >= CM_IN_SLAB_MIN_MSG_SIZE) {
+            /* large partial message, receive the rest of it directly into an input slab */
+            rc = cm_conn_slab_start(conn, (buff->data + buff_pos + SR_MSG_PREAM_SIZE),
+                    (buff_size - SR_MSG_PREAM_SIZE - buff_pos), msg_size);
+            if (SR_ERR_OK != rc) {
+                return rc;
+            }
+            buff_pos = buff_size;
+            break;
         } else {
             /* the message is not completely retrieved, end processing */
             SR_LOG_DBG("Partial message of size %zu, received %zu.", msg_size,
@@ -1166,6 +1682,7 @@ cm_conn_read_cb(struct ev_loop *loop, ev_io *w, int revents)
     sm_connection_t *conn = NULL;
     cm_ctx_t *cm_ctx = NULL;
     cm_buffer_t *buff = NULL;
+    cm_slab_t *slab = NULL;
     int bytes = 0;
     int rc = SR_ERR_OK;
 
@@ -1175,22 +1692,44 @@ cm_conn_read_cb(struct ev_loop *loop, ev_io *w, int revents)
     CHECK_NULL_ARG_VOID3(conn, conn->cm_data, conn->cm_data->cm_ctx);
     cm_ctx = conn->cm_data->cm_ctx;
     buff = &conn->cm_data->in_buff;
+    slab = &conn->cm_data->in_slab;
 
     SR_LOG_DBG("fd %d readable (revents %d)", conn->fd, revents);
 
     do {
-        /* expand input buffer if needed */
-        rc = cm_conn_buffer_expand(conn, buff, CM_IN_BUFF_MIN_SPACE);
-        if (SR_ERR_OK != rc) {
-            conn->close_requested = true;
-            break;
+        if (NULL != slab->data) {
+            /* receive the rest of a large message directly into the input slab */
+            bytes = recv(conn->fd, (slab->data + slab->pos), (slab->size - slab->pos), 0);
+            if (bytes > 0) {
+                SR_LOG_DBG("%d bytes of data received on fd %d", bytes, conn->fd);
+                slab->pos += bytes;
+                rc = cm_conn_slab_process(cm_ctx, conn);
+                if (SR_ERR_OK != rc) {
+                    break;
+                }
+                continue;
+            }
+        } else {
+            /* expand input buffer if needed */
+            rc = cm_conn_buffer_expand(conn, buff, CM_IN_BUFF_MIN_SPACE);
+            if (SR_ERR_OK != rc) {
+                conn->close_requested = true;
+                break;
+            }
+            /* receive data */
+            bytes = recv(conn->fd, (buff->data + buff->pos), (buff->size - buff->pos), 0);
         }
-        /* receive data */
-        bytes = recv(conn->fd, (buff->data + buff->pos), (buff->size - buff->pos), 0);
         if (bytes > 0) {
             /* Received "bytes" bytes of data */
             SR_LOG_DBG("%d bytes of data received on fd %d", bytes, conn->fd);
             buff->pos += bytes;
+            if (buff->pos == buff->size) {
+                /* process the buffer, a large message may continue in an input slab */
+                rc = cm_conn_in_buff_process(cm_ctx, conn);
+                if (SR_ERR_OK != rc) {
+                    break;
+                }
+            }
         } else if (0 == bytes) {
             /* connection closed by the other side */
             SR_LOG_DBG("Peer on fd %d disconnected.", conn->fd);
@@ -1222,7 +1761,9 @@ cm_conn_read_cb(struct ev_loop *loop, ev_io *w, int revents)
 
     /* close the connection if requested */
     if ((conn->close_requested) || (SR_ERR_OK != rc)) {
+        pthread_mutex_lock(&cm_ctx->lock);
         cm_conn_close(cm_ctx, conn);
+        pthread_mutex_unlock(&cm_ctx->lock);
     }
 }
 
@@ -1231,7 +1772,46 @@ cm_conn_read_cb(struct ev_loop *loop, ev_io *w, int revents)
  * a connection is writable (without blocking).
  */
 static void
-cm_conn_write_cb(struct ev_loop *loop, ev_io *w, int revents)
+cm_conn_write_cb(struct ev_loop *loop, ev_io *w, int revents)
+{
+    sm_connection_t *conn = NULL;
+    cm_ctx_t *cm_ctx = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG_VOID2(w, w->data);
+    conn = (sm_connection_t*)w->data;
+
+    CHECK_NULL_ARG_VOID3(conn, conn->cm_data, conn->cm_data->cm_ctx);
+    cm_ctx = conn->cm_data->cm_ctx;
+
+    SR_LOG_DBG("fd %d writeable (revents %d)", conn->fd, revents);
+
+    ev_io_stop(conn->cm_data->event_loop, &conn->cm_data->write_watcher);
+
+    /* flush the output buffer */
+    rc = cm_conn_out_buff_flush(cm_ctx, conn);
+
+    /* deliver the event notifications waiting for the subscriber */
+    if ((SR_ERR_OK == rc) && !conn->close_requested && (conn->cm_data->notif_queue.count > 0)) {
+        pthread_mutex_lock(&cm_ctx->lock);
+        rc = cm_conn_notif_queue_drain(cm_ctx, conn);
+        pthread_mutex_unlock(&cm_ctx->lock);
+    }
+
+    /* close the connection if requested */
+    if ((conn->close_requested) || (SR_ERR_OK != rc)) {
+        pthread_mutex_lock(&cm_ctx->lock);
+        cm_conn_close(cm_ctx, conn);
+        pthread_mutex_unlock(&cm_ctx->lock);
+    }
+}
+
+/**
+ * @brief Callback called by the event loop timer when the coalescing window
+ * of the output buffer of a connection has elapsed.
+ */
+static void
+cm_conn_flush_timer_cb(struct ev_loop *loop, ev_timer *w, int revents)
 {
     sm_connection_t *conn = NULL;
     cm_ctx_t *cm_ctx = NULL;
@@ -1243,25 +1823,33 @@ cm_conn_write_cb(struct ev_loop *loop, ev_io *w, int revents)
     CHECK_NULL_ARG_VOID3(conn, conn->cm_data, conn->cm_data->cm_ctx);
     cm_ctx = conn->cm_data->cm_ctx;
 
-    SR_LOG_DBG("fd %d writeable (revents %d)", conn->fd, revents);
-
-    ev_io_stop(cm_ctx->event_loop, &conn->cm_data->write_watcher);
-
     /* flush the output buffer */
     rc = cm_conn_out_buff_flush(cm_ctx, conn);
 
+    /* deliver the event notifications waiting for the subscriber */
+    if ((SR_ERR_OK == rc) && !conn->close_requested && (conn->cm_data->notif_queue.count > 0)) {
+        pthread_mutex_lock(&cm_ctx->lock);
+        rc = cm_conn_notif_queue_drain(cm_ctx, conn);
+        pthread_mutex_unlock(&cm_ctx->lock);
+    }
+
     /* close the connection if requested */
     if ((conn->close_requested) || (SR_ERR_OK != rc)) {
+        pthread_mutex_lock(&cm_ctx->lock);
         cm_conn_close(cm_ctx, conn);
+        pthread_mutex_unlock(&cm_ctx->lock);
     }
 }
 
 /**
  * @brief Initializes read and write watchers for the file descriptor of provided connection.
+ * If an I/O loop is provided, the connection is handed over to it, otherwise it is handled by the main loop.
  */
 static int
-cm_conn_watcher_init(cm_ctx_t *cm_ctx, sm_connection_t *conn)
+cm_conn_watcher_init(cm_ctx_t *cm_ctx, cm_io_loop_t *io_loop, sm_connection_t *conn)
 {
+    int rc = SR_ERR_OK;
+
     CHECK_NULL_ARG2(cm_ctx, conn);
 
     conn->cm_data = calloc(1, sizeof(*(conn->cm_data)));
@@ -1271,16 +1859,36 @@ cm_conn_watcher_init(cm_ctx_t *cm_ctx, sm_connection_t *conn)
     }
 
     conn->cm_data->cm_ctx = cm_ctx;
+    conn->cm_data->io_loop = io_loop;
+    conn->cm_data->event_loop = (NULL != io_loop) ? io_loop->event_loop : cm_ctx->event_loop;
 
     ev_io_init(&conn->cm_data->read_watcher, cm_conn_read_cb, conn->fd, EV_READ);
     conn->cm_data->read_watcher.data = (void*)conn;
-    ev_io_start(cm_ctx->event_loop, &conn->cm_data->read_watcher);
 
     ev_io_init(&conn->cm_data->write_watcher, cm_conn_write_cb, conn->fd, EV_WRITE);
     conn->cm_data->write_watcher.data = (void*)conn;
     /* do not start write watcher - will be started when needed */
 
-    return SR_ERR_OK;
+    ev_timer_init(&conn->cm_data->flush_timer, cm_conn_flush_timer_cb, 0., 0.);
+    conn->cm_data->flush_timer.data = (void*)conn;
+
+    if (NULL == io_loop) {
+        ev_io_start(cm_ctx->event_loop, &conn->cm_data->read_watcher);
+    } else {
+        /* watchers can be started only from the thread of the I/O loop */
+        pthread_mutex_lock(&io_loop->queue_mutex);
+        rc = sr_cbuff_enqueue(io_loop->conn_queue, &conn);
+        pthread_mutex_unlock(&io_loop->queue_mutex);
+        if (SR_ERR_OK == rc) {
+            ev_async_send(io_loop->event_loop, &io_loop->msg_queue_watcher);
+        } else {
+            SR_LOG_ERR("Cannot hand over fd=%d to an I/O loop.", conn->fd);
+            free(conn->cm_data);
+            conn->cm_data = NULL;
+        }
+    }
+
+    return rc;
 }
 
 /**
@@ -1292,6 +1900,7 @@ static void
 cm_server_watcher_cb(struct ev_loop *loop, ev_io *w, int revents)
 {
     cm_ctx_t *cm_ctx = NULL;
+    cm_io_loop_t *io_loop = NULL;
     sm_connection_t *connection = NULL;
     int clnt_fd = -1;
     int rc = SR_ERR_OK;
@@ -1311,9 +1920,11 @@ cm_server_watcher_cb(struct ev_loop *loop, ev_io *w, int revents)
                 close(clnt_fd);
                 continue;
             }
+            pthread_mutex_lock(&cm_ctx->lock);
             /* start connection in session manager */
             rc = sm_connection_start(cm_ctx->sm_ctx, CM_AF_UNIX_CLIENT, clnt_fd, &connection);
             if (SR_ERR_OK != rc) {
+                pthread_mutex_unlock(&cm_ctx->lock);
                 SR_LOG_ERR("Cannot start connection in Session manager (fd=%d).", clnt_fd);
                 close(clnt_fd);
                 continue;
@@ -1324,12 +1935,18 @@ cm_server_watcher_cb(struct ev_loop *loop, ev_io *w, int revents)
                     SR_LOG_ERR("Peer's uid=%d does not match with local uid=%d "
                             "(required by local mode).", connection->uid, geteuid());
                     sm_connection_stop(cm_ctx->sm_ctx, connection);
+                    pthread_mutex_unlock(&cm_ctx->lock);
                     close(clnt_fd);
                     continue;
                 }
             }
-            /* start watching this fd */
-            rc = cm_conn_watcher_init(cm_ctx, connection);
+            /* start watching this fd, distribute the connections across I/O loops in round-robin fashion */
+            if (cm_ctx->io_loop_cnt > 0) {
+                io_loop = &cm_ctx->io_loops[cm_ctx->io_loop_next];
+                cm_ctx->io_loop_next = (cm_ctx->io_loop_next + 1) % cm_ctx->io_loop_cnt;
+            }
+            rc = cm_conn_watcher_init(cm_ctx, io_loop, connection);
+            pthread_mutex_unlock(&cm_ctx->lock);
             if (SR_ERR_OK != rc) {
                 SR_LOG_ERR("Cannot initialize watcher for fd=%d.", clnt_fd);
                 close(clnt_fd);
@@ -1390,7 +2007,7 @@ cm_subscr_conn_create(cm_ctx_t *cm_ctx, const char *socket_path, sm_connection_t
     }
 
     /* initialize connection watchers */
-    rc = cm_conn_watcher_init(cm_ctx, connection);
+    rc = cm_conn_watcher_init(cm_ctx, NULL, connection);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR("Cannot initialize watcher for fd=%d.", fd);
         rc = SR_ERR_INTERNAL;
@@ -1649,6 +2266,14 @@ cm_out_event_notif_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
         rc = cm_subscr_conn_create(cm_ctx, destination_address, &connection);
     }
 
+    if (SR_ERR_OK == rc && ((connection->cm_data->notif_queue.count > 0) ||
+            ((connection->cm_data->out_buff.pos - connection->cm_data->out_buff.start) >= CM_OUT_BUFF_NOTIF_LIMIT))) {
+        /* the subscriber does not keep up, the notification waits until the data sent so far are read */
+        SR_LOG_DBG("Queueing the event notification for the slow subscriber at '%s'.", destination_address);
+        cm_conn_notif_enqueue(cm_ctx, connection, msg);
+        return SR_ERR_OK;
+    }
+
     /* send the message */
     if (SR_ERR_OK == rc) {
         rc = cm_msg_send_connection(cm_ctx, connection, msg);
@@ -1705,31 +2330,38 @@ cm_internal_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 
 /**
  * @brief Processes an outgoing message (message to be sent to the client library).
+ *
+ * Takes CM lock only for the session bookkeeping, the message is packed and sent without it
+ * (the connection of the session is handled by the calling thread, so it cannot be closed meanwhile).
  */
 static int
 cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 {
     sm_session_t *session = NULL;
+    sm_connection_t *connection = NULL;
+    uint32_t session_id = 0;
+    bool send = false, close_conn = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG2(cm_ctx, msg);
 
-    if (SR__MSG__MSG_TYPE__INTERNAL_REQUEST == msg->type) {
-        /* handle as an internal request from RP */
-        return cm_internal_msg_process(cm_ctx, msg);
-    }
+    session_id = msg->session_id;
+
+    pthread_mutex_lock(&cm_ctx->lock);
 
     /* find the session */
-    rc = sm_session_find_id(cm_ctx->sm_ctx, msg->session_id, &session);
+    rc = sm_session_find_id(cm_ctx->sm_ctx, session_id, &session);
     if (SR_ERR_OK != rc) {
+        pthread_mutex_unlock(&cm_ctx->lock);
         SR_LOG_ERR("Unable to find the session matching with id specified in the message "
-                "(id=%"PRIu32").", msg->session_id);
+                "(id=%"PRIu32").", session_id);
         sr_msg_free(msg);
         return SR_ERR_INTERNAL;
     }
 
     if ((NULL == session) || (NULL == session->cm_data)) {
-        SR_LOG_ERR("invalid session context - NULL value detected (id=%"PRIu32").", msg->session_id);
+        pthread_mutex_unlock(&cm_ctx->lock);
+        SR_LOG_ERR("invalid session context - NULL value detected (id=%"PRIu32").", session_id);
         sr_msg_free(msg);
         return SR_ERR_INTERNAL;
     }
@@ -1743,18 +2375,33 @@ cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
         session->cm_data->rp_resp_expected += 1;
     }
 
-    /* send the message */
-    if (!session->cm_data->stop_requested) {
-        /* only if session_stop has not been requested */
-        rc = cm_msg_send_connection(cm_ctx, session->connection, msg);
+    /* send the message only if session_stop has not been requested */
+    send = !session->cm_data->stop_requested;
+    connection = session->connection;
+
+    pthread_mutex_unlock(&cm_ctx->lock);
+
+    if (send) {
+        rc = cm_conn_msg_write(cm_ctx, connection, msg, &close_conn);
         if (SR_ERR_OK != rc) {
-            SR_LOG_ERR("Unable to send the message over session (id=%"PRIu32").", msg->session_id);
+            SR_LOG_ERR("Unable to send the message over session (id=%"PRIu32").", session_id);
         }
     }
 
     /* release the message */
     sr_msg_free(msg);
 
+    pthread_mutex_lock(&cm_ctx->lock);
+
+    if (close_conn) {
+        cm_conn_close(cm_ctx, connection);
+        /* the session may have been dropped together with the connection */
+        if (SR_ERR_OK != sm_session_find_id(cm_ctx->sm_ctx, session_id, &session) || NULL == session->cm_data) {
+            pthread_mutex_unlock(&cm_ctx->lock);
+            return rc;
+        }
+    }
+
     /* if there are no more outstanding session-related requests in RP */
     if (0 == session->cm_data->rp_req_cnt) {
         if (session->cm_data->stop_requested) {
@@ -1773,9 +2420,64 @@ cm_out_msg_process(cm_ctx_t *cm_ctx, Sr__Msg *msg)
         }
     }
 
+    pthread_mutex_unlock(&cm_ctx->lock);
+
     return rc;
 }
 
+/**
+ * @brief Returns true if the message is handled by the main event loop (internal requests and
+ * messages sent via subscriber connections), false if it is a message to be sent over a client session.
+ */
+static bool
+cm_msg_for_main_loop(Sr__Msg *msg)
+{
+    if ((SR__MSG__MSG_TYPE__NOTIFICATION == msg->type) || (SR__MSG__MSG_TYPE__INTERNAL_REQUEST == msg->type)) {
+        return true;
+    }
+    if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) && (NULL != msg->request) &&
+            ((SR__OPERATION__DATA_PROVIDE == msg->request->operation) ||
+             (SR__OPERATION__RPC == msg->request->operation) ||
+             (SR__OPERATION__ACTION == msg->request->operation) ||
+             (SR__OPERATION__EVENT_NOTIF == msg->request->operation))) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Processes an outgoing message dequeued from a message queue of an event loop.
+ */
+static void
+cm_out_msg_dispatch(cm_ctx_t *cm_ctx, Sr__Msg *msg)
+{
+    if (!cm_msg_for_main_loop(msg)) {
+        /* process as a normal message (takes the CM lock only when needed) */
+        cm_out_msg_process(cm_ctx, msg);
+        return;
+    }
+
+    pthread_mutex_lock(&cm_ctx->lock);
+    if (SR__MSG__MSG_TYPE__NOTIFICATION == msg->type) {
+        /* send the notification via subscriber connection */
+        cm_out_notif_process(cm_ctx, msg);
+    } else if (SR__MSG__MSG_TYPE__INTERNAL_REQUEST == msg->type) {
+        /* handle as an internal request from RP */
+        cm_internal_msg_process(cm_ctx, msg);
+    } else if (SR__OPERATION__DATA_PROVIDE == msg->request->operation) {
+        /* send the data-provide request via subscriber connection */
+        cm_out_dp_request_process(cm_ctx, msg);
+    } else if (SR__OPERATION__RPC == msg->request->operation ||
+            SR__OPERATION__ACTION == msg->request->operation) {
+        /* send the RPC request via subscriber connection */
+        cm_out_rpc_process(cm_ctx, msg);
+    } else {
+        /* send the event notification via subscriber connection */
+        cm_out_event_notif_process(cm_ctx, msg);
+    }
+    pthread_mutex_unlock(&cm_ctx->lock);
+}
+
 /**
  * @brief Callback called by the event loop watcher when a message is enqueued into message queue.
  */
@@ -1798,30 +2500,181 @@ cm_msg_enqueue_cb(struct ev_loop *loop, ev_async *w, int revents)
         pthread_mutex_unlock(&cm_ctx->msg_queue_mutex);
 
         if (dequeued) {
-            if (SR__MSG__MSG_TYPE__NOTIFICATION == msg->type) {
-                /* send the notification via subscriber connection */
-                cm_out_notif_process(cm_ctx, msg);
-            } else if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) &&
-                    (SR__OPERATION__DATA_PROVIDE == msg->request->operation)) {
-                /* send the data-provide request via subscriber connection */
-                cm_out_dp_request_process(cm_ctx, msg);
-            } else if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) &&
-                            (SR__OPERATION__RPC == msg->request->operation ||
-                             SR__OPERATION__ACTION == msg->request->operation)) {
-               /* send the RPC request via subscriber connection */
-               cm_out_rpc_process(cm_ctx, msg);
-            } else if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) &&
-                   (SR__OPERATION__EVENT_NOTIF == msg->request->operation)) {
-               /* send the event notification via subscriber connection */
-               cm_out_event_notif_process(cm_ctx, msg);
-           } else {
-                /* process as a normal message */
-                cm_out_msg_process(cm_ctx, msg);
-            }
+            cm_out_msg_dispatch(cm_ctx, msg);
+        }
+    } while (dequeued);
+}
+
+/**
+ * @brief Callback called by the I/O loop watcher when a message or a new connection
+ * is enqueued into the I/O loop's queues.
+ */
+static void
+cm_io_loop_enqueue_cb(struct ev_loop *loop, ev_async *w, int revents)
+{
+    cm_io_loop_t *io_loop = NULL;
+    sm_connection_t *conn = NULL;
+    Sr__Msg *msg = NULL;
+    bool dequeued = false;
+
+    CHECK_NULL_ARG_VOID2(w, w->data);
+    io_loop = (cm_io_loop_t*)w->data;
+
+    /* start watching newly accepted connections */
+    do {
+        pthread_mutex_lock(&io_loop->queue_mutex);
+        dequeued = sr_cbuff_dequeue(io_loop->conn_queue, &conn);
+        pthread_mutex_unlock(&io_loop->queue_mutex);
+
+        if (dequeued) {
+            SR_LOG_DBG("I/O loop %p takes over the connection on fd %d.", (void*)io_loop, conn->fd);
+            ev_io_start(io_loop->event_loop, &conn->cm_data->read_watcher);
+        }
+    } while (dequeued);
+
+    /* send outgoing messages */
+    do {
+        pthread_mutex_lock(&io_loop->queue_mutex);
+        dequeued = sr_cbuff_dequeue(io_loop->msg_queue, &msg);
+        pthread_mutex_unlock(&io_loop->queue_mutex);
+
+        if (dequeued) {
+            cm_out_msg_dispatch(io_loop->cm_ctx, msg);
         }
     } while (dequeued);
 }
 
+/**
+ * @brief Callback called by the I/O loop watcher when an async request to stop the loop is received.
+ */
+static void
+cm_io_loop_stop_cb(struct ev_loop *loop, ev_async *w, int revents)
+{
+    CHECK_NULL_ARG_VOID2(loop, w);
+
+    ev_break(loop, EVBREAK_ALL);
+}
+
+/**
+ * @brief Runs an I/O loop in its thread.
+ */
+static void *
+cm_io_loop_threaded(void *io_loop_p)
+{
+    cm_io_loop_t *io_loop = (cm_io_loop_t*)io_loop_p;
+
+    if (NULL == io_loop) {
+        return NULL;
+    }
+
+    SR_LOG_DBG("Starting CM I/O loop %p.", io_loop_p);
+
+    ev_run(io_loop->event_loop, 0);
+
+    SR_LOG_DBG("CM I/O loop %p finished.", io_loop_p);
+
+    return NULL;
+}
+
+/**
+ * @brief Initializes and starts the I/O loops (io_thread_cnt of them).
+ */
+static int
+cm_io_loops_start(cm_ctx_t *cm_ctx)
+{
+    cm_io_loop_t *io_loop = NULL;
+    int ret = 0, rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(cm_ctx);
+
+    if (0 == cm_ctx->io_thread_cnt) {
+        return SR_ERR_OK;
+    }
+
+    cm_ctx->io_loops = calloc(cm_ctx->io_thread_cnt, sizeof(*cm_ctx->io_loops));
+    CHECK_NULL_NOMEM_RETURN(cm_ctx->io_loops);
+
+    for (size_t i = 0; i < cm_ctx->io_thread_cnt; i++) {
+        io_loop = &cm_ctx->io_loops[i];
+        io_loop->cm_ctx = cm_ctx;
+        pthread_mutex_init(&io_loop->queue_mutex, NULL);
+
+        rc = sr_cbuff_init(CM_INIT_MSG_QUEUE_SIZE, sizeof(Sr__Msg*), &io_loop->msg_queue);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "CM I/O loop message queue initialization failed.");
+        rc = sr_cbuff_init(CM_INIT_CONN_QUEUE_SIZE, sizeof(sm_connection_t*), &io_loop->conn_queue);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "CM I/O loop connection queue initialization failed.");
+
+        io_loop->event_loop = ev_loop_new((EVBACKEND_ALL ^ EVBACKEND_EPOLL) | EVFLAG_NOENV);
+        CHECK_NULL_NOMEM_GOTO(io_loop->event_loop, rc, cleanup);
+
+        ev_async_init(&io_loop->stop_watcher, cm_io_loop_stop_cb);
+        io_loop->stop_watcher.data = (void*)io_loop;
+        ev_async_start(io_loop->event_loop, &io_loop->stop_watcher);
+
+        ev_async_init(&io_loop->msg_queue_watcher, cm_io_loop_enqueue_cb);
+        io_loop->msg_queue_watcher.data = (void*)io_loop;
+        ev_async_start(io_loop->event_loop, &io_loop->msg_queue_watcher);
+
+        ret = pthread_create(&io_loop->thread, NULL, cm_io_loop_threaded, io_loop);
+        CHECK_ZERO_LOG_GOTO(ret, rc, SR_ERR_INTERNAL, cleanup, "Error by creating CM I/O thread: %s", sr_strerror_safe(ret));
+        io_loop->started = true;
+    }
+
+    /* start distributing the connections across I/O loops */
+    pthread_mutex_lock(&cm_ctx->lock);
+    cm_ctx->io_loop_cnt = cm_ctx->io_thread_cnt;
+    pthread_mutex_unlock(&cm_ctx->lock);
+
+    SR_LOG_INF("Connection Manager started %zu I/O threads.", cm_ctx->io_loop_cnt);
+
+cleanup:
+    return rc;
+}
+
+/**
+ * @brief Stops the I/O loops and waits for their threads to exit.
+ */
+static void
+cm_io_loops_stop(cm_ctx_t *cm_ctx)
+{
+    for (size_t i = 0; NULL != cm_ctx->io_loops && i < cm_ctx->io_thread_cnt; i++) {
+        if (cm_ctx->io_loops[i].started) {
+            ev_async_send(cm_ctx->io_loops[i].event_loop, &cm_ctx->io_loops[i].stop_watcher);
+            pthread_join(cm_ctx->io_loops[i].thread, NULL);
+            cm_ctx->io_loops[i].started = false;
+        }
+    }
+}
+
+/**
+ * @brief Releases the resources of the (already stopped) I/O loops.
+ */
+static void
+cm_io_loops_cleanup(cm_ctx_t *cm_ctx)
+{
+    cm_io_loop_t *io_loop = NULL;
+    Sr__Msg *msg = NULL;
+
+    for (size_t i = 0; NULL != cm_ctx->io_loops && i < cm_ctx->io_thread_cnt; i++) {
+        io_loop = &cm_ctx->io_loops[i];
+        if (NULL != io_loop->event_loop) {
+            ev_loop_destroy(io_loop->event_loop);
+        }
+        if (NULL != io_loop->msg_queue) {
+            while (sr_cbuff_dequeue(io_loop->msg_queue, &msg)) {
+                sr_msg_free(msg);
+            }
+            sr_cbuff_cleanup(io_loop->msg_queue);
+        }
+        /* connections are released by Session Manager */
+        sr_cbuff_cleanup(io_loop->conn_queue);
+        pthread_mutex_destroy(&io_loop->queue_mutex);
+    }
+    free(cm_ctx->io_loops);
+    cm_ctx->io_loops = NULL;
+    cm_ctx->io_loop_cnt = 0;
+}
+
 /**
  * @brief Callback called by the event loop watcher when an async request to stop the loop is received.
  */
@@ -1910,6 +2763,14 @@ cm_init(const cm_connection_mode_t mode, const char *socket_path, cm_ctx_t **cm_
         goto cleanup;
     }
     ctx->mode = mode;
+    ctx->io_thread_cnt = SR_CM_IO_THREAD_COUNT;
+    atomic_init(&ctx->msg_sent_cnt, 0);
+    atomic_init(&ctx->send_call_cnt, 0);
+    pthread_mutex_init(&ctx->lock, NULL);
+    ctx->notif_queue_size = SR_NOTIF_QUEUE_SIZE;
+    ctx->notif_overflow_policy = CM_NOTIF_OVERFLOW_DEFAULT;
+    pthread_cond_init(&ctx->notif_queue_cv, NULL);
+    atomic_init(&ctx->notif_queue_waiters, 0);
 
     /* initialize message queue */
     pthread_mutex_init(&ctx->msg_queue_mutex, NULL);
@@ -1977,9 +2838,13 @@ cm_cleanup(cm_ctx_t *cm_ctx)
     sm_session_t *session = NULL;
     Sr__Msg *msg = NULL;
     cm_delayed_request_ctx_t *req = NULL, *tmp = NULL;
+    uint_fast64_t msg_cnt = 0, send_cnt = 0;
     int rc = SR_ERR_OK;
 
     if (NULL != cm_ctx) {
+        /* I/O threads should have been already stopped by cm_stop */
+        cm_io_loops_stop(cm_ctx);
+
         /* stop all sessions in RP */
         while (SR_ERR_OK == rc) {
             rc = sm_session_get_index(cm_ctx->sm_ctx, i++, &session);
@@ -1991,7 +2856,15 @@ cm_cleanup(cm_ctx_t *cm_ctx)
         rp_cleanup(cm_ctx->rp_ctx);
         sm_cleanup(cm_ctx->sm_ctx);
 
-        ev_loop_destroy(cm_ctx->event_loop);
+        msg_cnt = atomic_load(&cm_ctx->msg_sent_cnt);
+        send_cnt = atomic_load(&cm_ctx->send_call_cnt);
+        SR_LOG_INF("Connection Manager sent %"PRIu64" messages with %"PRIu64" send calls (%.2f syscalls per message).",
+                (uint64_t)msg_cnt, (uint64_t)send_cnt, (msg_cnt > 0) ? ((double)send_cnt / msg_cnt) : 0.0);
+
+        cm_io_loops_cleanup(cm_ctx);
+        if (NULL != cm_ctx->event_loop) {
+            ev_loop_destroy(cm_ctx->event_loop);
+        }
         cm_server_cleanup(cm_ctx);
 
         while (sr_cbuff_dequeue(cm_ctx->msg_queue, &msg)) {
@@ -1999,6 +2872,8 @@ cm_cleanup(cm_ctx_t *cm_ctx)
         }
         sr_cbuff_cleanup(cm_ctx->msg_queue);
         pthread_mutex_destroy(&cm_ctx->msg_queue_mutex);
+        pthread_cond_destroy(&cm_ctx->notif_queue_cv);
+        pthread_mutex_destroy(&cm_ctx->lock);
 
         tmp = cm_ctx->delayed_requests;
         while (NULL != tmp) {
@@ -2020,6 +2895,13 @@ cm_start(cm_ctx_t *cm_ctx)
 
     CHECK_NULL_ARG(cm_ctx);
 
+    /* start I/O threads */
+    rc = cm_io_loops_start(cm_ctx);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Unable to start Connection Manager I/O threads.");
+        return rc;
+    }
+
     if (CM_MODE_DAEMON == cm_ctx->mode) {
         /* run the event loop in this thread */
         cm_event_loop(cm_ctx);
@@ -2051,12 +2933,17 @@ cm_stop(cm_ctx_t *cm_ctx)
         pthread_join(cm_ctx->event_loop_thread, NULL);
     }
 
+    /* stop I/O threads */
+    cm_io_loops_stop(cm_ctx);
+
     return SR_ERR_OK;
 }
 
 int
 cm_msg_send(cm_ctx_t *cm_ctx, Sr__Msg *msg)
 {
+    sm_session_t *session = NULL;
+    cm_io_loop_t *io_loop = NULL;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG_NORET2(rc, cm_ctx, msg);
@@ -2068,6 +2955,45 @@ cm_msg_send(cm_ctx_t *cm_ctx, Sr__Msg *msg)
         return rc;
     }
 
+    if ((SR__MSG__MSG_TYPE__REQUEST == msg->type) && (NULL != msg->request) &&
+            (SR__OPERATION__EVENT_NOTIF == msg->request->operation) && (NULL != msg->request->event_notif_req)) {
+        /* do not let the sender outpace a slow subscriber if requested */
+        pthread_mutex_lock(&cm_ctx->lock);
+        if ((CM_NOTIF_OVERFLOW_BLOCK == cm_ctx->notif_overflow_policy) && !cm_notif_queue_wait(cm_ctx, msg)) {
+            /* the notification has been dropped */
+            msg = NULL;
+        }
+        pthread_mutex_unlock(&cm_ctx->lock);
+        if (NULL == msg) {
+            return SR_ERR_OK;
+        }
+    }
+
+    if (!cm_msg_for_main_loop(msg)) {
+        /* messages for client sessions are sent by the I/O loop handling the session's connection */
+        pthread_mutex_lock(&cm_ctx->lock);
+        if (cm_ctx->io_loop_cnt > 0 && SR_ERR_OK == sm_session_find_id(cm_ctx->sm_ctx, msg->session_id, &session) &&
+                NULL != session->connection && NULL != session->connection->cm_data) {
+            io_loop = session->connection->cm_data->io_loop;
+        }
+        pthread_mutex_unlock(&cm_ctx->lock);
+    }
+
+    if (NULL != io_loop) {
+        pthread_mutex_lock(&io_loop->queue_mutex);
+        rc = sr_cbuff_enqueue(io_loop->msg_queue, &msg);
+        pthread_mutex_unlock(&io_loop->queue_mutex);
+
+        if (SR_ERR_OK == rc) {
+            /* send async event to the I/O loop */
+            ev_async_send(io_loop->event_loop, &io_loop->msg_queue_watcher);
+        } else {
+            SR_LOG_ERR_MSG("Unable to send the message, skipping.");
+            sr_msg_free(msg);
+        }
+        return rc;
+    }
+
     pthread_mutex_lock(&cm_ctx->msg_queue_mutex);
     rc = sr_cbuff_enqueue(cm_ctx->msg_queue, &msg);
     pthread_mutex_unlock(&cm_ctx->msg_queue_mutex);
@@ -2093,6 +3019,12 @@ cm_msg_search(cm_ctx_t *cm_ctx, Sr__Msg *msg)
         pthread_mutex_lock(&cm_ctx->msg_queue_mutex);
         search_result = sr_cbuff_search(cm_ctx->msg_queue, &msg);
         pthread_mutex_unlock(&cm_ctx->msg_queue_mutex);
+
+        for (size_t i = 0; !search_result && i < cm_ctx->io_loop_cnt; i++) {
+            pthread_mutex_lock(&cm_ctx->io_loops[i].queue_mutex);
+            search_result = sr_cbuff_search(cm_ctx->io_loops[i].msg_queue, &msg);
+            pthread_mutex_unlock(&cm_ctx->io_loops[i].queue_mutex);
+        }
     }
 
     return search_result;
@@ -2126,6 +3058,174 @@ cm_get_connection_mode(cm_ctx_t *cm_ctx)
     }
 }
 
+int
+cm_set_rp_thread_limits(cm_ctx_t *cm_ctx, size_t min_threads, size_t max_threads)
+{
+    CHECK_NULL_ARG(cm_ctx);
+
+    return rp_set_thread_limits(cm_ctx->rp_ctx, min_threads, max_threads);
+}
+
+int
+cm_set_io_thread_count(cm_ctx_t *cm_ctx, size_t thread_cnt)
+{
+    CHECK_NULL_ARG(cm_ctx);
+
+    if (NULL != cm_ctx->io_loops) {
+        SR_LOG_ERR_MSG("Number of CM I/O threads cannot be changed after Connection Manager has been started.");
+        return SR_ERR_OPERATION_FAILED;
+    }
+    if (thread_cnt > CM_IO_THREAD_LIMIT) {
+        SR_LOG_ERR("Invalid number of CM I/O threads (%zu, maximum is %d).", thread_cnt, CM_IO_THREAD_LIMIT);
+        return SR_ERR_INVAL_ARG;
+    }
+
+    cm_ctx->io_thread_cnt = thread_cnt;
+
+    return SR_ERR_OK;
+}
+
+int
+cm_set_notif_queue_limits(cm_ctx_t *cm_ctx, size_t queue_size, cm_notif_overflow_policy_t policy)
+{
+    CHECK_NULL_ARG(cm_ctx);
+
+    if (0 == queue_size) {
+        SR_LOG_ERR_MSG("Invalid size of the event notification queue (0).");
+        return SR_ERR_INVAL_ARG;
+    }
+
+    pthread_mutex_lock(&cm_ctx->lock);
+    cm_ctx->notif_queue_size = queue_size;
+    cm_ctx->notif_overflow_policy = policy;
+    pthread_mutex_unlock(&cm_ctx->lock);
+
+    /* the waiting senders re-check the limits */
+    pthread_cond_broadcast(&cm_ctx->notif_queue_cv);
+
+    return SR_ERR_OK;
+}
+
+int
+cm_get_notif_queue_limits(cm_ctx_t *cm_ctx, size_t *queue_size, cm_notif_overflow_policy_t *policy)
+{
+    CHECK_NULL_ARG3(cm_ctx, queue_size, policy);
+
+    pthread_mutex_lock(&cm_ctx->lock);
+    *queue_size = cm_ctx->notif_queue_size;
+    *policy = cm_ctx->notif_overflow_policy;
+    pthread_mutex_unlock(&cm_ctx->lock);
+
+    return SR_ERR_OK;
+}
+
+/** @brief Names of the overflow policies indexed by ::cm_notif_overflow_policy_t. */
+static const char * const cm_notif_overflow_policy_names[] = {
+    [CM_NOTIF_OVERFLOW_BLOCK] = "block",
+    [CM_NOTIF_OVERFLOW_DROP_OLDEST] = "drop-oldest",
+    [CM_NOTIF_OVERFLOW_DROP_NEWEST] = "drop-newest",
+    [CM_NOTIF_OVERFLOW_COALESCE] = "coalesce",
+};
+
+int
+cm_notif_overflow_policy_from_str(const char *name, cm_notif_overflow_policy_t *policy)
+{
+    CHECK_NULL_ARG2(name, policy);
+
+    for (size_t i = 0; i < sizeof(cm_notif_overflow_policy_names) / sizeof(*cm_notif_overflow_policy_names); i++) {
+        if (0 == strcmp(name, cm_notif_overflow_policy_names[i])) {
+            *policy = (cm_notif_overflow_policy_t)i;
+            return SR_ERR_OK;
+        }
+    }
+
+    return SR_ERR_INVAL_ARG;
+}
+
+const char *
+cm_notif_overflow_policy_to_str(cm_notif_overflow_policy_t policy)
+{
+    if ((size_t)policy < sizeof(cm_notif_overflow_policy_names) / sizeof(*cm_notif_overflow_policy_names)) {
+        return cm_notif_overflow_policy_names[policy];
+    }
+    return NULL;
+}
+
+int
+cm_get_notif_dst_states(cm_ctx_t *cm_ctx, cm_notif_dst_state_t **states_p, size_t *state_cnt_p)
+{
+    sm_connection_t *connection = NULL;
+    cm_notif_dst_state_t *states = NULL, *tmp = NULL, *state = NULL;
+    size_t state_cnt = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(cm_ctx, states_p, state_cnt_p);
+
+    pthread_mutex_lock(&cm_ctx->lock);
+
+    for (uint32_t i = 0; SR_ERR_OK == sm_connection_get_dst_index(cm_ctx->sm_ctx, i, &connection); i++) {
+        if (NULL == connection->cm_data) {
+            continue;
+        }
+        tmp = realloc(states, (state_cnt + 1) * sizeof(*states));
+        CHECK_NULL_NOMEM_GOTO(tmp, rc, cleanup);
+        states = tmp;
+        state = &states[state_cnt++];
+        memset(state, 0, sizeof(*state));
+
+        state->dst_address = strdup(connection->dst_address);
+        CHECK_NULL_NOMEM_GOTO(state->dst_address, rc, cleanup);
+        state->queued_cnt = connection->cm_data->notif_queue.count;
+        state->slow_consumer = (connection->cm_data->notif_queue.count > 0);
+
+        if (connection->cm_data->notif_drop_subscr_cnt > 0) {
+            state->subscriptions = calloc(connection->cm_data->notif_drop_subscr_cnt, sizeof(*state->subscriptions));
+            CHECK_NULL_NOMEM_GOTO(state->subscriptions, rc, cleanup);
+            memcpy(state->subscriptions, connection->cm_data->notif_drops,
+                    connection->cm_data->notif_drop_subscr_cnt * sizeof(*state->subscriptions));
+            state->subscription_cnt = connection->cm_data->notif_drop_subscr_cnt;
+            for (size_t j = 0; j < state->subscription_cnt; j++) {
+                state->dropped_cnt += state->subscriptions[j].dropped_cnt;
+            }
+        }
+    }
+
+cleanup:
+    pthread_mutex_unlock(&cm_ctx->lock);
+
+    if (SR_ERR_OK != rc) {
+        cm_notif_dst_states_free(states, state_cnt);
+        return rc;
+    }
+
+    *states_p = states;
+    *state_cnt_p = state_cnt;
+    return SR_ERR_OK;
+}
+
+void
+cm_notif_dst_states_free(cm_notif_dst_state_t *states, size_t state_cnt)
+{
+    if (NULL != states) {
+        for (size_t i = 0; i < state_cnt; i++) {
+            free(states[i].dst_address);
+            free(states[i].subscriptions);
+        }
+        free(states);
+    }
+}
+
+int
+cm_get_stats(cm_ctx_t *cm_ctx, cm_stats_t *stats)
+{
+    CHECK_NULL_ARG2(cm_ctx, stats);
+
+    stats->msg_sent_cnt = atomic_load(&cm_ctx->msg_sent_cnt);
+    stats->send_call_cnt = atomic_load(&cm_ctx->send_call_cnt);
+
+    return SR_ERR_OK;
+}
+
 int
 cm_before_cleanup(cm_ctx_t *cm_ctx)
 {
@@ -40,6 +40,18 @@
  * the main thread in daemon mode (making the main thread blocked until stop
  * is requested by ::cm_stop), whereas in local (library( mode the event loop
  * runs in a new dedicated thread (to not block caller thread).
+ *
+ * Client connections can be distributed across multiple I/O threads, each running
+ * its own event loop (see ::cm_set_io_thread_count). The main event loop then
+ * only accepts new connections and handles subscriber connections and internal requests.
+ *
+ * Outgoing messages are not sent one by one, messages written into the output buffer
+ * of a connection within a coalescing window (SR_OUT_MSG_COALESCE_WINDOW) are flushed
+ * with a single send call.
+ *
+ * Event notifications are delivered to each subscriber through a bounded queue, so that a slow
+ * subscriber cannot make the output buffer of its connection grow without limit
+ * (see ::cm_set_notif_queue_limits).
  */
 
 #include "sysrepo.pb-c.h"
@@ -181,6 +193,146 @@ int cm_watch_signal(cm_ctx_t *cm_ctx, int signum, cm_signal_cb callback);
  */
 cm_connection_mode_t cm_get_connection_mode(cm_ctx_t *cm_ctx);
 
+/**
+ * @brief Sets the limits of the Request Processor's worker thread pool
+ * used by the given instance of Connection Manager.
+ *
+ * @param[in] cm_ctx Connection Manager context.
+ * @param[in] min_threads Minimum number of worker threads.
+ * @param[in] max_threads Maximum number of worker threads.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cm_set_rp_thread_limits(cm_ctx_t *cm_ctx, size_t min_threads, size_t max_threads);
+
+/**
+ * @brief Sets the number of I/O threads (event loops) that client connections
+ * are distributed across. Must be called before ::cm_start.
+ *
+ * @param[in] cm_ctx Connection Manager context.
+ * @param[in] thread_cnt Number of I/O threads, 0 means that all connections
+ * are handled by the main event loop.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cm_set_io_thread_count(cm_ctx_t *cm_ctx, size_t thread_cnt);
+
+/**
+ * @brief Policies applied when the queue of event notifications waiting for delivery to a slow subscriber is full.
+ */
+typedef enum cm_notif_overflow_policy_e {
+    CM_NOTIF_OVERFLOW_BLOCK,        /**< The sender waits until there is some space in the queue (at most ::SR_NOTIF_BLOCK_TIMEOUT,
+                                         the notification is dropped afterwards). Once the wait times out, the next
+                                         notifications for the subscriber are dropped without waiting until its queue
+                                         drains below the limit. */
+    CM_NOTIF_OVERFLOW_DROP_OLDEST,  /**< The oldest notification in the queue is dropped. */
+    CM_NOTIF_OVERFLOW_DROP_NEWEST,  /**< The new notification is dropped. */
+    CM_NOTIF_OVERFLOW_COALESCE,     /**< The new notification replaces a queued notification of the same subscription
+                                         with the same xpath, if there is none, the oldest notification is dropped. */
+} cm_notif_overflow_policy_t;
+
+/** @brief Overflow policy used unless ::cm_set_notif_queue_limits is called. */
+#define CM_NOTIF_OVERFLOW_DEFAULT CM_NOTIF_OVERFLOW_DROP_OLDEST
+
+/**
+ * @brief Sets the limits of the delivery of event notifications to subscribers.
+ *
+ * Event notifications are written to a subscriber connection only while the subscriber keeps up with reading
+ * the already sent data, otherwise they wait in the queue of the connection. If the queue is full,
+ * the overflow policy decides which notification is not delivered.
+ *
+ * With ::CM_NOTIF_OVERFLOW_BLOCK, the waiting sender is the Request Processor thread delivering the notification,
+ * so a stalled subscriber delays the other requests handled by that thread by at most ::SR_NOTIF_BLOCK_TIMEOUT
+ * until the subscriber reads some of its queued notifications.
+ *
+ * @param[in] cm_ctx Connection Manager context.
+ * @param[in] queue_size Maximum number of event notifications waiting for delivery to one subscriber.
+ * @param[in] policy Policy applied when the queue is full.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cm_set_notif_queue_limits(cm_ctx_t *cm_ctx, size_t queue_size, cm_notif_overflow_policy_t policy);
+
+/**
+ * @brief Returns the limits of the delivery of event notifications set by ::cm_set_notif_queue_limits.
+ *
+ * @param[in] cm_ctx Connection Manager context.
+ * @param[out] queue_size Maximum number of event notifications waiting for delivery to one subscriber.
+ * @param[out] policy Policy applied when the queue is full.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cm_get_notif_queue_limits(cm_ctx_t *cm_ctx, size_t *queue_size, cm_notif_overflow_policy_t *policy);
+
+/**
+ * @brief Converts the name of an overflow policy (as used in the sysrepo-monitoring module) to the policy.
+ *
+ * @param[in] name Name of the policy ("block", "drop-oldest", "drop-newest" or "coalesce").
+ * @param[out] policy Policy.
+ *
+ * @return Error code (SR_ERR_OK on success, SR_ERR_INVAL_ARG if the name is unknown).
+ */
+int cm_notif_overflow_policy_from_str(const char *name, cm_notif_overflow_policy_t *policy);
+
+/**
+ * @brief Returns the name of an overflow policy (as used in the sysrepo-monitoring module).
+ */
+const char *cm_notif_overflow_policy_to_str(cm_notif_overflow_policy_t policy);
+
+/**
+ * @brief Number of event notifications of one subscription dropped because of a slow subscriber.
+ */
+typedef struct cm_notif_drop_cnt_s {
+    uint32_t subscription_id;  /**< Identifier of the subscription (unique within the destination). */
+    uint64_t dropped_cnt;      /**< Number of dropped (or coalesced) notifications. */
+} cm_notif_drop_cnt_t;
+
+/**
+ * @brief State of the delivery of event notifications to one subscriber destination.
+ */
+typedef struct cm_notif_dst_state_s {
+    char *dst_address;                    /**< Address of the destination (subscriber's socket). */
+    size_t queued_cnt;                    /**< Number of notifications waiting in the queue. */
+    bool slow_consumer;                   /**< The subscriber does not keep up, new notifications wait in the queue. */
+    uint64_t dropped_cnt;                 /**< Total number of notifications not delivered to the destination. */
+    cm_notif_drop_cnt_t *subscriptions;   /**< Drop counters of the subscriptions that have lost some notifications. */
+    size_t subscription_cnt;              /**< Number of items in subscriptions. */
+} cm_notif_dst_state_t;
+
+/**
+ * @brief Returns the state of the delivery of event notifications to all connected subscriber destinations.
+ *
+ * @param[in] cm_ctx Connection Manager context.
+ * @param[out] states Array of the states, to be freed by ::cm_notif_dst_states_free.
+ * @param[out] state_cnt Number of items in states.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cm_get_notif_dst_states(cm_ctx_t *cm_ctx, cm_notif_dst_state_t **states, size_t *state_cnt);
+
+/**
+ * @brief Frees the states returned by ::cm_get_notif_dst_states.
+ */
+void cm_notif_dst_states_free(cm_notif_dst_state_t *states, size_t state_cnt);
+
+/**
+ * @brief Statistics of the messages sent by Connection Manager.
+ */
+typedef struct cm_stats_s {
+    uint64_t msg_sent_cnt;   /**< Number of messages sent to clients and subscribers. */
+    uint64_t send_call_cnt;  /**< Number of send calls issued, lower than msg_sent_cnt if the messages were coalesced. */
+} cm_stats_t;
+
+/**
+ * @brief Returns statistics of the messages sent by Connection Manager.
+ *
+ * @param[in] cm_ctx Connection Manager context.
+ * @param[out] stats Statistics.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int cm_get_stats(cm_ctx_t *cm_ctx, cm_stats_t *stats);
+
 /**
  * @brief Function blocks further commit request and wait for ongoing commits to finish.
  * @param [in] cm_ctx
@@ -26,9 +26,11 @@
 #include <stdlib.h>
 #include <dirent.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <fcntl.h>
 #include <libyang/libyang.h>
 #include <string.h>
+#include <ctype.h>
 #include <inttypes.h>
 #include <libyang/libyang.h>
 #include <libyang/tree_data.h>
@@ -43,6 +45,8 @@
 #include "rp_dt_edit.h"
 #include "module_dependencies.h"
 #include "nacm.h"
+#include "dm_journal.h"
+#include "dm_helper_pool.h"
 
 /**
  * @brief Structure holding an instance of temporary libyang context that can be used
@@ -69,17 +73,25 @@ typedef struct dm_session_s {
     char *error_xpath;                  /**< xpath of the last error if applicable */
     sr_list_t *locked_files;            /**< set of filename that are locked by this session */
     bool *holds_ds_lock;                /**< flags if the session holds ds lock*/
+    bool copies_checked[DM_DATASTORE_COUNT];         /**< flags whether all the session copies of the datastore are known
+                                                      * to be up to date as of checked_commit_cnt */
+    uint64_t checked_commit_cnt[DM_DATASTORE_COUNT]; /**< commit count of the version table at the last check
+                                                      * of the session copies (see ::dm_update_session_data_trees) */
+    uint32_t trees_generation;          /**< incremented whenever a data tree of the session is replaced or made private,
+                                         * see ::dm_get_session_trees_generation */
 } dm_session_t;
 
 /**
  * @brief Info structure for the node which holds its state in the running data store,
- * hash of its xpath in the schema tree and its depth in the data tree.
+ * hash of its xpath in the schema tree, its depth in the data tree and whether
+ * it is referenced by any constraint of the module.
  * (It will hold information about notification subscriptions.)
  */
 typedef struct dm_node_info_s {
     dm_node_state_t state;
     uint32_t xpath_hash;
     uint16_t data_depth;
+    bool referenced;
 } dm_node_info_t;
 
 /**
@@ -113,7 +125,23 @@ typedef enum dm_procedure_e {
  */
 #define DM_COMMIT_MAX_WAIT_TIME 30
 
-static int dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, bool skip_validation, bool *should_be_freed, dm_data_info_t **info);
+static int dm_commit_sync_flush(dm_sync_batch_t *batch);
+static int dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, bool skip_validation, bool rdonly, bool *should_be_freed, dm_data_info_t **info);
+
+/**
+ * @brief Parsed data tree of a module shared read-only by the sessions.
+ * The tree is freed when the last reference is released.
+ */
+typedef struct dm_data_snapshot_s {
+    dm_schema_info_t *schema;      /**< Schema of the data tree */
+    sr_datastore_t ds;             /**< Datastore the data tree has been loaded from */
+    struct lyd_node *node;         /**< Shared data tree, must not be modified */
+    struct timespec timestamp;     /**< Modification time of the data file the tree has been loaded from */
+    ino_t ino;                     /**< Inode of the data file the tree has been loaded from */
+    off_t size;                    /**< Size of the data file the tree has been loaded from */
+    uint64_t data_version;         /**< Version of the data file corresponding to the data tree */
+    atomic_size_t ref_count;       /**< Number of data infos referencing the snapshot (+1 if it is cached) */
+} dm_data_snapshot_t;
 
 /**
  * @brief Compares two data trees by module name
@@ -262,6 +290,21 @@ dm_set_node_data_depth(struct lys_node *node, uint16_t depth)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Marks the node as referenced by a when, must or leafref expression.
+ */
+static int
+dm_set_node_referenced(struct lys_node *node)
+{
+    CHECK_NULL_ARG(node);
+    if (NULL == node->priv) {
+        node->priv = calloc(1, sizeof(dm_node_info_t));
+        CHECK_NULL_NOMEM_RETURN(node->priv);
+    }
+    ((dm_node_info_t *) node->priv)->referenced = true;
+    return SR_ERR_OK;
+}
+
 static void
 dm_free_lys_private_data(const struct lys_node *node, void *private)
 {
@@ -284,6 +327,94 @@ dm_free_schema_info(void *schema_info)
     free(si);
 }
 
+/**
+ * @brief Compares two data snapshots by schema and datastore
+ */
+static int
+dm_data_snapshot_cmp(const void *a, const void *b)
+{
+    assert(a);
+    assert(b);
+    dm_data_snapshot_t *snap_a = (dm_data_snapshot_t *) a;
+    dm_data_snapshot_t *snap_b = (dm_data_snapshot_t *) b;
+
+    if (snap_a->schema != snap_b->schema) {
+        return (uintptr_t) snap_a->schema < (uintptr_t) snap_b->schema ? -1 : 1;
+    }
+    if (snap_a->ds != snap_b->ds) {
+        return snap_a->ds < snap_b->ds ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Releases one reference to the data snapshot, the data tree is freed with the last one.
+ */
+static void
+dm_data_snapshot_release(void *item)
+{
+    dm_data_snapshot_t *snapshot = (dm_data_snapshot_t *) item;
+    if (NULL != snapshot && 1 == atomic_fetch_sub(&snapshot->ref_count, 1)) {
+        lyd_free_withsiblings(snapshot->node);
+        free(snapshot);
+    }
+}
+
+/**
+ * @brief Frees the data tree of the data info (or releases the reference
+ * to the shared one) and sets the new one.
+ */
+static void
+dm_data_info_replace_node(dm_data_info_t *info, struct lyd_node *node)
+{
+    if (NULL != info->snapshot) {
+        dm_data_snapshot_release(info->snapshot);
+        info->snapshot = NULL;
+    } else if (!info->rdonly_copy) {
+        lyd_free_withsiblings(info->node);
+    }
+    info->node = node;
+}
+
+/**
+ * @brief Makes a private copy of the data tree if it is shared with other sessions.
+ */
+static int
+dm_data_info_make_private(dm_data_info_t *info)
+{
+    struct lyd_node *dup = NULL;
+
+    if (NULL == info->snapshot) {
+        return SR_ERR_OK;
+    }
+    if (NULL != info->node) {
+        dup = sr_dup_datatree(info->node);
+        CHECK_NULL_NOMEM_RETURN(dup);
+    }
+    SR_LOG_DBG("Private copy of the data tree of module %s has been made", info->schema->module_name);
+    dm_data_info_replace_node(info, dup);
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Drops the cached data trees of the module, the sessions keep their references.
+ */
+static void
+dm_drop_data_snapshots(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info)
+{
+    dm_data_snapshot_t lookup = {0}, *snapshot = NULL;
+
+    lookup.schema = schema_info;
+    pthread_mutex_lock(&dm_ctx->data_snapshots_lock);
+    for (lookup.ds = SR_DS_STARTUP; lookup.ds < DM_DATASTORE_COUNT; lookup.ds++) {
+        snapshot = sr_btree_search(dm_ctx->data_snapshots, &lookup);
+        if (NULL != snapshot) {
+            sr_btree_delete(dm_ctx->data_snapshots, snapshot);
+        }
+    }
+    pthread_mutex_unlock(&dm_ctx->data_snapshots_lock);
+}
+
 /**
  * @brief frees the dm_data_info stored in binary tree
  */
@@ -292,7 +423,7 @@ dm_data_info_free(void *item)
 {
     dm_data_info_t *info = (dm_data_info_t *) item;
     if (NULL != info && !info->rdonly_copy) {
-        lyd_free_withsiblings(info->node);
+        dm_data_info_replace_node(info, NULL);
         sr_free_list_of_strings(info->required_modules);
         /* decrement the number of usage of the module */
         pthread_mutex_lock(&info->schema->usage_count_mutex);
@@ -317,6 +448,7 @@ dm_model_subscription_free(void *sub)
             }
             sr_list_cleanup(ms->changes);
         }
+        free(ms->packed_changes);
         pthread_rwlock_destroy(&ms->changes_lock);
     }
     free(ms);
@@ -565,6 +697,22 @@ dm_free_tmp_ly_ctx(dm_tmp_ly_ctx_t *ctx)
     }
 }
 
+/**
+ * @brief Closes the descriptors of the group commit batch and frees it.
+ * @param [in] batch
+ */
+static void
+dm_sync_batch_free(dm_sync_batch_t *batch)
+{
+    if (NULL != batch) {
+        for (size_t i = 0; i < batch->fd_cnt; i++) {
+            close(batch->fds[i]);
+        }
+        free(batch->fds);
+        free(batch);
+    }
+}
+
 
 /**
  * @brief Acquires temporary libyang context, that can be used to parse/validate/print data that
@@ -668,6 +816,8 @@ dm_schema_info_init(const char *schema_search_dir, dm_schema_info_t **schema_inf
 
     pthread_rwlock_init(&si->model_lock, NULL);
     pthread_mutex_init(&si->usage_count_mutex, NULL);
+    dm_module_versions_init(&si->local_versions);
+    si->versions = &si->local_versions;
 
 cleanup:
     if (SR_ERR_OK != rc) {
@@ -704,6 +854,8 @@ dm_insert_data_info_copy(sr_btree_t *tree, const dm_data_info_t *di)
     pthread_mutex_unlock(&di->schema->usage_count_mutex);
     copy->schema = di->schema;
     copy->timestamp = di->timestamp;
+    copy->data_version = di->data_version;
+    copy->timestamp_reliable = di->timestamp_reliable;
 
     rc = sr_btree_insert(tree, (void *) copy);
 cleanup:
@@ -713,6 +865,25 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Marks that a session copy that might be out of date has been added to the session,
+ * the next ::dm_update_session_data_trees has to check each session copy of the datastore.
+ */
+static void
+dm_session_copies_unchecked(dm_session_t *session, sr_datastore_t ds)
+{
+    session->copies_checked[ds] = false;
+}
+
+/**
+ * @brief Records that data trees of the session have been replaced, the nodes looked up in them before are not valid.
+ */
+static void
+dm_session_trees_replaced(dm_session_t *session)
+{
+    session->trees_generation++;
+}
+
 /**
  * @brief Function verifies that current module is not used by a session
  * and dis/enable the feature
@@ -732,6 +903,9 @@ dm_feature_enable_internal(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, cons
     CHECK_NULL_ARG4(dm_ctx, schema_info, module_name, feature_name);
     int rc = SR_ERR_OK;
 
+    /* cached data trees do not count as usage, drop them */
+    dm_drop_data_snapshots(dm_ctx, schema_info);
+
     pthread_mutex_lock(&schema_info->usage_count_mutex);
     if (0 != schema_info->usage_count) {
         SR_LOG_ERR("Feature state can not be modified because %zu is using the module", schema_info->usage_count);
@@ -827,6 +1001,237 @@ dm_init_missing_node_priv_data(dm_schema_info_t *schema_info)
     return rc;
 }
 
+/**
+ * @brief Marks all schema nodes referenced by the expression evaluated in the context of the node.
+ */
+static int
+dm_mark_referenced_nodes(dm_schema_info_t *schema_info, const struct lys_node *node, const char *expr, int lyxp_opts)
+{
+    int rc = SR_ERR_OK;
+    struct ly_set *set = NULL;
+
+    if (LYS_AUGMENT == node->nodetype) {
+        node = ((struct lys_node_augment *)node)->target;
+    }
+
+    set = lys_xpath_atomize(node, LYXP_NODE_ELEM, expr, lyxp_opts);
+    if (NULL == set) {
+        SR_LOG_WRN("Failed to evaluate expression %s, data of module %s will be always validated completely.",
+                expr, schema_info->module_name);
+        schema_info->unbounded_constraints = true;
+        return SR_ERR_OK;
+    }
+    for (unsigned int i = 0; i < set->number && SR_ERR_OK == rc; i++) {
+        rc = dm_set_node_referenced(set->set.s[i]);
+    }
+    ly_set_free(set);
+    return rc;
+}
+
+/**
+ * @brief Marks the schema nodes referenced by the leafref paths of the type (including union members).
+ */
+static int
+dm_mark_type_references(dm_schema_info_t *schema_info, const struct lys_node *node, const struct lys_type *type)
+{
+    int rc = SR_ERR_OK;
+
+    if (LY_TYPE_LEAFREF == type->base) {
+        while (NULL == type->info.lref.path && NULL != type->der) {
+            type = &type->der->type;
+        }
+        if (NULL != type->info.lref.path) {
+            rc = dm_mark_referenced_nodes(schema_info, node, type->info.lref.path, 0);
+        }
+    } else if (LY_TYPE_UNION == type->base) {
+        while (0 == type->info.uni.count && NULL != type->der) {
+            type = &type->der->type;
+        }
+        for (int i = 0; i < type->info.uni.count && SR_ERR_OK == rc; i++) {
+            rc = dm_mark_type_references(schema_info, node, &type->info.uni.types[i]);
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief Marks the schema nodes referenced by any when, must or leafref expression in the data tree of the module
+ * (including the nodes augmented by other modules). A change of a leaf that is not referenced and has no constraints
+ * of its own can not affect validity of the rest of the data tree, see ::dm_is_change_unconstrained.
+ * Function assumes that the schema info is locked for writing or that it cannot be
+ * accessed by multiple threads at the same time.
+ *
+ * @param [in] schema_info
+ */
+static int
+dm_init_node_references(dm_schema_info_t *schema_info)
+{
+    int rc = SR_ERR_OK;
+    struct lys_node *node = NULL;
+    struct lys_when *when = NULL;
+    struct lys_restr *must = NULL;
+    size_t must_size = 0;
+    bool backtracking = false;
+    CHECK_NULL_ARG(schema_info);
+
+    node = schema_info->module->data;
+
+    while (node) {
+        if (backtracking) {
+            if (node->next) {
+                node = node->next;
+                backtracking = false;
+            } else {
+                node = node->parent;
+                if (NULL != node && LYS_AUGMENT == node->nodetype) {
+                    node = ((struct lys_node_augment *)node)->target;
+                }
+            }
+            continue;
+        }
+
+        /* nodes not instantiated in the configuration data tree */
+        if (node->nodetype & (LYS_GROUPING | LYS_RPC | LYS_ACTION | LYS_NOTIF)) {
+            backtracking = true;
+            continue;
+        }
+
+        when = NULL;
+        must = NULL;
+        must_size = 0;
+        switch (node->nodetype) {
+        case LYS_CONTAINER:
+            when = ((struct lys_node_container *)node)->when;
+            must = ((struct lys_node_container *)node)->must;
+            must_size = ((struct lys_node_container *)node)->must_size;
+            break;
+        case LYS_LIST:
+            when = ((struct lys_node_list *)node)->when;
+            must = ((struct lys_node_list *)node)->must;
+            must_size = ((struct lys_node_list *)node)->must_size;
+            break;
+        case LYS_LEAF:
+        case LYS_LEAFLIST:
+            when = ((struct lys_node_leaf *)node)->when;
+            must = ((struct lys_node_leaf *)node)->must;
+            must_size = ((struct lys_node_leaf *)node)->must_size;
+            rc = dm_mark_type_references(schema_info, node, &((struct lys_node_leaf *)node)->type);
+            break;
+        case LYS_ANYXML:
+        case LYS_ANYDATA:
+            when = ((struct lys_node_anydata *)node)->when;
+            must = ((struct lys_node_anydata *)node)->must;
+            must_size = ((struct lys_node_anydata *)node)->must_size;
+            break;
+        case LYS_CHOICE:
+            when = ((struct lys_node_choice *)node)->when;
+            break;
+        case LYS_CASE:
+            when = ((struct lys_node_case *)node)->when;
+            break;
+        case LYS_USES:
+            when = ((struct lys_node_uses *)node)->when;
+            break;
+        default:
+            break;
+        }
+        if (SR_ERR_OK == rc && NULL != when) {
+            rc = dm_mark_referenced_nodes(schema_info, node, when->cond, LYXP_WHEN);
+        }
+        for (size_t i = 0; i < must_size && SR_ERR_OK == rc; i++) {
+            rc = dm_mark_referenced_nodes(schema_info, node, must[i].expr, LYXP_MUST);
+        }
+        /* when of an augment applies to all its nodes, evaluate it once for the first one */
+        if (SR_ERR_OK == rc && NULL != node->parent && LYS_AUGMENT == node->parent->nodetype &&
+                node->parent->child == node && NULL != ((struct lys_node_augment *)node->parent)->when) {
+            rc = dm_mark_referenced_nodes(schema_info, node->parent, ((struct lys_node_augment *)node->parent)->when->cond,
+                    LYXP_WHEN);
+        }
+        if (SR_ERR_OK != rc) {
+            return rc;
+        }
+
+        if (!(node->nodetype & (LYS_LEAF | LYS_LEAFLIST | LYS_ANYDATA)) && node->child) {
+            node = node->child;
+        } else {
+            backtracking = true;
+        }
+    }
+
+    return rc;
+}
+
+bool
+dm_is_change_unconstrained(dm_schema_info_t *schema_info, const struct lys_node *node)
+{
+    const struct lys_node_leaf *leaf = NULL;
+    const struct lys_tpdf *tpdf = NULL;
+
+    if (NULL == schema_info || NULL == node || schema_info->unbounded_constraints || LYS_LEAF != node->nodetype) {
+        return false;
+    }
+    if (NULL == node->priv || ((dm_node_info_t *) node->priv)->referenced) {
+        return false;
+    }
+
+    /* constraints of the leaf itself, a leaf with a default value is re-created by the validation */
+    leaf = (const struct lys_node_leaf *) node;
+    if (NULL != leaf->when || 0 != leaf->must_size || NULL != leaf->dflt ||
+            ((LYS_MAND_TRUE | LYS_UNIQUE | LYS_CONFIG_R) & leaf->flags)) {
+        return false;
+    }
+    if (LY_TYPE_LEAFREF == leaf->type.base || LY_TYPE_INST == leaf->type.base || LY_TYPE_UNION == leaf->type.base) {
+        return false;
+    }
+    for (tpdf = leaf->type.der; NULL != tpdf; tpdf = tpdf->type.der) {
+        if (NULL != tpdf->dflt) {
+            return false;
+        }
+    }
+
+    /* the leaf must not be a part of a choice or under a conditional node */
+    node = node->parent;
+    while (NULL != node) {
+        switch (node->nodetype) {
+        case LYS_CONTAINER:
+            if (NULL != ((struct lys_node_container *)node)->when) {
+                return false;
+            }
+            break;
+        case LYS_LIST:
+            if (NULL != ((struct lys_node_list *)node)->when) {
+                return false;
+            }
+            break;
+        case LYS_USES:
+            if (NULL != ((struct lys_node_uses *)node)->when) {
+                return false;
+            }
+            break;
+        case LYS_AUGMENT:
+            if (NULL != ((struct lys_node_augment *)node)->when) {
+                return false;
+            }
+            node = ((struct lys_node_augment *)node)->target;
+            continue;
+        default:
+            return false;
+        }
+        node = node->parent;
+    }
+
+    return true;
+}
+
+void
+dm_data_info_set_modified(dm_data_info_t *info, bool unconstrained)
+{
+    CHECK_NULL_ARG_VOID(info);
+    /* the flag describes all the changes since the data tree has been loaded */
+    info->unconstrained_changes = (!info->modified || info->unconstrained_changes) && unconstrained;
+    info->modified = true;
+}
+
 /**
  * @brief Edits module private data - enables all nodes
  *
@@ -1261,6 +1666,11 @@ dm_load_module(dm_ctx_t *dm_ctx, const char *module_name, const char *revision,
     si->module_name = strdup(ly_mod->name);
     CHECK_NULL_NOMEM_GOTO(si->module_name, rc, cleanup);
     si->module = ly_mod;
+    si->versions = dm_version_table_get(dm_ctx->version_table, si->module_name);
+    si->shared_versions = NULL != si->versions;
+    if (!si->shared_versions) {
+        si->versions = &si->local_versions;
+    }
     si->has_instance_id = module->inst_ids->first != NULL;
 
     /* load the module schema and all its dependencies */
@@ -1280,6 +1690,10 @@ dm_load_module(dm_ctx_t *dm_ctx, const char *module_name, const char *revision,
     rc = dm_init_missing_node_priv_data(si);
     CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to initialize private data for module %s", module->name);
 
+    /* find the schema nodes the constraints depend on */
+    rc = dm_init_node_references(si);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to resolve constraint references in module %s", module->name);
+
     /* apply persist data enable features, running datastore */
     rc = sr_btree_init(dm_compare_modules_cb, NULL, &loaded_deps);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to init list");
@@ -1367,17 +1781,35 @@ dm_remove_added_data_trees_by_module_name(const char *module_name, struct lyd_no
     return rc;
 }
 
+/**
+ * @brief Checks whether the data file content is old enough to be cached. The file written
+ * just now could be modified again without changing its modification time.
+ */
+static bool
+dm_is_data_file_settled(const struct stat *st)
+{
+#ifdef HAVE_STAT_ST_MTIM
+    struct timespec now = {0};
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now.tv_sec != st->st_mtim.tv_sec || difftime(now.tv_nsec, st->st_mtim.tv_nsec) >= NANOSEC_THRESHOLD;
+#else
+    return false;
+#endif
+}
+
 /**
  * @brief Tries to load data tree from provided opened file.
  * @param [in] dm_ctx
  * @param [in] fd to be read from, function does not close it
  * If NULL passed data info with empty data will be created
  * @param [in] schema_info
+ * @param [in] ds datastore the data file belongs to
  * @param [in] data_info
  * @return Error code (SR_ERR_OK on success)
  */
 static int
-dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_schema_info_t *schema_info, dm_data_info_t **data_info)
+dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_schema_info_t *schema_info, sr_datastore_t ds,
+        dm_data_info_t **data_info)
 {
     CHECK_NULL_ARG4(dm_ctx, schema_info, data_filename, data_info);
     int rc = SR_ERR_OK;
@@ -1391,17 +1823,20 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
     if (-1 != fd) {
 #ifdef HAVE_STAT_ST_MTIM
         struct stat st = {0};
-        rc = stat(data_filename, &st);
-        if (-1 == rc) {
+        rc = dm_journal_stat(data_filename, fd, &st);
+        if (SR_ERR_OK != rc) {
             SR_LOG_ERR_MSG("Stat failed");
             free(data);
             return SR_ERR_INTERNAL;
         }
         data->timestamp = st.st_mtim;
+        data->timestamp_reliable = dm_is_data_file_settled(&st);
         SR_LOG_DBG("Loaded module %s: mtime sec=%lld nsec=%lld", schema_info->module->name,
                 (long long) st.st_mtim.tv_sec,
                 (long long) st.st_mtim.tv_nsec);
 #endif
+        /* a data file stored in a different format is not converted here since it is not locked for writing,
+         * it is converted once the whole file is written by a commit */
         if (schema_info->has_instance_id) {
             struct lyd_node *tmp_node = NULL;
             dm_tmp_ly_ctx_t *tmp_ctx = NULL;
@@ -1416,7 +1851,8 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
             ly_ctx_set_module_data_clb(tmp_ctx->ctx, dm_module_clb, dm_ctx);
 
             ly_errno = LY_SUCCESS;
-            tmp_node = sr_lyd_parse_fd(tmp_ctx->ctx, fd, SR_FILE_FORMAT_LY, LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG);
+            tmp_node = sr_lyd_parse_fd_any(tmp_ctx->ctx, fd, SR_FILE_FORMAT_LY,
+                    LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG, NULL);
             md_ctx_unlock(dm_ctx->md_ctx);
 
             if (NULL == tmp_node && LY_SUCCESS != ly_errno) {
@@ -1435,13 +1871,23 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
         } else {
             ly_errno = LY_SUCCESS;
             /* use LYD_OPT_TRUSTED, validation will be done later */
-            data_tree = sr_lyd_parse_fd(schema_info->ly_ctx, fd, SR_FILE_FORMAT_LY, LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG);
+            data_tree = sr_lyd_parse_fd_any(schema_info->ly_ctx, fd, SR_FILE_FORMAT_LY,
+                    LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG, NULL);
             if (NULL == data_tree && LY_SUCCESS != ly_errno) {
                 SR_LOG_ERR("Parsing data tree from file %s failed: %s", data_filename, ly_errmsg(schema_info->ly_ctx));
                 free(data);
                 return SR_ERR_INTERNAL;
             }
         }
+
+        /* apply the changes committed since the whole file has been written */
+        rc = dm_journal_replay(data_filename, fd, schema_info->ly_ctx, &data_tree);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Replaying journal of data file %s failed", data_filename);
+            lyd_free_withsiblings(data_tree);
+            free(data);
+            return rc;
+        }
     }
 
     /* if there is no data dependency validate it with of LYD_OPT_STRICT, validate it (only non-empty data trees are validated)*/
@@ -1479,7 +1925,10 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
 
     data->schema = schema_info;
     data->modified = false;
+    data->unconstrained_changes = false;
     data->node = data_tree;
+    /* the file is locked, the version can not change meanwhile */
+    data->data_version = dm_version_get(schema_info->versions, ds);
 
     /* increment counter of data tree using the module */
     pthread_mutex_lock(&schema_info->usage_count_mutex);
@@ -1499,29 +1948,300 @@ dm_load_data_tree_file(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_s
 }
 
 /**
- * @brief Loads data tree from file. Module and datastore argument are used to
- * determine the file name.
- *
- * @note Function expects that a schema info is locked for reading.
- *
- * @param [in] dm_ctx
- * @param [in] dm_session_ctx
- * @param [in] schema_info
- * @param [in] ds
- * @param [out] data_info
- * @return Error code (SR_ERR_OK on success), SR_ERR_INTERAL if the parsing of the data tree fails.
+ * @brief Returns true if the data tree of the module loaded from the datastore can be shared among the sessions.
+ * Data trees of modules with data dependencies are modified during the validation, candidate trees are private by nature.
  */
-static int
-dm_load_data_tree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, dm_data_info_t **data_info)
+static bool
+dm_data_snapshot_allowed(const dm_schema_info_t *schema_info, sr_datastore_t ds)
 {
-    CHECK_NULL_ARG4(dm_ctx, schema_info, schema_info->module, schema_info->module->name);
+    if (SR_DS_CANDIDATE == ds || schema_info->cross_module_data_dependency || schema_info->has_instance_id) {
+        return false;
+    }
+#ifdef HAVE_STAT_ST_MTIM
+    return true;
+#else
+    return schema_info->shared_versions;
+#endif
+}
 
-    char *data_filename = NULL;
-    int rc = 0;
+/**
+ * @brief Checks whether the cached data tree corresponds to the content of the data file.
+ * Unlike session copies, snapshots are never modified, so the file itself is the only thing to compare with.
+ */
+static bool
+dm_is_data_snapshot_uptodate(const dm_data_snapshot_t *snapshot, const struct stat *st)
+{
+#ifdef HAVE_STAT_ST_MTIM
+    return snapshot->timestamp.tv_sec == st->st_mtim.tv_sec && snapshot->timestamp.tv_nsec == st->st_mtim.tv_nsec &&
+            snapshot->ino == st->st_ino && snapshot->size == st->st_size;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Looks up the cached data tree of the module and returns it with a reference taken
+ * if it matches the data file. The file is checked using provided fd or by name if fd is -1.
+ *
+ * @return Referenced snapshot, NULL if there is no up to date one.
+ */
+static dm_data_snapshot_t *
+dm_acquire_data_snapshot(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, int fd, const char *data_filename)
+{
+    dm_data_snapshot_t lookup = {0}, *snapshot = NULL;
+    struct stat st = {0};
+    int ret = 0;
+
+    lookup.schema = schema_info;
+    lookup.ds = ds;
+
+    pthread_mutex_lock(&dm_ctx->data_snapshots_lock);
+    snapshot = sr_btree_search(dm_ctx->data_snapshots, &lookup);
+    if (NULL != snapshot) {
+        atomic_fetch_add(&snapshot->ref_count, 1);
+    }
+    pthread_mutex_unlock(&dm_ctx->data_snapshots_lock);
+
+    if (NULL == snapshot) {
+        return NULL;
+    }
+
+    if (schema_info->shared_versions) {
+        /* the version is incremented before each write of the data file */
+        if (snapshot->data_version != dm_version_get(schema_info->versions, ds)) {
+            dm_data_snapshot_release(snapshot);
+            return NULL;
+        }
+        atomic_fetch_add(&dm_ctx->data_cache_hit_cnt, 1);
+        return snapshot;
+    }
+
+    ret = dm_journal_stat(data_filename, fd, &st);
+    if (SR_ERR_OK != ret || !dm_is_data_snapshot_uptodate(snapshot, &st)) {
+        dm_data_snapshot_release(snapshot);
+        return NULL;
+    }
+
+    atomic_fetch_add(&dm_ctx->data_cache_hit_cnt, 1);
+    return snapshot;
+}
+
+/**
+ * @brief Creates data info referencing the snapshot, takes over the reference.
+ */
+static int
+dm_data_info_from_snapshot(dm_data_snapshot_t *snapshot, dm_data_info_t **data_info)
+{
+    dm_data_info_t *data = NULL;
+
+    data = calloc(1, sizeof(*data));
+    if (NULL == data) {
+        dm_data_snapshot_release(snapshot);
+        SR_LOG_ERR_MSG("Memory allocation failed");
+        return SR_ERR_NOMEM;
+    }
+    data->schema = snapshot->schema;
+    data->node = snapshot->node;
+    data->snapshot = snapshot;
+    data->timestamp = snapshot->timestamp;
+    data->data_version = snapshot->data_version;
+    data->timestamp_reliable = true;
+
+    /* increment counter of data tree using the module */
+    pthread_mutex_lock(&data->schema->usage_count_mutex);
+    data->schema->usage_count++;
+    SR_LOG_DBG("Usage count %s incremented (value=%zu)", data->schema->module_name, data->schema->usage_count);
+    pthread_mutex_unlock(&data->schema->usage_count_mutex);
+
+    SR_LOG_DBG("Shared data tree of module %s used", data->schema->module_name);
+    *data_info = data;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Caches the data tree corresponding to the data file described by st, replaces
+ * the cached one. If data_info is provided, it references the new snapshot too.
+ * If the snapshot can not be allocated, the data tree remains private to data_info (or is freed).
+ */
+static void
+dm_cache_data_snapshot(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, struct lyd_node *node,
+        const struct stat *st, uint64_t data_version, dm_data_info_t *data_info)
+{
+    dm_data_snapshot_t *snapshot = NULL, *cached = NULL;
+
+    snapshot = calloc(1, sizeof(*snapshot));
+    if (NULL == snapshot) {
+        if (NULL == data_info) {
+            lyd_free_withsiblings(node);
+        }
+        dm_drop_data_snapshots(dm_ctx, schema_info);
+        return;
+    }
+    snapshot->schema = schema_info;
+    snapshot->ds = ds;
+    snapshot->node = node;
+#ifdef HAVE_STAT_ST_MTIM
+    snapshot->timestamp = st->st_mtim;
+#endif
+    snapshot->ino = st->st_ino;
+    snapshot->size = st->st_size;
+    snapshot->data_version = data_version;
+    atomic_init(&snapshot->ref_count, 1);
+    if (NULL != data_info) {
+        atomic_fetch_add(&snapshot->ref_count, 1);
+        data_info->snapshot = snapshot;
+    }
+
+    pthread_mutex_lock(&dm_ctx->data_snapshots_lock);
+    cached = sr_btree_search(dm_ctx->data_snapshots, snapshot);
+    if (NULL != cached) {
+        sr_btree_delete(dm_ctx->data_snapshots, cached);
+    }
+    if (SR_ERR_OK != sr_btree_insert(dm_ctx->data_snapshots, snapshot)) {
+        /* not cached, only the data info references it */
+        dm_data_snapshot_release(snapshot);
+    }
+    pthread_mutex_unlock(&dm_ctx->data_snapshots_lock);
+}
+
+/**
+ * @brief Returns data info referencing the cached data tree of the module if it is up to date,
+ * otherwise loads the data tree from provided opened file and caches it.
+ *
+ * @note Function expects that a schema info is locked for reading and the file is locked for reading.
+ *
+ * @param [in] dm_ctx
+ * @param [in] fd to be read from, function does not close it
+ * @param [in] data_filename
+ * @param [in] schema_info
+ * @param [in] ds
+ * @param [out] data_info
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_load_data_snapshot(dm_ctx_t *dm_ctx, int fd, const char *data_filename, dm_schema_info_t *schema_info, sr_datastore_t ds, dm_data_info_t **data_info)
+{
+    CHECK_NULL_ARG4(dm_ctx, data_filename, schema_info, data_info);
+    int rc = SR_ERR_OK;
+    dm_data_snapshot_t *snapshot = NULL;
+    dm_data_info_t *data = NULL;
+    struct stat st = {0};
+
+    /* the data tree might have been loaded by another session in the meantime */
+    snapshot = dm_acquire_data_snapshot(dm_ctx, schema_info, ds, fd, data_filename);
+    if (NULL != snapshot) {
+        return dm_data_info_from_snapshot(snapshot, data_info);
+    }
+
+    atomic_fetch_add(&dm_ctx->data_cache_miss_cnt, 1);
+    rc = dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, ds, &data);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+    *data_info = data;
+
+    if (schema_info->shared_versions ||
+            (SR_ERR_OK == dm_journal_stat(data_filename, fd, &st) && dm_is_data_file_settled(&st))) {
+        dm_cache_data_snapshot(dm_ctx, schema_info, ds, data->node, &st, data->data_version, data);
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Records that the data file of the module is going to be written. Session copies and cached data trees
+ * loaded before are out of date from now on, even if the write fails or does not change the modification time of the file.
+ *
+ * @note Function expects that the file is locked for writing.
+ */
+static void
+dm_data_file_modified(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds)
+{
+    dm_version_increment(dm_ctx->version_table, schema_info->versions, ds);
+}
+
+/**
+ * @brief Checks that the data files of the datastore can be written by this process.
+ */
+static int
+dm_data_file_write_check(dm_ctx_t *dm_ctx, sr_datastore_t ds)
+{
+    if (SR_DS_CANDIDATE != ds && dm_ctx->writes_disabled) {
+        SR_LOG_ERR_MSG("Data files can not be written, the version table shared by the processes is not available.");
+        return SR_ERR_OPERATION_FAILED;
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Replaces the cached data tree of the module by a copy
+ * of the data tree that has just been written into the data file (or its journal), so that the following
+ * reads do not have to parse the file. Without the shared versions the cached tree is dropped instead,
+ * the file written just now could be modified again without changing its modification time (see ::dm_is_data_file_settled).
+ *
+ * @note Function expects that the file is locked for writing.
+ */
+static void
+dm_update_data_snapshot(dm_ctx_t *dm_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, const struct lyd_node *node,
+        const char *data_filename, int fd)
+{
+    struct lyd_node *dup = NULL;
+    struct stat st = {0};
+    uint64_t data_version = dm_version_get(schema_info->versions, ds);
+
+    if (!dm_data_snapshot_allowed(schema_info, ds)) {
+        return;
+    }
+    if (!schema_info->shared_versions &&
+            (SR_ERR_OK != dm_journal_stat(data_filename, fd, &st) || !dm_is_data_file_settled(&st))) {
+        dm_drop_data_snapshots(dm_ctx, schema_info);
+        return;
+    }
+    if (NULL != node) {
+        dup = sr_dup_datatree((struct lyd_node *) node);
+        if (NULL == dup) {
+            dm_drop_data_snapshots(dm_ctx, schema_info);
+            return;
+        }
+    }
+    dm_cache_data_snapshot(dm_ctx, schema_info, ds, dup, &st, data_version, NULL);
+}
+
+/**
+ * @brief Loads data tree from file. Module and datastore argument are used to
+ * determine the file name.
+ *
+ * @note Function expects that a schema info is locked for reading.
+ *
+ * @param [in] dm_ctx
+ * @param [in] dm_session_ctx
+ * @param [in] schema_info
+ * @param [in] ds
+ * @param [in] share - the data tree can be shared with other sessions (it will not be modified)
+ * @param [out] data_info
+ * @return Error code (SR_ERR_OK on success), SR_ERR_INTERAL if the parsing of the data tree fails.
+ */
+static int
+dm_load_data_tree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, dm_schema_info_t *schema_info, sr_datastore_t ds, bool share, dm_data_info_t **data_info)
+{
+    CHECK_NULL_ARG4(dm_ctx, schema_info, schema_info->module, schema_info->module->name);
+
+    char *data_filename = NULL;
+    int rc = 0;
     *data_info = NULL;
     rc = sr_get_data_file_name(dm_ctx->data_search_dir, schema_info->module->name, ds, &data_filename);
     CHECK_RC_LOG_RETURN(rc, "Get data_filename failed for %s", schema_info->module->name);
 
+    if (share) {
+        /* read access to the module has been already checked by the caller, the file does not have to be
+         * opened if the cached data tree is up to date */
+        dm_data_snapshot_t *snapshot = dm_acquire_data_snapshot(dm_ctx, schema_info, ds, -1, data_filename);
+        if (NULL != snapshot) {
+            free(data_filename);
+            return dm_data_info_from_snapshot(snapshot, data_info);
+        }
+    }
+
     ac_set_user_identity(dm_ctx->ac_ctx, dm_session_ctx->user_credentials);
 
     int fd = open(data_filename, O_RDWR);
@@ -1539,7 +2259,11 @@ dm_load_data_tree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, dm_schema_info
         return SR_ERR_UNAUTHORIZED;
     }
 
-    rc = dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, data_info);
+    if (share && -1 != fd) {
+        rc = dm_load_data_snapshot(dm_ctx, fd, data_filename, schema_info, ds, data_info);
+    } else {
+        rc = dm_load_data_tree_file(dm_ctx, fd, data_filename, schema_info, ds, data_info);
+    }
 
     if (-1 != fd) {
         sr_unlock_fd(fd);
@@ -1618,13 +2342,294 @@ dm_ly_log_cb(LY_LOG_LEVEL level, const char *msg, const char *path)
     }
 }
 
-int
-dm_lock_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *modul_name)
+/**
+ * @brief Lock of a data subtree held by a session (see ::dm_lock_subtree).
+ */
+typedef struct dm_subtree_lock_s {
+    dm_session_t *session;      /**< session holding the lock */
+    sr_datastore_t datastore;   /**< datastore the subtree belongs to */
+    char *module_name;          /**< name of the module the subtree belongs to */
+    char *xpath;                /**< xpath of the subtree root */
+} dm_subtree_lock_t;
+
+/**
+ * @brief Purpose of a module lock, decides how the lock is combined with the subtree locks.
+ */
+typedef enum dm_module_lock_mode_e {
+    DM_LOCK_SESSION,        /**< lock requested by the session, fails if another session holds a subtree lock in the module */
+    DM_LOCK_COMMIT,         /**< lock held by a commit until it finishes, fails if commits with subtree scope are in progress */
+    DM_LOCK_SCOPED_LOAD,    /**< lock held by a commit with subtree scope while the data file is loaded, the commit
+                             * is counted in scoped_commit_cnt of the module */
+    DM_LOCK_SCOPED_WRITE,   /**< lock held by a commit with subtree scope while the data file is written */
+} dm_module_lock_mode_t;
+
+/**
+ * @brief Splits off the first node of the xpath - its name without the module prefix and its predicates.
+ *
+ * @param [in,out] xpath Xpath, moved behind the node.
+ * @param [out] name Name of the node.
+ * @param [out] name_len Length of the name, 0 for the descendant axis.
+ * @param [out] preds Predicates of the node including the brackets.
+ * @param [out] preds_len Length of the predicates, 0 if there are none.
+ * @return False if there is no node left.
+ */
+static bool
+dm_xpath_next_node(const char **xpath, const char **name, size_t *name_len, const char **preds, size_t *preds_len)
+{
+    const char *p = *xpath;
+    char quote = 0;
+
+    if ('/' != *p) {
+        return false;
+    }
+    *name = ++p;
+    while ('\0' != *p && '/' != *p && '[' != *p) {
+        if (':' == *p) {
+            *name = p + 1;
+        }
+        p++;
+    }
+    *name_len = p - *name;
+
+    *preds = p;
+    while ('[' == *p) {
+        /* the predicate ends with the first bracket that is not quoted */
+        for (p++; '\0' != *p && (0 != quote || ']' != *p); p++) {
+            if (quote == *p) {
+                quote = 0;
+            } else if (0 == quote && ('\'' == *p || '"' == *p)) {
+                quote = *p;
+            }
+        }
+        if (']' == *p) {
+            p++;
+        }
+    }
+    *preds_len = p - *preds;
+
+    *xpath = p;
+    return true;
+}
+
+/**
+ * @brief Compares the predicates of two nodes, the kind of quotes and the whitespaces around the values are ignored.
+ */
+static bool
+dm_xpath_preds_equal(const char *a, size_t a_len, const char *b, size_t b_len)
+{
+    size_t i = 0, j = 0;
+    bool quoted = false;
+
+    while (true) {
+        if (!quoted) {
+            while (i < a_len && isspace(a[i])) {
+                i++;
+            }
+            while (j < b_len && isspace(b[j])) {
+                j++;
+            }
+        }
+        if (i == a_len || j == b_len) {
+            return i == a_len && j == b_len;
+        }
+        if (('\'' == a[i] || '"' == a[i]) && ('\'' == b[j] || '"' == b[j])) {
+            quoted = !quoted;
+        } else if (a[i] != b[j]) {
+            return false;
+        }
+        i++;
+        j++;
+    }
+}
+
+/**
+ * @brief Checks whether the node addressed by \p xpath lies in the subtree whose root is addressed by \p subtree.
+ *
+ * @param [in] subtree Xpath of the subtree root.
+ * @param [in] xpath Xpath of the node.
+ * @param [in] may True to check whether the node may lie in the subtree (the nodes addressed by any of the xpaths
+ * overlap, e.g. one is a list instance and the other is the whole list), false to check whether it certainly lies there.
+ */
+static bool
+dm_xpath_in_subtree(const char *subtree, const char *xpath, bool may)
+{
+    const char *s_name = NULL, *s_preds = NULL, *x_name = NULL, *x_preds = NULL;
+    size_t s_name_len = 0, s_preds_len = 0, x_name_len = 0, x_preds_len = 0;
+    bool s_node = false, x_node = false;
+
+    while (true) {
+        s_node = dm_xpath_next_node(&subtree, &s_name, &s_name_len, &s_preds, &s_preds_len);
+        x_node = dm_xpath_next_node(&xpath, &x_name, &x_name_len, &x_preds, &x_preds_len);
+        if (!s_node) {
+            /* the whole subtree path matched */
+            return '\0' == *subtree || may;
+        }
+        if (!x_node) {
+            /* the node is an ancestor of the subtree root */
+            return may;
+        }
+        if (0 == s_name_len || 0 == x_name_len || 0 == strncmp(s_name, "*", s_name_len) || 0 == strncmp(x_name, "*", x_name_len)) {
+            /* descendant axis or wildcard */
+            return may;
+        }
+        if (s_name_len != x_name_len || 0 != strncmp(s_name, x_name, s_name_len)) {
+            return false;
+        }
+        if (0 != s_preds_len && 0 == x_preds_len) {
+            /* all instances of the list */
+            if (!may) {
+                return false;
+            }
+        } else if (0 != s_preds_len && !dm_xpath_preds_equal(s_preds, s_preds_len, x_preds, x_preds_len)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Looks up a subtree lock held by another session in the module that overlaps with the xpath.
+ * Must be called with subtree_locks_mutex held.
+ *
+ * @param [in] dm_ctx
+ * @param [in] session Session whose own locks are ignored.
+ * @param [in] ds Datastore.
+ * @param [in] module_name Name of the module.
+ * @param [in] xpath Xpath of a node, NULL to look up any lock in the module.
+ * @return Conflicting lock, NULL if there is none.
+ */
+static dm_subtree_lock_t *
+dm_find_conflicting_subtree_lock(dm_ctx_t *dm_ctx, const dm_session_t *session, sr_datastore_t ds,
+        const char *module_name, const char *xpath)
+{
+    dm_subtree_lock_t *lock = NULL;
+
+    for (size_t i = 0; i < dm_ctx->subtree_locks->count; i++) {
+        lock = dm_ctx->subtree_locks->data[i];
+        if (lock->session == session || lock->datastore != ds || 0 != strcmp(lock->module_name, module_name)) {
+            continue;
+        }
+        if (NULL == xpath || dm_xpath_in_subtree(lock->xpath, xpath, true) || dm_xpath_in_subtree(xpath, lock->xpath, true)) {
+            return lock;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Frees the subtree lock and releases the module it references.
+ */
+static void
+dm_free_subtree_lock(dm_ctx_t *dm_ctx, dm_subtree_lock_t *lock)
+{
+    dm_schema_info_t *si = NULL;
+
+    if (NULL == lock) {
+        return;
+    }
+    if (SR_ERR_OK == dm_get_module_and_lock(dm_ctx, lock->module_name, &si)) {
+        pthread_mutex_lock(&si->usage_count_mutex);
+        si->usage_count--;
+        SR_LOG_DBG("Usage count %s decremented (value=%zu)", si->module_name, si->usage_count);
+        pthread_mutex_unlock(&si->usage_count_mutex);
+        pthread_rwlock_unlock(&si->model_lock);
+    }
+    free(lock->module_name);
+    free(lock->xpath);
+    free(lock);
+}
+
+/**
+ * @brief Releases all the subtree locks held by the session.
+ */
+static void
+dm_unlock_session_subtrees(dm_ctx_t *dm_ctx, dm_session_t *session)
+{
+    dm_subtree_lock_t *lock = NULL;
+    size_t i = 0;
+
+    if (NULL == dm_ctx->subtree_locks) {
+        return;
+    }
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    while (i < dm_ctx->subtree_locks->count) {
+        lock = dm_ctx->subtree_locks->data[i];
+        if (lock->session != session) {
+            i++;
+            continue;
+        }
+        sr_list_rm_at(dm_ctx->subtree_locks, i);
+        SR_LOG_DBG("Subtree %s unlocked", lock->xpath);
+        pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+        dm_free_subtree_lock(dm_ctx, lock);
+        pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    }
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+}
+
+/**
+ * @brief Acquires the module lock file, counts the commit with subtree scope in ::DM_LOCK_SCOPED_LOAD mode.
+ * Must be called with subtree_locks_mutex held, the lock is awaited (with the mutex released) only if it is held
+ * by a commit with subtree scope - such commits hold it only while they load or write the data file.
+ * The commits with subtree scope are flagged as the holders of the lock file until it is released
+ * by ::dm_unlock_module_file.
+ */
+static int
+dm_lock_module_file(dm_ctx_t *dm_ctx, dm_schema_info_t *si, sr_datastore_t ds, char *lock_file, dm_module_lock_mode_t mode)
+{
+    int rc = SR_ERR_OK;
+    bool wait = (DM_LOCK_SCOPED_WRITE == mode);
+
+    if (!wait) {
+        rc = dm_lock_file(dm_ctx->locking_ctx, lock_file);
+        wait = (SR_ERR_LOCKED == rc && DM_LOCK_SCOPED_LOAD == mode && si->scoped_file_locked[ds]);
+    }
+    if (DM_LOCK_SCOPED_LOAD == mode && (SR_ERR_OK == rc || wait)) {
+        /* counted before waiting, so that the module can not be locked as a whole meanwhile */
+        si->scoped_commit_cnt[ds]++;
+    }
+    if (wait) {
+        pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+        rc = sr_locking_set_lock_file_open(dm_ctx->locking_ctx, lock_file, true, true, NULL);
+        pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+        if (SR_ERR_OK != rc && DM_LOCK_SCOPED_LOAD == mode) {
+            si->scoped_commit_cnt[ds]--;
+        }
+    }
+    if (SR_ERR_OK == rc && (DM_LOCK_SCOPED_LOAD == mode || DM_LOCK_SCOPED_WRITE == mode)) {
+        si->scoped_file_locked[ds] = true;
+    }
+    return rc;
+}
+
+/**
+ * @brief Releases the module lock file acquired by ::dm_lock_module_file. The lock file can be held by one session
+ * of the process at a time, so its holder is no more a commit with subtree scope.
+ */
+static int
+dm_unlock_module_file(dm_ctx_t *dm_ctx, dm_schema_info_t *si, sr_datastore_t ds, char *lock_file)
+{
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    if (NULL != si) {
+        si->scoped_file_locked[ds] = false;
+    }
+    rc = dm_unlock_file(dm_ctx->locking_ctx, lock_file);
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+    return rc;
+}
+
+/**
+ * @brief Locks the module for the session, see ::dm_module_lock_mode_t.
+ */
+static int
+dm_lock_module_internal(dm_ctx_t *dm_ctx, dm_session_t *session, const char *modul_name, dm_module_lock_mode_t mode)
 {
     CHECK_NULL_ARG3(dm_ctx, session, modul_name);
     int rc = SR_ERR_OK;
     char *lock_file = NULL;
     dm_schema_info_t *si = NULL;
+    dm_subtree_lock_t *subtree_lock = NULL;
 
     /* check if module name is valid */
     rc = dm_get_module_and_lock(dm_ctx, modul_name, &si);
@@ -1647,22 +2652,35 @@ dm_lock_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *modul_name)
         }
     }
 
-    if (session->datastore != SR_DS_CANDIDATE) {
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    if (DM_LOCK_SESSION == mode) {
+        subtree_lock = dm_find_conflicting_subtree_lock(dm_ctx, session, session->datastore, modul_name, NULL);
+        if (NULL != subtree_lock) {
+            SR_LOG_ERR("Subtree %s of module %s is locked by another session", subtree_lock->xpath, modul_name);
+            rc = SR_ERR_LOCKED;
+        }
+    } else if (DM_LOCK_COMMIT == mode && 0 != si->scoped_commit_cnt[session->datastore]) {
+        SR_LOG_ERR("Module %s is being committed by a session holding its subtree lock", modul_name);
+        rc = SR_ERR_LOCKED;
+    }
+
+    if (SR_ERR_OK == rc && session->datastore != SR_DS_CANDIDATE) {
         /* switch identity */
         ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
 
-        rc = dm_lock_file(dm_ctx->locking_ctx, lock_file);
+        rc = dm_lock_module_file(dm_ctx, si, session->datastore, lock_file, mode);
 
         /* switch identity back */
         ac_unset_user_identity(dm_ctx->ac_ctx, session->user_credentials);
     }
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
 
     /* log information about locked model */
     if (SR_ERR_OK != rc) {
         free(lock_file);
     } else {
         rc = sr_list_add(session->locked_files, lock_file);
-        CHECK_RC_MSG_RETURN(rc, "List add failed");
+        CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
 
         pthread_mutex_lock(&si->usage_count_mutex);
         si->usage_count++;
@@ -1674,6 +2692,12 @@ cleanup:
     return rc;
 }
 
+int
+dm_lock_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *modul_name)
+{
+    return dm_lock_module_internal(dm_ctx, session, modul_name, DM_LOCK_SESSION);
+}
+
 int
 dm_unlock_module(dm_ctx_t *dm_ctx, dm_session_t *session, char *modul_name)
 {
@@ -1705,7 +2729,7 @@ dm_unlock_module(dm_ctx_t *dm_ctx, dm_session_t *session, char *modul_name)
         rc = SR_ERR_INVAL_ARG;
     } else {
         if (session->datastore != SR_DS_CANDIDATE) {
-            rc = dm_unlock_file(dm_ctx->locking_ctx, lock_file);
+            rc = dm_unlock_module_file(dm_ctx, si, session->datastore, lock_file);
         }
         free(session->locked_files->data[i]);
         sr_list_rm_at(session->locked_files, i);
@@ -1814,55 +2838,191 @@ dm_get_schema_info_by_lock_file(dm_ctx_t *dm_ctx, const char *lock_file, dm_sche
         module_name = strndup(begin, end-begin);
         CHECK_NULL_NOMEM_RETURN(module_name);
 
-        rc = dm_get_module_and_lock(dm_ctx, module_name, schema_info);
-        free(module_name);
-    } else {
-        SR_LOG_ERR("Unable to extract module name %s", lock_file);
-        rc = SR_ERR_INTERNAL;
+        rc = dm_get_module_and_lock(dm_ctx, module_name, schema_info);
+        free(module_name);
+    } else {
+        SR_LOG_ERR("Unable to extract module name %s", lock_file);
+        rc = SR_ERR_INTERNAL;
+    }
+
+    return rc;
+}
+
+int
+dm_unlock_datastore(dm_ctx_t *dm_ctx, dm_session_t *session)
+{
+    CHECK_NULL_ARG2(dm_ctx, session);
+    SR_LOG_INF_MSG("Unlock datastore request");
+    int rc = SR_ERR_OK;
+    char *file_path = NULL;
+    dm_schema_info_t *si = NULL;
+
+    while (session->locked_files->count > 0) {
+        si = NULL;
+        file_path = (char *)session->locked_files->data[0];
+        rc = dm_get_schema_info_by_lock_file(dm_ctx, file_path, &si);
+        if (SR_ERR_OK == rc) {
+            SR_LOG_DBG("Module_name %s", si->module_name);
+            pthread_mutex_lock(&si->usage_count_mutex);
+            si->usage_count--;
+            SR_LOG_DBG("Usage count %s decremented (value=%zu)", si->module_name, si->usage_count);
+            pthread_mutex_unlock(&si->usage_count_mutex);
+        } else {
+            SR_LOG_WRN("Get schema info by lock file failed %s", file_path);
+            si = NULL;
+        }
+
+        if (strlen(file_path) < 15 || 0 != strcmp(file_path + strlen(file_path) - 15, ".candidate.lock")) {
+            dm_unlock_module_file(dm_ctx, si, NULL != strstr(file_path, SR_RUNNING_FILE_EXT SR_LOCK_FILE_EXT) ?
+                    SR_DS_RUNNING : SR_DS_STARTUP, file_path);
+        }
+        if (NULL != si) {
+            pthread_rwlock_unlock(&si->model_lock);
+        }
+
+        free(session->locked_files->data[0]);
+        sr_list_rm_at(session->locked_files, 0);
+    }
+    for (int i = 0; i < DM_DATASTORE_COUNT; i++) {
+        if (session->holds_ds_lock[i]) {
+            pthread_mutex_lock(&dm_ctx->ds_lock_mutex);
+            dm_ctx->ds_lock[i] = false;
+            session->holds_ds_lock[i] = false;
+            pthread_mutex_unlock(&dm_ctx->ds_lock_mutex);
+        }
+    }
+    dm_unlock_session_subtrees(dm_ctx, session);
+    return SR_ERR_OK;
+}
+
+int
+dm_lock_subtree(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath)
+{
+    CHECK_NULL_ARG3(dm_ctx, session, xpath);
+    int rc = SR_ERR_OK;
+    char *module_name = NULL, *lock_file = NULL;
+    dm_schema_info_t *si = NULL;
+    dm_subtree_lock_t *lock = NULL, *held = NULL;
+    bool module_locked = false;
+
+    if ('/' != xpath[0] || NULL != strstr(xpath, "//") || NULL != strstr(xpath, "/*")) {
+        SR_LOG_ERR("Xpath %s does not address a single subtree", xpath);
+        return dm_report_error(session, "Only an absolute xpath without wildcards can be locked", xpath, SR_ERR_INVAL_ARG);
+    }
+
+    rc = sr_copy_first_ns(xpath, &module_name);
+    CHECK_RC_LOG_RETURN(rc, "Module name of xpath %s can not be determined", xpath);
+
+    rc = dm_get_module_and_lock(dm_ctx, module_name, &si);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Unknown module %s to lock", module_name);
+        free(module_name);
+        return rc;
+    }
+
+    if (si->can_not_be_locked) {
+        SR_LOG_DBG("Module %s contains no data, locking of its subtree is no operation.", module_name);
+        goto cleanup;
+    }
+
+    rc = sr_get_lock_data_file_name(dm_ctx->data_search_dir, module_name, session->datastore, &lock_file);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Lock file name can not be created");
+
+    for (size_t i = 0; i < session->locked_files->count; i++) {
+        if (0 == strcmp(lock_file, (char *) session->locked_files->data[i])) {
+            module_locked = true;
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    held = dm_find_conflicting_subtree_lock(dm_ctx, session, session->datastore, module_name, xpath);
+    if (NULL != held) {
+        SR_LOG_ERR("Subtree %s is locked by another session", held->xpath);
+        rc = SR_ERR_LOCKED;
+        goto unlock;
+    }
+
+    if (!module_locked && SR_DS_CANDIDATE != session->datastore) {
+        /* the module must not be locked by another session, the commits with subtree scope hold the lock file
+         * only for a short while */
+        ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
+        rc = dm_lock_file(dm_ctx->locking_ctx, lock_file);
+        if (SR_ERR_OK == rc) {
+            dm_unlock_file(dm_ctx->locking_ctx, lock_file);
+        } else if (SR_ERR_LOCKED == rc && si->scoped_file_locked[session->datastore]) {
+            rc = SR_ERR_OK;
+        }
+        ac_unset_user_identity(dm_ctx->ac_ctx, session->user_credentials);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Module %s is locked, its subtree can not be locked", module_name);
+            goto unlock;
+        }
+    }
+
+    for (size_t i = 0; i < dm_ctx->subtree_locks->count; i++) {
+        held = dm_ctx->subtree_locks->data[i];
+        if (held->session == session && held->datastore == session->datastore && 0 == strcmp(held->xpath, xpath)) {
+            SR_LOG_INF("Subtree %s is already locked by this session", xpath);
+            goto unlock;
+        }
     }
 
+    lock = calloc(1, sizeof *lock);
+    CHECK_NULL_NOMEM_GOTO(lock, rc, unlock);
+    lock->session = session;
+    lock->datastore = session->datastore;
+    lock->module_name = module_name;
+    lock->xpath = strdup(xpath);
+    CHECK_NULL_NOMEM_GOTO(lock->xpath, rc, unlock);
+
+    rc = sr_list_add(dm_ctx->subtree_locks, lock);
+    CHECK_RC_MSG_GOTO(rc, unlock, "List add failed");
+    module_name = NULL;
+    lock = NULL;
+
+    pthread_mutex_lock(&si->usage_count_mutex);
+    si->usage_count++;
+    SR_LOG_DBG("Usage count %s incremented (value=%zu)", si->module_name, si->usage_count);
+    pthread_mutex_unlock(&si->usage_count_mutex);
+
+unlock:
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+    if (NULL != lock) {
+        free(lock->xpath);
+        free(lock);
+    }
+cleanup:
+    free(module_name);
+    free(lock_file);
+    pthread_rwlock_unlock(&si->model_lock);
     return rc;
 }
 
 int
-dm_unlock_datastore(dm_ctx_t *dm_ctx, dm_session_t *session)
+dm_unlock_subtree(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath)
 {
-    CHECK_NULL_ARG2(dm_ctx, session);
-    SR_LOG_INF_MSG("Unlock datastore request");
-    int rc = SR_ERR_OK;
-    char *file_path = NULL;
-    dm_schema_info_t *si = NULL;
+    CHECK_NULL_ARG3(dm_ctx, session, xpath);
+    dm_subtree_lock_t *lock = NULL;
 
-    while (session->locked_files->count > 0) {
-        si = NULL;
-        file_path = (char *)session->locked_files->data[0];
-        rc = dm_get_schema_info_by_lock_file(dm_ctx, file_path, &si);
-        if (SR_ERR_OK == rc) {
-            SR_LOG_DBG("Module_name %s", si->module_name);
-            pthread_mutex_lock(&si->usage_count_mutex);
-            si->usage_count--;
-            SR_LOG_DBG("Usage count %s decremented (value=%zu)", si->module_name, si->usage_count);
-            pthread_mutex_unlock(&si->usage_count_mutex);
-            pthread_rwlock_unlock(&si->model_lock);
-        } else {
-            SR_LOG_WRN("Get schema info by lock file failed %s", file_path);
-        }
+    SR_LOG_INF("Unlock request subtree='%s'", xpath);
 
-        if (strlen(file_path) < 15 || 0 != strcmp(file_path + strlen(file_path) - 15, ".candidate.lock")) {
-            dm_unlock_file(dm_ctx->locking_ctx, file_path);
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    for (size_t i = 0; i < dm_ctx->subtree_locks->count; i++) {
+        lock = dm_ctx->subtree_locks->data[i];
+        if (lock->session == session && lock->datastore == session->datastore && 0 == strcmp(lock->xpath, xpath)) {
+            sr_list_rm_at(dm_ctx->subtree_locks, i);
+            break;
         }
-
-        free(session->locked_files->data[0]);
-        sr_list_rm_at(session->locked_files, 0);
+        lock = NULL;
     }
-    for (int i = 0; i < DM_DATASTORE_COUNT; i++) {
-        if (session->holds_ds_lock[i]) {
-            pthread_mutex_lock(&dm_ctx->ds_lock_mutex);
-            dm_ctx->ds_lock[i] = false;
-            session->holds_ds_lock[i] = false;
-            pthread_mutex_unlock(&dm_ctx->ds_lock_mutex);
-        }
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+
+    if (NULL == lock) {
+        SR_LOG_ERR("Subtree %s has not been locked by this session", xpath);
+        return SR_ERR_INVAL_ARG;
     }
+    dm_free_subtree_lock(dm_ctx, lock);
     return SR_ERR_OK;
 }
 
@@ -1904,22 +3064,39 @@ dm_get_node_data_depth(struct lys_node *node)
     return n_info->data_depth;
 }
 
+int
+dm_reserve_operations(dm_session_t *session, size_t count)
+{
+    CHECK_NULL_ARG(session);
+    size_t size = session->oper_size[session->datastore];
+
+    if (NULL != session->operations[session->datastore] && session->oper_count[session->datastore] + count <= size) {
+        return SR_ERR_OK;
+    }
+    if (0 == size) {
+        size = 1;
+    }
+    while (size < session->oper_count[session->datastore] + count) {
+        size *= 2;
+    }
+
+    dm_sess_op_t *tmp_op = realloc(session->operations[session->datastore], size * sizeof(*session->operations[session->datastore]));
+    CHECK_NULL_NOMEM_RETURN(tmp_op);
+    session->operations[session->datastore] = tmp_op;
+    session->oper_size[session->datastore] = size;
+
+    return SR_ERR_OK;
+}
+
 static int
 dm_alloc_operation(dm_session_t *session, dm_operation_t op, const char *xpath)
 {
     int rc = SR_ERR_OK;
     CHECK_NULL_ARG2(session, xpath);
 
-    if (NULL == session->operations[session->datastore]) {
-        session->oper_size[session->datastore] = 1;
-        session->operations[session->datastore] = calloc(session->oper_size[session->datastore], sizeof(*session->operations[session->datastore]));
-        CHECK_NULL_NOMEM_RETURN(session->operations[session->datastore]);
-    } else if (session->oper_count[session->datastore] == session->oper_size[session->datastore]) {
-        session->oper_size[session->datastore] *= 2;
-        dm_sess_op_t *tmp_op = realloc(session->operations[session->datastore], session->oper_size[session->datastore] * sizeof(*session->operations[session->datastore]));
-        CHECK_NULL_NOMEM_RETURN(tmp_op);
-        session->operations[session->datastore] = tmp_op;
-    }
+    rc = dm_reserve_operations(session, 1);
+    CHECK_RC_MSG_RETURN(rc, "Failed to allocate operation");
+
     int index = session->oper_count[session->datastore];
     session->operations[session->datastore][index].op = op;
     session->operations[session->datastore][index].has_error = false;
@@ -2136,6 +3313,12 @@ dm_is_running_ds_session(dm_session_t *session)
     return false;
 }
 
+uint32_t
+dm_get_session_trees_generation(const dm_session_t *session)
+{
+    return NULL != session ? session->trees_generation : 0;
+}
+
 /**
  * @brief Function appends data tree from different context to validate
  * cross-module reference
@@ -2155,7 +3338,7 @@ dm_append_data_tree(dm_ctx_t *dm_ctx, dm_session_t *session, dm_data_info_t *dat
     dm_data_info_t *di = NULL;
     bool must_be_freed = false;
 
-    rc = dm_get_data_info_internal(dm_ctx, session, module_name, true, &must_be_freed, &di);
+    rc = dm_get_data_info_internal(dm_ctx, session, module_name, true, true, &must_be_freed, &di);
     CHECK_RC_LOG_RETURN(rc, "Get data info failed for module %s", module_name);
 
     /* transform data from one ctx to another */
@@ -2306,6 +3489,14 @@ dm_init(ac_ctx_t *ac_ctx, np_ctx_t *np_ctx, pm_ctx_t *pm_ctx, const cm_connectio
     rc = sr_btree_init(dm_schema_info_cmp, dm_free_schema_info, &ctx->schema_info_tree);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Schema binary tree allocation failed");
 
+    rc = sr_btree_init(dm_data_snapshot_cmp, dm_data_snapshot_release, &ctx->data_snapshots);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Data snapshots binary tree allocation failed");
+
+    rc = pthread_mutex_init(&ctx->data_snapshots_lock, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "data_snapshots_lock init failed");
+    atomic_init(&ctx->data_cache_hit_cnt, 0);
+    atomic_init(&ctx->data_cache_miss_cnt, 0);
+
     rc = sr_btree_init(dm_c_ctx_id_cmp, dm_free_commit_context, &ctx->commit_ctxs.tree);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Commit context binary tree initialization failed");
 
@@ -2320,6 +3511,31 @@ dm_init(ac_ctx_t *ac_ctx, np_ctx_t *np_ctx, pm_ctx_t *pm_ctx, const cm_connectio
 
     ctx->commit_ctxs.empty = true;
 
+    rc = pthread_mutex_init(&ctx->commit_sync.mutex, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "commit_sync mutex init failed");
+
+    rc = pthread_cond_init(&ctx->commit_sync.cond, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "commit_sync cond init failed");
+
+    rc = sr_list_init(&ctx->subtree_locks);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List init failed");
+
+    rc = pthread_mutex_init(&ctx->subtree_locks_mutex, NULL);
+    CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "subtree_locks_mutex init failed");
+
+    rc = dm_helper_pool_init(SR_DM_HELPER_THREAD_COUNT, &ctx->helper_pool);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Helper pool init failed");
+
+    if (SR_ERR_OK != dm_version_table_open(ctx->data_search_dir, &ctx->version_table)) {
+        ctx->version_table = NULL;
+        ctx->writes_disabled = dm_version_table_supported();
+        if (ctx->writes_disabled) {
+            SR_LOG_WRN_MSG("The version table is not available, data files can be read but not written.");
+        } else {
+            SR_LOG_WRN_MSG("Data files will be checked for changes by their modification time.");
+        }
+    }
+
     rc = sr_str_join(schema_search_dir, "internal", &internal_schema_search_dir);
     CHECK_ZERO_MSG_GOTO(rc, rc, SR_ERR_INTERNAL, cleanup, "sr_str_join failed");
     rc = sr_str_join(data_search_dir, "internal", &internal_data_search_dir);
@@ -2369,12 +3585,27 @@ void
 dm_cleanup(dm_ctx_t *dm_ctx)
 {
     if (NULL != dm_ctx) {
+        SR_LOG_INF("Data Manager loaded %"PRIu64" data trees from the cache and %"PRIu64" from the data files.",
+                (uint64_t) atomic_load(&dm_ctx->data_cache_hit_cnt), (uint64_t) atomic_load(&dm_ctx->data_cache_miss_cnt));
         nacm_cleanup(dm_ctx->nacm_ctx);
         sr_btree_cleanup(dm_ctx->commit_ctxs.tree);
         free(dm_ctx->schema_search_dir);
         free(dm_ctx->data_search_dir);
         free(dm_ctx->ds_lock);
+        if (NULL != dm_ctx->subtree_locks) {
+            for (size_t i = 0; i < dm_ctx->subtree_locks->count; i++) {
+                dm_subtree_lock_t *lock = dm_ctx->subtree_locks->data[i];
+                free(lock->module_name);
+                free(lock->xpath);
+                free(lock);
+            }
+            sr_list_cleanup(dm_ctx->subtree_locks);
+        }
+        pthread_mutex_destroy(&dm_ctx->subtree_locks_mutex);
+        sr_btree_cleanup(dm_ctx->data_snapshots);
+        pthread_mutex_destroy(&dm_ctx->data_snapshots_lock);
         sr_btree_cleanup(dm_ctx->schema_info_tree);
+        dm_version_table_close(dm_ctx->version_table);
         md_destroy(dm_ctx->md_ctx);
         pthread_rwlock_destroy(&dm_ctx->schema_tree_lock);
         sr_locking_set_cleanup(dm_ctx->locking_ctx);
@@ -2382,6 +3613,14 @@ dm_cleanup(dm_ctx_t *dm_ctx)
         pthread_rwlock_destroy(&dm_ctx->commit_ctxs.lock);
         pthread_mutex_destroy(&dm_ctx->commit_ctxs.empty_mutex);
         pthread_cond_destroy(&dm_ctx->commit_ctxs.empty_cond);
+        dm_helper_pool_cleanup(dm_ctx->helper_pool);
+        if (NULL != dm_ctx->commit_sync.open_batch) {
+            /* files of the commits that have not waited for the flush */
+            dm_commit_sync_flush(dm_ctx->commit_sync.open_batch);
+            dm_sync_batch_free(dm_ctx->commit_sync.open_batch);
+        }
+        pthread_mutex_destroy(&dm_ctx->commit_sync.mutex);
+        pthread_cond_destroy(&dm_ctx->commit_sync.cond);
         dm_free_tmp_ly_ctx(dm_ctx->tmp_ly_ctx);
         free(dm_ctx);
     }
@@ -2662,7 +3901,7 @@ dm_requires_tmp_context(dm_ctx_t *dm_ctx, dm_session_t *session, dm_data_info_t
 
                 /* if dep has instanced id and it was inserted call recursively */
                 if (inserted && NULL != dep->dest->inst_ids->first) {
-                    rc = dm_get_data_info_internal(dm_ctx, session, dep->dest->name, true, &must_be_freed, &recursive_info);
+                    rc = dm_get_data_info_internal(dm_ctx, session, dep->dest->name, true, true, &must_be_freed, &recursive_info);
                     CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", dep->dest->name);
 
                     rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
@@ -2777,7 +4016,7 @@ dm_requires_tmp_context(dm_ctx_t *dm_ctx, dm_session_t *session, dm_data_info_t
 
                         /* if dep has instanced id and it was inserted call recursively */
                         if (inserted && NULL != dep->dest->inst_ids->first) {
-                            rc = dm_get_data_info_internal(dm_ctx, session, dep->dest->name, true, &must_be_freed, &recursive_info);
+                            rc = dm_get_data_info_internal(dm_ctx, session, dep->dest->name, true, true, &must_be_freed, &recursive_info);
                             CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", dep->dest->name);
 
                             rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
@@ -2804,7 +4043,7 @@ dm_requires_tmp_context(dm_ctx_t *dm_ctx, dm_session_t *session, dm_data_info_t
                     }
 
                     /* call recursively */
-                    rc = dm_get_data_info_internal(dm_ctx, session, inserted_namespace, true, &must_be_freed, &recursive_info);
+                    rc = dm_get_data_info_internal(dm_ctx, session, inserted_namespace, true, true, &must_be_freed, &recursive_info);
                     CHECK_RC_LOG_GOTO(rc, cleanup, "Get data info failed for %s", inserted_namespace);
 
                     rc = dm_requires_tmp_context(dm_ctx, session, recursive_info, required_data, required_modules);
@@ -2895,7 +4134,7 @@ dm_validate_data_info(dm_ctx_t *dm_ctx, dm_session_t *session, dm_data_info_t *i
             /* retrieve all required data */
             for (size_t i = 0; i < required_data->count; i++) {
                 SR_LOG_DBG("To pass the validation of '%s' data from module %s is needed", info->schema->module_name, (char *) required_data->data[i]);
-                rc = dm_get_data_info_internal(dm_ctx, session, (char *) required_data->data[i], true, &should_be_freed[i], &dep_di);
+                rc = dm_get_data_info_internal(dm_ctx, session, (char *) required_data->data[i], true, true, &should_be_freed[i], &dep_di);
                 CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get data infor for module %s", (char *) required_data->data[i]);
 
                 rc = sr_list_add(data_for_validation, dep_di);
@@ -2963,13 +4202,15 @@ cleanup:
 
 /**
  * @note if skip_validation is false, must_be_freed will not be set to true
+ * @note if rdonly is false, the returned data tree is not shared with other sessions and can be modified
  */
 static int
-dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, bool skip_validation, bool *must_be_freed, dm_data_info_t **info)
+dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, bool skip_validation, bool rdonly, bool *must_be_freed, dm_data_info_t **info)
 {
     int rc = SR_ERR_OK;
     dm_data_info_t *exisiting_data_info = NULL;
     dm_schema_info_t *schema_info = NULL;
+    bool share = false;
 
     rc = dm_get_module_and_lock(dm_ctx, module_name, &schema_info);
     CHECK_RC_LOG_RETURN(rc, "Get module '%s' failed", module_name);
@@ -2983,15 +4224,22 @@ dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const
     }
 
     if (NULL != exisiting_data_info) {
+        if (!rdonly && NULL != exisiting_data_info->snapshot) {
+            dm_session_trees_replaced(dm_session_ctx);
+            rc = dm_data_info_make_private(exisiting_data_info);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to make a private copy of %s data tree", module_name);
+        }
         *info = exisiting_data_info;
         SR_LOG_DBG("Module %s already loaded", module_name);
         goto cleanup;
     }
 
+    share = rdonly && dm_data_snapshot_allowed(schema_info, dm_session_ctx->datastore);
+
     /* session copy not found load it from file system */
     dm_data_info_t *di = NULL;
     if (SR_DS_CANDIDATE == dm_session_ctx->datastore) {
-        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, SR_DS_RUNNING, &di);
+        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, SR_DS_RUNNING, false, &di);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Getting data tree for %s failed.", module_name);
         rc = dm_remove_not_enabled_nodes(di);
         if (SR_ERR_OK != rc) {
@@ -3001,7 +4249,7 @@ dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const
         }
     }
     else {
-        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, dm_session_ctx->datastore, &di);
+        rc = dm_load_data_tree(dm_ctx, dm_session_ctx, schema_info, dm_session_ctx->datastore, share, &di);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Getting data tree for %s failed.", module_name);
     }
 
@@ -3016,6 +4264,10 @@ dm_get_data_info_internal(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const
             }
         }
         /* we do not insert data_info_t if it was loaded only as auxiliary cause of validation */
+        if (!di->schema->shared_versions) {
+            /* the copy can be checked only by the modification time */
+            dm_session_copies_unchecked(dm_session_ctx, dm_session_ctx->datastore);
+        }
         rc = sr_btree_insert(dm_session_ctx->session_modules[dm_session_ctx->datastore], (void *) di);
         if (SR_ERR_OK != rc) {
             SR_LOG_ERR("Insert into session avl failed module %s", module_name);
@@ -3043,7 +4295,25 @@ int
 dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info)
 {
     CHECK_NULL_ARG4(dm_ctx, dm_session_ctx, module_name, info);
-    return dm_get_data_info_internal(dm_ctx, dm_session_ctx, module_name, false, NULL, info);
+    return dm_get_data_info_internal(dm_ctx, dm_session_ctx, module_name, false, false, NULL, info);
+}
+
+int
+dm_get_data_info_rdonly(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info)
+{
+    CHECK_NULL_ARG4(dm_ctx, dm_session_ctx, module_name, info);
+    return dm_get_data_info_internal(dm_ctx, dm_session_ctx, module_name, false, true, NULL, info);
+}
+
+int
+dm_get_stats(dm_ctx_t *dm_ctx, dm_stats_t *stats)
+{
+    CHECK_NULL_ARG2(dm_ctx, stats);
+
+    stats->data_cache_hit_cnt = atomic_load(&dm_ctx->data_cache_hit_cnt);
+    stats->data_cache_miss_cnt = atomic_load(&dm_ctx->data_cache_miss_cnt);
+
+    return SR_ERR_OK;
 }
 
 int
@@ -3052,7 +4322,7 @@ dm_get_datatree(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *modu
     CHECK_NULL_ARG4(dm_ctx, dm_session_ctx, module_name, data_tree);
     int rc = SR_ERR_OK;
     dm_data_info_t *info = NULL;
-    rc = dm_get_data_info(dm_ctx, dm_session_ctx, module_name, &info);
+    rc = dm_get_data_info_rdonly(dm_ctx, dm_session_ctx, module_name, &info);
     CHECK_RC_LOG_RETURN(rc, "Get data info failed for module %s", module_name);
     *data_tree = info->node;
     if (NULL == info->node) {
@@ -3488,7 +4758,7 @@ dm_validate_module_inv_data_deps(dm_ctx_t *dm_ctx, dm_session_t *session, sr_err
         if (dep->type != MD_DEP_DATA || !dep->dest->has_data) {
             continue;
         }
-        rc = dm_get_data_info_internal(dm_ctx, session, dep->dest->name, true, &must_free_info, &info);
+        rc = dm_get_data_info_internal(dm_ctx, session, dep->dest->name, true, false, &must_free_info, &info);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to load data info for %s", dep->dest->name);
 
         /* The dependent data has changed, so leaf refs might not be valid anymore */
@@ -3513,6 +4783,73 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Validation of a module that does not depend on data of other modules,
+ * processed by the helper pool.
+ */
+typedef struct dm_validate_task_s {
+    dm_ctx_t *dm_ctx;           /**< Data Manager context */
+    dm_session_t *session;      /**< session the data tree belongs to */
+    dm_data_info_t *info;       /**< data tree to be validated */
+    int rc;                     /**< result of the validation */
+    sr_error_info_t *errors;    /**< validation errors */
+    size_t err_cnt;             /**< number of validation errors */
+} dm_validate_task_t;
+
+/**
+ * @brief Validates one module, called by the helper pool. The errors are recorded in the task
+ * since the libyang error information is thread specific.
+ */
+static void
+dm_validate_task(void *arg)
+{
+    dm_validate_task_t *task = (dm_validate_task_t *) arg;
+
+    if (task->info->unconstrained_changes) {
+        /* the values of the modified leaves have been validated when set and nothing else depends on them */
+        SR_LOG_DBG("Validation of '%s' module skipped, only unconstrained leaves were modified", task->info->schema->module_name);
+        task->rc = SR_ERR_OK;
+        return;
+    }
+    task->rc = dm_validate_data_info(task->dm_ctx, task->session, task->info);
+    if (SR_ERR_OK != task->rc) {
+        dm_record_errors(task->rc, &task->errors, &task->err_cnt, task->info);
+    }
+}
+
+/**
+ * @brief Checks whether the data tree of the module can be validated on its own, i.e. no data from other modules
+ * are attached to it and no other module references its data (see module dependencies). Such data trees
+ * use only the libyang context of the module and can be validated in parallel.
+ */
+static bool
+dm_is_validation_independent(dm_ctx_t *dm_ctx, const dm_data_info_t *info)
+{
+    md_module_t *module = NULL;
+    sr_llist_node_t *ll_node = NULL;
+    md_dep_t *dep = NULL;
+    bool independent = true;
+
+    if (info->schema->has_instance_id || info->schema->cross_module_data_dependency) {
+        return false;
+    }
+
+    md_ctx_lock(dm_ctx->md_ctx, false);
+    if (SR_ERR_OK != md_get_module_info(dm_ctx->md_ctx, info->schema->module_name, NULL, NULL, &module)) {
+        independent = false;
+    } else {
+        for (ll_node = module->inv_deps->first; NULL != ll_node && independent; ll_node = ll_node->next) {
+            dep = (md_dep_t *) ll_node->data;
+            if (MD_DEP_DATA == dep->type && dep->dest->has_data) {
+                independent = false;
+            }
+        }
+    }
+    md_ctx_unlock(dm_ctx->md_ctx);
+
+    return independent;
+}
+
 int
 dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error_info_t **errors, size_t *err_cnt)
 {
@@ -3525,6 +4862,8 @@ dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error
     sr_llist_t *session_modules = NULL;
     sr_llist_node_t *node = NULL;
     bool validation_failed = false;
+    dm_validate_task_t *tasks = NULL;
+    size_t task_cnt = 0, t = 0;
 
     rc = sr_llist_init(&session_modules);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Cannot initialize temporary linked-list for session modules.");
@@ -3535,11 +4874,42 @@ dm_validate_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_error
         cnt++;
     }
 
+    if (0 == cnt) {
+        goto cleanup;
+    }
+
+    /* validate the modules independent of the other modules in parallel */
+    tasks = calloc(cnt, sizeof *tasks);
+    CHECK_NULL_NOMEM_GOTO(tasks, rc, cleanup);
+    for (node = session_modules->first; NULL != node; node = node->next) {
+        info = (dm_data_info_t *)node->data;
+        if (info->modified && dm_is_validation_independent(dm_ctx, info)) {
+            tasks[task_cnt].dm_ctx = dm_ctx;
+            tasks[task_cnt].session = session;
+            tasks[task_cnt].info = info;
+            task_cnt++;
+        }
+    }
+    rc = dm_helper_pool_run(dm_ctx->helper_pool, dm_validate_task, tasks, sizeof *tasks, task_cnt);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Parallel validation failed");
+
+    /* the modules depending on the data of other modules are validated one by one,
+     * the errors are reported in the order of the modules */
     node = session_modules->first;
     while (NULL != node) {
         info = (dm_data_info_t *)node->data;
-        /* loaded data trees are valid, so check only the modified ones */
-        if (info->modified) {
+        if (t < task_cnt && tasks[t].info == info) {
+            if (SR_ERR_OK != tasks[t].rc) {
+                for (size_t i = 0; i < tasks[t].err_cnt; i++) {
+                    if (SR_ERR_OK != sr_add_error(errors, err_cnt, tasks[t].errors[i].xpath, "%s", tasks[t].errors[i].message)) {
+                        SR_LOG_WRN_MSG("Failed to record validation error");
+                    }
+                }
+                validation_failed = true;
+            }
+            t++;
+        } else if (info->modified) {
+            /* loaded data trees are valid, so check only the modified ones */
             rc = dm_validate_data_info(dm_ctx, session, info);
             if (rc != SR_ERR_OK) {
                 dm_record_errors(rc, errors, err_cnt, info);
@@ -3559,6 +4929,10 @@ cleanup:
     if (validation_failed) {
         rc = SR_ERR_VALIDATION_FAILED;
     }
+    for (size_t i = 0; i < task_cnt; i++) {
+        sr_free_errors(tasks[i].errors, tasks[i].err_cnt);
+    }
+    free(tasks);
     sr_llist_cleanup(session_modules);
     return rc;
 }
@@ -3570,6 +4944,7 @@ dm_discard_changes(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_n
     int rc = SR_ERR_OK, i;
     dm_data_info_t *info = NULL;
 
+    dm_session_trees_replaced(session);
     if (NULL == module_name) {
         sr_btree_cleanup(session->session_modules[session->datastore]);
         session->session_modules[session->datastore] = NULL;
@@ -3613,6 +4988,7 @@ dm_remove_modified_flag(dm_session_t* session)
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], cnt))) {
         /* remove modified flag */
         info->modified = false;
+        info->unconstrained_changes = false;
         cnt++;
     }
     return rc;
@@ -3628,36 +5004,58 @@ dm_remove_session_operations(dm_session_t *session)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Checks whether the session copy of the data tree still corresponds to the content of the data file.
+ * If the versions of the data files are shared by all the processes, the copy is up to date if the version
+ * did not change since the copy has been loaded. Otherwise the data file must not have been written by this process
+ * since then (data version) and its modification time must not have changed.
+ *
+ * @note Function expects that the file is locked unless the versions are shared.
+ *
+ * @param [in] dm_ctx
+ * @param [in] file_name
+ * @param [in] ds datastore the data file belongs to
+ * @param [in] info session copy
+ * @param [out] res
+ * @return Error code (SR_ERR_OK on success)
+ */
 static int
-dm_is_info_copy_uptodate(dm_ctx_t *dm_ctx, const char *file_name, const dm_data_info_t *info, bool *res)
+dm_is_info_copy_uptodate(dm_ctx_t *dm_ctx, const char *file_name, sr_datastore_t ds, const dm_data_info_t *info, bool *res)
 {
     CHECK_NULL_ARG4(dm_ctx, file_name, info, res);
     int rc = SR_ERR_OK;
+    uint64_t data_version = dm_version_get(info->schema->versions, ds);
+
+    if (info->schema->shared_versions) {
+        /* each write of the data file increments the version first */
+        *res = info->data_version == data_version;
+        if (!*res) {
+            SR_LOG_DBG("Module %s will be refreshed (version %"PRIu64" -> %"PRIu64")", info->schema->module->name,
+                    info->data_version, data_version);
+        }
+        return rc;
+    }
 #ifdef HAVE_STAT_ST_MTIM
     struct stat st = {0};
-    rc = stat(file_name, &st);
-    if (-1 == rc) {
+    rc = dm_journal_stat(file_name, -1, &st);
+    if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("Stat failed");
         return SR_ERR_INTERNAL;
     }
-    struct timespec now;
-    clock_gettime(CLOCK_REALTIME, &now);
-    SR_LOG_DBG("Session copy %s: mtime sec=%lld nsec=%lld", info->schema->module->name,
+    SR_LOG_DBG("Session copy %s: mtime sec=%lld nsec=%lld version=%"PRIu64, info->schema->module->name,
             (long long) info->timestamp.tv_sec,
-            (long long) info->timestamp.tv_nsec);
-    SR_LOG_DBG("Loaded module %s: mtime sec=%lld nsec=%lld", info->schema->module->name,
+            (long long) info->timestamp.tv_nsec,
+            info->data_version);
+    SR_LOG_DBG("Loaded module %s: mtime sec=%lld nsec=%lld version=%"PRIu64, info->schema->module->name,
             (long long) st.st_mtim.tv_sec,
-            (long long) st.st_mtim.tv_nsec);
-    SR_LOG_DBG("Current time: mtime sec=%lld nsec=%lld",
-            (long long) now.tv_sec,
-            (long long) now.tv_nsec);
-    /* check if we should update session copy conditions
-     * is the negation of the optimized commit */
-    if (info->timestamp.tv_sec != st.st_mtim.tv_sec ||
+            (long long) st.st_mtim.tv_nsec,
+            data_version);
+    /* the modification time can be relied on only if the file could not be written again
+     * within the same time tick after the copy has been loaded */
+    if (info->data_version != data_version ||
+            !info->timestamp_reliable ||
+            info->timestamp.tv_sec != st.st_mtim.tv_sec ||
             info->timestamp.tv_nsec != st.st_mtim.tv_nsec ||
-            (now.tv_sec == st.st_mtim.tv_sec && difftime(now.tv_nsec, st.st_mtim.tv_nsec) < NANOSEC_THRESHOLD) ||
-            info->timestamp.tv_sec < dm_ctx->last_commit_time.tv_sec ||
-            (info->timestamp.tv_sec == dm_ctx->last_commit_time.tv_sec && info->timestamp.tv_nsec <= dm_ctx->last_commit_time.tv_nsec) ||
             info->timestamp.tv_nsec == 0) {
         SR_LOG_DBG("Module %s will be refreshed", info->schema->module->name);
         *res = false;
@@ -3682,47 +5080,67 @@ dm_update_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_list_t
     dm_data_info_t *info = NULL;
     size_t i = 0;
     sr_list_t *to_be_refreshed = NULL, *up_to_date = NULL;
+    uint64_t commit_cnt = 0;
+    bool unchanged = false, all_checked = NULL != dm_ctx->version_table;
     rc = sr_list_init(&to_be_refreshed);
     CHECK_RC_MSG_GOTO(rc, cleanup, "List init failed");
 
     rc = sr_list_init(&up_to_date);
     CHECK_RC_MSG_GOTO(rc, cleanup, "List init failed");
 
+    if (NULL != dm_ctx->version_table) {
+        /* read before the copies are checked, a write done meanwhile is caught by the next check */
+        commit_cnt = dm_version_table_commit_cnt(dm_ctx->version_table, NULL);
+        unchanged = session->copies_checked[session->datastore] &&
+                commit_cnt == session->checked_commit_cnt[session->datastore];
+    }
+
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
-        rc = sr_get_data_file_name(dm_ctx->data_search_dir,
-                info->schema->module->name,
-                SR_DS_CANDIDATE == session->datastore ? SR_DS_RUNNING : session->datastore,
-                &file_name);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Get data file name failed");
-        ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
-        fd = open(file_name, O_RDONLY);
-        ac_unset_user_identity(dm_ctx->ac_ctx, session->user_credentials);
+        bool copy_uptodate = false;
+        if (unchanged) {
+            /* no data file has been written by any process since all the copies have been found up to date */
+            copy_uptodate = true;
+        } else if (info->schema->shared_versions) {
+            /* no need to open the data file, a writer increments the version before modifying it */
+            copy_uptodate = info->data_version == dm_version_get(info->schema->versions,
+                    SR_DS_CANDIDATE == session->datastore ? SR_DS_RUNNING : session->datastore);
+        } else {
+            /* the copy can not be trusted to remain up to date based on the commit count */
+            all_checked = false;
+            rc = sr_get_data_file_name(dm_ctx->data_search_dir,
+                    info->schema->module->name,
+                    SR_DS_CANDIDATE == session->datastore ? SR_DS_RUNNING : session->datastore,
+                    &file_name);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Get data file name failed");
+            ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
+            fd = open(file_name, O_RDONLY);
+            ac_unset_user_identity(dm_ctx->ac_ctx, session->user_credentials);
 
-        if (-1 == fd) {
-            SR_LOG_DBG("File %s can not be opened for read write", file_name);
-            if (EACCES == errno) {
-                SR_LOG_WRN("File %s can not be opened because of authorization", file_name);
-            } else if (ENOENT == errno) {
-                SR_LOG_DBG("File %s does not exist, trying to create an empty one", file_name);
+            if (-1 == fd) {
+                SR_LOG_DBG("File %s can not be opened for read write", file_name);
+                if (EACCES == errno) {
+                    SR_LOG_WRN("File %s can not be opened because of authorization", file_name);
+                } else if (ENOENT == errno) {
+                    SR_LOG_DBG("File %s does not exist, trying to create an empty one", file_name);
+                }
+                /* skip data trees that was not successfully opened */
+                free(file_name);
+                file_name = NULL;
+                continue;
             }
-            /* skip data trees that was not successfully opened */
-            free(file_name);
-            file_name = NULL;
-            continue;
-        }
 
-        /* lock for read, blocking - guards access to the file among processes.
-         * Inside the process access to data files is protected by commit_lock in rp.
-         * Each request that might need to read data file locks it for read at the beginning
-         * of request processing. */
-        rc = sr_lock_fd(fd, false, true);
+            /* lock for read, blocking - guards access to the file among processes.
+             * Inside the process access to data files is protected by commit_lock in rp.
+             * Each request that might need to read data file locks it for read at the beginning
+             * of request processing. */
+            rc = sr_lock_fd(fd, false, true);
 
-        bool copy_uptodate = false;
-        rc = dm_is_info_copy_uptodate(dm_ctx, file_name, info, &copy_uptodate);
-        if (SR_ERR_OK != rc) {
-            SR_LOG_ERR_MSG("File up to date check failed");
+            rc = dm_is_info_copy_uptodate(dm_ctx, file_name,
+                    SR_DS_CANDIDATE == session->datastore ? SR_DS_RUNNING : session->datastore, info, &copy_uptodate);
+            free(file_name);
+            file_name = NULL;
             close(fd);
-            goto cleanup;
+            CHECK_RC_MSG_GOTO(rc, cleanup, "File up to date check failed");
         }
 
         if (copy_uptodate) {
@@ -3733,17 +5151,16 @@ dm_update_session_data_trees(dm_ctx_t *dm_ctx, dm_session_t *session, sr_list_t
             SR_LOG_DBG("Module %s will be refreshed", info->schema->module->name);
             rc = sr_list_add(to_be_refreshed, info);
         }
-        free(file_name);
-        file_name = NULL;
-        close(fd);
-
         CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
-
     }
 
     for (i = 0; i < to_be_refreshed->count; i++) {
         sr_btree_delete(session->session_modules[session->datastore], to_be_refreshed->data[i]);
+        dm_session_trees_replaced(session);
     }
+    /* the remaining copies are up to date */
+    session->copies_checked[session->datastore] = all_checked;
+    session->checked_commit_cnt[session->datastore] = commit_cnt;
 
 cleanup:
     sr_list_cleanup(to_be_refreshed);
@@ -3992,6 +5409,28 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Stops counting the commit among the commits with subtree scope of its modules.
+ */
+static void
+dm_commit_release_scoped_models(dm_commit_context_t *c_ctx)
+{
+    dm_ctx_t *dm_ctx = NULL;
+
+    if (NULL == c_ctx->scoped_schemas || NULL == c_ctx->session) {
+        return;
+    }
+    dm_ctx = c_ctx->session->dm_ctx;
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    for (size_t i = 0; i < c_ctx->scoped_size; i++) {
+        if (NULL != c_ctx->scoped_schemas[i]) {
+            c_ctx->scoped_schemas[i]->scoped_commit_cnt[c_ctx->session->datastore]--;
+            c_ctx->scoped_schemas[i] = NULL;
+        }
+    }
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+}
+
 void
 dm_free_commit_context(void *commit_ctx)
 {
@@ -4000,6 +5439,9 @@ dm_free_commit_context(void *commit_ctx)
         for (size_t i = 0; i < c_ctx->modif_count; i++) {
             close(c_ctx->fds[i]);
         }
+        dm_commit_release_scoped_models(c_ctx);
+        free(c_ctx->scoped_schemas);
+        free(c_ctx->loaded_versions);
         pthread_mutex_destroy(&c_ctx->mutex);
         free(c_ctx->fds);
         free(c_ctx->existed);
@@ -4028,6 +5470,9 @@ dm_free_commit_context(void *commit_ctx)
         if (NULL != c_ctx->backup_session) {
             dm_session_stop(c_ctx->backup_session->dm_ctx, c_ctx->backup_session);
         }
+        if (NULL != c_ctx->sync_batch) {
+            dm_commit_sync_wait(c_ctx->sync_batch);
+        }
         free(c_ctx);
     }
 }
@@ -4102,6 +5547,7 @@ dm_release_resources_commit_context(dm_ctx_t *dm_ctx, dm_commit_context_t *c_ctx
     c_ctx->fds = NULL;
     c_ctx->existed = NULL;
     c_ctx->modif_count = 0;
+    dm_commit_release_scoped_models(c_ctx);
 
     dm_unlock_datastore(dm_ctx, c_ctx->session);
 
@@ -4207,6 +5653,12 @@ dm_commit_prepare_context(dm_ctx_t *dm_ctx, dm_session_t *session, dm_commit_con
     c_ctx->existed = calloc(c_ctx->modif_count, sizeof(*c_ctx->existed));
     CHECK_NULL_NOMEM_GOTO(c_ctx->existed, rc, cleanup);
 
+    c_ctx->scoped_schemas = calloc(c_ctx->modif_count, sizeof(*c_ctx->scoped_schemas));
+    CHECK_NULL_NOMEM_GOTO(c_ctx->scoped_schemas, rc, cleanup);
+    c_ctx->loaded_versions = calloc(c_ctx->modif_count, sizeof(*c_ctx->loaded_versions));
+    CHECK_NULL_NOMEM_GOTO(c_ctx->loaded_versions, rc, cleanup);
+    c_ctx->scoped_size = c_ctx->modif_count;
+
     /* create commit session */
     rc = dm_session_start(dm_ctx, session->user_credentials, session->datastore, &c_ctx->session);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Commit session initialization failed");
@@ -4264,18 +5716,126 @@ dm_commit_load_session_module_deps(dm_ctx_t *dm_ctx, dm_session_t *session)
     size_t i = 0;
     int rc = SR_ERR_OK;
 
-    i = 0;
-    while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
-        if (!info->modified) {
+    i = 0;
+    while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
+        if (!info->modified) {
+            continue;
+        }
+
+        /* get the list of required modules */
+        rc = dm_requires_tmp_context(dm_ctx, session, info, NULL, &info->required_modules);
+        CHECK_RC_LOG_RETURN(rc, "Failed to get module dependencies of '%s'.", info->schema->module->name);
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Checks that the changes of the commit do not touch the subtrees locked by other sessions.
+ *
+ * @param [in] whole_modules True if the modified modules are committed as a whole (copy-config),
+ * otherwise the operations of the session are checked.
+ */
+static int
+dm_commit_check_subtree_locks(dm_ctx_t *dm_ctx, const dm_session_t *session, dm_commit_context_t *c_ctx,
+        bool whole_modules, sr_error_info_t **errors, size_t *err_cnt)
+{
+    dm_data_info_t *info = NULL;
+    dm_subtree_lock_t *lock = NULL;
+    dm_sess_op_t *op = NULL;
+    size_t i = 0;
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    while (0 != dm_ctx->subtree_locks->count && NULL == lock &&
+            NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
+        if (!info->modified) {
+            continue;
+        }
+        if (whole_modules) {
+            lock = dm_find_conflicting_subtree_lock(dm_ctx, session, session->datastore, info->schema->module_name, NULL);
+            continue;
+        }
+        for (size_t o = 0; NULL == lock && o < c_ctx->oper_count; o++) {
+            op = &c_ctx->operations[o];
+            if (!op->has_error && 0 == sr_cmp_first_ns(op->xpath, info->schema->module_name)) {
+                lock = dm_find_conflicting_subtree_lock(dm_ctx, session, session->datastore, info->schema->module_name,
+                        op->xpath);
+            }
+        }
+    }
+    if (NULL != lock) {
+//! @cond doxygen_suppress
+#define ERR_FMT "Subtree %s is locked by another session"
+//! @endcond
+        if (SR_ERR_OK != sr_add_error(errors, err_cnt, lock->xpath, ERR_FMT, lock->xpath)) {
+            SR_LOG_WRN_MSG("Failed to record commit operation error");
+        }
+        SR_LOG_ERR(ERR_FMT, lock->xpath);
+        rc = SR_ERR_LOCKED;
+#undef ERR_FMT
+    }
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
+
+    return rc;
+}
+
+/**
+ * @brief Decides whether the module can be committed with subtree scope - the committing session holds subtree locks
+ * in the module (but not the module lock) and all the operations in the module lie in the locked subtrees. Moves are
+ * not scoped, they change the order of the siblings.
+ *
+ * A commit with subtree scope does not keep the module locked while the commit is validated and verified, it locks
+ * the data file again only to write it. The commits of one Request Processor are still serialized by its commit lock,
+ * the data file can be written in the meantime only by another process (e.g. a library-mode application).
+ */
+static bool
+dm_commit_is_subtree_scoped(dm_ctx_t *dm_ctx, const dm_session_t *session, dm_commit_context_t *c_ctx, dm_schema_info_t *si)
+{
+    dm_subtree_lock_t *lock = NULL;
+    dm_sess_op_t *op = NULL;
+    char *lock_file = NULL;
+    bool held = false, scoped = true, in_subtree = false;
+
+    if (SR_DS_CANDIDATE == session->datastore || !si->shared_versions) {
+        /* the concurrent writes of the data file by other processes could not be detected */
+        return false;
+    }
+
+    if (SR_ERR_OK != sr_get_lock_data_file_name(dm_ctx->data_search_dir, si->module_name, session->datastore, &lock_file)) {
+        return false;
+    }
+    for (size_t i = 0; i < session->locked_files->count; i++) {
+        if (0 == strcmp(lock_file, (char *) session->locked_files->data[i])) {
+            /* the module lock of the session is used */
+            scoped = false;
+            break;
+        }
+    }
+    free(lock_file);
+
+    pthread_mutex_lock(&dm_ctx->subtree_locks_mutex);
+    for (size_t i = 0; scoped && !held && i < dm_ctx->subtree_locks->count; i++) {
+        lock = dm_ctx->subtree_locks->data[i];
+        held = (lock->session == session && lock->datastore == session->datastore &&
+                0 == strcmp(lock->module_name, si->module_name));
+    }
+    for (size_t o = 0; held && scoped && o < c_ctx->oper_count; o++) {
+        op = &c_ctx->operations[o];
+        if (op->has_error || 0 != sr_cmp_first_ns(op->xpath, si->module_name)) {
             continue;
         }
-
-        /* get the list of required modules */
-        rc = dm_requires_tmp_context(dm_ctx, session, info, NULL, &info->required_modules);
-        CHECK_RC_LOG_RETURN(rc, "Failed to get module dependencies of '%s'.", info->schema->module->name);
+        in_subtree = false;
+        for (size_t i = 0; DM_MOVE_OP != op->op && !in_subtree && i < dm_ctx->subtree_locks->count; i++) {
+            lock = dm_ctx->subtree_locks->data[i];
+            in_subtree = (lock->session == session && lock->datastore == session->datastore &&
+                    0 == strcmp(lock->module_name, si->module_name) && dm_xpath_in_subtree(lock->xpath, op->xpath, false));
+        }
+        scoped = in_subtree;
     }
+    pthread_mutex_unlock(&dm_ctx->subtree_locks_mutex);
 
-    return SR_ERR_OK;
+    return held && scoped;
 }
 
 int
@@ -4292,17 +5852,37 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
     char *file_name = NULL;
     c_ctx->modif_count = 0; /* how many file descriptors should be closed on cleanup */
 
+    rc = dm_data_file_write_check(dm_ctx, session->datastore);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
+    rc = dm_commit_check_subtree_locks(dm_ctx, session, c_ctx, force_copy_uptodate, errors, err_cnt);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
     /* lock models that should be committed */
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
         if (!info->modified) {
             continue;
         }
-        rc = dm_lock_module(dm_ctx, c_ctx->session, info->schema->module->name);
-        if (SR_ERR_LOCKED == rc) {
-            /* check if the lock is hold by session that issued commit */
-            rc = dm_lock_module(dm_ctx, (dm_session_t *)session, info->schema->module->name);
+        if (!force_copy_uptodate && dm_commit_is_subtree_scoped(dm_ctx, session, c_ctx, info->schema)) {
+            /* the module is locked only until it is loaded, not during the validation and verification */
+            rc = dm_lock_module_internal(dm_ctx, c_ctx->session, info->schema->module->name, DM_LOCK_SCOPED_LOAD);
+            if (SR_ERR_OK == rc) {
+                SR_LOG_DBG("Module %s is committed with subtree scope", info->schema->module->name);
+                c_ctx->scoped_schemas[count] = info->schema;
+            }
+        } else {
+            rc = dm_lock_module_internal(dm_ctx, c_ctx->session, info->schema->module->name, DM_LOCK_COMMIT);
+            if (SR_ERR_LOCKED == rc) {
+                /* check if the lock is hold by session that issued commit */
+                rc = dm_lock_module_internal(dm_ctx, (dm_session_t *)session, info->schema->module->name, DM_LOCK_COMMIT);
+            }
         }
         CHECK_RC_LOG_RETURN(rc, "Module %s can not be locked", info->schema->module->name);
+        count++;
         if (SR_DS_RUNNING == session->datastore) {
             /* check if all subtrees are enabled */
             bool has_not_enabled = true;
@@ -4325,6 +5905,7 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
     ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
 
     i = 0;
+    count = 0;
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
         if (!info->modified) {
             continue;
@@ -4375,6 +5956,8 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
                 goto cleanup;
 #undef ERR_FMT
             }
+            /* the version does not change while the file is locked */
+            c_ctx->loaded_versions[count] = dm_version_get(info->schema->versions, c_ctx->session->datastore);
         }
 
         bool copy_uptodate;
@@ -4382,7 +5965,7 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
             /* candidate datatree is always up-to-date, there is only one copy */
             copy_uptodate = true;
         } else {
-            rc = dm_is_info_copy_uptodate(dm_ctx, file_name, info, &copy_uptodate);
+            rc = dm_is_info_copy_uptodate(dm_ctx, file_name, c_ctx->session->datastore, info, &copy_uptodate);
             CHECK_RC_MSG_GOTO(rc, cleanup, "File up to date check failed");
         }
 
@@ -4406,6 +5989,7 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
             pthread_mutex_unlock(&info->schema->usage_count_mutex);
             di->schema = info->schema;
             di->modified = info->modified;
+            di->unconstrained_changes = info->unconstrained_changes;
 
             /* duplicate also the list of required modules */
             rc = dm_dup_required_models_list(info, di);
@@ -4417,10 +6001,12 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
 
         } else {
             /* if the file existed pass FILE 'r+', otherwise pass -1 because there is 'w' fd already */
-            rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema, &di);
+            rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema,
+                    c_ctx->session->datastore, &di);
             CHECK_RC_MSG_GOTO(rc, cleanup, "Loading data file failed");
         }
 
+        dm_session_copies_unchecked(c_ctx->session, c_ctx->session->datastore);
         rc = sr_btree_insert(c_ctx->session->session_modules[c_ctx->session->datastore], (void *)di);
         if (SR_ERR_OK != rc) {
             SR_LOG_ERR("Insert into commit session avl failed module %s", info->schema->module->name);
@@ -4436,8 +6022,14 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
              * if NACM is enabled, we need to get the previous state in any case.
              */
             if (session->datastore != SR_DS_CANDIDATE && copy_uptodate) {
-                /* load data tree from file system */
-                rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema, &di);
+                /* the previous state is only read, use the cached data tree rather than parsing the file again */
+                if (c_ctx->existed[count] && dm_data_snapshot_allowed(info->schema, c_ctx->session->datastore)) {
+                    rc = dm_load_data_snapshot(dm_ctx, c_ctx->fds[count], file_name, info->schema,
+                            c_ctx->session->datastore, &di);
+                } else {
+                    rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name,
+                            info->schema, c_ctx->session->datastore, &di);
+                }
                 CHECK_RC_MSG_GOTO(rc, cleanup, "Loading data file failed");
 
                 rc = sr_btree_insert(c_ctx->prev_data_trees, (void *)di);
@@ -4453,6 +6045,14 @@ dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm
             }
         }
 
+        if (NULL != c_ctx->scoped_schemas[count]) {
+            /* the data file is locked again before it is written, the changes are applied once more
+             * if it has been written by another process meanwhile */
+            sr_unlock_fd(c_ctx->fds[count]);
+            rc = dm_unlock_module(dm_ctx, c_ctx->session, (char *) info->schema->module->name);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Module %s can not be unlocked", info->schema->module->name);
+        }
+
         free(file_name);
         file_name = NULL;
 
@@ -4482,28 +6082,422 @@ dm_commit_writelock_fds(dm_session_t *session, dm_commit_context_t *commit_ctx)
         if (!info->modified) {
             continue;
         }
-        /* try to lock for write, non-blocking */
-        rc = sr_lock_fd(commit_ctx->fds[cnt], true, false);
+        if (NULL != commit_ctx->scoped_schemas && NULL != commit_ctx->scoped_schemas[cnt]) {
+            /* the commits of other processes with subtree scope take turns in writing the data file */
+            rc = dm_lock_module_internal(session->dm_ctx, commit_ctx->session, info->schema->module->name,
+                    DM_LOCK_SCOPED_WRITE);
+            CHECK_RC_LOG_RETURN(rc, "Module %s can not be locked", info->schema->module->name);
+            rc = sr_lock_fd(commit_ctx->fds[cnt], true, true);
+        } else {
+            /* try to lock for write, non-blocking */
+            rc = sr_lock_fd(commit_ctx->fds[cnt], true, false);
+        }
         CHECK_RC_LOG_RETURN(rc, "Locking of file for module '%s' failed: %s.", info->schema->module_name, sr_strerror(rc));
         cnt++;
     }
     return rc;
 }
 
+int
+dm_commit_reload_stale_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm_commit_context_t *c_ctx,
+        sr_list_t **models_to_skip)
+{
+    CHECK_NULL_ARG4(dm_ctx, session, c_ctx, models_to_skip);
+    dm_data_info_t *info = NULL, *di = NULL, *old_info = NULL, lookup_info = {0};
+    sr_datastore_t ds = c_ctx->session->datastore;
+    sr_list_t *skip = NULL;
+    char *file_name = NULL;
+    struct stat st = {0};
+    bool reloaded = false;
+    size_t i = 0, count = 0;
+    int rc = SR_ERR_OK;
+
+    *models_to_skip = NULL;
+    if (NULL == c_ctx->scoped_schemas) {
+        return SR_ERR_OK;
+    }
+
+    rc = sr_list_init(&skip);
+    CHECK_RC_MSG_RETURN(rc, "List init failed");
+
+    ac_set_user_identity(dm_ctx->ac_ctx, session->user_credentials);
+
+    while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
+        if (!info->modified) {
+            continue;
+        }
+        if (NULL == c_ctx->scoped_schemas[count] ||
+                dm_version_get(info->schema->versions, ds) == c_ctx->loaded_versions[count]) {
+            rc = sr_list_add(skip, (void *) info->schema->module->name);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Adding to sr_list failed");
+            count++;
+            continue;
+        }
+        SR_LOG_DBG("Data file of module %s has been written by another process, the changes are applied again",
+                info->schema->module->name);
+
+        rc = sr_get_data_file_name(dm_ctx->data_search_dir, info->schema->module->name, ds, &file_name);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Get data file name failed");
+
+        if (0 == fstat(c_ctx->fds[count], &st) && st.st_size > 0) {
+            /* the file could have been created by the other process */
+            c_ctx->existed[count] = true;
+        }
+        rc = dm_load_data_tree_file(dm_ctx, c_ctx->existed[count] ? c_ctx->fds[count] : -1, file_name, info->schema,
+                ds, &di);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Loading data file failed");
+
+        /* replace the merged data tree and the previous state */
+        lookup_info.schema = info->schema;
+        old_info = sr_btree_search(c_ctx->session->session_modules[ds], &lookup_info);
+        if (NULL != old_info) {
+            sr_btree_delete(c_ctx->session->session_modules[ds], old_info);
+        }
+        dm_session_copies_unchecked(c_ctx->session, ds);
+        rc = sr_btree_insert(c_ctx->session->session_modules[ds], (void *) di);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Insert into commit session avl failed module %s", info->schema->module->name);
+            dm_data_info_free(di);
+            goto cleanup;
+        }
+
+        old_info = sr_btree_search(c_ctx->prev_data_trees, &lookup_info);
+        if (NULL != old_info) {
+            sr_btree_delete(c_ctx->prev_data_trees, old_info);
+            rc = dm_insert_data_info_copy(c_ctx->prev_data_trees, di);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Insert data info copy failed");
+        }
+
+        free(file_name);
+        file_name = NULL;
+        reloaded = true;
+        count++;
+    }
+
+cleanup:
+    ac_unset_user_identity(dm_ctx->ac_ctx, session->user_credentials);
+    free(file_name);
+    if (SR_ERR_OK == rc && reloaded) {
+        *models_to_skip = skip;
+    } else {
+        sr_list_cleanup(skip);
+    }
+    return rc;
+}
+
+/**
+ * @brief Tries to record the changes of the module made by the commit in the journal of the data file
+ * instead of writing the whole data file. Fails if the journal should be compacted, i.e. it has grown
+ * over ::SR_JOURNAL_COMPACT_SIZE and a quarter of the data file size.
+ * The journal is not synced, its descriptor is returned in \p sync_fd (-1 if nothing has been written).
+ *
+ * @return True if the changes have been recorded.
+ */
+static bool
+dm_commit_journal_changes(dm_commit_context_t *c_ctx, const dm_data_info_t *merged_info, const char *file_name, int fd,
+        bool existed, int *sync_fd)
+{
+    dm_model_subscription_t lookup_ms = {0}, *ms = NULL;
+    dm_data_info_t lookup_info = {0}, *prev_info = NULL;
+    struct lyd_difflist *diff = NULL;
+    bool diff_owned = false;
+    off_t journal_size = 0;
+    struct stat st = {0};
+    LYD_FORMAT file_format = LYD_UNKNOWN;
+    int rc = SR_ERR_OK;
+
+    if (0 == SR_JOURNAL_COMPACT_SIZE || NULL == file_name || !existed || NULL != merged_info->required_modules) {
+        return false;
+    }
+    if (merged_info->schema->cross_module_data_dependency || merged_info->schema->has_instance_id) {
+        /* data trees of other modules may be attached, only the whole file can be written */
+        return false;
+    }
+
+    rc = sr_get_data_file_format(fd, &file_format);
+    if (SR_ERR_OK != rc || (LYD_UNKNOWN != file_format && SR_FILE_FORMAT_LY != file_format)) {
+        /* the data file is converted to the configured format once it is written as a whole */
+        SR_LOG_DBG("Data file of module %s is converted to \"%s\"", merged_info->schema->module_name, SR_FILE_FORMAT_EXT);
+        return false;
+    }
+
+    rc = dm_journal_get_size(file_name, &journal_size);
+    if (SR_ERR_OK != rc || 0 != fstat(fd, &st)) {
+        return false;
+    }
+    if (journal_size >= MAX((off_t) SR_JOURNAL_COMPACT_SIZE * 1024, st.st_size / 4)) {
+        SR_LOG_DBG("Journal of module %s is compacted", merged_info->schema->module_name);
+        return false;
+    }
+
+    /* the changes are recorded against the content of the data file before the commit */
+    lookup_info.schema = merged_info->schema;
+    prev_info = sr_btree_search(c_ctx->prev_data_trees, &lookup_info);
+    if (NULL == prev_info) {
+        return false;
+    }
+    lookup_ms.schema_info = merged_info->schema;
+    ms = sr_btree_search(c_ctx->subscriptions, &lookup_ms);
+    if (NULL != ms && NULL != ms->difflist) {
+        /* already generated for the notifications */
+        diff = ms->difflist;
+    } else {
+        diff = lyd_diff(prev_info->node, merged_info->node, LYD_DIFFOPT_WITHDEFAULTS);
+        if (NULL == diff) {
+            SR_LOG_WRN("Lyd diff failed for module %s", merged_info->schema->module_name);
+            return false;
+        }
+        diff_owned = true;
+    }
+
+    if (LYD_DIFF_END == diff->type[0]) {
+        SR_LOG_DBG("No changes in module %s to be written", merged_info->schema->module_name);
+    } else {
+        rc = dm_journal_append(file_name, fd, diff, &journal_size, sync_fd);
+    }
+    if (diff_owned) {
+        lyd_free_diff(diff);
+    }
+    return SR_ERR_OK == rc;
+}
+
+/**
+ * @brief Adds the descriptors of the files written by a commit to the open group commit batch.
+ * The ownership of the descriptors is passed to the batch on success.
+ *
+ * @param [in] sync Group commit state.
+ * @param [in] fds Descriptors to be synced.
+ * @param [in] fd_cnt Number of descriptors.
+ * @param [out] batch Batch the commit has to wait for (see ::dm_commit_sync_wait).
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_commit_sync_enqueue(dm_commit_sync_t *sync, const int *fds, size_t fd_cnt, dm_sync_batch_t **batch)
+{
+    CHECK_NULL_ARG3(sync, fds, batch);
+    dm_sync_batch_t *open_batch = NULL;
+    int *tmp = NULL;
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&sync->mutex);
+    if (NULL == sync->open_batch) {
+        sync->open_batch = calloc(1, sizeof *sync->open_batch);
+        CHECK_NULL_NOMEM_GOTO(sync->open_batch, rc, cleanup);
+        sync->open_batch->sync = sync;
+    }
+    open_batch = sync->open_batch;
+
+    tmp = realloc(open_batch->fds, (open_batch->fd_cnt + fd_cnt) * sizeof *tmp);
+    CHECK_NULL_NOMEM_GOTO(tmp, rc, cleanup);
+    memcpy(tmp + open_batch->fd_cnt, fds, fd_cnt * sizeof *fds);
+    open_batch->fds = tmp;
+    open_batch->fd_cnt += fd_cnt;
+    open_batch->ref_count++;
+    *batch = open_batch;
+
+cleanup:
+    if (NULL != open_batch && 0 == open_batch->fd_cnt) {
+        /* allocation of a new batch failed */
+        sync->open_batch = NULL;
+        dm_sync_batch_free(open_batch);
+    }
+    pthread_mutex_unlock(&sync->mutex);
+    return rc;
+}
+
+/**
+ * @brief Syncs all the files of the batch, each file is synced only once even if it has been
+ * written by several commits.
+ * @param [in] batch
+ * @return Error code (SR_ERR_OK on success)
+ */
+static int
+dm_commit_sync_flush(dm_sync_batch_t *batch)
+{
+    struct stat *synced = NULL;
+    size_t synced_cnt = 0, i = 0, j = 0;
+    int rc = SR_ERR_OK;
+
+    synced = calloc(batch->fd_cnt, sizeof *synced);
+    CHECK_NULL_NOMEM_RETURN(synced);
+
+    for (i = 0; i < batch->fd_cnt; i++) {
+        if (0 != fstat(batch->fds[i], &synced[synced_cnt])) {
+            SR_LOG_ERR("Stat of a committed file failed: %s", sr_strerror_safe(errno));
+            rc = SR_ERR_IO;
+            continue;
+        }
+        for (j = 0; j < synced_cnt; j++) {
+            if (synced[j].st_dev == synced[synced_cnt].st_dev && synced[j].st_ino == synced[synced_cnt].st_ino) {
+                break;
+            }
+        }
+        if (j < synced_cnt) {
+            /* already synced within this batch */
+            continue;
+        }
+        if (0 != fsync(batch->fds[i])) {
+            SR_LOG_ERR("Sync of a committed file failed: %s", sr_strerror_safe(errno));
+            rc = SR_ERR_IO;
+            continue;
+        }
+        synced_cnt++;
+    }
+    SR_LOG_DBG("Group commit of %zu commit(s) synced %zu file(s)", batch->ref_count, synced_cnt);
+
+    free(synced);
+    return rc;
+}
+
+int
+dm_commit_sync_wait(dm_sync_batch_t *batch)
+{
+    CHECK_NULL_ARG2(batch, batch->sync);
+    dm_commit_sync_t *sync = batch->sync;
+    struct timespec delay = {0};
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&sync->mutex);
+    while (!batch->done) {
+        if (sync->flushing) {
+            /* the batch is flushed by this or the next leader */
+            pthread_cond_wait(&sync->cond, &sync->mutex);
+            continue;
+        }
+        /* become the leader, let other commits join the batch */
+        sync->flushing = true;
+        if (SR_GROUP_COMMIT_DELAY > 0) {
+            delay.tv_sec = SR_GROUP_COMMIT_DELAY / 1000000;
+            delay.tv_nsec = (SR_GROUP_COMMIT_DELAY % 1000000) * 1000;
+            pthread_mutex_unlock(&sync->mutex);
+            nanosleep(&delay, NULL);
+            pthread_mutex_lock(&sync->mutex);
+        }
+        /* commits from now on are added to a new batch */
+        sync->open_batch = NULL;
+        pthread_mutex_unlock(&sync->mutex);
+
+        rc = dm_commit_sync_flush(batch);
+
+        pthread_mutex_lock(&sync->mutex);
+        batch->result = rc;
+        batch->done = true;
+        sync->flushing = false;
+        pthread_cond_broadcast(&sync->cond);
+    }
+    rc = batch->result;
+    if (0 == --batch->ref_count) {
+        dm_sync_batch_free(batch);
+    }
+    pthread_mutex_unlock(&sync->mutex);
+
+    return rc;
+}
+
+void
+dm_commit_sync_release(dm_sync_batch_t *batch)
+{
+    CHECK_NULL_ARG_VOID2(batch, batch->sync);
+    dm_commit_sync_t *sync = batch->sync;
+
+    pthread_mutex_lock(&sync->mutex);
+    if (0 == --batch->ref_count && batch->done) {
+        dm_sync_batch_free(batch);
+    }
+    /* otherwise the batch is still open (a batch being flushed is referenced by its leader),
+     * it is flushed by the next group commit or by ::dm_cleanup */
+    pthread_mutex_unlock(&sync->mutex);
+}
+
+/**
+ * @brief Writing of one modified module into its data file, processed by the helper pool.
+ */
+typedef struct dm_write_task_s {
+    dm_commit_context_t *c_ctx; /**< commit context */
+    const char *module_name;    /**< name of the module */
+    dm_data_info_t *merged_info;/**< merged data tree to be written */
+    struct lyd_node *data_tree; /**< data tree to be printed (merged or duplicated into tmp context) */
+    struct ly_ctx *ly_ctx;      /**< libyang context of data_tree */
+    char *file_name;            /**< name of the data file, NULL if not known */
+    int fd;                     /**< opened data file */
+    bool existed;               /**< flag whether the data file existed before the commit */
+    bool done;                  /**< flag whether the task has already been processed */
+    int ret;                    /**< result of writing, 0 on success */
+    bool journaled;             /**< flag whether the changes have been appended to the journal */
+    int sync_fd;                /**< descriptor to be synced by the group commit, -1 if none */
+} dm_write_task_t;
+
+/**
+ * @brief Writes the data of one module - appends the changes to the journal if possible,
+ * otherwise rewrites the whole data file. Files are not synced unless the journal is discarded.
+ */
+static void
+dm_write_task(void *arg)
+{
+    dm_write_task_t *task = (dm_write_task_t *) arg;
+    off_t journal_size = 0;
+
+    if (task->done) {
+        return;
+    }
+    task->done = true;
+    task->journaled = false;
+    task->sync_fd = -1;
+    ly_errno = LY_SUCCESS; /* needed to check if the error was in libyang or not below */
+
+    /* append only the changes to the journal if possible, otherwise rewrite the whole file */
+    if (0 == task->ret) {
+        dm_data_file_modified(task->c_ctx->session->dm_ctx, task->merged_info->schema, task->c_ctx->session->datastore);
+        task->journaled = dm_commit_journal_changes(task->c_ctx, task->merged_info, task->file_name, task->fd,
+                task->existed, &task->sync_fd);
+    }
+    if (0 == task->ret && !task->journaled) {
+        task->ret = ftruncate(task->fd, 0);
+    }
+    if (0 == task->ret && !task->journaled) {
+        task->ret = lyd_print_fd(task->fd, task->data_tree, SR_FILE_FORMAT_LY, LYP_WITHSIBLINGS | LYP_FORMAT);
+    }
+
+    if (0 == task->ret && !task->journaled) {
+        if (NULL != task->file_name && (SR_ERR_OK != dm_journal_get_size(task->file_name, &journal_size) || 0 != journal_size)) {
+            /* the data file must be durable before its journal is discarded */
+            task->ret = fsync(task->fd);
+            if (0 == task->ret && SR_ERR_OK != dm_journal_reset(task->file_name)) {
+                /* the journal does not match the new content of the data file, it would be ignored */
+                SR_LOG_WRN("Failed to reset the journal of module '%s'", task->module_name);
+            }
+        } else {
+            task->sync_fd = dup(task->fd);
+            task->ret = (-1 == task->sync_fd) ? fsync(task->fd) : 0;
+        }
+    }
+    if (0 != task->ret) {
+        /* libyang error information is thread specific, log it right away */
+        SR_LOG_ERR("Failed to write data of '%s' module: %s", task->module_name,
+                (ly_errno != LY_SUCCESS) ? ly_errmsg(task->ly_ctx) : sr_strerror_safe(errno));
+    }
+}
+
 int
 dm_commit_write_files(dm_session_t *session, dm_commit_context_t *c_ctx)
 {
     CHECK_NULL_ARG2(session, c_ctx);
     int rc = SR_ERR_OK;
-    int ret = 0;
     size_t i = 0;
     size_t count = 0;
     dm_data_info_t *info = NULL;
     dm_tmp_ly_ctx_t *tmp_ctx = NULL;
-    struct lyd_node *tmp_data_tree = NULL;
-    struct ly_ctx *ly_ctx = NULL;
+    dm_write_task_t *tasks = NULL, *task = NULL;
+    int *sync_fds = NULL;
+    size_t sync_fd_cnt = 0;
+
+    tasks = calloc(c_ctx->modif_count, sizeof *tasks);
+    CHECK_NULL_NOMEM_RETURN(tasks);
+    /* descriptors of the written files, they are synced together with the files of concurrent commits */
+    sync_fds = calloc(c_ctx->modif_count, sizeof *sync_fds);
+    CHECK_NULL_NOMEM_GOTO(sync_fds, rc, cleanup);
 
-    /* write data trees */
+    /* prepare the data trees to be written */
     i = 0;
     dm_data_info_t *merged_info = NULL;
     while (NULL != (info = sr_btree_get_at(session->session_modules[session->datastore], i++))) {
@@ -4515,61 +6509,92 @@ dm_commit_write_files(dm_session_t *session, dm_commit_context_t *c_ctx)
                 rc = SR_ERR_INTERNAL;
                 continue;
             }
+            task = &tasks[count];
+            task->c_ctx = c_ctx;
+            task->module_name = info->schema->module->name;
+            task->merged_info = merged_info;
+            task->data_tree = merged_info->node;
+            task->ly_ctx = merged_info->schema->ly_ctx;
+            task->fd = c_ctx->fds[count];
+            task->existed = c_ctx->existed[count];
+            task->sync_fd = -1;
+
             /* remove attached data trees */
-            ret = dm_remove_added_data_trees(session, info);
+            task->ret = dm_remove_added_data_trees(session, info);
+
+            if (SR_ERR_OK != sr_get_data_file_name(session->dm_ctx->data_search_dir, info->schema->module->name,
+                    c_ctx->session->datastore, &task->file_name)) {
+                SR_LOG_WRN("Get data file name failed for module %s", info->schema->module->name);
+            }
 
-            /* print using tmp context if schemas different from installation time deps are needed */
+            /* print using tmp context if schemas different from installation time deps are needed,
+             * the tmp context is shared by all modules so they are written right away */
             if (NULL != merged_info->required_modules) {
                 SR_LOG_DBG("Additional schemas are needed to print data of modules %s", merged_info->schema->module_name);
                 rc = dm_get_tmp_ly_ctx(session->dm_ctx, merged_info->required_modules, &tmp_ctx);
                 if (SR_ERR_OK == rc) {
-                    tmp_data_tree = sr_dup_datatree_to_ctx(merged_info->node, tmp_ctx->ctx);
+                    task->data_tree = sr_dup_datatree_to_ctx(merged_info->node, tmp_ctx->ctx);
+                    task->ly_ctx = tmp_ctx->ctx;
+                    dm_write_task(task);
+                    lyd_free_withsiblings(task->data_tree);
+                    task->data_tree = NULL;
+                    dm_release_tmp_ly_ctx(session->dm_ctx, tmp_ctx);
                 } else {
                     SR_LOG_ERR_MSG("Failed to acquired tmp ly_ctx");
+                    free(task->file_name);
+                    memset(task, 0, sizeof *task);
                     continue;
                 }
             }
+            count++;
+        }
+    }
 
-            if (SR_ERR_OK == ret) {
-                ret = ftruncate(c_ctx->fds[count], 0);
-            }
-            if (0 == ret) {
-                ly_errno = LY_SUCCESS; /* needed to check if the error was in libyang or not below */
-                ret = lyd_print_fd(c_ctx->fds[count], NULL == merged_info->required_modules ? merged_info->node : tmp_data_tree,
-                            SR_FILE_FORMAT_LY, LYP_WITHSIBLINGS | LYP_FORMAT);
-            }
+    /* write the independent data files in parallel */
+    if (SR_ERR_OK != dm_helper_pool_run(session->dm_ctx->helper_pool, dm_write_task, tasks, sizeof *tasks, count)) {
+        SR_LOG_ERR_MSG("Parallel writing of data files failed");
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
 
-            if (NULL != merged_info->required_modules) {
-                lyd_free_withsiblings(tmp_data_tree);
-                tmp_data_tree = NULL;
-                dm_release_tmp_ly_ctx(session->dm_ctx, tmp_ctx);
+    for (i = 0; i < count; i++) {
+        task = &tasks[i];
+        if (-1 != task->sync_fd) {
+            sync_fds[sync_fd_cnt++] = task->sync_fd;
+        }
+        if (0 != task->ret) {
+            rc = SR_ERR_INTERNAL;
+            continue;
+        }
+        SR_LOG_DBG("Data successfully written for module '%s'%s", task->module_name,
+                task->journaled ? " (journal)" : "");
+        dm_update_data_snapshot(session->dm_ctx, task->merged_info->schema, c_ctx->session->datastore,
+                task->merged_info->node, task->file_name, task->fd);
+        if (SR_DS_RUNNING == c_ctx->session->datastore) {
+            if (0 == strcmp("ietf-netconf-acm", task->merged_info->schema->module_name)) {
+                c_ctx->nacm_edited = true;
             }
+        }
+    }
 
-            if (0 == ret) {
-                ret = fsync(c_ctx->fds[count]);
-            }
-            if (0 != ret) {
-                if (ly_errno) {
-                    ly_ctx = (NULL == merged_info->required_modules ? merged_info->node->schema->module->ctx :
-                          tmp_data_tree->schema->module->ctx);
-                }
-                SR_LOG_ERR("Failed to write data of '%s' module: %s", info->schema->module->name,
-                        (ly_errno != LY_SUCCESS) ? ly_errmsg(ly_ctx) : sr_strerror_safe(errno));
+    if (0 != sync_fd_cnt && SR_ERR_OK != dm_commit_sync_enqueue(&session->dm_ctx->commit_sync, sync_fds, sync_fd_cnt,
+                &c_ctx->sync_batch)) {
+        /* sync the files right away */
+        for (i = 0; i < sync_fd_cnt; i++) {
+            if (0 != fsync(sync_fds[i])) {
+                SR_LOG_ERR("Sync of a committed file failed: %s", sr_strerror_safe(errno));
                 rc = SR_ERR_INTERNAL;
-            } else {
-                SR_LOG_DBG("Data successfully written for module '%s'", info->schema->module->name);
-            }
-            if (0 == ret && SR_DS_RUNNING == c_ctx->session->datastore) {
-                if (0 == strcmp("ietf-netconf-acm", info->schema->module_name)) {
-                    c_ctx->nacm_edited = true;
-                }
             }
-            count++;
+            close(sync_fds[i]);
         }
     }
-    /* save time of the last commit */
-    sr_clock_get_time(CLOCK_REALTIME, &session->dm_ctx->last_commit_time);
 
+cleanup:
+    for (i = 0; i < c_ctx->modif_count; i++) {
+        free(tasks[i].file_name);
+    }
+    free(tasks);
+    free(sync_fds);
     return rc;
 }
 
@@ -5022,6 +7047,46 @@ dm_should_skip_subscription(np_subscription_t *subscription, dm_commit_context_t
     return false;
 }
 
+/**
+ * @brief Packs the changes of the module once for all the subscriptions requesting inline changes.
+ * The changes are generated from the difflist if no subscriber has asked for them yet.
+ */
+static int
+dm_pack_model_changes(dm_model_subscription_t *ms)
+{
+    CHECK_NULL_ARG(ms);
+    Sr__ChangeSet change_set = SR__CHANGE_SET__INIT;
+    int rc = SR_ERR_OK;
+
+    RWLOCK_WRLOCK_TIMED_CHECK_RETURN(&ms->changes_lock);
+
+    if (NULL != ms->packed_changes) {
+        goto cleanup;
+    }
+
+    if (!ms->changes_generated) {
+        rc = rp_dt_difflist_to_changes(ms->difflist, &ms->changes);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Difflist to changes failed");
+        ms->changes_generated = true;
+    }
+
+    rc = sr_changes_sr_to_gpb(ms->changes, NULL, &change_set.changes, &change_set.n_changes);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Conversion of the changes to GPB failed");
+
+    ms->packed_changes_size = sr__change_set__get_packed_size(&change_set);
+    ms->packed_changes = malloc(ms->packed_changes_size > 0 ? ms->packed_changes_size : 1);
+    CHECK_NULL_NOMEM_GOTO(ms->packed_changes, rc, cleanup);
+    sr__change_set__pack(&change_set, ms->packed_changes);
+
+cleanup:
+    for (size_t i = 0; i < change_set.n_changes; i++) {
+        sr__change__free_unpacked(change_set.changes[i], NULL);
+    }
+    free(change_set.changes);
+    pthread_rwlock_unlock(&ms->changes_lock);
+    return rc;
+}
+
 int
 dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, dm_commit_context_t *c_ctx)
 {
@@ -5116,6 +7181,9 @@ dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, d
                 sr_list_cleanup(ms->changes);
             }
             ms->changes = NULL;
+            free(ms->packed_changes);
+            ms->packed_changes = NULL;
+            ms->packed_changes_size = 0;
 
             lyd_free_diff(ms->difflist);
             ms->changes_generated = false;
@@ -5203,8 +7271,16 @@ dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t ev, d
                 }
 
                 if (match) {
+                    if (sub->inline_changes && NULL == ms->packed_changes) {
+                        rc = dm_pack_model_changes(ms);
+                        if (SR_ERR_OK != rc) {
+                            SR_LOG_WRN("Unable to pack the changes of module %s, the subscriber has to ask for them.",
+                                    sub->module_name);
+                        }
+                    }
                     /* something has been changed for this subscription, send notification */
-                    rc = np_subscription_notify(dm_ctx->np_ctx, sub, ev, c_ctx->id);
+                    rc = np_subscription_notify(dm_ctx->np_ctx, sub, ev, c_ctx->id, ms->packed_changes,
+                            ms->packed_changes_size);
                     if (SR_ERR_OK != rc) {
                        SR_LOG_WRN("Unable to send notifications about the changes for the subscription in module %s xpath %s.",
                                sub->module_name,
@@ -5352,6 +7428,10 @@ dm_install_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_na
         rc = dm_init_missing_node_priv_data(si);
         CHECK_RC_LOG_GOTO(rc, unlock, "Failed to initialize private data for module %s", module->name);
 
+        /* find the schema nodes the constraints depend on */
+        rc = dm_init_node_references(si);
+        CHECK_RC_LOG_GOTO(rc, unlock, "Failed to resolve constraint references in module %s", module->name);
+
         if (dm_module_has_persist(module)) {
             rc = dm_apply_persist_data_for_model(dm_ctx, session, module->name, si, false);
             CHECK_RC_LOG_GOTO(rc, unlock, "Failed to apply persist data for %s", module->name);
@@ -5384,6 +7464,10 @@ unlock:
                 rc = dm_init_missing_node_priv_data(si_ext);
                 CHECK_RC_LOG_GOTO(rc, unlock, "Failed to initialize private data for module %s", dep->dest->name);
 
+                /* find the schema nodes the constraints depend on */
+                rc = dm_init_node_references(si_ext);
+                CHECK_RC_LOG_GOTO(rc, unlock, "Failed to resolve constraint references in module %s", dep->dest->name);
+
                 if (dm_module_has_persist(module)) {
                     rc = dm_apply_persist_data_for_model(dm_ctx, session, module->name, si_ext, false);
                     CHECK_RC_LOG_GOTO(rc, unlock, "Failed to apply persist data for %s", module->name);
@@ -5426,6 +7510,7 @@ dm_uninstall_module_schema(dm_ctx_t *dm_ctx, const char *module_name, const char
     if (NULL != schema_info) {
         pthread_rwlock_wrlock(&schema_info->model_lock);
         if (NULL != schema_info->ly_ctx){
+            dm_drop_data_snapshots(dm_ctx, schema_info);
             pthread_mutex_lock(&schema_info->usage_count_mutex);
             if (0 != schema_info->usage_count) {
                 rc = SR_ERR_OPERATION_FAILED;
@@ -5672,7 +7757,7 @@ dm_send_enabled_notification(dm_ctx_t *dm_ctx, dm_commit_context_t *c_ctx, const
     rc = sr_list_add(notif_list, (void *) subscription);
     CHECK_RC_MSG_GOTO(rc, cleanup, "List insert failed");
 
-    rc = np_subscription_notify(dm_ctx->np_ctx, (np_subscription_t *) subscription, SR_EV_ENABLED, commit_id);
+    rc = np_subscription_notify(dm_ctx->np_ctx, (np_subscription_t *) subscription, SR_EV_ENABLED, commit_id, NULL, 0);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Sending of SR_EV_ENABLED notification failed");
 
     rc = np_commit_notifications_sent(dm_ctx->np_ctx, commit_id, true, notif_list);
@@ -5706,6 +7791,9 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
         return rc;
     }
 
+    rc = dm_data_file_write_check(dm_ctx, dst);
+    CHECK_RC_MSG_RETURN(rc, "Copy config refused");
+
     if (NULL != subscription) {
         if (SR_DS_RUNNING != dst) {
             SR_LOG_ERR_MSG("Notification cannot be sent for datastore different from running");
@@ -5811,6 +7899,8 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
             }
             opened_files++;
             free(file_name);
+            /* the file has just been truncated */
+            dm_data_file_modified(dm_ctx, src_infos[i]->schema, dst);
         }
     }
 
@@ -5829,6 +7919,20 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
                         (ly_errno != LY_SUCCESS) ? ly_errmsg(src_infos[i]->node->schema->module->ctx) : sr_strerror_safe(errno));
                 rc = SR_ERR_INTERNAL;
             }
+            if (SR_ERR_OK == rc) {
+                rc = sr_get_data_file_name(dm_ctx->data_search_dir, module_name, dst, &file_name);
+            }
+            if (SR_ERR_OK == rc) {
+                /* the journal recorded changes of the overwritten content */
+                if (SR_ERR_OK != dm_journal_reset(file_name)) {
+                    SR_LOG_WRN("Failed to reset the journal of module '%s'", module_name);
+                }
+                dm_update_data_snapshot(dm_ctx, src_infos[i]->schema, dst, src_infos[i]->node, file_name, fds[i]);
+                free(file_name);
+                file_name = NULL;
+            } else {
+                dm_drop_data_snapshots(dm_ctx, src_infos[i]->schema);
+            }
         } else {
             /* copy data tree into candidate session */
             struct lyd_node *dup = sr_dup_datatree(src_infos[i]->node);
@@ -5843,7 +7947,7 @@ dm_copy_config(dm_ctx_t *dm_ctx, dm_session_t *session, const sr_list_t *module_
             CHECK_RC_MSG_GOTO(rc, cleanup, "Get data info failed");
             lyd_free_withsiblings(di_tmp->node);
             di_tmp->node = dup;
-            di_tmp->modified = true;
+            dm_data_info_set_modified(di_tmp, false);
         }
     }
 
@@ -6062,7 +8166,7 @@ dm_copy_subtree_startup_running(dm_ctx_t *ctx, dm_session_t *session, const char
         rc = SR_ERR_OK;
     }
     CHECK_RC_MSG_GOTO(rc, cleanup, "Find nodes for configuration to be enabled failed");
-    candidate_info->modified = true;
+    dm_data_info_set_modified(candidate_info, false);
 
     /* insert selected nodes */
     for (unsigned i = 0; NULL != nodes && i < nodes->number; i++) {
@@ -6539,7 +8643,7 @@ dm_validate_procedure_content(rp_ctx_t *rp_ctx, rp_session_t *session, dm_data_i
             /* retrieve all required data */
             for (size_t i = 0; i < required_data->count; i++) {
                 SR_LOG_DBG("To pass the validation of '%s' data from module %s is needed", di->schema->module_name, (char *)required_data->data[i]);
-                rc = dm_get_data_info_internal(rp_ctx->dm_ctx, session->dm_session, (char *)required_data->data[i], true, &should_be_freed[i], &dep_di);
+                rc = dm_get_data_info_internal(rp_ctx->dm_ctx, session->dm_session, (char *)required_data->data[i], true, true, &should_be_freed[i], &dep_di);
                 CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to get data info for module %s", (char *)required_data->data[i]);
 
                 rc = sr_list_add(data_for_validation, dep_di);
@@ -7004,10 +9108,14 @@ dm_copy_modified_session_trees(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_
         }
 
         new_info->modified = info->modified;
+        new_info->unconstrained_changes = info->unconstrained_changes;
         new_info->schema = info->schema;
         new_info->timestamp = info->timestamp;
-        lyd_free_withsiblings(new_info->node);
-        new_info->node = NULL;
+        new_info->data_version = info->data_version;
+        new_info->timestamp_reliable = info->timestamp_reliable;
+        dm_session_copies_unchecked(to, to->datastore);
+        dm_session_trees_replaced(to);
+        dm_data_info_replace_node(new_info, NULL);
         if (NULL != info->node) {
             new_info->node = sr_dup_datatree(info->node);
         }
@@ -7061,16 +9169,20 @@ dm_copy_session_tree(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_t *to, con
     }
 
     new_info->modified = info->modified;
+    new_info->unconstrained_changes = info->unconstrained_changes;
     new_info->schema = info->schema;
     new_info->timestamp = info->timestamp;
+    new_info->data_version = info->data_version;
+    new_info->timestamp_reliable = info->timestamp_reliable;
+    dm_session_copies_unchecked(to, to->datastore);
+    dm_session_trees_replaced(to);
     if (NULL != info->node) {
         tmp_node = sr_dup_datatree(info->node);
         CHECK_NULL_NOMEM_ERROR(tmp_node, rc);
     }
 
     if (SR_ERR_OK == rc) {
-        lyd_free_withsiblings(new_info->node);
-        new_info->node = tmp_node;
+        dm_data_info_replace_node(new_info, tmp_node);
     }
 
     if (!existed) {
@@ -7113,11 +9225,14 @@ dm_create_rdonly_ptr_data_tree(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_
     }
 
     new_info->modified = info->modified;
+    new_info->unconstrained_changes = info->unconstrained_changes;
     new_info->schema = info->schema;
     new_info->timestamp = info->timestamp;
+    new_info->data_version = info->data_version;
+    new_info->timestamp_reliable = info->timestamp_reliable;
+    dm_session_copies_unchecked(to, to->datastore);
+    dm_data_info_replace_node(new_info, info->node);
     new_info->rdonly_copy = true;
-    lyd_free_withsiblings(new_info->node);
-    new_info->node = info->node;
 
     if (!existed) {
         rc = sr_btree_insert(to->session_modules[to->datastore], new_info);
@@ -7160,6 +9275,8 @@ dm_move_session_tree_and_ops(dm_ctx_t *dm_ctx, dm_session_t *from, dm_session_t
 
     sr_btree_cleanup(to->session_modules[ds]);
     dm_free_sess_operations(to->operations[ds], to->oper_count[ds]);
+    dm_session_trees_replaced(to);
+    dm_session_trees_replaced(from);
 
     to->session_modules[ds] = from->session_modules[ds];
     to->oper_count[ds] = from->oper_count[ds];
@@ -7192,6 +9309,7 @@ dm_move_session_trees_in_session(dm_ctx_t *dm_ctx, dm_session_t *session, sr_dat
 
     /* cleanup the target*/
     sr_btree_cleanup(session->session_modules[to]);
+    dm_session_trees_replaced(session);
     dm_free_sess_operations(session->operations[to], session->oper_count[to]);
 
     /* move */
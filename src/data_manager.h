@@ -31,6 +31,7 @@
 #include <libyang/libyang.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <stdatomic.h>
 #include "sysrepo.h"
 
 #include "sr_common.h"
@@ -39,6 +40,7 @@
 #include "connection_manager.h"
 #include "module_dependencies.h"
 #include "nacm.h"
+#include "dm_version_table.h"
 
 /**
  * @brief number of supported data stores - length of arrays used in session
@@ -58,9 +60,35 @@ typedef struct dm_c_ctxs_s {
     bool commits_blocked;        /**< flag that decides whether a new commit context cane be inserted into the tree */
 } dm_commit_ctxs_t;
 
+/**
+ * @brief Files written by the commits that are flushed to the disk together (group commit).
+ */
+typedef struct dm_sync_batch_s {
+    struct dm_commit_sync_s *sync; /**< group commit state the batch belongs to */
+    int *fds;                      /**< duplicated descriptors of the written files to be synced */
+    size_t fd_cnt;                 /**< number of descriptors in fds */
+    size_t ref_count;              /**< number of commits waiting for the batch */
+    bool done;                     /**< flag whether the batch has been flushed */
+    int result;                    /**< result of the flush */
+} dm_sync_batch_t;
+
+/**
+ * @brief Group commit state - commits that have written their data files while another batch was being
+ * flushed are collected in the open batch and flushed together by one of them.
+ */
+typedef struct dm_commit_sync_s {
+    pthread_mutex_t mutex;         /**< guards the structure and the batches */
+    pthread_cond_t cond;           /**< signaled when a batch has been flushed */
+    dm_sync_batch_t *open_batch;   /**< batch the newly written files are added to, NULL if empty */
+    bool flushing;                 /**< flag whether a batch is being flushed */
+} dm_commit_sync_t;
+
 /** defined in data_manager.c */
 typedef struct dm_tmp_ly_ctx_s dm_tmp_ly_ctx_t;
 
+/** defined in dm_helper_pool.c */
+typedef struct dm_helper_pool_s dm_helper_pool_t;
+
 /**
  * @brief Data manager context holding loaded schemas, data trees
  * and corresponding locks
@@ -80,9 +108,19 @@ typedef struct dm_ctx_s {
     sr_btree_t *schema_info_tree; /**< Binary tree holding information about schemas */
     pthread_rwlock_t schema_tree_lock;  /**< rwlock for access schema_info_tree */
     dm_commit_ctxs_t commit_ctxs; /**< Structure holding commit contexts and corresponding lock */
-    struct timespec last_commit_time;  /**< Time of the last commit */
     dm_tmp_ly_ctx_t *tmp_ly_ctx;  /**< Structure wrapping libyang context that is used to validate/print/parse date
                                    * where the set of required yang module can vary */
+    sr_btree_t *data_snapshots;   /**< Parsed data trees shared read-only by the sessions (per module and datastore) */
+    pthread_mutex_t data_snapshots_lock; /**< Mutex guarding data_snapshots */
+    atomic_uint_fast64_t data_cache_hit_cnt;  /**< Number of data tree loads served from data_snapshots */
+    atomic_uint_fast64_t data_cache_miss_cnt; /**< Number of data tree loads that had to parse the data file */
+    dm_commit_sync_t commit_sync; /**< Group commit state used to flush the files written by commits */
+    dm_helper_pool_t *helper_pool;/**< Helper threads validating and writing independent modules in parallel */
+    dm_version_table_t *version_table; /**< Versions of the data files shared with other processes, NULL if not available */
+    bool writes_disabled;         /**< The version table is supported but could not be opened, the data files must not
+                                   * be written - the other processes would not notice the changes */
+    sr_list_t *subtree_locks;     /**< Subtree locks held by the sessions (see ::dm_lock_subtree) */
+    pthread_mutex_t subtree_locks_mutex; /**< Mutex guarding subtree_locks and the counts of the subtree-scoped commits */
 
 } dm_ctx_t;
 
@@ -113,6 +151,19 @@ typedef struct dm_schema_info_s {
     bool cross_module_data_dependency;  /**< Flag whether data from different module is needed for validation */
     bool has_instance_id;               /**< Flag whether the module contains a node of type instance identifier */
     bool can_not_be_locked;             /**< If true module contains no data and lock_module for the module is NOP */
+    bool unbounded_constraints;         /**< Flag whether some constraint of the module could not be resolved,
+                                         * in such case modified data trees are always validated completely */
+    dm_module_versions_t *versions;     /**< Versions of the module's data files, incremented with the data file locked
+                                         * for writing. Points to the version table if shared_versions is set,
+                                         * to local_versions otherwise */
+    dm_module_versions_t local_versions;/**< Versions counting only the writes done by this process */
+    bool shared_versions;               /**< Flag whether the versions are shared by all the processes, so that an unchanged
+                                         * version alone proves that the data file has not been modified */
+    size_t scoped_commit_cnt[DM_DATASTORE_COUNT]; /**< number of the commits with subtree scope in progress
+                                         * (see ::dm_lock_subtree), guarded by subtree_locks_mutex of dm_ctx */
+    bool scoped_file_locked[DM_DATASTORE_COUNT]; /**< Flag whether the lock file of the module is held by a commit
+                                         * with subtree scope rather than by a session lock of this or another process,
+                                         * guarded by subtree_locks_mutex of dm_ctx */
 }dm_schema_info_t;
 
 /**
@@ -122,8 +173,16 @@ typedef struct dm_data_info_s{
     bool rdonly_copy;                   /**< node member is only copy of pointer it must not be freed nor modified */
     dm_schema_info_t *schema;           /**< pointer to schema info */
     struct lyd_node *node;              /**< data tree */
+    struct dm_data_snapshot_s *snapshot;/**< if set, node is shared with other sessions and must not be modified,
+                                         * the private copy is made by ::dm_get_data_info */
     struct timespec timestamp;          /**< timestamp of this copy (used only if HAVE_ST_MTIM is defined) */
+    uint64_t data_version;              /**< version of the data file at the time the copy has been loaded */
+    bool timestamp_reliable;            /**< flag denoting that the data file could not have been modified without changing
+                                         * its modification time since the copy has been loaded */
     bool modified;                      /**< flag denoting whether a change has been made*/
+    bool unconstrained_changes;         /**< flag denoting that all the changes made since the data tree has been loaded
+                                         * can not violate any constraint (see ::dm_is_change_unconstrained),
+                                         * the validation of the data tree can be skipped */
     sr_list_t *required_modules;        /**< schemas that needs to be in context to print data */
 }dm_data_info_t;
 
@@ -196,7 +255,10 @@ typedef struct dm_model_subscription_s {
     struct lyd_difflist *difflist;      /**< diff list */
     sr_list_t *changes;                 /**< set of changes for the model */
     bool changes_generated;             /**< Flag signalizing that changes has been generated */
-    pthread_rwlock_t changes_lock;      /**< Lock guarding the changes member of structure */
+    uint8_t *packed_changes;            /**< changes packed as Sr__ChangeSet once for all the subscriptions
+                                             with inline changes, NULL if not packed yet */
+    size_t packed_changes_size;         /**< size of the packed changes */
+    pthread_rwlock_t changes_lock;      /**< Lock guarding the changes and packed_changes members of structure */
 }dm_model_subscription_t;
 
 /**
@@ -233,6 +295,11 @@ typedef struct dm_commit_context_s {
     bool should_be_removed;     /**< flag denoting whether c_ctx can be removed from btree */
     int result;                 /**< result of verify or apply commit phase */
     dm_session_t *backup_session; /**< session with backed up modifications from before the commit */
+    dm_sync_batch_t *sync_batch;/**< batch that flushes the files written by the commit, NULL if nothing to be flushed */
+    dm_schema_info_t **scoped_schemas; /**< modules committed with subtree scope (indexed as fds, NULL for the other modules),
+                                 * their scoped_commit_cnt is incremented until the commit context is released */
+    uint64_t *loaded_versions;  /**< versions of the data files of scoped_schemas at the time they were loaded */
+    size_t scoped_size;         /**< number of items allocated in scoped_schemas and loaded_versions */
 } dm_commit_context_t;
 
 /**
@@ -337,6 +404,38 @@ void dm_session_stop(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx);
  */
 int dm_get_data_info(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info);
 
+/**
+ * @brief Same as ::dm_get_data_info, but the returned data tree can be shared with
+ * other sessions and must not be modified. The session gets its private copy
+ * of the data tree on the first ::dm_get_data_info call.
+ *
+ * @note Function acquires and releases read lock for the schema info.
+ *
+ * @param [in] dm_ctx
+ * @param [in] dm_session_ctx
+ * @param [in] module_name
+ * @param [out] info
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNKNOWN_MODEL
+ */
+int dm_get_data_info_rdonly(dm_ctx_t *dm_ctx, dm_session_t *dm_session_ctx, const char *module_name, dm_data_info_t **info);
+
+/**
+ * @brief Statistics of the Data Manager's parsed data tree cache.
+ */
+typedef struct dm_stats_s {
+    uint64_t data_cache_hit_cnt;   /**< Number of data tree loads served from the cache. */
+    uint64_t data_cache_miss_cnt;  /**< Number of data tree loads that had to parse the data file. */
+} dm_stats_t;
+
+/**
+ * @brief Returns statistics of the Data Manager's parsed data tree cache.
+ *
+ * @param [in] dm_ctx
+ * @param [out] stats
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_get_stats(dm_ctx_t *dm_ctx, dm_stats_t *stats);
+
 /**
  * @brief Returns the data tree for the specified module.
  * @param [in] dm_ctx
@@ -417,7 +516,8 @@ int dm_list_schemas(dm_ctx_t *dm_ctx, dm_session_t *dm_session, sr_schema_t **sc
 int dm_get_schema(dm_ctx_t *dm_ctx, const char *module_name, const char *module_revision, const char *submodule_name, const char *submodule_revision, bool yang_format, char **schema);
 
 /**
- * @brief Validates the data_trees in session.
+ * @brief Validates the data_trees in session. Data trees of modules independent of other modules, where only
+ * leaves no constraint depends on have been changed (see ::dm_data_info_t::unconstrained_changes), are not validated.
  *
  * @note Function does not acquire nor release a schema lock.
  *
@@ -487,9 +587,9 @@ int dm_commit_prepare_context(dm_ctx_t *dm_ctx, dm_session_t *session, dm_commit
 int dm_commit_load_session_module_deps(dm_ctx_t *dm_ctx, dm_session_t *session);
 
 /**
- * @brief Loads the data tree which has been modified in the session to the commit context. If the session copy has
- * the same timestamp as the file system file it is copied otherwise, data tree is loaded from file and the changes
- * made in the session are applied.
+ * @brief Loads the data tree which has been modified in the session to the commit context. If the data file has not
+ * been written since the session copy has been loaded, the session copy is committed directly, otherwise the data
+ * tree is loaded from file and the changes made in the session are applied.
  * @param [in] dm_ctx
  * @param [in] session
  * @param [in] c_ctx - commit context
@@ -504,22 +604,61 @@ int dm_commit_load_modified_models(dm_ctx_t *dm_ctx, const dm_session_t *session
         bool force_copy_uptodate, sr_error_info_t **errors, size_t *err_cnt);
 
 /**
- * @brief Tries to acquire write locks on opened fds
+ * @brief Tries to acquire write locks on opened fds. Waits for the locks of the modules committed
+ * with subtree scope (see ::dm_lock_subtree), they are shared with the commits of other processes.
  * @param [in] session
  * @param [in] commit_ctx
  * @return Error code (SR_ERR_OK on success)
  */
 int dm_commit_writelock_fds(dm_session_t *session, dm_commit_context_t *commit_ctx);
 
+/**
+ * @brief Loads again the modules committed with subtree scope whose data files have been written by other
+ * processes since they were loaded by ::dm_commit_load_modified_models. The changes made in the session has to be
+ * replayed on the reloaded data trees then. To be called with the data files locked for writing.
+ * @param [in] dm_ctx
+ * @param [in] session
+ * @param [in] c_ctx - commit context
+ * @param [out] models_to_skip Set of the names of the modified modules that have not been reloaded,
+ * NULL if no module has been reloaded.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_commit_reload_stale_models(dm_ctx_t *dm_ctx, const dm_session_t *session, dm_commit_context_t *c_ctx,
+        sr_list_t **models_to_skip);
+
 /**
  * @brief Writes the data trees from commit session stored in commit context into the files.
+ * If possible, only the changes are appended to the journal of the data file (see @ref dm_journal).
  * In case of error tries to continue. Does not do a cleanup.
+ *
+ * The written files are not synced, they are added to a group commit batch returned in
+ * dm_commit_context_t::sync_batch instead. The commit is durable once ::dm_commit_sync_wait succeeds.
  * @param [in] session to be committed
  * @param [in] c_ctx
  * @return Error code (SR_ERR_OK on success)
  */
 int dm_commit_write_files(dm_session_t *session, dm_commit_context_t *c_ctx);
 
+/**
+ * @brief Waits until the files of the group commit batch are flushed to the disk and releases
+ * the reference to the batch. If no other commit is flushing at the moment, the calling thread
+ * flushes the batch together with the files of all the commits that joined it meanwhile.
+ *
+ * @note If called with the commit lock held, no other commit can join the batch.
+ * @param [in] batch Batch returned by ::dm_commit_write_files, it must not be used after the call.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_IO if the flush failed.
+ */
+int dm_commit_sync_wait(dm_sync_batch_t *batch);
+
+/**
+ * @brief Releases the reference to the group commit batch without waiting for the flush.
+ * The files of the batch are flushed by the other commits of the batch, or together with the next
+ * group commit if there is none.
+ *
+ * @param [in] batch Batch returned by ::dm_commit_write_files, it must not be used after the call.
+ */
+void dm_commit_sync_release(dm_sync_batch_t *batch);
+
 /**
  * @brief Execute NETCONF access control (NACM) to determine if the user is allowed
  * to perform all the data modifications included in the commit.
@@ -552,6 +691,15 @@ int dm_commit_notify(dm_ctx_t *dm_ctx, dm_session_t *session, sr_notif_event_t e
  */
 void dm_free_commit_context(void *commit_ctx);
 
+/**
+ * @brief Makes sure that the session operation list of the current datastore has room for
+ * at least count more operations, so that they can be logged without reallocating the list.
+ * @param [in] session
+ * @param [in] count
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_reserve_operations(dm_session_t *session, size_t count);
+
 /**
  * @brief Logs add operation into session operation list. The operation list is used
  * during the commit. Passed allocated arguments are freed in case of error also.
@@ -686,6 +834,28 @@ uint16_t dm_get_node_data_depth(struct lys_node *node);
  */
 int dm_set_node_state(struct lys_node *node, dm_node_state_t state);
 
+/**
+ * @brief Checks whether a change (creation, update or removal) of an instance of the schema node can not violate
+ * any constraint in the data tree of the module. That is the case of a config leaf that has no constraints of its own
+ * (when, must, leafref, instance-identifier, unique, mandatory, default value), is not a part of a choice
+ * or a conditional subtree and that is not referenced by any when, must or leafref expression of the module.
+ * The value of the leaf is validated by libyang already when it is set.
+ *
+ * @param [in] schema_info Schema info of the module the node belongs to.
+ * @param [in] node Schema node.
+ * @return True if the change does not require the validation of the data tree.
+ */
+bool dm_is_change_unconstrained(dm_schema_info_t *schema_info, const struct lys_node *node);
+
+/**
+ * @brief Marks the data tree as modified.
+ *
+ * @param [in] info Modified data tree.
+ * @param [in] unconstrained Whether the change can not violate any constraint, see ::dm_is_change_unconstrained.
+ * Only changes that do not create any other node (e.g. the parent list instance) qualify.
+ */
+void dm_data_info_set_modified(dm_data_info_t *info, bool unconstrained);
+
 /**
  * @brief Returns true if argument is not NULL and session is tied to the running data store.
  * @param [in] session
@@ -693,6 +863,14 @@ int dm_set_node_state(struct lys_node *node, dm_node_state_t state);
  */
 bool dm_is_running_ds_session(dm_session_t *session);
 
+/**
+ * @brief Returns the generation of the session's data trees. It changes whenever a data tree of the session
+ * is replaced or a shared data tree is made private, so that the nodes looked up before must not be used anymore.
+ * @param [in] session
+ * @return Generation of the data trees
+ */
+uint32_t dm_get_session_trees_generation(const dm_session_t *session);
+
 /**
  * @brief Locks the module with exclusive lock in provided dm_ctx_t. When the module is locked, the changes
  * can be committed only by the session holding lock. Function does the
@@ -705,7 +883,7 @@ bool dm_is_running_ds_session(dm_session_t *session);
  * @param [in] dm_ctx
  * @param [in] session
  * @param [in] module_name
- * @return Error code (SR_ERR_OK on success), SR_ERR_LOCKED if the module is locked
+ * @return Error code (SR_ERR_OK on success), SR_ERR_LOCKED if the module or its subtree is locked
  * by other session, SR_ERR_UNAUTHORIZED if the file can no be locked because of permissions.
  */
 int dm_lock_module(dm_ctx_t *dm_ctx, dm_session_t *session, const char *module_name);
@@ -734,13 +912,49 @@ int dm_unlock_module(dm_ctx_t *dm_ctx, dm_session_t *session, char *modul_name);
 int dm_lock_datastore(dm_ctx_t *dm_ctx, dm_session_t *session);
 
 /**
- * @brief Releases all locks hold by the session
+ * @brief Releases all locks hold by the session, including the subtree locks.
  * @param [in] dm_ctx
  * @param [in] session
  * @return Error code (SR_ERR_OK on success)
  */
 int dm_unlock_datastore(dm_ctx_t *dm_ctx, dm_session_t *session);
 
+/**
+ * @brief Locks the subtree (typically a list instance) of a module in the datastore the session is tied to.
+ * Subtree locks of different sessions must not overlap, i.e. none of the locked nodes can be an ancestor of another one,
+ * and the module must not be locked by another session. While another session holds a subtree lock,
+ * the module can not be locked as a whole (::dm_lock_module).
+ *
+ * A commit fails with SR_ERR_LOCKED if one of its operations touches a subtree locked by another session.
+ * If all the operations of the commit in a module lie in the subtrees locked by the committing session,
+ * the module is committed with subtree scope - the data file is locked only while it is loaded and written, not while
+ * the commit is validated and verified, and the changes are applied again if the data file has been written
+ * by a commit of another process in the meantime. The commits of one process are still serialized by commit_lock
+ * of the Request Processor.
+ *
+ * The subtree locks are kept by the Data Manager of the process, so they exclude each other only within the process
+ * (i.e. the sessions of the daemon). Commits with subtree scope are allowed only if the versions of the data files
+ * are shared by the processes (see ::dm_version_table_get).
+ *
+ * @note Function acquires and releases read lock for the schema info.
+ *
+ * @param [in] dm_ctx
+ * @param [in] session
+ * @param [in] xpath Absolute xpath of the subtree root without wildcards.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_LOCKED if an overlapping subtree or the module is locked
+ * by another session, SR_ERR_UNAUTHORIZED if the module can not be locked because of permissions.
+ */
+int dm_lock_subtree(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath);
+
+/**
+ * @brief Releases the subtree lock acquired by ::dm_lock_subtree.
+ * @param [in] dm_ctx
+ * @param [in] session
+ * @param [in] xpath Xpath of the subtree passed to ::dm_lock_subtree.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_INVAL_ARG if the subtree is not locked by the session
+ */
+int dm_unlock_subtree(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath);
+
 /**
  * @brief Enables or disables the feature state in the module.
  *
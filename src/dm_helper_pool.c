@@ -0,0 +1,214 @@
+/**
+ * @file dm_helper_pool.c
+ * @brief Data Manager's pool of helper threads processing independent tasks in parallel.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "sr_common.h"
+#include "dm_helper_pool.h"
+
+/**
+ * @brief Tasks submitted by one ::dm_helper_pool_run call.
+ */
+typedef struct dm_helper_job_s {
+    dm_helper_task_cb func;       /**< callback processing a task */
+    char *tasks;                  /**< array of the tasks */
+    size_t task_size;             /**< size of one task */
+    size_t task_cnt;              /**< number of the tasks */
+    size_t claimed;               /**< number of tasks taken for processing */
+    size_t finished;              /**< number of processed tasks */
+    struct dm_helper_job_s *next; /**< next job in the queue */
+} dm_helper_job_t;
+
+/**
+ * @brief Pool of the helper threads.
+ */
+struct dm_helper_pool_s {
+    pthread_t *threads;           /**< helper threads */
+    size_t thread_cnt;            /**< number of started helper threads */
+    pthread_mutex_t mutex;        /**< guards the queue and the jobs */
+    pthread_cond_t work_cond;     /**< signaled when a job has been queued or the pool is being stopped */
+    pthread_cond_t done_cond;     /**< signaled when a task has been finished */
+    dm_helper_job_t *queue;       /**< jobs with tasks that have not been claimed yet */
+    bool stop;                    /**< flag requesting the helper threads to exit */
+};
+
+/**
+ * @brief Claims the next task of the first job in the queue, removes the job from the queue once
+ * all of its tasks are claimed. Must be called with the pool mutex held.
+ */
+static dm_helper_job_t *
+dm_helper_pool_claim(dm_helper_pool_t *pool, dm_helper_job_t *job, size_t *index)
+{
+    dm_helper_job_t **iter = NULL;
+
+    if (NULL == job) {
+        job = pool->queue;
+    }
+    if (NULL == job || job->claimed == job->task_cnt) {
+        return NULL;
+    }
+    *index = job->claimed++;
+    if (job->claimed == job->task_cnt) {
+        for (iter = &pool->queue; NULL != *iter; iter = &(*iter)->next) {
+            if (*iter == job) {
+                *iter = job->next;
+                break;
+            }
+        }
+    }
+    return job;
+}
+
+/**
+ * @brief Processes a claimed task, the pool mutex is released meanwhile.
+ */
+static void
+dm_helper_pool_process(dm_helper_pool_t *pool, dm_helper_job_t *job, size_t index)
+{
+    pthread_mutex_unlock(&pool->mutex);
+    job->func(job->tasks + index * job->task_size);
+    pthread_mutex_lock(&pool->mutex);
+
+    if (++job->finished == job->task_cnt) {
+        pthread_cond_broadcast(&pool->done_cond);
+    }
+}
+
+/**
+ * @brief Helper thread.
+ */
+static void *
+dm_helper_pool_thread(void *arg)
+{
+    dm_helper_pool_t *pool = (dm_helper_pool_t *) arg;
+    dm_helper_job_t *job = NULL;
+    size_t index = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->stop) {
+        job = dm_helper_pool_claim(pool, NULL, &index);
+        if (NULL == job) {
+            pthread_cond_wait(&pool->work_cond, &pool->mutex);
+            continue;
+        }
+        dm_helper_pool_process(pool, job, index);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+int
+dm_helper_pool_init(size_t thread_cnt, dm_helper_pool_t **pool_p)
+{
+    CHECK_NULL_ARG(pool_p);
+    dm_helper_pool_t *pool = NULL;
+    int rc = SR_ERR_OK;
+
+    pool = calloc(1, sizeof *pool);
+    CHECK_NULL_NOMEM_RETURN(pool);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    if (thread_cnt > 0) {
+        pool->threads = calloc(thread_cnt, sizeof *pool->threads);
+        CHECK_NULL_NOMEM_GOTO(pool->threads, rc, cleanup);
+    }
+    for (size_t i = 0; i < thread_cnt; i++) {
+        if (0 != pthread_create(&pool->threads[i], NULL, dm_helper_pool_thread, pool)) {
+            SR_LOG_ERR("Failed to start a helper thread: %s", sr_strerror_safe(errno));
+            rc = SR_ERR_INIT_FAILED;
+            goto cleanup;
+        }
+        pool->thread_cnt++;
+    }
+    SR_LOG_DBG("Started %zu Data Manager helper threads", pool->thread_cnt);
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        dm_helper_pool_cleanup(pool);
+        pool = NULL;
+    }
+    *pool_p = pool;
+    return rc;
+}
+
+void
+dm_helper_pool_cleanup(dm_helper_pool_t *pool)
+{
+    if (NULL == pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < pool->thread_cnt; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_cond_destroy(&pool->done_cond);
+    free(pool);
+}
+
+int
+dm_helper_pool_run(dm_helper_pool_t *pool, dm_helper_task_cb func, void *tasks, size_t task_size, size_t task_cnt)
+{
+    CHECK_NULL_ARG2(func, tasks);
+    dm_helper_job_t job = { 0, };
+    dm_helper_job_t **tail = NULL;
+    size_t index = 0;
+
+    if (NULL == pool || 0 == pool->thread_cnt || task_cnt < 2) {
+        for (size_t i = 0; i < task_cnt; i++) {
+            func((char *) tasks + i * task_size);
+        }
+        return SR_ERR_OK;
+    }
+
+    job.func = func;
+    job.tasks = tasks;
+    job.task_size = task_size;
+    job.task_cnt = task_cnt;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (tail = &pool->queue; NULL != *tail; tail = &(*tail)->next);
+    *tail = &job;
+    pthread_cond_broadcast(&pool->work_cond);
+
+    /* take part in the processing */
+    while (NULL != dm_helper_pool_claim(pool, &job, &index)) {
+        dm_helper_pool_process(pool, &job, index);
+    }
+    while (job.finished < job.task_cnt) {
+        pthread_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return SR_ERR_OK;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file dm_helper_pool.h
+ * @brief Data Manager's pool of helper threads processing independent tasks in parallel.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DM_HELPER_POOL_H_
+#define DM_HELPER_POOL_H_
+
+#include <stddef.h>
+
+/**
+ * @defgroup dm_helper_pool Data Manager Helper Pool
+ * @ingroup dm
+ * @{
+ *
+ * @brief Fixed number of helper threads used to process the per-module parts of a commit
+ * (validation, writing of the data files) in parallel. The thread that submits the tasks
+ * takes part in their processing and returns once all of them are finished, so the pool
+ * never limits the progress of the submitter - with no helper threads the tasks are
+ * processed sequentially by the submitter itself.
+ */
+
+/**
+ * @brief Pool of the helper threads.
+ */
+typedef struct dm_helper_pool_s dm_helper_pool_t;
+
+/**
+ * @brief Callback processing one task.
+ *
+ * @param [in] task Pointer to the task in the array passed to ::dm_helper_pool_run.
+ */
+typedef void (*dm_helper_task_cb)(void *task);
+
+/**
+ * @brief Starts the helper threads.
+ *
+ * @param [in] thread_cnt Number of helper threads, with 0 no threads are started.
+ * @param [out] pool Allocated pool.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_helper_pool_init(size_t thread_cnt, dm_helper_pool_t **pool);
+
+/**
+ * @brief Stops the helper threads and frees the pool. No tasks can be in progress.
+ *
+ * @param [in] pool
+ */
+void dm_helper_pool_cleanup(dm_helper_pool_t *pool);
+
+/**
+ * @brief Processes the tasks in parallel by the calling thread and the helper threads, returns
+ * once all the tasks have been processed. Can be called from several threads at the same time.
+ *
+ * @param [in] pool Pool of helper threads, can be NULL (tasks are processed sequentially).
+ * @param [in] func Callback called for each task.
+ * @param [in] tasks Array of the tasks.
+ * @param [in] task_size Size of one task in the array.
+ * @param [in] task_cnt Number of the tasks.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_helper_pool_run(dm_helper_pool_t *pool, dm_helper_task_cb func, void *tasks, size_t task_size, size_t task_cnt);
+
+/**@} dm_helper_pool */
+
+#endif /* DM_HELPER_POOL_H_ */
@@ -0,0 +1,853 @@
+/**
+ * @file dm_journal.c
+ * @brief Data Manager's journal of changes committed to the data files.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libyang/libyang.h>
+
+#include "sr_common.h"
+#include "dm_journal.h"
+
+#define DM_JOURNAL_MAGIC       0x4c4e524aU  /**< Magic number of the journal header ("JRNL") */
+#define DM_JOURNAL_BLOCK_MAGIC 0x4b4c424aU  /**< Magic number of a journal block ("JBLK") */
+
+/**
+ * @brief Operations recorded in the journal.
+ */
+typedef enum dm_journal_op_e {
+    DM_JOURNAL_OP_SET = 1,      /**< Create the node or update its value (path, value or NULL) */
+    DM_JOURNAL_OP_DELETE = 2,   /**< Delete the node (path) */
+    DM_JOURNAL_OP_MOVE = 3,     /**< Move the list or leaf-list instance (path, path of the preceding instance or NULL if first) */
+} dm_journal_op_t;
+
+/**
+ * @brief Header of the journal, identifies the data file content the journal has been started for.
+ */
+typedef struct dm_journal_header_s {
+    uint32_t magic;             /**< ::DM_JOURNAL_MAGIC */
+    uint32_t crc;               /**< Checksum of the following members */
+    uint64_t ino;               /**< Inode of the data file */
+    int64_t size;               /**< Size of the data file */
+    int64_t mtime_sec;          /**< Modification time of the data file (seconds) */
+    int64_t mtime_nsec;         /**< Modification time of the data file (nanoseconds) */
+} dm_journal_header_t;
+
+/**
+ * @brief Header of a journal block holding the changes of one commit. The block payload
+ * is followed by a copy of its size, so that the last block can be located from the end of the journal.
+ */
+typedef struct dm_journal_block_s {
+    uint32_t magic;             /**< ::DM_JOURNAL_BLOCK_MAGIC */
+    uint32_t size;              /**< Size of the payload */
+    uint32_t crc;               /**< Checksum of the payload */
+} dm_journal_block_t;
+
+/** Size of the block with the payload of given size */
+#define DM_JOURNAL_BLOCK_SIZE(PAYLOAD) ((off_t) sizeof(dm_journal_block_t) + (off_t) (PAYLOAD) + (off_t) sizeof(uint32_t))
+
+/** Length written in place of a string that is NULL */
+#define DM_JOURNAL_NULL_STR UINT32_MAX
+
+/**
+ * @brief Buffer the records of a block are serialized into.
+ */
+typedef struct dm_journal_buf_s {
+    char *data;
+    size_t size;
+    size_t allocated;
+} dm_journal_buf_t;
+
+static int
+dm_journal_get_file_name(const char *data_filename, char **journal_filename)
+{
+    CHECK_NULL_ARG2(data_filename, journal_filename);
+    return sr_str_join(data_filename, SR_JOURNAL_FILE_EXT, journal_filename);
+}
+
+/**
+ * @brief Fills the journal header describing the content of the data file.
+ */
+static void
+dm_journal_header_init(const struct stat *data_st, dm_journal_header_t *header)
+{
+    memset(header, 0, sizeof *header);
+    header->magic = DM_JOURNAL_MAGIC;
+    header->ino = (uint64_t) data_st->st_ino;
+    header->size = (int64_t) data_st->st_size;
+#ifdef HAVE_STAT_ST_MTIM
+    header->mtime_sec = (int64_t) data_st->st_mtim.tv_sec;
+    header->mtime_nsec = (int64_t) data_st->st_mtim.tv_nsec;
+#endif
+    header->crc = sr_crc32(&header->ino, sizeof *header - offsetof(dm_journal_header_t, ino));
+}
+
+/**
+ * @brief Reads the whole file into memory.
+ */
+static int
+dm_journal_read_all(int fd, size_t size, char **data)
+{
+    char *buf = NULL;
+
+    buf = malloc(size);
+    CHECK_NULL_NOMEM_RETURN(buf);
+
+    if (SR_ERR_OK != sr_pread_full(fd, buf, size, 0)) {
+        SR_LOG_ERR("Reading of the journal failed: %s", sr_strerror_safe(errno));
+        free(buf);
+        return SR_ERR_IO;
+    }
+
+    *data = buf;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Checks the block at the offset, returns the offset of the following block or -1 if the block is not valid.
+ */
+static off_t
+dm_journal_check_block(const char *data, off_t size, off_t offset)
+{
+    dm_journal_block_t block = {0};
+    uint32_t trailer = 0;
+
+    if (size - offset < DM_JOURNAL_BLOCK_SIZE(0)) {
+        return -1;
+    }
+    memcpy(&block, data + offset, sizeof block);
+    if (DM_JOURNAL_BLOCK_MAGIC != block.magic || size - offset < DM_JOURNAL_BLOCK_SIZE(block.size)) {
+        return -1;
+    }
+    memcpy(&trailer, data + offset + sizeof block + block.size, sizeof trailer);
+    if (trailer != block.size || block.crc != sr_crc32(data + offset + sizeof block, block.size)) {
+        return -1;
+    }
+    return offset + DM_JOURNAL_BLOCK_SIZE(block.size);
+}
+
+/**
+ * @brief Returns the first node among the siblings of the node.
+ */
+static struct lyd_node *
+dm_journal_first_sibling(struct lyd_node *node)
+{
+    while (NULL != node->prev->next) {
+        node = node->prev;
+    }
+    return node;
+}
+
+/**
+ * @brief Reads a string from the record, value is not copied.
+ */
+static int
+dm_journal_read_str(const char **p, const char *end, char **str)
+{
+    uint32_t len = 0;
+
+    if (end - *p < (ssize_t) sizeof len) {
+        return SR_ERR_MALFORMED_MSG;
+    }
+    memcpy(&len, *p, sizeof len);
+    *p += sizeof len;
+    if (DM_JOURNAL_NULL_STR == len) {
+        *str = NULL;
+        return SR_ERR_OK;
+    }
+    if (end - *p < (ssize_t) len + 1 || '\0' != (*p)[len]) {
+        return SR_ERR_MALFORMED_MSG;
+    }
+    *str = (char *) *p;
+    *p += len + 1;
+    return SR_ERR_OK;
+}
+
+static int
+dm_journal_apply_set(struct ly_ctx *ly_ctx, struct lyd_node **data_tree, const char *path, const char *value)
+{
+    struct lyd_node *node = NULL;
+
+    ly_errno = LY_SUCCESS;
+    node = lyd_new_path(*data_tree, ly_ctx, path, (void *) value, 0, LYD_PATH_OPT_UPDATE);
+    if (NULL == node && LY_SUCCESS != ly_errno) {
+        SR_LOG_ERR("Setting of %s failed: %s", path, ly_errmsg(ly_ctx));
+        return SR_ERR_INTERNAL;
+    }
+    if (NULL == *data_tree) {
+        *data_tree = node;
+    }
+    return SR_ERR_OK;
+}
+
+static int
+dm_journal_apply_delete(struct lyd_node **data_tree, const char *path)
+{
+    struct ly_set *set = NULL;
+    struct lyd_node *node = NULL;
+
+    if (NULL == *data_tree) {
+        return SR_ERR_OK;
+    }
+    set = lyd_find_path(*data_tree, path);
+    if (NULL == set) {
+        SR_LOG_ERR("Lookup of %s failed", path);
+        return SR_ERR_INTERNAL;
+    }
+    for (unsigned int i = 0; i < set->number; ++i) {
+        node = set->set.d[i];
+        if (node == *data_tree) {
+            *data_tree = node->next;
+        }
+        lyd_free(node);
+    }
+    ly_set_free(set);
+    return SR_ERR_OK;
+}
+
+static int
+dm_journal_apply_move(struct lyd_node **data_tree, const char *path, const char *after_path)
+{
+    struct ly_set *set = NULL;
+    struct lyd_node *node = NULL, *sibling = NULL;
+    int ret = 0;
+
+    if (NULL == *data_tree) {
+        return SR_ERR_INTERNAL;
+    }
+    set = lyd_find_path(*data_tree, path);
+    if (NULL == set || 1 != set->number) {
+        SR_LOG_ERR("Node %s to be moved not found", path);
+        ly_set_free(set);
+        return SR_ERR_INTERNAL;
+    }
+    node = set->set.d[0];
+    ly_set_free(set);
+
+    if (NULL != after_path) {
+        set = lyd_find_path(*data_tree, after_path);
+        if (NULL == set || 1 != set->number) {
+            SR_LOG_ERR("Node %s to move %s after not found", after_path, path);
+            ly_set_free(set);
+            return SR_ERR_INTERNAL;
+        }
+        sibling = set->set.d[0];
+        ly_set_free(set);
+        ret = lyd_insert_after(sibling, node);
+    } else {
+        /* move before the first instance */
+        sibling = dm_journal_first_sibling(node);
+        while (NULL != sibling && sibling->schema != node->schema) {
+            sibling = sibling->next;
+        }
+        if (sibling != node) {
+            ret = lyd_insert_before(sibling, node);
+        }
+    }
+    if (0 != ret) {
+        SR_LOG_ERR("Moving of %s failed", path);
+        return SR_ERR_INTERNAL;
+    }
+    if (NULL == node->parent) {
+        *data_tree = dm_journal_first_sibling(node);
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Applies the records of one block on the data tree.
+ */
+static int
+dm_journal_apply_block(struct ly_ctx *ly_ctx, struct lyd_node **data_tree, const char *payload, size_t size)
+{
+    const char *p = payload, *end = payload + size;
+    char *first = NULL, *second = NULL;
+    int rc = SR_ERR_OK;
+    uint8_t op = 0;
+
+    while (p < end) {
+        op = (uint8_t) *p++;
+        rc = dm_journal_read_str(&p, end, &first);
+        if (SR_ERR_OK == rc) {
+            rc = dm_journal_read_str(&p, end, &second);
+        }
+        if (SR_ERR_OK != rc || NULL == first) {
+            SR_LOG_ERR_MSG("Malformed journal record");
+            return SR_ERR_INTERNAL;
+        }
+
+        switch (op) {
+        case DM_JOURNAL_OP_SET:
+            rc = dm_journal_apply_set(ly_ctx, data_tree, first, second);
+            break;
+        case DM_JOURNAL_OP_DELETE:
+            rc = dm_journal_apply_delete(data_tree, first);
+            break;
+        case DM_JOURNAL_OP_MOVE:
+            rc = dm_journal_apply_move(data_tree, first, second);
+            break;
+        default:
+            SR_LOG_ERR("Unknown journal operation %d", op);
+            rc = SR_ERR_INTERNAL;
+        }
+        if (SR_ERR_OK != rc) {
+            return rc;
+        }
+        if (NULL != *data_tree) {
+            *data_tree = dm_journal_first_sibling(*data_tree);
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Opens the journal of the data file and checks whether it belongs to the current data file content.
+ *
+ * @param [out] valid Set to true if the journal header matches the data file.
+ * @param [out] size Size of the journal.
+ */
+static int
+dm_journal_open(const char *journal_filename, int data_fd, int flags, int *fd, bool *valid, off_t *size)
+{
+    dm_journal_header_t header = {0}, expected = {0};
+    struct stat st = {0};
+    ssize_t ret = 0;
+
+    *valid = false;
+    *size = 0;
+
+    if (0 != fstat(data_fd, &st)) {
+        SR_LOG_ERR("Stat of the data file failed: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+    dm_journal_header_init(&st, &expected);
+
+    *fd = open(journal_filename, flags, st.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+    if (-1 == *fd) {
+        if (ENOENT == errno) {
+            return SR_ERR_OK;
+        }
+        SR_LOG_ERR("Unable to open the journal %s: %s", journal_filename, sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+    if (0 != fstat(*fd, &st)) {
+        SR_LOG_ERR("Stat of the journal %s failed: %s", journal_filename, sr_strerror_safe(errno));
+        close(*fd);
+        *fd = -1;
+        return SR_ERR_IO;
+    }
+    *size = st.st_size;
+
+    if (*size >= (off_t) sizeof header) {
+        ret = pread(*fd, &header, sizeof header, 0);
+        *valid = (sizeof header == ret && 0 == memcmp(&header, &expected, sizeof header));
+    }
+    return SR_ERR_OK;
+}
+
+int
+dm_journal_replay(const char *data_filename, int data_fd, struct ly_ctx *ly_ctx, struct lyd_node **data_tree)
+{
+    CHECK_NULL_ARG3(data_filename, ly_ctx, data_tree);
+    char *journal_filename = NULL, *data = NULL;
+    dm_journal_block_t block = {0};
+    off_t size = 0, offset = 0, next = 0;
+    size_t count = 0;
+    bool valid = false;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_get_file_name(data_filename, &journal_filename);
+    CHECK_RC_MSG_RETURN(rc, "Get journal file name failed");
+
+    rc = dm_journal_open(journal_filename, data_fd, O_RDONLY, &fd, &valid, &size);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal open failed");
+
+    if (!valid) {
+        if (size > 0) {
+            SR_LOG_WRN("Journal %s does not belong to the data file, ignoring.", journal_filename);
+        }
+        goto cleanup;
+    }
+
+    rc = dm_journal_read_all(fd, size, &data);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal read failed");
+
+    offset = sizeof(dm_journal_header_t);
+    while (offset < size) {
+        next = dm_journal_check_block(data, size, offset);
+        if (-1 == next) {
+            SR_LOG_WRN("Journal %s contains an incomplete block at offset %lld, ignoring the rest of it.",
+                    journal_filename, (long long) offset);
+            break;
+        }
+        memcpy(&block, data + offset, sizeof block);
+        rc = dm_journal_apply_block(ly_ctx, data_tree, data + offset + sizeof block, block.size);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Replaying of journal %s failed", journal_filename);
+        offset = next;
+        count++;
+    }
+    SR_LOG_DBG("%zu commits replayed from journal %s", count, journal_filename);
+
+cleanup:
+    if (-1 != fd) {
+        close(fd);
+    }
+    free(data);
+    free(journal_filename);
+    return rc;
+}
+
+static int
+dm_journal_buf_add(dm_journal_buf_t *buf, const void *data, size_t size)
+{
+    char *tmp = NULL;
+    size_t new_size = 0;
+
+    if (buf->size + size > buf->allocated) {
+        new_size = buf->allocated ? buf->allocated * 2 : 256;
+        while (new_size < buf->size + size) {
+            new_size *= 2;
+        }
+        tmp = realloc(buf->data, new_size);
+        CHECK_NULL_NOMEM_RETURN(tmp);
+        buf->data = tmp;
+        buf->allocated = new_size;
+    }
+    memcpy(buf->data + buf->size, data, size);
+    buf->size += size;
+    return SR_ERR_OK;
+}
+
+static int
+dm_journal_buf_add_str(dm_journal_buf_t *buf, const char *str)
+{
+    uint32_t len = (NULL == str) ? DM_JOURNAL_NULL_STR : (uint32_t) strlen(str);
+    int rc = dm_journal_buf_add(buf, &len, sizeof len);
+    if (SR_ERR_OK == rc && NULL != str) {
+        rc = dm_journal_buf_add(buf, str, len + 1);
+    }
+    return rc;
+}
+
+static int
+dm_journal_buf_add_record(dm_journal_buf_t *buf, dm_journal_op_t op, const char *first, const char *second)
+{
+    uint8_t op_byte = (uint8_t) op;
+    int rc = dm_journal_buf_add(buf, &op_byte, sizeof op_byte);
+    if (SR_ERR_OK == rc) {
+        rc = dm_journal_buf_add_str(buf, first);
+    }
+    if (SR_ERR_OK == rc) {
+        rc = dm_journal_buf_add_str(buf, second);
+    }
+    return rc;
+}
+
+/**
+ * @brief Creates the path of the leaf-list without the predicate selecting the instance. The path is composed
+ * from the path of the parent, the value in the predicate could contain brackets.
+ */
+static int
+dm_journal_leaflist_path(const struct lyd_node *node, char **path)
+{
+    char *parent_path = NULL;
+    int rc = SR_ERR_OK;
+
+    if (NULL != node->parent) {
+        parent_path = lyd_path(node->parent);
+        CHECK_NULL_NOMEM_RETURN(parent_path);
+    }
+    if (NULL == node->parent || lyd_node_module(node->parent) != lyd_node_module(node)) {
+        rc = sr_asprintf(path, "%s/%s:%s", NULL != parent_path ? parent_path : "", lyd_node_module(node)->name,
+                node->schema->name);
+    } else {
+        rc = sr_asprintf(path, "%s/%s", parent_path, node->schema->name);
+    }
+    free(parent_path);
+    return rc;
+}
+
+/**
+ * @brief Records the operation on the node. The other node is the preceding instance in case of a move.
+ */
+static int
+dm_journal_add_node_record(dm_journal_buf_t *buf, dm_journal_op_t op, const struct lyd_node *node, const struct lyd_node *other)
+{
+    char *path = NULL, *other_path = NULL;
+    const char *value = NULL;
+    int rc = SR_ERR_OK;
+
+    if (DM_JOURNAL_OP_SET == op && LYS_LEAFLIST == node->schema->nodetype) {
+        /* new leaf-list instance is created by the value, the path must not contain the predicate */
+        rc = dm_journal_leaflist_path(node, &path);
+        CHECK_RC_MSG_RETURN(rc, "Leaf-list path can not be created");
+    } else {
+        path = lyd_path((struct lyd_node *) node);
+        CHECK_NULL_NOMEM_RETURN(path);
+    }
+
+    if (DM_JOURNAL_OP_MOVE == op) {
+        if (NULL != other) {
+            other_path = lyd_path((struct lyd_node *) other);
+            CHECK_NULL_NOMEM_GOTO(other_path, rc, cleanup);
+        }
+    } else if (DM_JOURNAL_OP_SET == op && (LYS_LEAF | LYS_LEAFLIST) & node->schema->nodetype) {
+        value = ((struct lyd_node_leaf_list *) node)->value_str;
+    }
+
+    rc = dm_journal_buf_add_record(buf, op, path, DM_JOURNAL_OP_MOVE == op ? other_path : value);
+
+cleanup:
+    free(path);
+    free(other_path);
+    return rc;
+}
+
+/**
+ * @brief Returns true if the node is a key of a list instance.
+ */
+static bool
+dm_journal_is_list_key(const struct lyd_node *node)
+{
+    const struct lys_node_list *slist = NULL;
+
+    if (LYS_LEAF != node->schema->nodetype || NULL == node->parent || LYS_LIST != node->parent->schema->nodetype) {
+        return false;
+    }
+    slist = (const struct lys_node_list *) node->parent->schema;
+    for (unsigned int i = 0; i < slist->keys_size; ++i) {
+        if ((const struct lys_node *) slist->keys[i] == node->schema) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Records creation of the subtree, implicitly created nodes (defaults, keys, non-presence containers)
+ * are skipped.
+ */
+static int
+dm_journal_add_created(dm_journal_buf_t *buf, const struct lyd_node *root)
+{
+    struct lyd_node *next = NULL, *elem = NULL;
+    int rc = SR_ERR_OK;
+
+    LY_TREE_DFS_BEGIN((struct lyd_node *) root, next, elem) {
+        if (!elem->dflt) {
+            switch (elem->schema->nodetype) {
+            case LYS_CONTAINER:
+                if (((struct lys_node_container *) elem->schema)->presence) {
+                    rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_SET, elem, NULL);
+                }
+                break;
+            case LYS_LEAF:
+                if (!dm_journal_is_list_key(elem)) {
+                    rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_SET, elem, NULL);
+                }
+                break;
+            case LYS_LIST:
+            case LYS_LEAFLIST:
+                rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_SET, elem, NULL);
+                break;
+            default:
+                rc = SR_ERR_UNSUPPORTED;
+            }
+            if (SR_ERR_OK != rc) {
+                return rc;
+            }
+        }
+        LY_TREE_DFS_END((struct lyd_node *) root, next, elem);
+    }
+    return rc;
+}
+
+/**
+ * @brief Serializes the diff into the journal block payload.
+ */
+static int
+dm_journal_diff_to_records(const struct lyd_difflist *diff, dm_journal_buf_t *buf)
+{
+    const struct lyd_node *first = NULL, *second = NULL;
+    int rc = SR_ERR_OK;
+
+    for (size_t i = 0; SR_ERR_OK == rc && LYD_DIFF_END != diff->type[i]; ++i) {
+        first = diff->first[i];
+        second = diff->second[i];
+        switch (diff->type[i]) {
+        case LYD_DIFF_DELETED:
+            if (!first->dflt) {
+                rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_DELETE, first, NULL);
+            }
+            break;
+        case LYD_DIFF_CHANGED:
+            if (!(LYS_LEAF & second->schema->nodetype)) {
+                rc = SR_ERR_UNSUPPORTED;
+            } else if (second->dflt) {
+                /* explicit value removed, the default one will be added by validation */
+                if (!first->dflt) {
+                    rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_DELETE, first, NULL);
+                }
+            } else {
+                rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_SET, second, NULL);
+            }
+            break;
+        case LYD_DIFF_CREATED:
+            rc = dm_journal_add_created(buf, second);
+            break;
+        case LYD_DIFF_MOVEDAFTER1:
+            rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_MOVE, first, second);
+            break;
+        case LYD_DIFF_MOVEDAFTER2:
+            rc = dm_journal_add_node_record(buf, DM_JOURNAL_OP_MOVE, second, first);
+            break;
+        default:
+            rc = SR_ERR_INTERNAL;
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief Finds the end of the last complete block of the journal.
+ */
+static int
+dm_journal_find_end(int fd, off_t size, off_t *end)
+{
+    char *data = NULL;
+    off_t offset = sizeof(dm_journal_header_t), next = 0, last = 0;
+    uint32_t trailer = 0;
+    int rc = SR_ERR_OK;
+
+    if (size == offset) {
+        *end = size;
+        return SR_ERR_OK;
+    }
+
+    /* the journal usually ends with a complete block, check just the last one */
+    if (size >= offset + DM_JOURNAL_BLOCK_SIZE(0) &&
+            sizeof trailer == pread(fd, &trailer, sizeof trailer, size - sizeof trailer) &&
+            size - DM_JOURNAL_BLOCK_SIZE(trailer) >= offset) {
+        last = size - DM_JOURNAL_BLOCK_SIZE(trailer);
+        data = malloc(DM_JOURNAL_BLOCK_SIZE(trailer));
+        CHECK_NULL_NOMEM_RETURN(data);
+        if (DM_JOURNAL_BLOCK_SIZE(trailer) == pread(fd, data, DM_JOURNAL_BLOCK_SIZE(trailer), last) &&
+                DM_JOURNAL_BLOCK_SIZE(trailer) == dm_journal_check_block(data, DM_JOURNAL_BLOCK_SIZE(trailer), 0)) {
+            free(data);
+            *end = size;
+            return SR_ERR_OK;
+        }
+        free(data);
+        data = NULL;
+    }
+
+    /* the last commit was interrupted, find the end of the complete blocks */
+    rc = dm_journal_read_all(fd, size, &data);
+    CHECK_RC_MSG_RETURN(rc, "Journal read failed");
+    while (offset < size && -1 != (next = dm_journal_check_block(data, size, offset))) {
+        offset = next;
+    }
+    SR_LOG_WRN("Discarding incomplete journal block at offset %lld", (long long) offset);
+    free(data);
+    *end = offset;
+    return SR_ERR_OK;
+}
+
+int
+dm_journal_append(const char *data_filename, int data_fd, const struct lyd_difflist *diff, off_t *journal_size,
+        int *sync_fd)
+{
+    CHECK_NULL_ARG3(data_filename, diff, journal_size);
+    char *journal_filename = NULL;
+    dm_journal_buf_t buf = {0};
+    dm_journal_block_t block = {0};
+    dm_journal_header_t header = {0};
+    struct stat data_st = {0};
+    uint32_t trailer = 0;
+    off_t size = 0, end = 0;
+    bool valid = false;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    /* serialize the changes first, the journal is not touched if they can not be recorded */
+    rc = dm_journal_buf_add(&buf, &block, sizeof block);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal buffer allocation failed");
+    rc = dm_journal_diff_to_records(diff, &buf);
+    if (SR_ERR_UNSUPPORTED == rc) {
+        SR_LOG_DBG("Changes can not be recorded in journal of %s", data_filename);
+        goto cleanup;
+    }
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Serialization of the changes failed");
+
+    block.magic = DM_JOURNAL_BLOCK_MAGIC;
+    block.size = (uint32_t) (buf.size - sizeof block);
+    block.crc = sr_crc32(buf.data + sizeof block, block.size);
+    memcpy(buf.data, &block, sizeof block);
+    trailer = block.size;
+    rc = dm_journal_buf_add(&buf, &trailer, sizeof trailer);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal buffer allocation failed");
+
+    rc = dm_journal_get_file_name(data_filename, &journal_filename);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get journal file name failed");
+
+    rc = dm_journal_open(journal_filename, data_fd, O_RDWR | O_CREAT, &fd, &valid, &size);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Journal open failed");
+    if (-1 == fd) {
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    if (valid) {
+        rc = dm_journal_find_end(fd, size, &end);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Journal check failed");
+    } else {
+        /* new journal for the current content of the data file */
+        if (0 != fstat(data_fd, &data_st)) {
+            SR_LOG_ERR("Stat of the data file %s failed: %s", data_filename, sr_strerror_safe(errno));
+            rc = SR_ERR_IO;
+            goto cleanup;
+        }
+        if (0 == size && 0 != fchown(fd, data_st.st_uid, data_st.st_gid)) {
+            /* keeping the ownership of the data file is best effort */
+            SR_LOG_DBG("Unable to change the owner of journal %s", journal_filename);
+        }
+        dm_journal_header_init(&data_st, &header);
+        rc = sr_pwrite_full(fd, &header, sizeof header, 0);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Writing of the journal %s header failed: %s", journal_filename, sr_strerror_safe(errno));
+        end = sizeof header;
+    }
+    if (end != size && 0 != ftruncate(fd, end)) {
+        SR_LOG_ERR("Truncation of the journal %s failed: %s", journal_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    rc = sr_pwrite_full(fd, buf.data, buf.size, end);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Writing to the journal %s failed: %s", journal_filename, sr_strerror_safe(errno));
+    if (NULL != sync_fd) {
+        /* synced by the caller */
+        *sync_fd = fd;
+        fd = -1;
+    } else if (0 != fsync(fd)) {
+        SR_LOG_ERR("Sync of the journal %s failed: %s", journal_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+    *journal_size = end + buf.size;
+    SR_LOG_DBG("Commit of %zu bytes appended to journal %s", buf.size, journal_filename);
+
+cleanup:
+    if (-1 != fd) {
+        close(fd);
+    }
+    free(buf.data);
+    free(journal_filename);
+    return rc;
+}
+
+int
+dm_journal_reset(const char *data_filename)
+{
+    CHECK_NULL_ARG(data_filename);
+    char *journal_filename = NULL;
+    int rc = SR_ERR_OK;
+    int fd = -1;
+
+    rc = dm_journal_get_file_name(data_filename, &journal_filename);
+    CHECK_RC_MSG_RETURN(rc, "Get journal file name failed");
+
+    fd = open(journal_filename, O_WRONLY);
+    if (-1 == fd) {
+        if (ENOENT != errno) {
+            SR_LOG_ERR("Unable to open the journal %s: %s", journal_filename, sr_strerror_safe(errno));
+            rc = SR_ERR_IO;
+        }
+        free(journal_filename);
+        return rc;
+    }
+    if (0 != ftruncate(fd, 0) || 0 != fsync(fd)) {
+        SR_LOG_ERR("Reset of the journal %s failed: %s", journal_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+    }
+    close(fd);
+    free(journal_filename);
+    return rc;
+}
+
+int
+dm_journal_get_size(const char *data_filename, off_t *size)
+{
+    CHECK_NULL_ARG2(data_filename, size);
+    char *journal_filename = NULL;
+    struct stat st = {0};
+    int rc = SR_ERR_OK;
+
+    rc = dm_journal_get_file_name(data_filename, &journal_filename);
+    CHECK_RC_MSG_RETURN(rc, "Get journal file name failed");
+
+    *size = 0;
+    if (0 == stat(journal_filename, &st)) {
+        *size = st.st_size;
+    } else if (ENOENT != errno) {
+        SR_LOG_ERR("Stat of the journal %s failed: %s", journal_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+    }
+    free(journal_filename);
+    return rc;
+}
+
+int
+dm_journal_stat(const char *data_filename, int data_fd, struct stat *st)
+{
+    CHECK_NULL_ARG2(data_filename, st);
+    char *journal_filename = NULL;
+    struct stat journal_st = {0};
+    int rc = SR_ERR_OK;
+
+    if (0 != ((-1 != data_fd) ? fstat(data_fd, st) : stat(data_filename, st))) {
+        return SR_ERR_IO;
+    }
+    if (0 == SR_JOURNAL_COMPACT_SIZE) {
+        return SR_ERR_OK;
+    }
+
+    rc = dm_journal_get_file_name(data_filename, &journal_filename);
+    CHECK_RC_MSG_RETURN(rc, "Get journal file name failed");
+
+    if (0 == stat(journal_filename, &journal_st) && journal_st.st_size > 0) {
+        st->st_size += journal_st.st_size;
+#ifdef HAVE_STAT_ST_MTIM
+        if (journal_st.st_mtim.tv_sec > st->st_mtim.tv_sec ||
+                (journal_st.st_mtim.tv_sec == st->st_mtim.tv_sec && journal_st.st_mtim.tv_nsec > st->st_mtim.tv_nsec)) {
+            st->st_mtim = journal_st.st_mtim;
+        }
+#endif
+    }
+    free(journal_filename);
+    return rc;
+}
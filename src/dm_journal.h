@@ -0,0 +1,107 @@
+/**
+ * @file dm_journal.h
+ * @brief Data Manager's journal of changes committed to the data files.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DM_JOURNAL_H_
+#define DM_JOURNAL_H_
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <libyang/libyang.h>
+
+/**
+ * @defgroup dm_journal Data Manager Journal
+ * @ingroup dm
+ * @{
+ *
+ * @brief Instead of rewriting the whole data file, a commit can append the changes made
+ * in the module to the journal file that accompanies the data file (data file name with
+ * ::SR_JOURNAL_FILE_EXT extension). The journal is replayed on top of the data file
+ * whenever the data file is loaded. Once the journal grows too large, the next commit
+ * writes the whole data file again and resets the journal.
+ *
+ * The journal is bound to the data file content it has been started for (inode, size and
+ * modification time). A journal left behind by an interrupted rewrite of the data file is
+ * therefore ignored. Each commit is appended as one checksummed block, a block that has not
+ * been written completely (crash during the commit) is ignored and overwritten by the next commit.
+ *
+ * All functions expect that the data file is locked by the caller - for reading
+ * in case of ::dm_journal_replay, for writing otherwise.
+ */
+
+/**
+ * @brief Applies the changes recorded in the journal of the data file on the data tree
+ * that has been loaded from the data file.
+ *
+ * @param [in] data_filename Path to the data file.
+ * @param [in] data_fd Opened data file the data tree has been loaded from.
+ * @param [in] ly_ctx libyang context of the data tree.
+ * @param [in,out] data_tree Data tree loaded from the data file, can be NULL if the file is empty.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_journal_replay(const char *data_filename, int data_fd, struct ly_ctx *ly_ctx, struct lyd_node **data_tree);
+
+/**
+ * @brief Appends the changes made by a commit to the journal of the data file.
+ *
+ * @param [in] data_filename Path to the data file.
+ * @param [in] data_fd Opened data file, its content must correspond to the data tree the diff has been computed from
+ * (with the journal replayed).
+ * @param [in] diff Changes made by the commit.
+ * @param [out] journal_size Size of the journal after the append.
+ * @param [out] sync_fd If not NULL, the journal is not synced, its descriptor is returned instead
+ * to be synced and closed by the caller. Otherwise the journal is synced before return.
+ * @return Error code (SR_ERR_OK on success), SR_ERR_UNSUPPORTED if the changes can not be
+ * recorded in the journal (the whole data file has to be written instead).
+ */
+int dm_journal_append(const char *data_filename, int data_fd, const struct lyd_difflist *diff, off_t *journal_size,
+        int *sync_fd);
+
+/**
+ * @brief Discards the journal of the data file, to be called once the whole data file has been written.
+ *
+ * @param [in] data_filename Path to the data file.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_journal_reset(const char *data_filename);
+
+/**
+ * @brief Returns the size of the journal of the data file.
+ *
+ * @param [in] data_filename Path to the data file.
+ * @param [out] size Size of the journal, 0 if there is none.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_journal_get_size(const char *data_filename, off_t *size);
+
+/**
+ * @brief Stats the data file including its journal - the size of the journal is added to the size
+ * of the data file and the modification time is the later one of both files. The result can be used
+ * to tell whether the content of the data file changed since it has been loaded.
+ *
+ * @param [in] data_filename Path to the data file.
+ * @param [in] data_fd Opened data file or -1 if the file should be stat by name.
+ * @param [out] st
+ * @return Error code (SR_ERR_OK on success), SR_ERR_IO if the data file can not be stat.
+ */
+int dm_journal_stat(const char *data_filename, int data_fd, struct stat *st);
+
+/**@} dm_journal */
+
+#endif /* DM_JOURNAL_H_ */
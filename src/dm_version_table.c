@@ -0,0 +1,439 @@
+/**
+ * @file dm_version_table.c
+ * @brief Data Manager's table of data file versions shared among the processes.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "sr_common.h"
+#include "dm_version_table.h"
+
+#define DM_VERSION_TABLE_MAGIC 0x53525654  /**< Identifies the version table file ("SRVT"). */
+#define DM_VERSION_TABLE_LAYOUT 2          /**< Layout of the version table, to be incremented on any change. */
+#define DM_VERSION_TABLE_SLOTS 1024        /**< Number of modules that fit into the version table. */
+#define DM_VERSION_NAME_SIZE 128           /**< Maximum length of a module name in the version table (including '\0'). */
+#define DM_VERSION_POLL_INTERVAL 10        /**< Interval (in milliseconds) of checking for a change where futex is not available. */
+#define DM_VERSION_BILLION 1000000000L     /**< one billion, used for time calculations. */
+
+/**
+ * @brief Entry of a module in the version table.
+ */
+typedef struct dm_version_slot_s {
+    atomic_uint used;                           /**< set once the module name has been filled in */
+    char module_name[DM_VERSION_NAME_SIZE];     /**< name of the module */
+    dm_module_versions_t versions;              /**< versions of the data files of the module */
+} dm_version_slot_t;
+
+/**
+ * @brief Content of the version table file.
+ */
+typedef struct dm_version_table_file_s {
+    uint32_t magic;                             /**< ::DM_VERSION_TABLE_MAGIC */
+    uint32_t layout;                            /**< ::DM_VERSION_TABLE_LAYOUT */
+    uint32_t slot_size;                         /**< size of one slot */
+    uint32_t slot_cnt;                          /**< number of the slots */
+    atomic_uint_fast64_t commit_cnt;            /**< number of the writes of all the data files */
+    atomic_uint_fast64_t last_commit_time;      /**< time (CLOCK_REALTIME, in nanoseconds) of the last write */
+    dm_version_slot_t slots[];                  /**< open addressing hash table of the modules */
+} dm_version_table_file_t;
+
+/**
+ * @brief Mapped version table.
+ */
+struct dm_version_table_s {
+    char *file_name;                            /**< path to the table file */
+    int fd;                                     /**< opened table file, locked while a module is being added */
+    dm_version_table_file_t *file;              /**< mapped content of the table file */
+    size_t size;                                /**< size of the mapping */
+    pthread_mutex_t mutex;                      /**< serializes the additions within the process */
+    size_t ref_count;                           /**< number of users of the table in the process */
+};
+
+/**
+ * @brief The table is mapped only once in the process - the file locks are owned by the process
+ * and closing any descriptor of the file would release them.
+ */
+static dm_version_table_t *dm_version_table = NULL;
+
+/**
+ * @brief Guards ::dm_version_table.
+ */
+static pthread_mutex_t dm_version_table_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Searches for the slot of the module. If the module is not present, returns NULL and the index
+ * of the slot where it can be added (or DM_VERSION_TABLE_SLOTS if the table is full).
+ */
+static dm_version_slot_t *
+dm_version_table_lookup(dm_version_table_t *table, const char *module_name, size_t *free_index)
+{
+    dm_version_slot_t *slot = NULL;
+    size_t index = sr_str_hash(module_name) % DM_VERSION_TABLE_SLOTS;
+
+    for (size_t i = 0; i < DM_VERSION_TABLE_SLOTS; i++, index = (index + 1) % DM_VERSION_TABLE_SLOTS) {
+        slot = &table->file->slots[index];
+        if (!atomic_load(&slot->used)) {
+            *free_index = index;
+            return NULL;
+        }
+        if (0 == strcmp(slot->module_name, module_name)) {
+            return slot;
+        }
+    }
+    *free_index = DM_VERSION_TABLE_SLOTS;
+    return NULL;
+}
+
+/**
+ * @brief Initializes the table file if it is empty, checks its layout otherwise.
+ * @note Function expects that the table file is locked for writing.
+ */
+static int
+dm_version_table_prepare(dm_version_table_t *table)
+{
+    dm_version_table_file_t header = { 0, };
+    struct stat st = { 0, };
+    ssize_t ret = 0;
+
+    if (0 != fstat(table->fd, &st)) {
+        SR_LOG_ERR("Unable to stat the version table '%s': %s", table->file_name, sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+
+    if (0 == st.st_size) {
+        /* zeroed slots are free, only the header has to be written */
+        header.magic = DM_VERSION_TABLE_MAGIC;
+        header.layout = DM_VERSION_TABLE_LAYOUT;
+        header.slot_size = sizeof(dm_version_slot_t);
+        header.slot_cnt = DM_VERSION_TABLE_SLOTS;
+        if (0 != ftruncate(table->fd, table->size) ||
+                sizeof header != pwrite(table->fd, &header, sizeof header, 0)) {
+            SR_LOG_ERR("Unable to initialize the version table '%s': %s", table->file_name, sr_strerror_safe(errno));
+            return SR_ERR_IO;
+        }
+        return SR_ERR_OK;
+    }
+
+    ret = pread(table->fd, &header, sizeof header, 0);
+    if (sizeof header != ret || (size_t) st.st_size != table->size || DM_VERSION_TABLE_MAGIC != header.magic ||
+            DM_VERSION_TABLE_LAYOUT != header.layout || sizeof(dm_version_slot_t) != header.slot_size ||
+            DM_VERSION_TABLE_SLOTS != header.slot_cnt) {
+        SR_LOG_WRN("Version table '%s' has unexpected layout.", table->file_name);
+        return SR_ERR_UNSUPPORTED;
+    }
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Frees the table, it must not be referenced anymore.
+ */
+static void
+dm_version_table_free(dm_version_table_t *table)
+{
+    if (NULL == table) {
+        return;
+    }
+    if (NULL != table->file) {
+        munmap(table->file, table->size);
+    }
+    if (-1 != table->fd) {
+        close(table->fd);
+    }
+    pthread_mutex_destroy(&table->mutex);
+    free(table->file_name);
+    free(table);
+}
+
+bool
+dm_version_table_supported(void)
+{
+    atomic_uint_fast64_t probe;
+
+    atomic_init(&probe, 0);
+    return atomic_is_lock_free(&probe);
+}
+
+/**
+ * @brief Opens the table file, creates it with the read and write permissions of the data search directory
+ * if it does not exist (regardless of umask), so that it is accessible to everyone who can write the data files.
+ */
+static int
+dm_version_table_file_open(const char *data_search_dir, const char *file_name)
+{
+    struct stat st = { 0, };
+    mode_t mode = 0;
+    int fd = -1;
+
+    fd = open(file_name, O_RDWR);
+    if (-1 != fd || ENOENT != errno) {
+        return fd;
+    }
+
+    if (0 != stat(data_search_dir, &st)) {
+        return -1;
+    }
+    mode = st.st_mode & (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+
+    fd = open(file_name, O_RDWR | O_CREAT | O_EXCL, mode);
+    if (-1 == fd) {
+        /* created by another process in the meantime */
+        return (EEXIST == errno) ? open(file_name, O_RDWR) : -1;
+    }
+    if (0 != fchmod(fd, mode)) {
+        SR_LOG_WRN("Unable to set the permissions of the version table '%s': %s", file_name, sr_strerror_safe(errno));
+    }
+    return fd;
+}
+
+int
+dm_version_table_open(const char *data_search_dir, dm_version_table_t **table_p)
+{
+    CHECK_NULL_ARG2(data_search_dir, table_p);
+    dm_version_table_t *table = NULL;
+    char *file_name = NULL;
+    void *addr = NULL;
+    int rc = SR_ERR_OK;
+
+    if (!dm_version_table_supported()) {
+        SR_LOG_WRN_MSG("64-bit atomic operations are not lock-free, the version table can not be shared.");
+        return SR_ERR_UNSUPPORTED;
+    }
+
+    rc = sr_str_join(data_search_dir, SR_VERSION_TABLE_FILE, &file_name);
+    CHECK_RC_MSG_RETURN(rc, "Unable to get the version table file name.");
+
+    pthread_mutex_lock(&dm_version_table_lock);
+    if (NULL != dm_version_table) {
+        if (0 == strcmp(dm_version_table->file_name, file_name)) {
+            dm_version_table->ref_count++;
+            *table_p = dm_version_table;
+        } else {
+            SR_LOG_WRN("Version table '%s' is already in use, '%s' can not be opened.", dm_version_table->file_name, file_name);
+            rc = SR_ERR_UNSUPPORTED;
+        }
+        pthread_mutex_unlock(&dm_version_table_lock);
+        free(file_name);
+        return rc;
+    }
+
+    table = calloc(1, sizeof *table);
+    CHECK_NULL_NOMEM_GOTO(table, rc, cleanup);
+    table->file_name = file_name;
+    file_name = NULL;
+    table->fd = -1;
+    table->size = sizeof(dm_version_table_file_t) + DM_VERSION_TABLE_SLOTS * sizeof(dm_version_slot_t);
+    table->ref_count = 1;
+    pthread_mutex_init(&table->mutex, NULL);
+
+    table->fd = dm_version_table_file_open(data_search_dir, table->file_name);
+    if (-1 == table->fd) {
+        SR_LOG_WRN("Unable to open the version table '%s': %s", table->file_name, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    rc = sr_lock_fd(table->fd, true, true);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to lock the version table '%s'.", table->file_name);
+    rc = dm_version_table_prepare(table);
+    sr_unlock_fd(table->fd);
+    if (SR_ERR_OK != rc) {
+        goto cleanup;
+    }
+
+    addr = mmap(NULL, table->size, PROT_READ | PROT_WRITE, MAP_SHARED, table->fd, 0);
+    if (MAP_FAILED == addr) {
+        SR_LOG_WRN("Unable to map the version table '%s': %s", table->file_name, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+    table->file = addr;
+
+    SR_LOG_DBG("Version table '%s' opened.", table->file_name);
+    dm_version_table = table;
+    *table_p = table;
+
+cleanup:
+    pthread_mutex_unlock(&dm_version_table_lock);
+    if (SR_ERR_OK != rc) {
+        dm_version_table_free(table);
+    }
+    free(file_name);
+    return rc;
+}
+
+void
+dm_version_table_close(dm_version_table_t *table)
+{
+    if (NULL == table) {
+        return;
+    }
+
+    pthread_mutex_lock(&dm_version_table_lock);
+    if (0 == --table->ref_count) {
+        dm_version_table = NULL;
+        dm_version_table_free(table);
+    }
+    pthread_mutex_unlock(&dm_version_table_lock);
+}
+
+dm_module_versions_t *
+dm_version_table_get(dm_version_table_t *table, const char *module_name)
+{
+    dm_version_slot_t *slot = NULL;
+    size_t index = 0;
+
+    if (NULL == table || NULL == module_name || strlen(module_name) >= DM_VERSION_NAME_SIZE) {
+        return NULL;
+    }
+
+    slot = dm_version_table_lookup(table, module_name, &index);
+    if (NULL != slot) {
+        return &slot->versions;
+    }
+
+    /* add the module, other threads and processes might be adding it as well */
+    pthread_mutex_lock(&table->mutex);
+    if (SR_ERR_OK == sr_lock_fd(table->fd, true, true)) {
+        slot = dm_version_table_lookup(table, module_name, &index);
+        if (NULL == slot && index < DM_VERSION_TABLE_SLOTS) {
+            slot = &table->file->slots[index];
+            strcpy(slot->module_name, module_name);
+            /* publishes the name to the lock-free lookups */
+            atomic_store(&slot->used, 1);
+        }
+        sr_unlock_fd(table->fd);
+    }
+    pthread_mutex_unlock(&table->mutex);
+
+    if (NULL == slot) {
+        SR_LOG_WRN("Module '%s' can not be added into the version table.", module_name);
+        return NULL;
+    }
+    return &slot->versions;
+}
+
+void
+dm_module_versions_init(dm_module_versions_t *versions)
+{
+    CHECK_NULL_ARG_VOID(versions);
+
+    for (size_t i = 0; i < DM_VERSION_COUNT; i++) {
+        atomic_init(&versions->version[i], 0);
+    }
+    atomic_init(&versions->change_seq, 0);
+    atomic_init(&versions->waiter_cnt, 0);
+}
+
+uint64_t
+dm_version_increment(dm_version_table_t *table, dm_module_versions_t *versions, int index)
+{
+    struct timespec ts = { 0, };
+    uint64_t version = atomic_fetch_add(&versions->version[index], 1) + 1;
+
+    atomic_fetch_add(&versions->change_seq, 1);
+    if (NULL != table) {
+        sr_clock_get_time(CLOCK_REALTIME, &ts);
+        atomic_store(&table->file->last_commit_time, (uint64_t) ts.tv_sec * DM_VERSION_BILLION + ts.tv_nsec);
+        atomic_fetch_add(&table->file->commit_cnt, 1);
+    }
+
+    /* a waiter registers itself before it checks change_seq, so it can not be missed */
+    if (0 != atomic_load(&versions->waiter_cnt)) {
+#ifdef __linux__
+        syscall(SYS_futex, &versions->change_seq, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+#endif
+    }
+
+    return version;
+}
+
+uint64_t
+dm_version_table_commit_cnt(dm_version_table_t *table, struct timespec *last_commit_time)
+{
+    uint64_t time = 0;
+
+    if (NULL == table) {
+        if (NULL != last_commit_time) {
+            last_commit_time->tv_sec = 0;
+            last_commit_time->tv_nsec = 0;
+        }
+        return 0;
+    }
+
+    if (NULL != last_commit_time) {
+        time = atomic_load(&table->file->last_commit_time);
+        last_commit_time->tv_sec = time / DM_VERSION_BILLION;
+        last_commit_time->tv_nsec = time % DM_VERSION_BILLION;
+    }
+    return atomic_load(&table->file->commit_cnt);
+}
+
+int
+dm_version_wait(dm_module_versions_t *versions, uint32_t change_seq, uint32_t timeout_ms)
+{
+    CHECK_NULL_ARG(versions);
+    struct timespec deadline = { 0, }, now = { 0, }, remaining = { 0, };
+    int64_t remaining_ns = 0;
+    bool changed = false;
+
+    sr_clock_get_time(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= DM_VERSION_BILLION) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= DM_VERSION_BILLION;
+    }
+
+    atomic_fetch_add(&versions->waiter_cnt, 1);
+    while (!(changed = (atomic_load(&versions->change_seq) != change_seq))) {
+        sr_clock_get_time(CLOCK_MONOTONIC, &now);
+        remaining_ns = (int64_t) (deadline.tv_sec - now.tv_sec) * DM_VERSION_BILLION + (deadline.tv_nsec - now.tv_nsec);
+        if (remaining_ns <= 0) {
+            break;
+        }
+#ifdef __linux__
+        remaining.tv_sec = remaining_ns / DM_VERSION_BILLION;
+        remaining.tv_nsec = remaining_ns % DM_VERSION_BILLION;
+        /* the table is shared among the processes, the futex can not be private */
+        syscall(SYS_futex, &versions->change_seq, FUTEX_WAIT, change_seq, &remaining, NULL, 0);
+#else
+        if (remaining_ns > DM_VERSION_POLL_INTERVAL * 1000000L) {
+            remaining_ns = DM_VERSION_POLL_INTERVAL * 1000000L;
+        }
+        remaining.tv_sec = remaining_ns / DM_VERSION_BILLION;
+        remaining.tv_nsec = remaining_ns % DM_VERSION_BILLION;
+        nanosleep(&remaining, NULL);
+#endif
+    }
+    atomic_fetch_sub(&versions->waiter_cnt, 1);
+
+    return changed ? SR_ERR_OK : SR_ERR_TIME_OUT;
+}
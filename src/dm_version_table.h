@@ -0,0 +1,171 @@
+/**
+ * @file dm_version_table.h
+ * @brief Data Manager's table of data file versions shared among the processes.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DM_VERSION_TABLE_H_
+#define DM_VERSION_TABLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <time.h>
+
+/**
+ * @defgroup dm_version_table Data Manager Version Table
+ * @ingroup dm
+ * @{
+ *
+ * @brief Table of monotonic versions of the data files of each module, stored in the file
+ * ::SR_VERSION_TABLE_FILE in the data search directory and mapped into the memory of all
+ * the processes accessing the data files. A version is incremented before its data file is
+ * written (with the data file locked for writing), so the data loaded from the file is up to date
+ * as long as the version has not changed since the load - the check needs no system call.
+ *
+ * The table also counts the writes of all the data files and records the time of the last one, so a process
+ * can tell that nothing has changed since its last check with one comparison. A process can wait for a change
+ * of the data files of a module (futex on Linux) instead of polling.
+ *
+ * Entries of the modules are added on demand and never removed. If a module has no entry (the table is full,
+ * or the name is too long), no process has one, so all of them fall back to the modification times of its files.
+ * A process that can not open the table at all must not write the data files (see ::dm_version_table_supported),
+ * the other processes would not notice the change.
+ */
+
+/** @brief Index of the version of the persist data file, the versions of the datastores are indexed by ::sr_datastore_t. */
+#define DM_VERSION_PERSIST 3
+
+/** @brief Number of the versions kept for each module. */
+#define DM_VERSION_COUNT 4
+
+/**
+ * @brief Versions of the data files of a module.
+ */
+typedef struct dm_module_versions_s {
+    atomic_uint_fast64_t version[DM_VERSION_COUNT];  /**< versions of the data files indexed by ::sr_datastore_t
+                                                          or ::DM_VERSION_PERSIST */
+    atomic_uint change_seq;                          /**< incremented together with any of the versions,
+                                                          the waiters for a change sleep on it */
+    atomic_uint waiter_cnt;                          /**< number of the waiters for a change of change_seq */
+} dm_module_versions_t;
+
+/**
+ * @brief Mapped version table.
+ */
+typedef struct dm_version_table_s dm_version_table_t;
+
+/**
+ * @brief Returns true if the version table can be shared among the processes on this platform
+ * (the 64-bit atomic operations are lock-free). In that case, any process that writes the data files
+ * has to do so with the table opened.
+ */
+bool dm_version_table_supported(void);
+
+/**
+ * @brief Opens the version table in the data search directory, creates it if it does not exist.
+ * A new table gets the read and write permissions of the data search directory.
+ *
+ * @param [in] data_search_dir Directory with the data files.
+ * @param [out] table Opened table.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int dm_version_table_open(const char *data_search_dir, dm_version_table_t **table);
+
+/**
+ * @brief Unmaps the version table. The versions returned by ::dm_version_table_get can not be used anymore.
+ *
+ * @param [in] table
+ */
+void dm_version_table_close(dm_version_table_t *table);
+
+/**
+ * @brief Returns the versions of the data files of the module, adds the module into the table if needed.
+ *
+ * @param [in] table Version table, can be NULL.
+ * @param [in] module_name Name of the module.
+ * @return Versions of the module located in the shared memory, NULL if the table is not available
+ * or there is no free entry left.
+ */
+dm_module_versions_t *dm_version_table_get(dm_version_table_t *table, const char *module_name);
+
+/**
+ * @brief Initializes the versions of a module that are not located in the table.
+ *
+ * @param [in] versions
+ */
+void dm_module_versions_init(dm_module_versions_t *versions);
+
+/**
+ * @brief Records that the data file is going to be written. To be called with the data file locked for writing,
+ * before its content is modified - a crash in the middle of the write can not leave the change unnoticed.
+ * Wakes up the waiters for a change of the module.
+ *
+ * @param [in] table Version table the write is counted in, can be NULL.
+ * @param [in] versions Versions of the module.
+ * @param [in] index Index of the data file (::sr_datastore_t or ::DM_VERSION_PERSIST).
+ * @return The new version.
+ */
+uint64_t dm_version_increment(dm_version_table_t *table, dm_module_versions_t *versions, int index);
+
+/**
+ * @brief Returns the number of the writes of all the data files recorded in the table and optionally
+ * the time of the last one. Unchanged number proves that no data file has been written in the meantime.
+ *
+ * @param [in] table
+ * @param [out] last_commit_time Time (CLOCK_REALTIME) of the last write, zero if unknown. Can be NULL.
+ * @return Number of the writes.
+ */
+uint64_t dm_version_table_commit_cnt(dm_version_table_t *table, struct timespec *last_commit_time);
+
+/**
+ * @brief Returns the sequence number of the changes of the module, to be passed to ::dm_version_wait.
+ *
+ * @param [in] versions Versions of the module.
+ */
+static inline uint32_t
+dm_version_change_seq(dm_module_versions_t *versions)
+{
+    return atomic_load(&versions->change_seq);
+}
+
+/**
+ * @brief Waits until a data file of the module is written by any process, i.e. until the sequence number
+ * of the changes differs from the provided one. Library-mode applications wait through ::sr_module_change_wait.
+ *
+ * @param [in] versions Versions of the module.
+ * @param [in] change_seq Sequence number returned by ::dm_version_change_seq before the data have been checked.
+ * @param [in] timeout_ms Maximum time to wait in milliseconds.
+ * @return Error code (SR_ERR_OK if the module has changed), SR_ERR_TIME_OUT if the timeout expired.
+ */
+int dm_version_wait(dm_module_versions_t *versions, uint32_t change_seq, uint32_t timeout_ms);
+
+/**
+ * @brief Returns the current version of the data file.
+ *
+ * @param [in] versions Versions of the module.
+ * @param [in] index Index of the data file (::sr_datastore_t or ::DM_VERSION_PERSIST).
+ */
+static inline uint64_t
+dm_version_get(dm_module_versions_t *versions, int index)
+{
+    return atomic_load(&versions->version[index]);
+}
+
+/**@} dm_version_table */
+
+#endif /* DM_VERSION_TABLE_H_ */
@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <signal.h>
@@ -63,7 +64,8 @@ srd_print_help()
     srd_print_version();
 
     printf("Usage:\n");
-    printf("  sysrepod [-h] [-v] [-d] [-l <level>]\n\n");
+    printf("  sysrepod [-h] [-v] [-d] [-l <level>] [-t <min threads>] [-T <max threads>] [-i <I/O threads>]\n");
+    printf("           [-q <queue size>] [-p <policy>]\n\n");
     printf("Options:\n");
     printf("  -h\t\tPrints usage help.\n");
     printf("  -v\t\tPrints version.\n");
@@ -74,6 +76,18 @@ srd_print_help()
     printf("\t\t\t2 = (default) log error and warning messages\n");
     printf("\t\t\t3 = log error, warning and informational messages\n");
     printf("\t\t\t4 = log everything, including development debug messages\n");
+    printf("  -t <count>\tMinimum number of request processing threads (default %d, raises the maximum if needed).\n",
+            SR_RP_THREAD_COUNT_MIN);
+    printf("  -T <count>\tMaximum number of request processing threads (default %d, lowers the minimum if needed).\n",
+            SR_RP_THREAD_COUNT_MAX);
+    printf("  -i <count>\tNumber of threads handling client connections, 0 = main thread only (default %d).\n", SR_CM_IO_THREAD_COUNT);
+    printf("  -q <count>\tMaximum number of event notifications waiting for a slow subscriber (default %d).\n", SR_NOTIF_QUEUE_SIZE);
+    printf("  -p <policy>\tPolicy applied when the event notification queue of a slow subscriber is full:\n");
+    printf("\t\t\tblock = the sender waits for the subscriber (at most %d ms, then drops\n", SR_NOTIF_BLOCK_TIMEOUT);
+    printf("\t\t\t        the notifications until the subscriber catches up)\n");
+    printf("\t\t\tdrop-oldest = (default) the oldest queued notification is dropped\n");
+    printf("\t\t\tdrop-newest = the new notification is dropped\n");
+    printf("\t\t\tcoalesce = the new notification replaces a queued one of the same subscription and xpath\n");
 }
 
 /**
@@ -88,9 +102,15 @@ main(int argc, char* argv[])
     int c = 0;
     bool debug_mode = false;
     int log_level = -1;
+    int thread_min = SR_RP_THREAD_COUNT_MIN, thread_max = SR_RP_THREAD_COUNT_MAX;
+    bool thread_min_set = false, thread_max_set = false;
+    int io_threads = SR_CM_IO_THREAD_COUNT;
+    int notif_queue_size = SR_NOTIF_QUEUE_SIZE;
+    cm_notif_overflow_policy_t notif_policy = CM_NOTIF_OVERFLOW_DEFAULT;
+    struct rusage usage = { 0, };
     int rc = SR_ERR_OK;
 
-    while ((c = getopt (argc, argv, "hvdl:")) != -1) {
+    while ((c = getopt (argc, argv, "hvdl:t:T:i:q:p:")) != -1) {
         switch (c) {
             case 'v':
                 srd_print_version();
@@ -102,12 +122,53 @@ main(int argc, char* argv[])
             case 'l':
                 log_level = atoi(optarg);
                 break;
+            case 't':
+                thread_min = atoi(optarg);
+                thread_min_set = true;
+                break;
+            case 'T':
+                thread_max = atoi(optarg);
+                thread_max_set = true;
+                break;
+            case 'i':
+                io_threads = atoi(optarg);
+                break;
+            case 'q':
+                notif_queue_size = atoi(optarg);
+                break;
+            case 'p':
+                if (SR_ERR_OK != cm_notif_overflow_policy_from_str(optarg, &notif_policy)) {
+                    fprintf(stderr, "Invalid event notification overflow policy '%s'.\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
             default:
                 srd_print_help();
                 return 0;
         }
     }
 
+    if (!thread_max_set && thread_min > thread_max) {
+        /* only the minimum has been specified */
+        thread_max = thread_min;
+    }
+    if (!thread_min_set && thread_min > thread_max) {
+        /* only the maximum has been specified */
+        thread_min = thread_max;
+    }
+    if (thread_min <= 0 || thread_min > thread_max) {
+        fprintf(stderr, "Invalid number of request processing threads (min=%d, max=%d).\n", thread_min, thread_max);
+        return EXIT_FAILURE;
+    }
+    if (io_threads < 0) {
+        fprintf(stderr, "Invalid number of connection handling threads (%d).\n", io_threads);
+        return EXIT_FAILURE;
+    }
+    if (notif_queue_size <= 0) {
+        fprintf(stderr, "Invalid size of the event notification queue (%d).\n", notif_queue_size);
+        return EXIT_FAILURE;
+    }
+
     /* init logger */
     sr_logger_init("sysrepod");
 
@@ -118,6 +179,18 @@ main(int argc, char* argv[])
     rc = cm_init(CM_MODE_DAEMON, SR_DAEMON_SOCKET, &sr_cm_ctx);
     CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to initialize Connection Manager: %s.", sr_strerror(rc));
 
+    /* set up the request processing thread pool */
+    rc = cm_set_rp_thread_limits(sr_cm_ctx, thread_min, thread_max);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to set up request processing threads: %s.", sr_strerror(rc));
+
+    /* set up the connection handling threads */
+    rc = cm_set_io_thread_count(sr_cm_ctx, io_threads);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to set up connection handling threads: %s.", sr_strerror(rc));
+
+    /* set up the delivery of event notifications to slow subscribers */
+    rc = cm_set_notif_queue_limits(sr_cm_ctx, notif_queue_size, notif_policy);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to set up event notification queues: %s.", sr_strerror(rc));
+
     /* install SIGTERM & SIGINT signal watchers */
     rc = cm_watch_signal(sr_cm_ctx, SIGTERM, srd_sigterm_cb);
     if (SR_ERR_OK == rc) {
@@ -131,6 +204,9 @@ main(int argc, char* argv[])
     }
 
     SR_LOG_INF_MSG("Sysrepo daemon initialized successfully.");
+    if (0 == getrusage(RUSAGE_SELF, &usage)) {
+        SR_LOG_INF("Peak memory usage during initialization: %ld kB.", usage.ru_maxrss);
+    }
 
     /* execute the server (the call is blocking in the event loop) */
     rc = cm_start(sr_cm_ctx);
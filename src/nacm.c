@@ -28,6 +28,7 @@
 
 #include "nacm.h"
 #include "data_manager.h"
+#include "dm_journal.h"
 #include "notification_processor.h"
 #include "sysrepo/xpath.h"
 
@@ -493,11 +494,15 @@ nacm_load_config(nacm_ctx_t *nacm_ctx, const sr_datastore_t ds)
     ly_ctx_set_module_data_clb(nacm_ctx->schema_info->ly_ctx, dm_module_clb, nacm_ctx->dm_ctx);
 
     ly_errno = 0;
-    data_tree = sr_lyd_parse_fd(nacm_ctx->schema_info->ly_ctx, fd, SR_FILE_FORMAT_LY, LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG);
+    /* the file is not converted here, the journal is bound to its current content */
+    data_tree = sr_lyd_parse_fd_any(nacm_ctx->schema_info->ly_ctx, fd, SR_FILE_FORMAT_LY,
+            LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG, NULL);
     if (NULL == data_tree && LY_SUCCESS != ly_errno) {
         SR_LOG_ERR("Parsing of data tree from file %s failed: %s", ds_filepath, ly_errmsg(nacm_ctx->schema_info->ly_ctx));
         goto cleanup;
     }
+    rc = dm_journal_replay(ds_filepath, fd, nacm_ctx->schema_info->ly_ctx, &data_tree);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Replaying of the journal of %s failed.", ds_filepath);
     close(fd);
     fd = -1;
 
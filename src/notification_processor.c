@@ -36,9 +36,9 @@
 #include "notification_processor.h"
 #include "request_processor.h"
 #include "data_manager.h"
+#include "np_notif_store.h"
 
 #define NP_NS_SCHEMA_FILE                  "sysrepo-notification-store.yang"  /**< Schema of notification store. */
-#define NP_NS_XPATH_NOTIFICATION           "/sysrepo-notification-store:notifications/notification[xpath='%s'][generated-time='%s'][logged-time='%u']"  /**< XPath of one notification entry */
 #define NP_NS_XPATH_NOTIFICATION_BY_XPATH  "/sysrepo-notification-store:notifications/notification[xpath='%s']" /**< XPath of notification entry identified only by xpath */
 
 /**
@@ -50,6 +50,15 @@ typedef struct np_dst_info_s {
     size_t subscribed_modules_cnt;  /**< Number of the modules with subscriptions. */
 } np_dst_info_t;
 
+/**
+ * @brief Verify notification waiting for the acknowledgment of its verifier.
+ */
+typedef struct np_verify_pending_s {
+    char *dst_address;               /**< Destination address of the verifier's subscription. */
+    uint32_t dst_id;                 /**< Destination ID of the verifier's subscription. */
+    struct timespec sent_time;       /**< Time (CLOCK_MONOTONIC) when the notification has been sent. */
+} np_verify_pending_t;
+
 /**
  * @brief Context holding information about notifications sent per commit.
  */
@@ -57,6 +66,8 @@ typedef struct np_commit_ctx_s {
     uint32_t commit_id;              /**< Commit identifier. */
     bool all_notifications_sent;     /**< Flag indicating whether all commit notifications has been already sent. */
     bool commit_finished;            /**< TRUE if commit has finished and can be released, FALSE if it will continue with another phase. */
+    bool verify_completed;           /**< TRUE if the verify phase has been completed, verify ACKs received later are late. */
+    sr_list_t *verify_pending;       /**< Verify notifications not acknowledged yet (::np_verify_pending_t). */
     size_t notifications_sent;       /**< Count of sent notifications. */
     size_t notifications_acked;      /**< Count of received acknowledgments. */
     int result;                      /**< Used to store overall result of the commit operation. */
@@ -79,6 +90,8 @@ typedef struct np_ctx_s {
     const struct lys_module *ns_schema;   /**< Schema tree of the notification store YANG. */
     sr_locking_set_t *lock_ctx;           /**< Context for locking notification store files. */
     bool do_notif_store_cleanup;          /**< TRUE if notification store cleanups should be performed.*/
+    np_verifier_stats_t *verifier_stats;  /**< Statistics of the commit verifiers. */
+    size_t verifier_stats_cnt;            /**< Number of the commit verifiers with statistics. */
 } np_ctx_t;
 
 /**
@@ -285,6 +298,27 @@ np_commit_ctx_find(np_ctx_t *np_ctx, uint32_t commit_id, sr_llist_node_t **llist
     }
 }
 
+/**
+ * @brief Frees the commit context including the verify notifications that have not been acknowledged.
+ */
+static void
+np_commit_ctx_free(np_commit_ctx_t *commit)
+{
+    np_verify_pending_t *pending = NULL;
+
+    if (NULL != commit) {
+        if (NULL != commit->verify_pending) {
+            for (size_t i = 0; i < commit->verify_pending->count; i++) {
+                pending = commit->verify_pending->data[i];
+                free(pending->dst_address);
+                free(pending);
+            }
+            sr_list_cleanup(commit->verify_pending);
+        }
+        free(commit);
+    }
+}
+
 /**
  * @brief Create a commit for the specified commit ID.
  */
@@ -316,6 +350,136 @@ unlock:
     return commit;
 }
 
+/**
+ * @brief Records that a verify notification is being sent to the subscription of a verifier.
+ */
+static int
+np_commit_verify_pending_add(np_ctx_t *np_ctx, np_commit_ctx_t *commit, const np_subscription_t *subscription)
+{
+    np_verify_pending_t *pending = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(np_ctx, commit, subscription, subscription->dst_address);
+
+    pending = calloc(1, sizeof(*pending));
+    CHECK_NULL_NOMEM_RETURN(pending);
+    pending->dst_address = strdup(subscription->dst_address);
+    CHECK_NULL_NOMEM_GOTO(pending->dst_address, rc, cleanup);
+    pending->dst_id = subscription->dst_id;
+    sr_clock_get_time(CLOCK_MONOTONIC, &pending->sent_time);
+
+    pthread_rwlock_wrlock(&np_ctx->lock);
+    if (NULL == commit->verify_pending) {
+        rc = sr_list_init(&commit->verify_pending);
+    }
+    if (SR_ERR_OK == rc) {
+        rc = sr_list_add(commit->verify_pending, pending);
+    }
+    pthread_rwlock_unlock(&np_ctx->lock);
+
+cleanup:
+    if (SR_ERR_OK != rc) {
+        free(pending->dst_address);
+        free(pending);
+    }
+    return rc;
+}
+
+/**
+ * @brief Returns the statistics of the verifier identified by its subscription, adds a new entry if needed.
+ * Expects the NP context locked for writing.
+ */
+static np_verifier_stats_t *
+np_verifier_stats_get(np_ctx_t *np_ctx, const char *dst_address, uint32_t dst_id, const char *subs_xpath)
+{
+    np_verifier_stats_t *tmp = NULL, *stats = NULL;
+
+    for (size_t i = 0; i < np_ctx->verifier_stats_cnt; i++) {
+        if (dst_id == np_ctx->verifier_stats[i].dst_id && 0 == strcmp(np_ctx->verifier_stats[i].dst_address, dst_address)) {
+            return &np_ctx->verifier_stats[i];
+        }
+    }
+
+    tmp = realloc(np_ctx->verifier_stats, (np_ctx->verifier_stats_cnt + 1) * sizeof(*tmp));
+    if (NULL == tmp) {
+        SR_LOG_ERR_MSG("Unable to allocate memory for verifier statistics.");
+        return NULL;
+    }
+    np_ctx->verifier_stats = tmp;
+    stats = &np_ctx->verifier_stats[np_ctx->verifier_stats_cnt];
+    memset(stats, 0, sizeof(*stats));
+    stats->dst_address = strdup(dst_address);
+    stats->dst_id = dst_id;
+    stats->subs_xpath = strdup(subs_xpath);
+    if (NULL == stats->dst_address || NULL == stats->subs_xpath) {
+        SR_LOG_ERR_MSG("Unable to allocate memory for verifier statistics.");
+        free(stats->dst_address);
+        free(stats->subs_xpath);
+        return NULL;
+    }
+    np_ctx->verifier_stats_cnt++;
+
+    return stats;
+}
+
+/**
+ * @brief Matches the verify ACK with its pending notification and accounts it in the statistics of the verifier.
+ * Expects the NP context locked for writing.
+ */
+static void
+np_commit_verify_ack_account(np_ctx_t *np_ctx, np_commit_ctx_t *commit, const char *dst_address, uint32_t dst_id,
+        const char *subs_xpath, int result, bool late)
+{
+    np_verifier_stats_t *stats = NULL;
+    np_verify_pending_t *pending = NULL;
+    struct timespec now = {0};
+    uint64_t latency = 0;
+    size_t bucket = 0;
+
+    if (NULL == dst_address || NULL == subs_xpath) {
+        return;
+    }
+
+    /* several subscriptions may share the xpath, the ACK is matched by its subscription */
+    for (size_t i = 0; (NULL != commit->verify_pending) && (i < commit->verify_pending->count); i++) {
+        pending = commit->verify_pending->data[i];
+        if (dst_id == pending->dst_id && 0 == strcmp(pending->dst_address, dst_address)) {
+            sr_list_rm_at(commit->verify_pending, i);
+            break;
+        }
+        pending = NULL;
+    }
+
+    stats = np_verifier_stats_get(np_ctx, dst_address, dst_id, subs_xpath);
+    if (NULL != stats) {
+        stats->verify_cnt++;
+        if (SR_ERR_OK != result) {
+            stats->error_cnt++;
+        }
+        if (late) {
+            stats->late_cnt++;
+        }
+        if (NULL != pending) {
+            sr_clock_get_time(CLOCK_MONOTONIC, &now);
+            latency = (now.tv_sec - pending->sent_time.tv_sec) * 1000 +
+                    (now.tv_nsec - pending->sent_time.tv_nsec) / 1000000;
+            if (latency > stats->max_latency) {
+                stats->max_latency = latency > UINT32_MAX ? UINT32_MAX : latency;
+            }
+            /* bucket i counts the latencies below 2^i ms, the last one all the others */
+            while ((bucket < NP_VERIFY_LATENCY_BUCKETS - 1) && (latency >= (1ULL << bucket))) {
+                bucket++;
+            }
+            stats->latency_hist[bucket]++;
+        }
+    }
+
+    if (NULL != pending) {
+        free(pending->dst_address);
+        free(pending);
+    }
+}
+
 /**
  * @brief Adds an error xpath into commit context.
  */
@@ -354,16 +518,16 @@ np_commit_error_add(np_commit_ctx_t *commit_ctx, const char *err_subs_xpath, boo
 }
 
 /**
- * @brief Loads the data tree from provided file.
+ * @brief Opens (creates if it does not exist and write access is requested) and locks provided data file.
  */
 static int
-np_load_data_tree(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *data_filename,
-        const bool read_only, struct lyd_node **data_tree, int *fd_p)
+np_open_data_file(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *data_filename, const bool read_only,
+        int *fd_p)
 {
     int fd = -1;
     int rc = SR_ERR_OK;
 
-    CHECK_NULL_ARG4(np_ctx, np_ctx->rp_ctx, data_filename, data_tree);
+    CHECK_NULL_ARG4(np_ctx, np_ctx->rp_ctx, data_filename, fd_p);
 
     /* open the file as the proper user */
     if (NULL != user_cred) {
@@ -405,10 +569,39 @@ np_load_data_tree(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *dat
         }
     }
 
-    /* lock & load the data tree */
+    /* lock the file */
     rc = sr_locking_set_lock_fd(np_ctx->lock_ctx, fd, data_filename, (read_only ? false : true), true);
-    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to lock data file '%s'.", data_filename);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Unable to lock data file '%s'.", data_filename);
+        close(fd);
+        goto cleanup;
+    }
+
+    *fd_p = fd;
+
+cleanup:
+    return rc;
+}
 
+/**
+ * @brief Loads the data tree from provided file.
+ */
+static int
+np_load_data_tree(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *data_filename,
+        const bool read_only, struct lyd_node **data_tree, int *fd_p)
+{
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG4(np_ctx, np_ctx->rp_ctx, data_filename, data_tree);
+
+    /* open & lock the file */
+    rc = np_open_data_file(np_ctx, user_cred, data_filename, read_only, &fd);
+    if (SR_ERR_OK != rc) {
+        return rc;
+    }
+
+    /* load the data tree */
     ly_errno = LY_SUCCESS;
     *data_tree = sr_lyd_parse_fd(np_ctx->ly_ctx, fd, SR_FILE_FORMAT_LY, LYD_OPT_STRICT | LYD_OPT_CONFIG);
     if (NULL == *data_tree && LY_SUCCESS != ly_errno) {
@@ -426,49 +619,33 @@ np_load_data_tree(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *dat
         *fd_p = fd;
     }
 
-cleanup:
     return rc;
 }
 
 /**
- * @brief Saves the data tree into the file specified by file descriptor.
- */
-static int
-np_save_data_tree(struct lyd_node *data_tree, int fd)
-{
-    int ret = 0;
-
-    CHECK_NULL_ARG(data_tree);
-
-    /* empty file content */
-    ret = ftruncate(fd, 0);
-    CHECK_ZERO_LOG_RETURN(ret, SR_ERR_INTERNAL, "File truncate failed: %s", sr_strerror_safe(errno));
-
-    /* print data tree to file */
-    ret = lyd_print_fd(fd, data_tree, SR_FILE_FORMAT_LY, LYP_WITHSIBLINGS | LYP_FORMAT | LYP_WD_EXPLICIT);
-    CHECK_ZERO_LOG_RETURN(ret, SR_ERR_INTERNAL, "Saving notification store data tree failed: %s",
-                          ly_errmsg(data_tree->schema->module->ctx));
-
-    /* flush in-core data to the disc */
-    ret = fsync(fd);
-    CHECK_ZERO_LOG_RETURN(ret, SR_ERR_INTERNAL, "File synchronization failed: %s", sr_strerror_safe(errno));
-
-    SR_LOG_DBG_MSG("Data tree successfully saved.");
-
-    return SR_ERR_OK;
-}
-
-/**
- * @brief Cleans up specified data tree and closes specified file descriptor.
+ * @brief Creates a notification store file if it does not exist and applies the access permissions of the module.
  */
 static void
-np_cleanup_data_tree(np_ctx_t *np_ctx, struct lyd_node *data_tree, int fd)
+np_create_notif_store_file(const char *module_name, const char *filename)
 {
-    if (NULL != data_tree) {
-        lyd_free_withsiblings(data_tree);
-    }
-    if (-1 != fd && NULL != np_ctx) {
-        sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, fd);
+    mode_t old_umask = 0;
+    int fd = -1;
+    int rc = SR_ERR_OK;
+
+    if (-1 == access(filename, F_OK)) {
+        old_umask = umask(0);
+        fd = open(filename, O_CREAT, S_IRUSR | S_IWUSR);
+        umask(old_umask);
+        if (-1 == fd) {
+            SR_LOG_WRN("Error by opening file '%s': %s.", filename, sr_strerror_safe(errno));
+        } else {
+            /* close and apply access permissions */
+            close(fd);
+            rc = sr_set_data_file_permissions(filename, false, SR_DATA_SEARCH_DIR, module_name, false);
+            if (SR_ERR_OK != rc) {
+                SR_LOG_WRN("Error by applying correct data file permissions on file '%s'.", filename);
+            }
+        }
     }
 }
 
@@ -481,7 +658,7 @@ np_get_notif_store_filename(const char *module_name, time_t received_time, char
     mode_t old_umask = 0;
     time_t raw_time = 0;
     struct tm *tm_time = { 0, };
-    int fd = -1;
+    char *index_filename = NULL;
     int ret = 0, rc = SR_ERR_OK;
 
     /* create the parent directory for notifications (if it does not exist already) */
@@ -512,28 +689,28 @@ np_get_notif_store_filename(const char *module_name, time_t received_time, char
     /* move raw_time back to the beginning of the current NP_NOTIF_FILE_WINDOW */
     raw_time -= (((tm_time->tm_hour * 60) + tm_time->tm_min) % SR_NOTIF_TIME_WINDOW) * 60;
     strftime(filename_buff + strlen(filename_buff), filename_buff_size - strlen(filename_buff) - 1,
-            "%Y-%m-%d_%H-%M." SR_FILE_FORMAT_EXT, localtime(&raw_time));
+            "%Y-%m-%d_%H-%M" SR_NOTIF_STORE_FILE_EXT, localtime(&raw_time));
 
-    /* create file if not exists & apply access permissions */
-    if (-1 == access(filename_buff, F_OK)) {
-        old_umask = umask(0);
-        fd = open(filename_buff, O_CREAT, S_IRUSR | S_IWUSR);
-        if (-1 == fd) {
-            SR_LOG_WRN("Error by opening file '%s': %s.", filename_buff, sr_strerror_safe(errno));
-        } else {
-            /* close and apply access permissions */
-            close(fd);
-            umask(old_umask);
-            rc = sr_set_data_file_permissions(filename_buff, false, SR_DATA_SEARCH_DIR, module_name, false);
-            if (SR_ERR_OK != rc) {
-                SR_LOG_WRN("Error by applying correct data file permissions on file '%s'.", filename_buff);
-            }
-        }
-    }
+    /* create the log and its index if they do not exist & apply access permissions */
+    np_create_notif_store_file(module_name, filename_buff);
+    rc = np_notif_store_index_filename(filename_buff, &index_filename);
+    CHECK_RC_MSG_RETURN(rc, "Unable to compose notification index file name.");
+    np_create_notif_store_file(module_name, index_filename);
+    free(index_filename);
 
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Returns true if the file is an event notification log, false if it is a notification data file
+ * written by an older version of the notification store.
+ */
+static bool
+np_is_notif_store_log(const char *filename)
+{
+    return sr_str_ends_with(filename, SR_NOTIF_STORE_FILE_EXT);
+}
+
 /**
  * @brief Get notification files of given module with last modification time from provided time interval.
  */
@@ -566,7 +743,7 @@ np_get_notification_files(np_ctx_t *np_ctx, const char *module_name, time_t time
         }
     } else {
         for (size_t i = 0; i < dir_elem_cnt; i++) {
-            if ((DT_DIR != entries[i]->d_type) &&
+            if ((DT_DIR != entries[i]->d_type) && !sr_str_ends_with(entries[i]->d_name, SR_NOTIF_INDEX_FILE_EXT) &&
                     (0 != strcmp(entries[i]->d_name, ".")) && (0 != strcmp(entries[i]->d_name, ".."))) {
                 /* for each file */
                 snprintf(filename, PATH_MAX - 1, "%s/%s", dirname, entries[i]->d_name);
@@ -651,6 +828,7 @@ np_event_notification_content_cleanup(np_ev_notification_t *notification)
             default:
                 break;
         }
+        free(notification->data_buf);
         free((void*)notification->xpath);
     }
 }
@@ -832,10 +1010,11 @@ np_cleanup(np_ctx_t *np_ctx)
         /* cleanup unfinished commits */
         node = np_ctx->commits->first;
         while (NULL != node) {
-            free(node->data);
+            np_commit_ctx_free(node->data);
             node = node->next;
         }
         sr_llist_cleanup(np_ctx->commits);
+        np_verifier_stats_free(np_ctx->verifier_stats, np_ctx->verifier_stats_cnt);
 
         sr_btree_cleanup(np_ctx->dst_info_btree);
         pthread_rwlock_destroy(&np_ctx->lock);
@@ -1020,6 +1199,7 @@ np_notification_subscribe(np_ctx_t *np_ctx, const rp_session_t *rp_session, Sr__
     subscription->priority = priority;
     subscription->enable_running = (opts & NP_SUBSCR_ENABLE_RUNNING);
     subscription->enable_nacm = (rp_session->options & SR_SESS_ENABLE_NACM);
+    subscription->inline_changes = (opts & NP_SUBSCR_INLINE_CHANGES);
     subscription->api_variant = api_variant;
 
     if (NULL != xpath) {
@@ -1385,9 +1565,12 @@ np_get_data_provider_subscriptions(np_ctx_t *np_ctx, const rp_session_t *rp_sess
 }
 
 int
-np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id)
+np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id,
+        const uint8_t *changes, size_t changes_size)
 {
     Sr__Msg *notif = NULL;
+    ProtobufCBinaryData *notif_changes = NULL;
+    protobuf_c_boolean *has_notif_changes = NULL;
     int rc = SR_ERR_OK;
     np_commit_ctx_t *commit;
 
@@ -1405,11 +1588,26 @@ np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_not
             notif->notification->module_change_notif->event = sr_notification_event_sr_to_gpb(event);
             notif->notification->module_change_notif->module_name = strdup(subscription->module_name);
             CHECK_NULL_NOMEM_ERROR(notif->notification->module_change_notif->module_name, rc);
+            notif_changes = &notif->notification->module_change_notif->changes;
+            has_notif_changes = &notif->notification->module_change_notif->has_changes;
         }
         if (SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
             notif->notification->subtree_change_notif->event = sr_notification_event_sr_to_gpb(event);
             notif->notification->subtree_change_notif->xpath = strdup(subscription->xpath);
             CHECK_NULL_NOMEM_ERROR(notif->notification->subtree_change_notif->xpath, rc);
+            notif_changes = &notif->notification->subtree_change_notif->changes;
+            has_notif_changes = &notif->notification->subtree_change_notif->has_changes;
+        }
+    }
+
+    if (SR_ERR_OK == rc && subscription->inline_changes && NULL != changes && NULL != notif_changes) {
+        /* the changes are packed only once for all the subscribers, each notification gets its copy */
+        notif_changes->data = malloc(changes_size);
+        CHECK_NULL_NOMEM_ERROR(notif_changes->data, rc);
+        if (SR_ERR_OK == rc) {
+            memcpy(notif_changes->data, changes, changes_size);
+            notif_changes->len = changes_size;
+            *has_notif_changes = true;
         }
     }
 
@@ -1423,6 +1621,10 @@ np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_not
         if (!commit) {
             return SR_ERR_INTERNAL;
         }
+        if (SR_EV_VERIFY == event) {
+            /* the latency of the verifier is measured from now on */
+            np_commit_verify_pending_add(np_ctx, commit, subscription);
+        }
         /* send the message */
         rc = cm_msg_send(np_ctx->rp_ctx->cm_ctx, notif);
         if (SR_ERR_OK == rc) {
@@ -1554,6 +1756,12 @@ np_commit_notifications_sent(np_ctx_t *np_ctx, uint32_t commit_id, bool commit_f
                 /* all ACKs already received - deliver the msg immediately */
                 req->internal_request->commit_timeout_req->expired = false;  /* do not produce error */
                 req->internal_request->has_postpone_timeout = false;
+            } else if (!commit_finished && SR_ERR_OK != commit->result) {
+                /* a verifier has already failed - abort without waiting for the others */
+                SR_LOG_DBG("Commit id=%"PRIu32" verification failed, not waiting for the remaining verifiers.", commit_id);
+                commit->all_notifications_sent = false;
+                req->internal_request->commit_timeout_req->expired = false;
+                req->internal_request->has_postpone_timeout = false;
             } else {
                 /* not all ACKs recieved - deliver the msg after timeout */
                 req->internal_request->commit_timeout_req->expired = true;  /* produce error */
@@ -1575,12 +1783,13 @@ np_commit_notifications_sent(np_ctx_t *np_ctx, uint32_t commit_id, bool commit_f
 }
 
 int
-np_commit_notification_ack(np_ctx_t *np_ctx, uint32_t commit_id, char *subs_xpath, sr_notif_event_t event, int result,
-        bool do_not_send_abort, const char *err_msg, const char *err_xpath)
+np_commit_notification_ack(np_ctx_t *np_ctx, uint32_t commit_id, const char *dst_address, uint32_t dst_id,
+        char *subs_xpath, sr_notif_event_t event, int result, bool do_not_send_abort, const char *err_msg,
+        const char *err_xpath)
 {
     np_commit_ctx_t *commit = NULL;
     sr_llist_node_t *commit_node = NULL;
-    bool all_acks_received = false;
+    bool all_acks_received = false, late = false;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG(np_ctx);
@@ -1590,12 +1799,25 @@ np_commit_notification_ack(np_ctx_t *np_ctx, uint32_t commit_id, char *subs_xpat
     commit = np_commit_ctx_find(np_ctx, commit_id, &commit_node);
 
     if (NULL != commit) {
-        if (SR_EV_VERIFY == event && SR_ERR_OK != result) {
+        if (SR_EV_VERIFY == event) {
+            late = commit->verify_completed;
+            np_commit_verify_ack_account(np_ctx, commit, dst_address, dst_id, subs_xpath, result, late);
+        }
+        if (SR_EV_VERIFY == event && SR_ERR_OK != result && late) {
+            SR_LOG_WRN("Verifier for '%s' returned an error after the commit verification has completed (msg: '%s').",
+                    subs_xpath, err_msg);
+        } else if (SR_EV_VERIFY == event && SR_ERR_OK != result) {
             /* error returned from the verifier */
             commit->result = result;
             np_commit_error_add(commit, subs_xpath, do_not_send_abort, err_msg, err_xpath);
             SR_LOG_ERR("Verifier for '%s' returned an error (msg: '%s', xpath: '%s'), commit will be aborted.",
                     subs_xpath, err_msg, err_xpath);
+            if (commit->all_notifications_sent) {
+                /* do not wait for the remaining verifiers, their ACKs will be late */
+                commit->all_notifications_sent = false;
+                commit->verify_completed = true;
+                all_acks_received = true;
+            }
         }
         commit->notifications_acked++;
         if (commit->all_notifications_sent && (commit->notifications_sent == commit->notifications_acked)) {
@@ -1640,10 +1862,11 @@ np_commit_notifications_complete(np_ctx_t *np_ctx, uint32_t commit_id, bool time
             /* commit has finished, release commit context */
             SR_LOG_DBG("Releasing commit id=%"PRIu32".", commit_id);
             sr_llist_rm(np_ctx->commits, commit_node);
-            free(commit);
+            np_commit_ctx_free(commit);
             commit = NULL;
         } else {
             /* reset the context for the next commit phase */
+            commit->verify_completed = true;
             commit->all_notifications_sent = false;
             commit->commit_finished = false;
             commit->err_subs_xpaths = NULL;
@@ -1668,6 +1891,57 @@ np_commit_notifications_complete(np_ctx_t *np_ctx, uint32_t commit_id, bool time
     return rc;
 }
 
+int
+np_get_verifier_stats(np_ctx_t *np_ctx, np_verifier_stats_t **stats_p, size_t *stats_cnt_p)
+{
+    np_verifier_stats_t *stats = NULL;
+    size_t stats_cnt = 0;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(np_ctx, stats_p, stats_cnt_p);
+
+    pthread_rwlock_rdlock(&np_ctx->lock);
+
+    if (np_ctx->verifier_stats_cnt > 0) {
+        stats = calloc(np_ctx->verifier_stats_cnt, sizeof(*stats));
+        CHECK_NULL_NOMEM_GOTO(stats, rc, cleanup);
+        for (stats_cnt = 0; stats_cnt < np_ctx->verifier_stats_cnt; stats_cnt++) {
+            stats[stats_cnt] = np_ctx->verifier_stats[stats_cnt];
+            stats[stats_cnt].dst_address = strdup(np_ctx->verifier_stats[stats_cnt].dst_address);
+            stats[stats_cnt].subs_xpath = strdup(np_ctx->verifier_stats[stats_cnt].subs_xpath);
+            if (NULL == stats[stats_cnt].dst_address || NULL == stats[stats_cnt].subs_xpath) {
+                stats_cnt++;
+                rc = SR_ERR_NOMEM;
+                SR_LOG_ERR_MSG("Unable to allocate memory for verifier statistics.");
+                goto cleanup;
+            }
+        }
+    }
+
+cleanup:
+    pthread_rwlock_unlock(&np_ctx->lock);
+
+    if (SR_ERR_OK == rc) {
+        *stats_p = stats;
+        *stats_cnt_p = stats_cnt;
+    } else {
+        np_verifier_stats_free(stats, stats_cnt);
+    }
+    return rc;
+}
+
+void
+np_verifier_stats_free(np_verifier_stats_t *stats, size_t stats_cnt)
+{
+    if (NULL != stats) {
+        for (size_t i = 0; i < stats_cnt; i++) {
+            free(stats[i].dst_address);
+            free(stats[i].subs_xpath);
+        }
+        free(stats);
+    }
+}
+
 void
 np_subscription_content_cleanup(np_subscription_t *subscription)
 {
@@ -1707,16 +1981,10 @@ int
 np_store_event_notification(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const char *xpath, const time_t generated_time,
         struct lyd_node *notif_data_tree)
 {
-//! @cond doxygen_suppress
-#define TIME_BUF_SIZE 64
-//! @endcond
-
-    char *module_name = NULL, *tmp_xpath = NULL, *ptr;
+    char *module_name = NULL, *data = NULL;
     char data_filename[PATH_MAX] = { 0, };
-    char data_xpath[PATH_MAX] = { 0, };
-    char generated_time_buf[TIME_BUF_SIZE] = { 0, };
-    struct timespec logged_time_spec = { 0, };
-    struct lyd_node *data_tree = NULL, *new_node = NULL;
+    np_ev_notif_data_type_t data_type = NP_EV_NOTIF_DATA_NONE;
+    size_t data_size = 0;
     int fd = -1;
     int rc = SR_ERR_OK;
 
@@ -1735,6 +2003,39 @@ np_store_event_notification(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const
         goto cleanup;
     }
 
+    /* print the notification data, before the store is locked */
+    if (0 == strcmp("/ietf-netconf-notifications:netconf-config-change", xpath)) {
+        rc = dm_netconf_config_change_to_string(np_ctx->rp_ctx->dm_ctx, notif_data_tree, &data);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed print config-change notif to string");
+    } else if (lyd_print_mem(&data, notif_data_tree, SR_FILE_FORMAT_LY, LYP_WITHSIBLINGS | LYP_FORMAT)) {
+        SR_LOG_ERR("Error printing notification data tree: %s.", ly_errmsg(notif_data_tree->schema->module->ctx));
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+    if (NULL == data) {
+        SR_LOG_ERR("No data printed for notification '%s'.", xpath);
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+    switch (SR_FILE_FORMAT_LY) {
+    case LYD_JSON:
+        data_type = NP_EV_NOTIF_DATA_JSON;
+        data_size = strlen(data);
+        break;
+    case LYD_XML:
+        data_type = NP_EV_NOTIF_DATA_STRING;
+        data_size = strlen(data);
+        break;
+    case LYD_LYB:
+        data_type = NP_EV_NOTIF_DATA_LYB;
+        data_size = lyd_lyb_data_length(data);
+        break;
+    default:
+        SR_LOG_ERR_MSG("Unknown libyang format '" "SR_FILE_FORMAT_LY" "'.");
+        rc = SR_ERR_INTERNAL;
+        goto cleanup;
+    }
+
     /* extract module name from xpath */
     rc = sr_copy_first_ns(xpath, &module_name);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Error by extracting module name from xpath.");
@@ -1743,95 +2044,22 @@ np_store_event_notification(np_ctx_t *np_ctx, const ac_ucred_t *user_cred, const
     rc = np_get_notif_store_filename(module_name, generated_time, data_filename, PATH_MAX);
     CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to compose notification data file name for '%s'.", module_name);
 
-    /* load notif. data */
-    rc = np_load_data_tree(np_ctx, user_cred, data_filename, false, &data_tree, &fd);
-    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load notification store data for module '%s'.", module_name);
-
-    /* format the time & retrieve current time */
-    sr_time_to_str(generated_time, generated_time_buf, TIME_BUF_SIZE);
-    sr_clock_get_time(CLOCK_REALTIME, &logged_time_spec);
-
-    /* make sure there will be no invalid quotes */
-    if (strchr(xpath, '\'')) {
-        tmp_xpath = strdup(xpath);
-        for (ptr = strchr(tmp_xpath, '\''); ptr; ptr = strchr(ptr + 1, '\'')) {
-            *ptr = '"';
-        }
-    }
-
-    /* create data subtree to be stored in the notif. data file */
-    snprintf(data_xpath, PATH_MAX - 1, NP_NS_XPATH_NOTIFICATION, tmp_xpath ? tmp_xpath : xpath, generated_time_buf,
-            /* logged-time in hundreds of seconds */
-            (uint32_t) (((logged_time_spec.tv_sec * 100) + (uint32_t)(logged_time_spec.tv_nsec / 1.0e7)) % UINT32_MAX));
-    free(tmp_xpath);
-
-    new_node = lyd_new_path(data_tree, np_ctx->ly_ctx, data_xpath, NULL, 0, 0);
-    if (NULL == new_node) {
-        SR_LOG_WRN("Error by adding new notification entry %s: %s.", data_xpath, ly_errmsg(np_ctx->ly_ctx));
-        goto cleanup; /* do not set error code - it may be just too much notifications within the same hundred of second */
-    }
-    if (NULL == data_tree) {
-        /* if the new data tree has been just created */
-        data_tree = new_node;
-        new_node = new_node->child; /* new_node is 'notifications' container */
-    }
+    /* open & lock the notification log */
+    rc = np_open_data_file(np_ctx, user_cred, data_filename, false, &fd);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to open notification store for module '%s'.", module_name);
 
-    if (0 == strcmp("/ietf-netconf-notifications:netconf-config-change", xpath)) {
-        char *string_notif = NULL;
-        rc = dm_netconf_config_change_to_string(np_ctx->rp_ctx->dm_ctx, notif_data_tree, &string_notif);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Failed print config-change notif to string");
-        switch (SR_FILE_FORMAT_LY) {
-        case LYD_JSON:
-            new_node = lyd_new_anydata(new_node, NULL, "data", string_notif, LYD_ANYDATA_JSOND);
-            break;
-        case LYD_XML:
-            new_node = lyd_new_anydata(new_node, NULL, "data", string_notif, LYD_ANYDATA_STRING);
-            break;
-        case LYD_LYB:
-            new_node = lyd_new_anydata(new_node, NULL, "data", string_notif, LYD_ANYDATA_LYBD);
-            break;
-        default:
-            SR_LOG_ERR_MSG("Unknown libyang format '" "SR_FILE_FORMAT_LY" "'.");
-            rc = SR_ERR_INTERNAL;
-            goto cleanup;
-        }
-    } else {
-        /* store notification data as anydata */
-        if (lyd_print_mem(&ptr, notif_data_tree, SR_FILE_FORMAT_LY, LYP_WITHSIBLINGS | LYP_FORMAT)) {
-            SR_LOG_ERR("Error printing notification data tree: %s.", ly_errmsg(notif_data_tree->schema->module->ctx));
-            goto cleanup;
-        }
-        switch (SR_FILE_FORMAT_LY) {
-        case LYD_JSON:
-            new_node = lyd_new_anydata(new_node, NULL, "data", ptr, LYD_ANYDATA_JSOND);
-            break;
-        case LYD_XML:
-            new_node = lyd_new_anydata(new_node, NULL, "data", ptr, LYD_ANYDATA_SXMLD);
-            break;
-        case LYD_LYB:
-            new_node = lyd_new_anydata(new_node, NULL, "data", ptr, LYD_ANYDATA_LYBD);
-            break;
-        default:
-            SR_LOG_ERR_MSG("Unknown libyang format '" "SR_FILE_FORMAT_LY" "'.");
-            rc = SR_ERR_INTERNAL;
-            goto cleanup;
-        }
-    }
-    if (NULL == new_node) {
-        SR_LOG_ERR("Error by adding notification content into notification store: %s.", ly_errmsg(notif_data_tree->schema->module->ctx));
-        rc = SR_ERR_INTERNAL;
-        goto cleanup;
-    }
-
-    /* save notif. data */
-    rc = np_save_data_tree(data_tree, fd);
+    /* append the notification */
+    rc = np_notif_store_append(data_filename, fd, xpath, generated_time, data_type, data, data_size);
     if (SR_ERR_OK == rc) {
         SR_LOG_DBG("Notification successfully logged into '%s' notification store.", module_name);
     }
 
 cleanup:
-    np_cleanup_data_tree(np_ctx, data_tree, fd);
+    if (-1 != fd) {
+        sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, fd);
+    }
     free(module_name);
+    free(data);
     return rc;
 }
 
@@ -1841,11 +2069,12 @@ np_get_event_notifications(np_ctx_t *np_ctx, rp_session_t *rp_session, const cha
 {
     char *module_name = NULL;
     char req_xpath[PATH_MAX] = { 0, };
-    sr_list_t *file_list = NULL, *notif_list = NULL;
+    sr_list_t *file_list = NULL, *notif_list = NULL, *log_notif_list = NULL;
     struct lyd_node *data_tree = NULL, *main_tree = NULL;
     struct ly_set *node_set = NULL;
     np_ev_notification_t *notification = NULL;
     time_t effective_stop_time = 0;
+    int fd = -1;
     int rc = SR_ERR_OK, ret = 0;
 
     CHECK_NULL_ARG3(np_ctx, xpath, notifications);
@@ -1874,8 +2103,23 @@ np_get_event_notifications(np_ctx_t *np_ctx, rp_session_t *rp_session, const cha
             file_list);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to retrieve notification file list.");
 
+    /* init the notification list */
+    rc = sr_list_init(&notif_list);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize notification list.");
+    rc = sr_list_init(&log_notif_list);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize notification list.");
+
     /* load all notification files */
     for (size_t i = 0; i < file_list->count; i++) {
+        if (np_is_notif_store_log(file_list->data[i])) {
+            /* read the matching records of the notification log */
+            rc = np_open_data_file(np_ctx, rp_session->user_credentials, file_list->data[i], true, &fd);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to open notification store for module '%s'.", module_name);
+            rc = np_notif_store_read(file_list->data[i], fd, xpath, start_time, effective_stop_time, log_notif_list);
+            sr_locking_set_unlock_close_fd(np_ctx->lock_ctx, fd);
+            CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to read notification store of module '%s'.", module_name);
+            continue;
+        }
         rc = np_load_data_tree(np_ctx, rp_session->user_credentials, file_list->data[i], true, &data_tree, NULL);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to load notification store data for module '%s'.", module_name);
         if (NULL == main_tree) {
@@ -1896,10 +2140,6 @@ np_get_event_notifications(np_ctx_t *np_ctx, rp_session_t *rp_session, const cha
     }
 
     if (NULL != node_set && node_set->number > 0) {
-        /* init the notification list */
-        rc = sr_list_init(&notif_list);
-        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to initialize notification list.");
-
         for (size_t i = 0; i < node_set->number; i++) {
             /* allocate a new notification entry */
             notification = calloc(1, sizeof(*notification));
@@ -1928,6 +2168,26 @@ np_get_event_notifications(np_ctx_t *np_ctx, rp_session_t *rp_session, const cha
         }
     }
 
+    /* parse the notifications read from the notification logs */
+    for (size_t i = 0; i < log_notif_list->count; i++) {
+        notification = log_notif_list->data[i];
+        log_notif_list->data[i] = NULL;
+
+        rc = dm_parse_event_notif(np_ctx->rp_ctx, rp_session, NULL, notification, api_variant);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Error by parsing notification '%s'.", notification->xpath);
+
+        SR_LOG_DBG("Adding a new notification: '%s' (time=%ld)", notification->xpath, notification->timestamp);
+
+        rc = sr_list_add(notif_list, notification);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Error by adding notification into list.");
+        notification = NULL;
+    }
+
+    if (0 == notif_list->count) {
+        /* no notifications found */
+        sr_list_cleanup(notif_list);
+        notif_list = NULL;
+    }
     *notifications = notif_list;
     notif_list = NULL;
 
@@ -1940,6 +2200,12 @@ cleanup:
         }
         sr_list_cleanup(notif_list);
     }
+    if (NULL != log_notif_list) {
+        for (size_t i = 0; i < log_notif_list->count; i++) {
+            np_event_notification_cleanup(log_notif_list->data[i]);
+        }
+        sr_list_cleanup(log_notif_list);
+    }
     ly_set_free(node_set);
     lyd_free_withsiblings(main_tree);
     sr_free_list_of_strings(file_list);
@@ -1960,6 +2226,7 @@ int
 np_notification_store_cleanup(np_ctx_t *np_ctx, bool reschedule)
 {
     sr_list_t *file_list = NULL;
+    char *index_filename = NULL;
     int ret = 0, rc = SR_ERR_OK;
 
     CHECK_NULL_ARG(np_ctx);
@@ -1978,6 +2245,14 @@ np_notification_store_cleanup(np_ctx_t *np_ctx, bool reschedule)
             SR_LOG_WRN("Unable to delete notification data file '%s': %s.",
                     (char*)file_list->data[i], sr_strerror_safe(ret));
         }
+        if (np_is_notif_store_log(file_list->data[i]) &&
+                SR_ERR_OK == np_notif_store_index_filename(file_list->data[i], &index_filename)) {
+            if (-1 == unlink(index_filename) && ENOENT != errno) {
+                SR_LOG_WRN("Unable to delete notification index file '%s': %s.", index_filename, sr_strerror_safe(errno));
+            }
+            free(index_filename);
+            index_filename = NULL;
+        }
     }
 
     sr_free_list_of_strings(file_list);
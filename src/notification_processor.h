@@ -55,6 +55,7 @@ typedef struct np_subscription_s {
     uint32_t priority;                 /**< Priority of the subscription by delivering notifications (0 is the lowest priority). */
     bool enable_running;               /**< TRUE if the subscription enables specified subtree in the running datastore. */
     bool enable_nacm;                  /**< TRUE if the NETCONF Access Control is enabled for this subscription. */
+    bool inline_changes;               /**< TRUE if the changes are sent together with the change notifications. */
     sr_api_variant_t api_variant;      /**< API variant -- values vs. trees (relevant for the callback type only). */
     size_t copy_cnt;                   /**< Count of other references to the primary structure. 0 means no other copies exist. */
 } np_subscription_t;
@@ -86,8 +87,28 @@ typedef struct np_ev_notification_s {
         sr_node_t *trees;               /**< Trees with the notification data. */
     } data;
     size_t data_cnt;                    /**< Values of the data. */
+    char *data_buf;                     /**< Buffer owned by the notification the string data point into, if any. */
 } np_ev_notification_t;
 
+/** @brief Number of the buckets of the latency histogram of a commit verifier. */
+#define NP_VERIFY_LATENCY_BUCKETS 16
+
+/**
+ * @brief Statistics of a commit verifier, accumulated over all the commits.
+ */
+typedef struct np_verifier_stats_s {
+    char *dst_address;                                 /**< Destination address of the verifier's subscription. */
+    uint32_t dst_id;                                   /**< Destination ID of the verifier's subscription. */
+    char *subs_xpath;                                  /**< Module name or subtree xpath the verifier is subscribed to. */
+    uint64_t verify_cnt;                               /**< Number of the verify notifications acknowledged by the verifier. */
+    uint64_t error_cnt;                                /**< Number of the verify notifications rejected by the verifier. */
+    uint64_t late_cnt;                                 /**< Number of the acknowledgments received after the verification
+                                                            had already been completed (aborted by another verifier). */
+    uint32_t max_latency;                              /**< Maximum verification latency in milliseconds. */
+    uint64_t latency_hist[NP_VERIFY_LATENCY_BUCKETS];  /**< Histogram of the latencies, bucket i counts the latencies
+                                                            below 2^i milliseconds, the last bucket all the longer ones. */
+} np_verifier_stats_t;
+
 /**
  * @brief Initializes a Notification Processor instance.
  *
@@ -115,6 +136,7 @@ typedef enum np_subscr_flag_e {
     NP_SUBSCR_ENABLE_RUNNING = 1,
     NP_SUBSCR_EXCLUSIVE = 2,
     NP_SUBSCR_EV_EVENT = 4,
+    NP_SUBSCR_INLINE_CHANGES = 8,
 } np_subscr_flag_t;
 
 /**
@@ -245,10 +267,14 @@ int np_get_data_provider_subscriptions(np_ctx_t *np_ctx, const rp_session_t *rp_
  * @param[in] subscription Subscription context acquired by ::np_get_module_change_subscriptions call.
  * @param[in] event type of event to be sent to subscription
  * @param[in] commit_id ID of the commit to be used for starting a new notification session from client library.
+ * @param[in] changes Changes of the module packed as Sr__ChangeSet, sent with the notification if the subscription
+ * requested inline changes. Can be NULL.
+ * @param[in] changes_size Size of the packed changes.
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id);
+int np_subscription_notify(np_ctx_t *np_ctx, np_subscription_t *subscription, sr_notif_event_t event, uint32_t commit_id,
+        const uint8_t *changes, size_t changes_size);
 
 /**
  * @brief Request operational data from a data provider subscription.
@@ -285,11 +311,35 @@ int np_commit_notifications_sent(np_ctx_t *np_ctx, uint32_t commit_id,  bool com
  */
 int np_commit_notifications_complete(np_ctx_t *np_ctx, uint32_t commit_id, bool timeout_expired);
 
+/**
+ * @brief Returns the statistics of all the commit verifiers that have acknowledged a verify notification.
+ *
+ * @note The verify notifications of a commit are sent to all the verifiers at once. The first verifier
+ * returning an error completes the verification, the commit is aborted without waiting for the others.
+ *
+ * @param[in] np_ctx Notification Processor context acquired by ::np_init call.
+ * @param[out] stats Allocated array of the statistics, to be freed by ::np_verifier_stats_free.
+ * @param[out] stats_cnt Number of the verifiers in the array.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int np_get_verifier_stats(np_ctx_t *np_ctx, np_verifier_stats_t **stats, size_t *stats_cnt);
+
+/**
+ * @brief Frees the statistics returned by ::np_get_verifier_stats.
+ *
+ * @param[in] stats Array of the statistics.
+ * @param[in] stats_cnt Number of the verifiers in the array.
+ */
+void np_verifier_stats_free(np_verifier_stats_t *stats, size_t stats_cnt);
+
 /**
  * @brief Track a response to a notification (notification acknowledgment).
  *
  * @param[in] np_ctx Notification Processor context acquired by ::np_init call.
  * @param[in] commit_id Commit identifier.
+ * @param[in] dst_address Destination address of the acknowledged subscription.
+ * @param[in] dst_id Destination ID of the acknowledged subscription.
  * @param[in] subs_xpath XPath where the subscription is subscribed to.
  * @param[in] event Event that is currently being processed.
  * @param[in] result Result of the processing by the subscriber.
@@ -299,8 +349,9 @@ int np_commit_notifications_complete(np_ctx_t *np_ctx, uint32_t commit_id, bool
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int np_commit_notification_ack(np_ctx_t *np_ctx, uint32_t commit_id, char *subs_xpath, sr_notif_event_t event,
-        int result, bool do_not_send_abort, const char *err_msg, const char *err_xpath);
+int np_commit_notification_ack(np_ctx_t *np_ctx, uint32_t commit_id, const char *dst_address, uint32_t dst_id,
+        char *subs_xpath, sr_notif_event_t event, int result, bool do_not_send_abort, const char *err_msg,
+        const char *err_xpath);
 
 /**
  * @brief Cleans up a subscription context (including all its content).
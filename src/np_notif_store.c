@@ -0,0 +1,433 @@
+/**
+ * @file np_notif_store.c
+ * @brief Notification Processor's append-only store of event notifications.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+
+#include "sr_common.h"
+#include "np_notif_store.h"
+
+#define NP_NOTIF_RECORD_MAGIC 0x46544f4eU  /**< Magic number of a notification record ("NOTF") */
+
+/**
+ * @brief Header of a notification record. The payload consists of the NULL-terminated xpath
+ * followed by the NULL-terminated notification data.
+ */
+typedef struct np_notif_record_s {
+    uint32_t magic;             /**< ::NP_NOTIF_RECORD_MAGIC */
+    uint32_t crc;               /**< Checksum of the payload */
+    uint32_t size;              /**< Size of the payload */
+    uint32_t data_type;         /**< ::np_ev_notif_data_type_t of the data */
+    int64_t generated_time;     /**< Generation time of the notification */
+} np_notif_record_t;
+
+/**
+ * @brief Entry of the index describing one record of the log.
+ */
+typedef struct np_notif_index_entry_s {
+    int64_t generated_time;     /**< Generation time of the notification */
+    int64_t max_time;           /**< Latest generation time of this and all the preceding records */
+    uint64_t offset;            /**< Offset of the record in the log */
+    uint32_t size;              /**< Size of the payload of the record */
+    uint32_t crc;               /**< Checksum of the payload of the record */
+} np_notif_index_entry_t;
+
+/** Size of the record with the payload of given size */
+#define NP_NOTIF_RECORD_SIZE(PAYLOAD) ((off_t) sizeof(np_notif_record_t) + (off_t) (PAYLOAD))
+
+int
+np_notif_store_index_filename(const char *log_filename, char **index_filename)
+{
+    CHECK_NULL_ARG2(log_filename, index_filename);
+    return sr_str_join(log_filename, SR_NOTIF_INDEX_FILE_EXT, index_filename);
+}
+
+/**
+ * @brief Reads the record at the offset of the log and checks it. The payload is returned only if requested.
+ *
+ * @return SR_ERR_OK if the record is complete and valid, SR_ERR_NOT_FOUND otherwise.
+ */
+static int
+np_notif_store_read_record(int log_fd, off_t log_size, off_t offset, np_notif_record_t *record, char **payload)
+{
+    char *buf = NULL;
+    int rc = SR_ERR_OK;
+
+    if (log_size - offset < NP_NOTIF_RECORD_SIZE(0) ||
+            SR_ERR_OK != sr_pread_full(log_fd, record, sizeof *record, offset)) {
+        return SR_ERR_NOT_FOUND;
+    }
+    if (NP_NOTIF_RECORD_MAGIC != record->magic || record->size < 2 ||
+            log_size - offset < NP_NOTIF_RECORD_SIZE(record->size)) {
+        return SR_ERR_NOT_FOUND;
+    }
+
+    buf = malloc(record->size);
+    CHECK_NULL_NOMEM_RETURN(buf);
+    rc = sr_pread_full(log_fd, buf, record->size, offset + sizeof *record);
+    if (SR_ERR_OK != rc || record->crc != sr_crc32(buf, record->size) || '\0' != buf[record->size - 1] ||
+            NULL == memchr(buf, '\0', record->size - 1)) {
+        free(buf);
+        return SR_ERR_NOT_FOUND;
+    }
+
+    if (NULL != payload) {
+        *payload = buf;
+    } else {
+        free(buf);
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Opens the index of the log, creates it with the ownership and permissions of the log if requested.
+ *
+ * @param [out] fd Opened index, -1 if it does not exist and has not been requested to be created.
+ * @param [out] size Size of the index.
+ */
+static int
+np_notif_store_index_open(const char *index_filename, int log_fd, bool create, int *fd, off_t *size)
+{
+    struct stat log_st = {0}, st = {0};
+
+    *size = 0;
+
+    if (0 != fstat(log_fd, &log_st)) {
+        SR_LOG_ERR("Stat of the notification log failed: %s", sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+
+    *fd = open(index_filename, create ? (O_RDWR | O_CREAT) : O_RDONLY, log_st.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+    if (-1 == *fd) {
+        if (ENOENT == errno && !create) {
+            return SR_ERR_OK;
+        }
+        SR_LOG_ERR("Unable to open the notification index %s: %s", index_filename, sr_strerror_safe(errno));
+        return (EACCES == errno) ? SR_ERR_UNAUTHORIZED : SR_ERR_IO;
+    }
+    if (0 != fstat(*fd, &st)) {
+        SR_LOG_ERR("Stat of the notification index %s failed: %s", index_filename, sr_strerror_safe(errno));
+        close(*fd);
+        *fd = -1;
+        return SR_ERR_IO;
+    }
+    if (create && 0 == st.st_size && (st.st_uid != log_st.st_uid || st.st_gid != log_st.st_gid) &&
+            0 != fchown(*fd, log_st.st_uid, log_st.st_gid)) {
+        /* keeping the ownership of the log is best effort */
+        SR_LOG_DBG("Unable to change the owner of notification index %s", index_filename);
+    }
+
+    *size = st.st_size;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Returns the offset of the end of the record described by the last valid entry of the index.
+ * Entries pointing beyond the end of the log (log truncated after a crash) are dropped.
+ *
+ * @param [in,out] entry_cnt Number of entries in the index, decreased by the number of the dropped entries.
+ * @param [out] max_time Latest generation time of the records described by the valid entries.
+ */
+static int
+np_notif_store_index_end(int index_fd, size_t *entry_cnt, off_t log_size, off_t *end, int64_t *max_time)
+{
+    np_notif_index_entry_t entry = {0};
+    int rc = SR_ERR_OK;
+
+    *end = 0;
+    *max_time = INT64_MIN;
+    while (*entry_cnt > 0) {
+        rc = sr_pread_full(index_fd, &entry, sizeof entry, (*entry_cnt - 1) * sizeof entry);
+        CHECK_RC_MSG_RETURN(rc, "Reading of the notification index failed");
+        if ((off_t) entry.offset + NP_NOTIF_RECORD_SIZE(entry.size) <= log_size) {
+            *end = (off_t) entry.offset + NP_NOTIF_RECORD_SIZE(entry.size);
+            *max_time = entry.max_time;
+            break;
+        }
+        --*entry_cnt;
+    }
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Binary-searches the index for the first entry whose record may have been generated at or after
+ * time_from, i.e. all the records described by the preceding entries have been generated before it.
+ */
+static int
+np_notif_store_index_find(int index_fd, size_t entry_cnt, int64_t time_from, size_t *first)
+{
+    np_notif_index_entry_t entry = {0};
+    size_t low = 0, high = entry_cnt, mid = 0;
+    int rc = SR_ERR_OK;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        rc = sr_pread_full(index_fd, &entry, sizeof entry, mid * sizeof entry);
+        CHECK_RC_MSG_RETURN(rc, "Reading of the notification index failed");
+        if (entry.max_time < time_from) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    *first = low;
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Builds the index entries of the valid records of the log starting at the offset, i.e. of the records
+ * that have not made it into the index.
+ *
+ * @param [in] max_time Latest generation time of the records preceding the offset.
+ * @param [out] end Offset of the end of the last valid record.
+ */
+static int
+np_notif_store_scan(int log_fd, off_t log_size, off_t offset, int64_t max_time, np_notif_index_entry_t **entries,
+        size_t *entry_cnt, off_t *end)
+{
+    np_notif_index_entry_t *tmp = NULL;
+    np_notif_record_t record = {0};
+    size_t allocated = *entry_cnt;
+
+    while (offset < log_size && SR_ERR_OK == np_notif_store_read_record(log_fd, log_size, offset, &record, NULL)) {
+        if (*entry_cnt == allocated) {
+            allocated = (0 == allocated) ? 16 : 2 * allocated;
+            tmp = realloc(*entries, allocated * sizeof *tmp);
+            CHECK_NULL_NOMEM_RETURN(tmp);
+            *entries = tmp;
+        }
+        max_time = (record.generated_time > max_time) ? record.generated_time : max_time;
+        (*entries)[*entry_cnt].generated_time = record.generated_time;
+        (*entries)[*entry_cnt].max_time = max_time;
+        (*entries)[*entry_cnt].offset = offset;
+        (*entries)[*entry_cnt].size = record.size;
+        (*entries)[*entry_cnt].crc = record.crc;
+        ++*entry_cnt;
+        offset += NP_NOTIF_RECORD_SIZE(record.size);
+    }
+    *end = offset;
+    return SR_ERR_OK;
+}
+
+int
+np_notif_store_append(const char *log_filename, int log_fd, const char *xpath, time_t generated_time,
+        np_ev_notif_data_type_t data_type, const char *data, size_t data_size)
+{
+    CHECK_NULL_ARG3(log_filename, xpath, data);
+    char *index_filename = NULL, *buf = NULL;
+    np_notif_index_entry_t *missing = NULL, entry = {0};
+    np_notif_record_t record = {0};
+    size_t xpath_len = strlen(xpath), missing_cnt = 0, entry_cnt = 0;
+    struct stat st = {0};
+    off_t index_size = 0, end = 0;
+    int64_t max_time = 0;
+    int index_fd = -1;
+    int rc = SR_ERR_OK;
+
+    if (xpath_len + data_size + 2 > UINT32_MAX - sizeof record) {
+        SR_LOG_ERR("Notification '%s' is too large to be stored.", xpath);
+        return SR_ERR_INVAL_ARG;
+    }
+
+    /* serialize the record */
+    record.magic = NP_NOTIF_RECORD_MAGIC;
+    record.size = (uint32_t) (xpath_len + data_size + 2);
+    record.data_type = (uint32_t) data_type;
+    record.generated_time = (int64_t) generated_time;
+    buf = malloc(NP_NOTIF_RECORD_SIZE(record.size));
+    CHECK_NULL_NOMEM_RETURN(buf);
+    memcpy(buf + sizeof record, xpath, xpath_len + 1);
+    memcpy(buf + sizeof record + xpath_len + 1, data, data_size);
+    buf[sizeof record + record.size - 1] = '\0';
+    record.crc = sr_crc32(buf + sizeof record, record.size);
+    memcpy(buf, &record, sizeof record);
+
+    rc = np_notif_store_index_filename(log_filename, &index_filename);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get notification index file name failed");
+    rc = np_notif_store_index_open(index_filename, log_fd, true, &index_fd, &index_size);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Notification index open failed");
+    entry_cnt = index_size / sizeof entry;
+
+    if (0 != fstat(log_fd, &st)) {
+        SR_LOG_ERR("Stat of the notification log %s failed: %s", log_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    /* the index normally describes the whole log, complete it otherwise */
+    rc = np_notif_store_index_end(index_fd, &entry_cnt, st.st_size, &end, &max_time);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Notification index check failed");
+    if (end != st.st_size) {
+        rc = np_notif_store_scan(log_fd, st.st_size, end, max_time, &missing, &missing_cnt, &end);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Notification log scan failed");
+        if (missing_cnt > 0) {
+            max_time = missing[missing_cnt - 1].max_time;
+        }
+        if (end != st.st_size) {
+            SR_LOG_WRN("Discarding incomplete notification record at offset %lld of %s", (long long) end, log_filename);
+            if (0 != ftruncate(log_fd, end)) {
+                SR_LOG_ERR("Truncation of the notification log %s failed: %s", log_filename, sr_strerror_safe(errno));
+                rc = SR_ERR_IO;
+                goto cleanup;
+            }
+        }
+    }
+    if ((off_t) (entry_cnt * sizeof entry) != index_size && 0 != ftruncate(index_fd, entry_cnt * sizeof entry)) {
+        SR_LOG_ERR("Truncation of the notification index %s failed: %s", index_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+    if (missing_cnt > 0) {
+        rc = sr_pwrite_full(index_fd, missing, missing_cnt * sizeof entry, entry_cnt * sizeof entry);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Writing to the notification index %s failed: %s", index_filename,
+                sr_strerror_safe(errno));
+        entry_cnt += missing_cnt;
+    }
+
+    /* append the record, it is durable once the log is synced */
+    rc = sr_pwrite_full(log_fd, buf, NP_NOTIF_RECORD_SIZE(record.size), end);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Writing to the notification log %s failed: %s", log_filename, sr_strerror_safe(errno));
+    if (0 != fsync(log_fd)) {
+        SR_LOG_ERR("Sync of the notification log %s failed: %s", log_filename, sr_strerror_safe(errno));
+        rc = SR_ERR_IO;
+        goto cleanup;
+    }
+
+    /* index the record, a lost entry is restored from the log */
+    entry.generated_time = record.generated_time;
+    entry.max_time = (record.generated_time > max_time) ? record.generated_time : max_time;
+    entry.offset = (uint64_t) end;
+    entry.size = record.size;
+    entry.crc = record.crc;
+    rc = sr_pwrite_full(index_fd, &entry, sizeof entry, entry_cnt * sizeof entry);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Writing to the notification index %s failed: %s", index_filename,
+            sr_strerror_safe(errno));
+
+    SR_LOG_DBG("Notification '%s' appended to %s at offset %lld", xpath, log_filename, (long long) end);
+
+cleanup:
+    if (-1 != index_fd) {
+        close(index_fd);
+    }
+    free(missing);
+    free(index_filename);
+    free(buf);
+    return rc;
+}
+
+int
+np_notif_store_read(const char *log_filename, int log_fd, const char *xpath, time_t time_from, time_t time_to,
+        sr_list_t *notifications)
+{
+    CHECK_NULL_ARG2(log_filename, notifications);
+    np_notif_index_entry_t *entries = NULL;
+    np_ev_notification_t *notification = NULL;
+    np_notif_record_t record = {0};
+    struct stat st = {0};
+    size_t entry_cnt = 0, first = 0, xpath_len = 0;
+    char *index_filename = NULL, *payload = NULL;
+    off_t index_size = 0, end = 0;
+    int64_t max_time = 0;
+    int index_fd = -1;
+    int rc = SR_ERR_OK;
+
+    if (0 != fstat(log_fd, &st)) {
+        SR_LOG_ERR("Stat of the notification log %s failed: %s", log_filename, sr_strerror_safe(errno));
+        return SR_ERR_IO;
+    }
+
+    rc = np_notif_store_index_filename(log_filename, &index_filename);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Get notification index file name failed");
+    rc = np_notif_store_index_open(index_filename, log_fd, false, &index_fd, &index_size);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Notification index open failed");
+    entry_cnt = index_size / sizeof *entries;
+
+    /* only the entries from the first one that may fall into the time interval are read */
+    rc = np_notif_store_index_end(index_fd, &entry_cnt, st.st_size, &end, &max_time);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Notification index check failed");
+    rc = np_notif_store_index_find(index_fd, entry_cnt, (int64_t) time_from, &first);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Notification index search failed");
+    entry_cnt -= first;
+    if (entry_cnt > 0) {
+        entries = malloc(entry_cnt * sizeof *entries);
+        CHECK_NULL_NOMEM_GOTO(entries, rc, cleanup);
+        rc = sr_pread_full(index_fd, entries, entry_cnt * sizeof *entries, first * sizeof *entries);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Reading of the notification index %s failed: %s", index_filename,
+                sr_strerror_safe(errno));
+    }
+
+    /* records that have not made it into the index are found in the log */
+    if (end != st.st_size) {
+        rc = np_notif_store_scan(log_fd, st.st_size, end, max_time, &entries, &entry_cnt, &end);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Notification log scan failed");
+    }
+
+    for (size_t i = 0; i < entry_cnt; i++) {
+        /* only the records from the time interval are read */
+        if (entries[i].generated_time < (int64_t) time_from || entries[i].generated_time > (int64_t) time_to) {
+            continue;
+        }
+        rc = np_notif_store_read_record(log_fd, st.st_size, entries[i].offset, &record, &payload);
+        if (SR_ERR_OK != rc || record.crc != entries[i].crc) {
+            SR_LOG_WRN("Skipping invalid notification record at offset %llu of %s",
+                    (unsigned long long) entries[i].offset, log_filename);
+            free(payload);
+            payload = NULL;
+            rc = SR_ERR_OK;
+            continue;
+        }
+        if (NULL != xpath && 0 != strcmp(payload, xpath)) {
+            free(payload);
+            payload = NULL;
+            continue;
+        }
+
+        notification = calloc(1, sizeof *notification);
+        CHECK_NULL_NOMEM_GOTO(notification, rc, cleanup);
+        xpath_len = strlen(payload);
+        notification->xpath = strdup(payload);
+        CHECK_NULL_NOMEM_GOTO(notification->xpath, rc, cleanup);
+        notification->timestamp = (time_t) record.generated_time;
+        notification->data_type = (np_ev_notif_data_type_t) record.data_type;
+        notification->data_buf = payload;
+        notification->data.string = payload + xpath_len + 1;
+        payload = NULL;
+
+        rc = sr_list_add(notifications, notification);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Error by adding notification into list.");
+        notification = NULL;
+    }
+
+cleanup:
+    if (-1 != index_fd) {
+        close(index_fd);
+    }
+    np_event_notification_cleanup(notification);
+    free(index_filename);
+    free(payload);
+    free(entries);
+    return rc;
+}
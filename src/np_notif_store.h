@@ -0,0 +1,95 @@
+/**
+ * @file np_notif_store.h
+ * @brief Notification Processor's append-only store of event notifications.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NP_NOTIF_STORE_H_
+#define NP_NOTIF_STORE_H_
+
+#include <stddef.h>
+#include <time.h>
+
+#include "sr_common.h"
+#include "notification_processor.h"
+
+/**
+ * @defgroup np_notif_store Notification Store
+ * @ingroup np
+ * @{
+ *
+ * @brief Event notifications generated within one time window are appended as checksummed binary
+ * records to one log file (::SR_NOTIF_STORE_FILE_EXT extension). Storing a notification therefore
+ * costs one write of the record regardless of the number of notifications already stored, and
+ * notifications generated at the same time are all kept.
+ *
+ * The log is accompanied by an index file (log file name with ::SR_NOTIF_INDEX_FILE_EXT extension) holding
+ * the generation time, offset and size of each record, so that the notifications from a time interval
+ * can be located without reading the whole log. Each entry also holds the latest generation time of the
+ * records up to it, which never decreases even if the notifications are not stored in the order they have
+ * been generated, so the first entry of the interval is found by a binary search and only the entries
+ * from there on are read. Only the log is synced to the disk, the index is
+ * completed from the log whenever it is found shorter (e.g. after a crash). A record that has not
+ * been written completely is discarded by the next append.
+ *
+ * All functions expect that the log file is locked by the caller - for reading in case of
+ * ::np_notif_store_read, for writing otherwise.
+ */
+
+/**
+ * @brief Appends a notification to the log file.
+ *
+ * @param [in] log_filename Path to the log file.
+ * @param [in] log_fd Opened log file.
+ * @param [in] xpath XPath of the notification.
+ * @param [in] generated_time Time when the notification has been generated.
+ * @param [in] data_type Type of the notification data (::NP_EV_NOTIF_DATA_STRING, ::NP_EV_NOTIF_DATA_JSON
+ * or ::NP_EV_NOTIF_DATA_LYB).
+ * @param [in] data Notification data.
+ * @param [in] data_size Size of the notification data.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int np_notif_store_append(const char *log_filename, int log_fd, const char *xpath, time_t generated_time,
+        np_ev_notif_data_type_t data_type, const char *data, size_t data_size);
+
+/**
+ * @brief Reads the notifications generated within the time interval from the log file.
+ *
+ * @param [in] log_filename Path to the log file.
+ * @param [in] log_fd Opened log file.
+ * @param [in] xpath XPath the notifications have to match, NULL for all notifications.
+ * @param [in] time_from Beginning of the time interval.
+ * @param [in] time_to End of the time interval.
+ * @param [in,out] notifications List the read notifications (::np_ev_notification_t) are appended to,
+ * their data are not parsed.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int np_notif_store_read(const char *log_filename, int log_fd, const char *xpath, time_t time_from, time_t time_to,
+        sr_list_t *notifications);
+
+/**
+ * @brief Returns the name of the index file of the log file.
+ *
+ * @param [in] log_filename Path to the log file.
+ * @param [out] index_filename Allocated path to the index file.
+ * @return Error code (SR_ERR_OK on success)
+ */
+int np_notif_store_index_filename(const char *log_filename, char **index_filename);
+
+/**@} np_notif_store */
+
+#endif /* NP_NOTIF_STORE_H_ */
@@ -32,6 +32,7 @@
 #include "access_control.h"
 #include "rp_internal.h"
 #include "persistence_manager.h"
+#include "dm_version_table.h"
 
 #ifdef HAVE_FSETXATTR
 #include <sys/xattr.h>
@@ -54,6 +55,7 @@
 #define PM_XPATH_SUBSCRIPTION_EVENT           PM_XPATH_SUBSCRIPTION      "/event"
 #define PM_XPATH_SUBSCRIPTION_PRIORITY        PM_XPATH_SUBSCRIPTION      "/priority"
 #define PM_XPATH_SUBSCRIPTION_ENABLE_RUNNING  PM_XPATH_SUBSCRIPTION      "/enable-running"
+#define PM_XPATH_SUBSCRIPTION_INLINE_CHANGES  PM_XPATH_SUBSCRIPTION      "/inline-changes"
 #define PM_XPATH_SUBSCRIPTION_ENABLE_NACM     PM_XPATH_SUBSCRIPTION      "/enable-nacm"
 #define PM_XPATH_SUBSCRIPTION_API_VARIANT     PM_XPATH_SUBSCRIPTION      "/api-variant"
 
@@ -78,6 +80,8 @@ typedef struct pm_ctx_s {
     sr_locking_set_t *lock_ctx;         /**< Context for locking persist data files. */
     sr_btree_t *module_data;            /**< Binary tree holding cached data of a module. */
     pthread_rwlock_t module_data_lock;  /**< RW lock for accessing module_data. */
+    dm_version_table_t *version_table;  /**< Versions of the persist data files shared by the processes, can be NULL. */
+    bool writes_disabled;               /**< The version table is supported but could not be opened, persist files must not be written. */
 } pm_ctx_t;
 
 /**
@@ -86,8 +90,9 @@ typedef struct pm_ctx_s {
 typedef struct pm_module_data_s {
     const char *module_name;    /**< Name of the module. */
     sr_list_t *cached_data;     /**< Cached data of the module. */
-    uint64_t timestamp;         /**< Timestamp of the cached data file. */
+    uint64_t timestamp;         /**< Timestamp of the cached data file, its version if versions is set. */
     bool use_xattr;             /**< Use file extended attributes to store timestamp. */
+    dm_module_versions_t *versions; /**< Versions of the module's data files in the version table, NULL if not available. */
 
 } pm_module_data_t;
 
@@ -182,6 +187,22 @@ pm_save_data_tree(struct lyd_node *data_tree, int fd)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Records that the persist data file of the module is going to be written, the cached data
+ * of the module are out of date in all the processes from now on.
+ *
+ * @note Function expects that the file is locked for writing.
+ */
+static void
+pm_persist_file_modified(pm_ctx_t *pm_ctx, const char *module_name)
+{
+    dm_module_versions_t *versions = dm_version_table_get(pm_ctx->version_table, module_name);
+
+    if (NULL != versions) {
+        dm_version_increment(pm_ctx->version_table, versions, DM_VERSION_PERSIST);
+    }
+}
+
 /**
  * @brief Cleans up specified data tree and closes specified file descriptor.
  */
@@ -391,6 +412,11 @@ pm_save_persistent_data(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const cha
         *running_affected = false;
     }
 
+    if (pm_ctx->writes_disabled) {
+        SR_LOG_ERR("Persist data of module '%s' can not be written, the version table is not available.", module_name);
+        return SR_ERR_OPERATION_FAILED;
+    }
+
     if (NULL != data_tree_p && NULL != *data_tree_p) {
         /* use provided data tree */
         data_tree = *data_tree_p;
@@ -410,6 +436,7 @@ pm_save_persistent_data(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const cha
 
     /* save the changes to the persist file */
     if (-1 != fd) {
+        pm_persist_file_modified(pm_ctx, module_name);
         rc = pm_save_data_tree(data_tree, fd);
         CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to save persist data tree.");
     }
@@ -469,6 +496,9 @@ pm_subscription_entry_fill(const char *module_name, np_subscription_t *subscript
             if (0 == strcmp(node->schema->name, "enable-running")) {
                 subscription->enable_running = true;
             }
+            if (0 == strcmp(node->schema->name, "inline-changes")) {
+                subscription->inline_changes = true;
+            }
             if (0 == strcmp(node->schema->name, "enable-nacm")) {
                 subscription->enable_nacm = true;
             }
@@ -497,6 +527,13 @@ pm_module_data_version_save(pm_ctx_t *pm_ctx, const char *module_name, pm_module
     struct stat file_stat = { 0, };
     int ret = 0, rc = SR_ERR_OK;
 
+    md->versions = dm_version_table_get(pm_ctx->version_table, module_name);
+    if (NULL != md->versions) {
+        /* the version is incremented before each write of the file */
+        md->timestamp = dm_version_get(md->versions, DM_VERSION_PERSIST);
+        return SR_ERR_OK;
+    }
+
     rc = sr_get_persist_data_file_name_buf(pm_ctx->data_search_dir, module_name, file_name, PATH_MAX);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to get persist data file name.");
 
@@ -546,6 +583,15 @@ pm_module_data_version_changed(pm_ctx_t *pm_ctx, const char *module_name, pm_mod
 
     *changed = true;
 
+    if (NULL != md->versions) {
+        /* no need to touch the file */
+        timestamp = dm_version_get(md->versions, DM_VERSION_PERSIST);
+        *changed = timestamp != md->timestamp;
+        SR_LOG_DBG("Module '%s' persist file version %s cached value (%"PRIu64").", module_name,
+                *changed ? "does not match with the last" : "matches with", timestamp);
+        return rc;
+    }
+
     rc = sr_get_persist_data_file_name_buf(pm_ctx->data_search_dir, module_name, file_name, PATH_MAX);
     CHECK_RC_MSG_RETURN(rc, "Unable to get persist data file name.");
 
@@ -885,6 +931,16 @@ pm_init(rp_ctx_t *rp_ctx, const char *schema_search_dir, const char *data_search
     rc = sr_btree_init(pm_module_data_cmp, pm_free_module_data, &ctx->module_data);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Module data binary tree init failed.");
 
+    if (SR_ERR_OK != dm_version_table_open(ctx->data_search_dir, &ctx->version_table)) {
+        ctx->version_table = NULL;
+        ctx->writes_disabled = dm_version_table_supported();
+        if (ctx->writes_disabled) {
+            SR_LOG_WRN_MSG("The version table is not available, persist data files can be read but not written.");
+        } else {
+            SR_LOG_WRN_MSG("Persist data files will be checked for changes by their modification time.");
+        }
+    }
+
     /* initialize libyang */
     ctx->ly_ctx = ly_ctx_new(schema_search_dir, 0);
     if (NULL == ctx->ly_ctx) {
@@ -928,6 +984,7 @@ pm_cleanup(pm_ctx_t *pm_ctx)
         }
         pthread_rwlock_destroy(&pm_ctx->module_data_lock);
         sr_btree_cleanup(pm_ctx->module_data);
+        dm_version_table_close(pm_ctx->version_table);
         sr_locking_set_cleanup(pm_ctx->lock_ctx);
         free((void*)pm_ctx->data_search_dir);
         free(pm_ctx);
@@ -1176,6 +1233,12 @@ pm_add_subscription(pm_ctx_t *pm_ctx, const ac_ucred_t *user_cred, const char *m
         value = sr_notification_event_gpb_to_str(subscription->notif_event);
         rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, value, true, true, NULL);
         CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+        if (subscription->inline_changes) {
+            snprintf(xpath, PATH_MAX, PM_XPATH_SUBSCRIPTION_INLINE_CHANGES, module_name,
+                    sr_subscription_type_gpb_to_str(subscription->type), subscription->dst_address, subscription->dst_id);
+            rc = pm_modify_persist_data_tree(pm_ctx, &data_tree, xpath, NULL, true, true, NULL);
+            CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to add new leaf into the data tree.");
+        }
     }
     if (SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS == subscription->type ||
             SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS == subscription->type) {
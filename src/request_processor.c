@@ -22,8 +22,10 @@
 
 #include <time.h>
 #include <unistd.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <pthread.h>
+#include <stdatomic.h>
 
 #include "sr_common.h"
 #include "access_control.h"
@@ -35,7 +37,10 @@
 #include "rp_dt_edit.h"
 #include "rp_dt_xpath.h"
 
-#define RP_INIT_REQ_QUEUE_SIZE   10  /**< Initial size of the request queue. */
+#define RP_REQ_QUEUE_SIZE 4096       /**< Capacity of the (bounded, lock-free) request queue, further requests are spilled
+                                          into the overflow queue. */
+#define RP_OVERFLOW_QUEUE_INIT_SIZE 64  /**< Initial capacity of the overflow request queue (grows when needed). */
+#define RP_SESSION_QUEUE_INIT_SIZE 8  /**< Initial capacity of the per-session message queue (grows when needed). */
 
 /*
  * Attributes that can significantly affect performance of the threadpool.
@@ -45,9 +50,16 @@
                                             Enables thread spinning if a thread needs to be woken up again in less than this timeout. */
 #define RP_THREAD_SPIN_MIN 1000        /**< Minimum number of cycles that a thread will spin before going to sleep, if spin is enabled. */
 #define RP_THREAD_SPIN_MAX 1000000     /**< Maximum number of cycles that a thread can spin before going to sleep. */
+#define RP_THREAD_IDLE_TIMEOUT 10      /**< Time in seconds after which an idle thread exits if there are more threads than the minimum. */
+#define RP_THREAD_LIMIT 1024           /**< Upper bound for the maximum size of the thread pool. */
 
 /**
  * @brief Request context (for storing requests inside of the request queue).
+ *
+ * Messages bound to a session are kept in the session's own queue, the request queue
+ * contains only the session (with msg set to NULL) to mark it ready for processing.
+ * Session-less messages are stored in the request queue directly. An entry with
+ * both session and msg set to NULL requests the worker thread to exit.
  */
 typedef struct rp_request_s {
     rp_session_t *session;  /**< Request Processor's session. */
@@ -483,6 +495,7 @@ rp_list_schemas_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session,
     resp->response->result = rc;
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -522,6 +535,7 @@ rp_get_schema_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, S
             &resp->response->get_schema_resp->schema_content);
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -592,6 +606,7 @@ rp_module_install_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *
     resp->response->result = oper_rc;
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     /* notify subscribers */
@@ -668,6 +683,7 @@ rp_feature_enable_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *
     resp->response->result = oper_rc;
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     /* notify subscribers */
@@ -771,6 +787,7 @@ cleanup:
     }
 
     sr_free_val(value);
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -864,6 +881,7 @@ cleanup:
     }
 
     sr_free_values(values, count);
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -946,6 +964,7 @@ cleanup:
     }
 
     sr_free_tree(tree);
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1031,6 +1050,7 @@ cleanup:
     }
 
     sr_free_trees(trees, count);
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1149,6 +1169,7 @@ cleanup:
     }
 
     sr_free_trees(chunks, chunk_cnt);
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1212,6 +1233,7 @@ rp_set_item_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1268,6 +1290,7 @@ cleanup:
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1315,6 +1338,7 @@ rp_delete_item_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1361,6 +1385,144 @@ rp_move_item_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
+    rc = cm_msg_send(rp_ctx->cm_ctx, resp);
+
+    return rc;
+}
+
+/**
+ * @brief Processes an edit_batch request.
+ */
+static int
+rp_edit_batch_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
+{
+    Sr__Msg *resp = NULL;
+    Sr__EditBatchReq *req = NULL;
+    Sr__EditBatchResp *batch_resp = NULL;
+    Sr__EditOperation *op = NULL;
+    Sr__Error *error = NULL;
+    sr_mem_ctx_t *sr_mem = NULL;
+    sr_val_t *value = NULL;
+    char *str_value = NULL;
+    int rc = SR_ERR_OK, rc_op = SR_ERR_OK, first_rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG5(rp_ctx, session, msg, msg->request, msg->request->edit_batch_req);
+
+    req = msg->request->edit_batch_req;
+
+    SR_LOG_DBG("Processing edit_batch request (%zu operations).", req->n_operations);
+
+    /* allocate the response */
+    rc = sr_mem_new(0, &sr_mem);
+    CHECK_RC_MSG_RETURN(rc, "Failed to create a new Sysrepo memory context.");
+    rc = sr_gpb_resp_alloc(sr_mem, SR__OPERATION__EDIT_BATCH, session->id, &resp);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Allocation of edit_batch response failed.");
+        sr_mem_free(sr_mem);
+        return SR_ERR_NOMEM;
+    }
+    batch_resp = resp->response->edit_batch_resp;
+
+    if (0 == req->n_operations) {
+        goto cleanup;
+    }
+
+    batch_resp->results = sr_calloc(sr_mem, req->n_operations, sizeof(*batch_resp->results));
+    CHECK_NULL_NOMEM_GOTO(batch_resp->results, first_rc, cleanup);
+    batch_resp->errors = sr_calloc(sr_mem, req->n_operations, sizeof(*batch_resp->errors));
+    CHECK_NULL_NOMEM_GOTO(batch_resp->errors, first_rc, cleanup);
+
+    /* make room for all operations in the session operation list at once */
+    first_rc = dm_reserve_operations(session->dm_session, req->n_operations);
+    CHECK_RC_MSG_GOTO(first_rc, cleanup, "Failed to allocate session operations.");
+
+    for (size_t i = 0; i < req->n_operations; i++) {
+        op = req->operations[i];
+        value = NULL;
+        str_value = NULL;
+        rc_op = SR_ERR_OK;
+
+        switch (op->type) {
+            case SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__SET:
+                if (NULL != op->value) {
+                    rc_op = sr_dup_gpb_to_val_t((sr_mem_ctx_t *)msg->_sysrepo_mem_ctx, op->value, &value);
+                    if (SR_ERR_OK != rc_op) {
+                        SR_LOG_ERR("Copying gpb value to sr_val_t failed for xpath '%s'", op->xpath);
+                        break;
+                    }
+                }
+                rc_op = rp_dt_set_item_wrapper(rp_ctx, session, op->xpath, value, NULL, op->options);
+                break;
+            case SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__SET_STR:
+                if (NULL != op->str_value) {
+                    str_value = strdup(op->str_value);
+                    CHECK_NULL_NOMEM_ERROR(str_value, rc_op);
+                    if (SR_ERR_OK != rc_op) {
+                        break;
+                    }
+                }
+                rc_op = rp_dt_set_item_wrapper(rp_ctx, session, op->xpath, NULL, str_value, op->options);
+                break;
+            case SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__DELETE:
+                rc_op = rp_dt_delete_item_wrapper(rp_ctx, session, op->xpath, op->options);
+                break;
+            case SR__EDIT_OPERATION__EDIT_OPERATION_TYPE__MOVE:
+                rc_op = rp_dt_move_list_wrapper(rp_ctx, session, op->xpath,
+                        sr_move_direction_gpb_to_sr(op->position), op->relative_item);
+                break;
+            default:
+                SR_LOG_ERR("Unsupported operation type %d in edit batch.", op->type);
+                rc_op = SR_ERR_UNSUPPORTED;
+                break;
+        }
+
+        batch_resp->results[i] = rc_op;
+        ++batch_resp->n_results;
+
+        if (SR_ERR_OK != rc_op) {
+            SR_LOG_ERR("Operation %zu of edit batch failed for '%s', session id=%"PRIu32".", i, op->xpath, session->id);
+            if (SR_ERR_OK == first_rc) {
+                first_rc = rc_op;
+            }
+            /* store the error of the operation */
+            error = sr_calloc(sr_mem, 1, sizeof(*error));
+            CHECK_NULL_NOMEM_GOTO(error, rc, cleanup);
+            sr__error__init(error);
+            if (dm_has_error(session->dm_session)) {
+                rc = dm_copy_errors(session->dm_session, sr_mem, &error->message, &error->xpath);
+                CHECK_RC_MSG_GOTO(rc, cleanup, "Copying errors to gpb failed");
+            } else {
+                sr_mem_edit_string(sr_mem, &error->message, sr_strerror(rc_op));
+                CHECK_NULL_NOMEM_GOTO(error->message, rc, cleanup);
+                sr_mem_edit_string(sr_mem, &error->xpath, op->xpath);
+                CHECK_NULL_NOMEM_GOTO(error->xpath, rc, cleanup);
+            }
+            batch_resp->errors[batch_resp->n_errors++] = error;
+            dm_clear_session_errors(session->dm_session);
+
+            if (!req->continue_on_error) {
+                break;
+            }
+        }
+    }
+
+    /* report the first error as the error of the whole request */
+    if (batch_resp->n_errors > 0) {
+        dm_report_error(session->dm_session, batch_resp->errors[0]->message, batch_resp->errors[0]->xpath, first_rc);
+    }
+
+cleanup:
+    /* set response code */
+    resp->response->result = (SR_ERR_OK != rc) ? rc : first_rc;
+
+    rc = rp_resp_fill_errors(resp, session->dm_session);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Copying errors to gpb failed");
+    }
+
+    /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1409,6 +1571,7 @@ rp_validate_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1489,11 +1652,46 @@ cleanup:
         sr_free_errors(errors, err_cnt);
     }
 
+    sr_gpb_resp_set_req_id(msg, resp);
+    if (NULL != session->commit_sync) {
+        /* the written data are not durable yet, the response is sent by rp_commit_resp_send
+         * once the commit lock is released */
+        session->commit_resp = resp;
+        return SR_ERR_OK;
+    }
+
     /* send the response */
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
     return rc;
 }
 
+/**
+ * @brief Sends the response to a commit request once the files written by the commit
+ * are flushed to the disk (together with the files of concurrent commits).
+ */
+static int
+rp_commit_resp_send(rp_ctx_t *rp_ctx, rp_session_t *session)
+{
+    Sr__Msg *resp = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG3(rp_ctx, session, session->commit_resp);
+
+    resp = session->commit_resp;
+    session->commit_resp = NULL;
+
+    rc = rp_dt_commit_sync_wait(session);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR("Flush of the data committed in session id=%"PRIu32" failed.", session->id);
+        if (SR_ERR_OK == resp->response->result) {
+            resp->response->result = rc;
+        }
+    }
+
+    /* send the response */
+    return cm_msg_send(rp_ctx->cm_ctx, resp);
+}
+
 /**
  * @brief Processes a discard_changes request.
  */
@@ -1529,6 +1727,7 @@ rp_discard_changes_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *sessi
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1601,6 +1800,7 @@ cleanup:
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
     return rc;
 }
@@ -1645,6 +1845,7 @@ rp_session_refresh_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1682,6 +1883,7 @@ rp_switch_datastore_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1720,6 +1922,7 @@ rp_session_set_opts(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1749,7 +1952,12 @@ rp_lock_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__Msg
         return SR_ERR_NOMEM;
     }
 
-    rc = rp_dt_lock(rp_ctx, session, msg->request->lock_req->module_name);
+    if (NULL != msg->request->lock_req->xpath) {
+        /* subtree-level lock */
+        rc = rp_dt_lock_subtree(rp_ctx, session, msg->request->lock_req->xpath);
+    } else {
+        rc = rp_dt_lock(rp_ctx, session, msg->request->lock_req->module_name);
+    }
 
     /* set response code */
     resp->response->result = rc;
@@ -1760,6 +1968,7 @@ rp_lock_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__Msg
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1789,7 +1998,10 @@ rp_unlock_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__M
         return SR_ERR_NOMEM;
     }
 
-    if (NULL != msg->request->unlock_req->module_name) {
+    if (NULL != msg->request->unlock_req->xpath) {
+        /* subtree-level lock */
+        rc = dm_unlock_subtree(rp_ctx->dm_ctx, session->dm_session, msg->request->unlock_req->xpath);
+    } else if (NULL != msg->request->unlock_req->module_name) {
         /* module-level lock */
         rc = dm_unlock_module(rp_ctx->dm_ctx, session->dm_session, msg->request->unlock_req->module_name);
     } else {
@@ -1806,6 +2018,7 @@ rp_unlock_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__M
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1857,6 +2070,9 @@ rp_subscribe_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr
     if (subscribe_req->has_enable_event && subscribe_req->enable_event) {
         options |= NP_SUBSCR_EV_EVENT;
     }
+    if (subscribe_req->has_inline_changes && subscribe_req->inline_changes) {
+        options |= NP_SUBSCR_INLINE_CHANGES;
+    }
 
     /* subscribe to the notification */
     rc = np_notification_subscribe(rp_ctx->np_ctx, session, subscribe_req->type,
@@ -1876,6 +2092,7 @@ rp_subscribe_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     if (SR_ERR_OK == rc) {
@@ -1925,6 +2142,7 @@ rp_unsubscribe_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *session,
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -1971,6 +2189,7 @@ rp_check_enabled_running_req_process(const rp_ctx_t *rp_ctx, const rp_session_t
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
     return rc;
 }
@@ -2055,6 +2274,7 @@ cleanup:
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     sr_list_cleanup(changes);
@@ -2138,6 +2358,7 @@ rp_check_exec_perm_req_process(const rp_ctx_t *rp_ctx, const rp_session_t *sessi
     resp->response->check_exec_perm_resp->permitted = (nacm_action == NACM_ACTION_PERMIT);
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -2302,6 +2523,9 @@ rp_rpc_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *
             CHECK_RC_LOG_GOTO(rc, finalize, "Failed to duplicate %s request (%s).", op_name,
                     msg->request->rpc_req->xpath);
             req->request->rpc_req->action = action;
+            /*  - request id, echoed back by the subscriber */
+            req->request->req_id = msg->request->req_id;
+            req->request->has_req_id = msg->request->has_req_id;
             /*  - xpath */
             if (sr_mem) {
                 req->request->rpc_req->xpath = msg->request->rpc_req->xpath;
@@ -2388,6 +2612,7 @@ finalize:
                 resp->response->rpc_resp->xpath = strdup(msg->request->rpc_req->xpath);
             }
             /* send the response */
+            sr_gpb_resp_set_req_id(msg, resp);
             rc = cm_msg_send(rp_ctx->cm_ctx, resp);
         }
     }
@@ -2680,6 +2905,8 @@ rp_rpc_resp_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
         rc = sr_gpb_resp_alloc(sr_mem, action ? SR__OPERATION__ACTION : SR__OPERATION__RPC, session->id, &resp);
     }
     if (SR_ERR_OK == rc) {
+        resp->response->req_id = msg->response->req_id;
+        resp->response->has_req_id = msg->response->has_req_id;
         resp->response->rpc_resp->action = action;
         if (sr_mem) {
             resp->response->rpc_resp->xpath = msg->response->rpc_resp->xpath;
@@ -2797,6 +3024,197 @@ rp_oper_data_timeout_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Ms
     return rc;
 }
 
+/**
+ * @brief Sets a leaf of the internal state data identified by the formatted xpath.
+ */
+static int
+rp_internal_state_data_set_leaf(rp_ctx_t *rp_ctx, rp_session_t *session, const sr_val_t *value, const char *format, ...)
+{
+    va_list va;
+    char *xpath = NULL;
+    int rc = SR_ERR_OK;
+
+    va_start(va, format);
+    rc = sr_vasprintf(&xpath, format, va);
+    va_end(va);
+    CHECK_RC_MSG_RETURN(rc, "Unable to format the xpath of internal state data.");
+
+    rc = rp_dt_set_item(rp_ctx->dm_ctx, session->dm_session, xpath, SR_EDIT_DEFAULT, value, NULL, false);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_WRN("Failed to set operational data for xpath '%s'.", xpath);
+    }
+    free(xpath);
+
+    return rc;
+}
+
+/**
+ * @brief Sets the state of the delivery of event notifications to the subscribers (sysrepo-monitoring module).
+ */
+static int
+rp_notif_delivery_state_data_set(rp_ctx_t *rp_ctx, rp_session_t *session, size_t queue_size,
+        cm_notif_overflow_policy_t policy, cm_notif_dst_state_t *states, size_t state_cnt)
+{
+    const char *prefix = "/sysrepo-monitoring:notification-delivery";
+    sr_val_t value = { 0, };
+    int rc = SR_ERR_OK;
+
+    value.type = SR_UINT32_T;
+    value.data.uint32_val = queue_size;
+    rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/queue-size", prefix);
+
+    if (SR_ERR_OK == rc) {
+        value.type = SR_ENUM_T;
+        value.data.enum_val = (char *)cm_notif_overflow_policy_to_str(policy);
+        rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/overflow-policy", prefix);
+    }
+
+    for (size_t i = 0; SR_ERR_OK == rc && i < state_cnt; i++) {
+        value.type = SR_BOOL_T;
+        value.data.bool_val = states[i].slow_consumer;
+        rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/destination[address='%s']/slow-consumer",
+                prefix, states[i].dst_address);
+        if (SR_ERR_OK == rc) {
+            value.type = SR_UINT32_T;
+            value.data.uint32_val = states[i].queued_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/destination[address='%s']/queued",
+                    prefix, states[i].dst_address);
+        }
+        if (SR_ERR_OK == rc) {
+            value.type = SR_UINT64_T;
+            value.data.uint64_val = states[i].dropped_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/destination[address='%s']/dropped",
+                    prefix, states[i].dst_address);
+        }
+        for (size_t j = 0; SR_ERR_OK == rc && j < states[i].subscription_cnt; j++) {
+            value.type = SR_UINT64_T;
+            value.data.uint64_val = states[i].subscriptions[j].dropped_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value,
+                    "%s/destination[address='%s']/subscription[id='%"PRIu32"']/dropped",
+                    prefix, states[i].dst_address, states[i].subscriptions[j].subscription_id);
+        }
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Sets the statistics of the commit verifiers (sysrepo-monitoring module).
+ */
+static int
+rp_commit_verification_state_data_set(rp_ctx_t *rp_ctx, rp_session_t *session, np_verifier_stats_t *stats,
+        size_t stats_cnt)
+{
+    const char *prefix = "/sysrepo-monitoring:commit-verification";
+    char *verifier = NULL;
+    sr_val_t value = { 0, };
+    int rc = SR_ERR_OK;
+
+    for (size_t i = 0; SR_ERR_OK == rc && i < stats_cnt; i++) {
+        rc = sr_asprintf(&verifier, "%s/verifier[destination='%s'][subscription-id='%"PRIu32"']",
+                prefix, stats[i].dst_address, stats[i].dst_id);
+        CHECK_RC_MSG_RETURN(rc, "Unable to allocate verifier xpath.");
+
+        value.type = SR_STRING_T;
+        value.data.string_val = stats[i].subs_xpath;
+        rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/name", verifier);
+        if (SR_ERR_OK == rc) {
+            value.type = SR_UINT64_T;
+            value.data.uint64_val = stats[i].verify_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/verify-count", verifier);
+        }
+        if (SR_ERR_OK == rc) {
+            value.data.uint64_val = stats[i].error_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/error-count", verifier);
+        }
+        if (SR_ERR_OK == rc) {
+            value.data.uint64_val = stats[i].late_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/late-count", verifier);
+        }
+        if (SR_ERR_OK == rc) {
+            value.type = SR_UINT32_T;
+            value.data.uint32_val = stats[i].max_latency;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/max-latency", verifier);
+        }
+        for (size_t j = 0; SR_ERR_OK == rc && j < NP_VERIFY_LATENCY_BUCKETS; j++) {
+            if (0 == stats[i].latency_hist[j]) {
+                continue;
+            }
+            value.type = SR_UINT64_T;
+            value.data.uint64_val = stats[i].latency_hist[j];
+            if (j < NP_VERIFY_LATENCY_BUCKETS - 1) {
+                rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value,
+                        "%s/latency-bucket[upper-bound='%"PRIu32"']/count", verifier, (uint32_t)1 << j);
+            } else {
+                rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value,
+                        "%s/latency-bucket[upper-bound='infinity']/count", verifier);
+            }
+        }
+        free(verifier);
+        verifier = NULL;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Returns the statistics of the message queues of all running client sessions.
+ */
+static int
+rp_get_sessions_stats(rp_ctx_t *rp_ctx, rp_session_stats_t **stats_p, size_t *stats_cnt_p)
+{
+    rp_session_stats_t *stats = NULL;
+    size_t stats_cnt = 0;
+    int rc = SR_ERR_OK;
+
+    pthread_mutex_lock(&rp_ctx->sessions_mutex);
+    if (rp_ctx->sessions->count > 0) {
+        stats = calloc(rp_ctx->sessions->count, sizeof(*stats));
+        CHECK_NULL_NOMEM_GOTO(stats, rc, cleanup);
+    }
+    for (size_t i = 0; i < rp_ctx->sessions->count; i++) {
+        rp_get_session_stats(rp_ctx->sessions->data[i], &stats[stats_cnt++]);
+    }
+
+cleanup:
+    pthread_mutex_unlock(&rp_ctx->sessions_mutex);
+
+    *stats_p = stats;
+    *stats_cnt_p = stats_cnt;
+    return rc;
+}
+
+/**
+ * @brief Sets the statistics of the message queues of the sessions (sysrepo-monitoring module).
+ */
+static int
+rp_sessions_state_data_set(rp_ctx_t *rp_ctx, rp_session_t *session, rp_session_stats_t *stats, size_t stats_cnt)
+{
+    const char *prefix = "/sysrepo-monitoring:sessions";
+    sr_val_t value = { 0, };
+    int rc = SR_ERR_OK;
+
+    for (size_t i = 0; SR_ERR_OK == rc && i < stats_cnt; i++) {
+        value.type = SR_UINT32_T;
+        value.data.uint32_val = stats[i].queued;
+        rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/session[id='%"PRIu32"']/queued",
+                prefix, stats[i].id);
+        if (SR_ERR_OK == rc) {
+            value.data.uint32_val = stats[i].max_queued;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/session[id='%"PRIu32"']/max-queued",
+                    prefix, stats[i].id);
+        }
+        if (SR_ERR_OK == rc) {
+            value.type = SR_UINT64_T;
+            value.data.uint64_val = stats[i].processed_cnt;
+            rc = rp_internal_state_data_set_leaf(rp_ctx, session, &value, "%s/session[id='%"PRIu32"']/processed",
+                    prefix, stats[i].id);
+        }
+    }
+
+    return rc;
+}
+
 /**
  * @brief Processes an internal state data request.
  */
@@ -2806,6 +3224,14 @@ rp_internal_state_data_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__
     CHECK_NULL_ARG5(rp_ctx, session, msg, msg->internal_request, msg->internal_request->internal_state_data_req);
     nacm_ctx_t *nacm_ctx = NULL;
     sr_val_t nacm_stats = {0};
+    cm_notif_dst_state_t *notif_dst_states = NULL;
+    size_t notif_dst_state_cnt = 0, notif_queue_size = 0;
+    cm_notif_overflow_policy_t notif_policy = CM_NOTIF_OVERFLOW_DEFAULT;
+    np_verifier_stats_t *verifier_stats = NULL;
+    size_t verifier_stats_cnt = 0;
+    rp_session_stats_t *session_stats = NULL;
+    size_t session_stats_cnt = 0;
+    bool notif_delivery = false;
     int rc = SR_ERR_OK;
     const char *xpath = msg->internal_request->internal_state_data_req->xpath;
     uint64_t orig_req_id = msg->internal_request->internal_state_data_req->request_id;
@@ -2813,6 +3239,23 @@ rp_internal_state_data_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__
 
     SR_LOG_INF("Internal request for state data at xpath %s, orig-req id = %" PRIu64, xpath, orig_req_id);
 
+    if (0 == strcmp(xpath, "/sysrepo-monitoring:notification-delivery")) {
+        /* retrieved before the session is locked, Connection Manager may need the session meanwhile */
+        notif_delivery = (SR_ERR_OK == cm_get_notif_queue_limits(rp_ctx->cm_ctx, &notif_queue_size, &notif_policy) &&
+                SR_ERR_OK == cm_get_notif_dst_states(rp_ctx->cm_ctx, &notif_dst_states, &notif_dst_state_cnt));
+        if (!notif_delivery) {
+            SR_LOG_WRN_MSG("Failed to get the state of event notification delivery.");
+        }
+    } else if (0 == strcmp(xpath, "/sysrepo-monitoring:commit-verification")) {
+        if (SR_ERR_OK != np_get_verifier_stats(rp_ctx->np_ctx, &verifier_stats, &verifier_stats_cnt)) {
+            SR_LOG_WRN_MSG("Failed to get the statistics of commit verifiers.");
+        }
+    } else if (0 == strcmp(xpath, "/sysrepo-monitoring:sessions")) {
+        if (SR_ERR_OK != rp_get_sessions_stats(rp_ctx, &session_stats, &session_stats_cnt)) {
+            SR_LOG_WRN_MSG("Failed to get the statistics of sessions.");
+        }
+    }
+
     MUTEX_LOCK_TIMED_CHECK_GOTO(&session->cur_req_mutex, rc, cleanup);
     if (RP_REQ_WAITING_FOR_DATA != session->state || NULL == session->req || orig_req_id != session->req->request->_id) {
         SR_LOG_ERR("State data arrived after timeout expiration or session id=%u is invalid.", session->id);
@@ -2856,12 +3299,24 @@ rp_internal_state_data_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__
                 SR_LOG_WRN("Failed to set operational data for xpath '%s'.", xpath);
             }
         }
+    } else if (0 == strcmp(xpath, "/sysrepo-monitoring:notification-delivery")) {
+        if (notif_delivery) {
+            rc = rp_notif_delivery_state_data_set(rp_ctx, session, notif_queue_size, notif_policy,
+                    notif_dst_states, notif_dst_state_cnt);
+        }
+    } else if (0 == strcmp(xpath, "/sysrepo-monitoring:commit-verification")) {
+        rc = rp_commit_verification_state_data_set(rp_ctx, session, verifier_stats, verifier_stats_cnt);
+    } else if (0 == strcmp(xpath, "/sysrepo-monitoring:sessions")) {
+        rc = rp_sessions_state_data_set(rp_ctx, session, session_stats, session_stats_cnt);
     } else {
         SR_LOG_WRN("Request for not supported internal state data %s received ", xpath);
     }
 
 
 cleanup:
+    cm_notif_dst_states_free(notif_dst_states, notif_dst_state_cnt);
+    np_verifier_stats_free(verifier_stats, verifier_stats_cnt);
+    free(session_stats);
     if (0 == session->dp_req_waiting) {
         rp_dt_free_state_data_ctx_content(&session->state_data_ctx);
         if (RP_REQ_WAITING_FOR_DATA == session->state) {
@@ -2939,15 +3394,14 @@ rp_nacm_reload_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg * ms
 }
 
 /**
- * @brief Sends an event notification to specified notification subscriber.
+ * @brief Allocates an event notification request with given type, xpath, timestamp and optionally values / trees.
  */
 static int
-rp_event_notif_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__EventNotifReq__NotifType type,
-        const char *xpath, time_t timestamp, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
-        const sr_node_t *sr_trees, size_t sr_trees_cnt, const char *subscription_address, uint32_t subscription_id,
-        time_t delivery_time)
+rp_event_notif_req_alloc(const rp_session_t *session, Sr__EventNotifReq__NotifType type, const char *xpath,
+        time_t timestamp, bool with_data, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
+        const sr_node_t *sr_trees, size_t sr_trees_cnt, Sr__Msg **req_p)
 {
-    Sr__Msg *req = NULL, *internal_req = NULL;
+    Sr__Msg *req = NULL;
     int rc = SR_ERR_OK;
 
     rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, (NULL != session ? session->id : 0), &req);
@@ -2960,17 +3414,73 @@ rp_event_notif_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__Eve
     req->request->event_notif_req->timestamp = timestamp;
 
     /* set values / trees */
-    switch (api_variant) {
-        case SR_API_VALUES:
-            rc = sr_values_sr_to_gpb(sr_values, sr_values_cnt, &req->request->event_notif_req->values,
-                    &req->request->event_notif_req->n_values);
-            break;
-        case SR_API_TREES:
-            rc = sr_trees_sr_to_gpb(sr_trees, sr_trees_cnt, &req->request->event_notif_req->trees,
-                    &req->request->event_notif_req->n_trees);
-            break;
+    if (with_data) {
+        switch (api_variant) {
+            case SR_API_VALUES:
+                rc = sr_values_sr_to_gpb(sr_values, sr_values_cnt, &req->request->event_notif_req->values,
+                        &req->request->event_notif_req->n_values);
+                break;
+            case SR_API_TREES:
+                rc = sr_trees_sr_to_gpb(sr_trees, sr_trees_cnt, &req->request->event_notif_req->trees,
+                        &req->request->event_notif_req->n_trees);
+                break;
+        }
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to duplicate event notification (%s) input data.", xpath);
+    }
+
+    *req_p = req;
+    req = NULL;
+
+cleanup:
+    sr_msg_free(req);
+    return rc;
+}
+
+/**
+ * @brief Packs the data of an event notification once, so that they can be shared by the messages
+ * delivering the notification to all the subscribers with the same API variant.
+ */
+static int
+rp_event_notif_body_pack(Sr__EventNotifReq__NotifType type, const char *xpath, time_t timestamp,
+        sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt, const sr_node_t *sr_trees,
+        size_t sr_trees_cnt, sr_gpb_shared_body_t **body)
+{
+    Sr__Msg *req = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = rp_event_notif_req_alloc(NULL, type, xpath, timestamp, true, api_variant, sr_values, sr_values_cnt,
+            sr_trees, sr_trees_cnt, &req);
+    CHECK_RC_LOG_RETURN(rc, "Failed to prepare event notification (%s) data.", xpath);
+
+    rc = sr_gpb_shared_body_pack(req->request->event_notif_req, body);
+    sr_msg_free(req);
+    CHECK_RC_LOG_RETURN(rc, "Failed to pack event notification (%s) data.", xpath);
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Sends an event notification to specified notification subscriber. If the shared body with
+ * the notification data is provided, it is sent in place of the values / trees.
+ */
+static int
+rp_event_notif_send(const rp_ctx_t *rp_ctx, const rp_session_t *session, Sr__EventNotifReq__NotifType type,
+        const char *xpath, time_t timestamp, sr_api_variant_t api_variant, const sr_val_t *sr_values, size_t sr_values_cnt,
+        const sr_node_t *sr_trees, size_t sr_trees_cnt, sr_gpb_shared_body_t *body, const char *subscription_address,
+        uint32_t subscription_id, time_t delivery_time)
+{
+    Sr__Msg *req = NULL, *internal_req = NULL;
+    int rc = SR_ERR_OK;
+
+    /* the shared body can not be sent later - delayed messages are not released one by one */
+    if (0 != delivery_time) {
+        body = NULL;
     }
-    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to duplicate event notification (%s) input data.", xpath);
+
+    rc = rp_event_notif_req_alloc(session, type, xpath, timestamp, (NULL == body), api_variant, sr_values, sr_values_cnt,
+            sr_trees, sr_trees_cnt, &req);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Failed to duplicate event notification request (%s).", xpath);
+    sr_gpb_shared_body_attach(req, body);
 
     /* set subscription info */
     req->request->event_notif_req->subscriber_address = strdup(subscription_address);
@@ -3042,6 +3552,7 @@ rp_event_notif_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg
     size_t values_cnt = 0, tree_cnt = 0, with_def_cnt = 0, with_def_tree_cnt = 0;
     sr_list_t *subscriptions_list = NULL;
     np_subscription_t *subscription = NULL;
+    sr_gpb_shared_body_t *bodies[2] = { NULL, }, **body = NULL;
     bool sub_match = false, tmp_rp_session = false;
     Sr__Msg *resp = NULL;
     sr_mem_ctx_t *sr_mem_msg = NULL;
@@ -3191,10 +3702,19 @@ rp_event_notif_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg
                     }
                 }
 
+                /* the notification data are packed only once for all the subscribers of the same API variant */
+                body = &bodies[SR_API_VALUES == subscription->api_variant ? 0 : 1];
+                if (NULL == *body) {
+                    rc = rp_event_notif_body_pack(msg->request->event_notif_req->type, xpath,
+                            msg->request->event_notif_req->timestamp, subscription->api_variant,
+                            with_def, with_def_cnt, with_def_tree, with_def_tree_cnt, body);
+                    CHECK_RC_LOG_GOTO(rc, finalize, "Error by packing the notification '%s'.", xpath);
+                }
+
                 rc = rp_event_notif_send(rp_ctx, session, msg->request->event_notif_req->type,
                         xpath, msg->request->event_notif_req->timestamp,
                         subscription->api_variant, with_def, with_def_cnt, with_def_tree, with_def_tree_cnt,
-                        subscription->dst_address, subscription->dst_id, 0);
+                        *body, subscription->dst_address, subscription->dst_id, 0);
                 CHECK_RC_LOG_GOTO(rc, finalize, "Error by sending the notification '%s' to the subscriber '%s'.",
                         subscription->xpath, subscription->dst_address);
             }
@@ -3214,6 +3734,8 @@ finalize:
     free(nacm_rule);
     free(nacm_rule_info);
     np_subscriptions_list_cleanup(subscriptions_list);
+    sr_gpb_shared_body_release(bodies[0]);
+    sr_gpb_shared_body_release(bodies[1]);
 
     if (!sub_match && SR_ERR_OK == rc) {
         /* no subscription for this event notification */
@@ -3225,6 +3747,7 @@ finalize:
         rc_tmp = sr_gpb_resp_alloc(sr_mem_msg, SR__OPERATION__EVENT_NOTIF, session->id, &resp);
         if (SR_ERR_OK == rc_tmp) {
             resp->response->result = rc;
+            sr_gpb_resp_set_req_id(msg, resp);
             rc = cm_msg_send(rp_ctx->cm_ctx, resp);
         }
     } else {
@@ -3290,7 +3813,7 @@ rp_event_notif_replay_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__M
             rc = rp_event_notif_send(rp_ctx, session, SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REPLAY, notification->xpath,
                     notification->timestamp, sr_api_variant_gpb_to_sr(replay_req->api_variant),
                     notification->data.values, notification->data_cnt, notification->data.trees, notification->data_cnt,
-                    replay_req->subscriber_address, replay_req->subscription_id, 0);
+                    NULL, replay_req->subscriber_address, replay_req->subscription_id, 0);
             CHECK_RC_LOG_GOTO(rc, finalize, "Error by sending the replay of notification '%s' to the subscriber '%s'.",
                     notification->xpath, replay_req->subscriber_address);
         }
@@ -3299,7 +3822,7 @@ rp_event_notif_replay_req_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__M
     /* send replay-complete notification */
     rc = rp_event_notif_send(rp_ctx, session, SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REPLAY_COMPLETE,
             replay_req->xpath, time(NULL), sr_api_variant_gpb_to_sr(replay_req->api_variant),
-            NULL, 0, NULL, 0, replay_req->subscriber_address, replay_req->subscription_id, 0);
+            NULL, 0, NULL, 0, NULL, replay_req->subscriber_address, replay_req->subscription_id, 0);
     CHECK_RC_LOG_GOTO(rc, finalize, "Error by sending the replay-complete notification to the subscriber '%s'.",
             replay_req->subscriber_address);
 
@@ -3315,7 +3838,7 @@ finalize:
     /* schedule replay-stop notification */
     if ((0 != replay_req->stop_time) && (time(NULL) <= replay_req->stop_time)) {
         rc = rp_event_notif_send(rp_ctx, session, SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REPLAY_STOP, replay_req->xpath,
-                replay_req->stop_time, sr_api_variant_gpb_to_sr(replay_req->api_variant), NULL, 0, NULL, 0,
+                replay_req->stop_time, sr_api_variant_gpb_to_sr(replay_req->api_variant), NULL, 0, NULL, 0, NULL,
                 replay_req->subscriber_address, replay_req->subscription_id, replay_req->stop_time);
         if (SR_ERR_OK != rc) {
             SR_LOG_ERR("Error by scheduling the replay-stop notification to the subscriber '%s'.",
@@ -3332,6 +3855,7 @@ finalize:
     }
 
     /* send the response */
+    sr_gpb_resp_set_req_id(msg, resp);
     rc = cm_msg_send(rp_ctx->cm_ctx, resp);
 
     return rc;
@@ -3371,8 +3895,9 @@ rp_notification_ack_process(rp_ctx_t *rp_ctx, Sr__Msg *msg)
                 subs_xpath, sr_notification_event_gpb_to_str(event), sr_strerror(msg->notification_ack->result));
     }
 
-    rc = np_commit_notification_ack(rp_ctx->np_ctx, notif->commit_id, subs_xpath, sr_notification_event_gpb_to_sr(event),
-            msg->notification_ack->result, msg->notification_ack->do_not_send_abort, err_msg, err_xpath);
+    rc = np_commit_notification_ack(rp_ctx->np_ctx, notif->commit_id, notif->destination_address, notif->subscription_id,
+            subs_xpath, sr_notification_event_gpb_to_sr(event), msg->notification_ack->result,
+            msg->notification_ack->do_not_send_abort, err_msg, err_xpath);
 
     return rc;
 }
@@ -3416,6 +3941,7 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         case SR__OPERATION__SET_ITEM_STR:
         case SR__OPERATION__DELETE_ITEM:
         case SR__OPERATION__MOVE_ITEM:
+        case SR__OPERATION__EDIT_BATCH:
         case SR__OPERATION__SESSION_REFRESH:
             pthread_rwlock_rdlock(&rp_ctx->commit_lock);
             locked = true;
@@ -3477,6 +4003,9 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         case SR__OPERATION__MOVE_ITEM:
             rc = rp_move_item_req_process(rp_ctx, session, msg);
             break;
+        case SR__OPERATION__EDIT_BATCH:
+            rc = rp_edit_batch_req_process(rp_ctx, session, msg);
+            break;
         case SR__OPERATION__VALIDATE:
             rc = rp_validate_req_process(rp_ctx, session, msg);
             break;
@@ -3535,6 +4064,11 @@ rp_req_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg, bool *ski
         pthread_rwlock_unlock(&rp_ctx->commit_lock);
     }
 
+    if (NULL != session && NULL != session->commit_resp) {
+        /* group commit - flush the data together with the concurrent commits, reply afterwards */
+        rc = rp_commit_resp_send(rp_ctx, session);
+    }
+
     return rc;
 }
 
@@ -3698,18 +4232,49 @@ rp_msg_dispatch(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
  * @brief Cleans up the session (releases the data allocated by Request Processor).
  */
 static int
-rp_session_cleanup(const rp_ctx_t *rp_ctx, rp_session_t *session)
+rp_session_cleanup(rp_ctx_t *rp_ctx, rp_session_t *session)
 {
     CHECK_NULL_ARG2(rp_ctx, session);
 
     SR_LOG_DBG("RP session cleanup, session id=%"PRIu32".", session->id);
 
+    if (0 != session->id) {
+        pthread_mutex_lock(&rp_ctx->sessions_mutex);
+        if (rp_ctx->sessions->count > 0) {
+            /* not found if the session start has failed */
+            sr_list_rm(rp_ctx->sessions, session);
+        }
+        pthread_mutex_unlock(&rp_ctx->sessions_mutex);
+    }
+
+    if (NULL != session->commit_sync) {
+        /* do not wait for the flush, the session may be stopped with the CM lock held */
+        dm_commit_sync_release(session->commit_sync);
+        session->commit_sync = NULL;
+    }
+    if (NULL != session->commit_resp) {
+        sr_msg_free(session->commit_resp);
+    }
     dm_session_stop(rp_ctx->dm_ctx, session->dm_session);
     ac_session_cleanup(session->ac_session);
 
     ly_set_free(session->get_items_ctx.nodes);
     free(session->get_items_ctx.xpath);
     pthread_mutex_destroy(&session->msg_count_mutex);
+    if (NULL != session->msg_queue) {
+        Sr__Msg *msg = NULL;
+        while (sr_cbuff_dequeue(session->msg_queue, &msg)) {
+            sr_msg_free(msg);
+        }
+        sr_cbuff_cleanup(session->msg_queue);
+    }
+    if (NULL != session->held_queue) {
+        Sr__Msg *msg = NULL;
+        while (sr_cbuff_dequeue(session->held_queue, &msg)) {
+            sr_msg_free(msg);
+        }
+        sr_cbuff_cleanup(session->held_queue);
+    }
     pthread_mutex_destroy(&session->total_req_cnt_mutex);
     pthread_mutex_destroy(&session->cur_req_mutex);
     free(session->change_ctx.xpath);
@@ -3732,6 +4297,238 @@ rp_session_cleanup(const rp_ctx_t *rp_ctx, rp_session_t *session)
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Puts a request into the request queue. If the lock-free queue is full, the request
+ * is spilled into the overflow queue, so that no request is dropped and the producer
+ * (CM thread or a worker) never waits for the workers to drain the queue.
+ */
+static int
+rp_request_enqueue(rp_ctx_t *rp_ctx, rp_request_t *req)
+{
+    int rc = SR_ERR_OK;
+
+    if (0 == atomic_load(&rp_ctx->overflow_cnt)) {
+        rc = sr_mpmc_queue_enqueue(rp_ctx->request_queue, req);
+        if (SR_ERR_OK == rc) {
+            return rc;
+        }
+    }
+
+    /* once some requests have been spilled, the following ones go after them to keep the FIFO order */
+    pthread_mutex_lock(&rp_ctx->overflow_mutex);
+    rc = sr_cbuff_enqueue(rp_ctx->overflow_queue, req);
+    if (SR_ERR_OK == rc) {
+        atomic_fetch_add(&rp_ctx->overflow_cnt, 1);
+    }
+    pthread_mutex_unlock(&rp_ctx->overflow_mutex);
+
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Unable to spill a request into the RP overflow queue.");
+    }
+    return rc;
+}
+
+/**
+ * @brief Takes the oldest request from the request queue. The spilled requests are newer
+ * than the ones in the lock-free queue, so they are taken only once it has been drained.
+ */
+static bool
+rp_request_dequeue(rp_ctx_t *rp_ctx, rp_request_t *req)
+{
+    bool dequeued = sr_mpmc_queue_dequeue(rp_ctx->request_queue, req);
+
+    if (!dequeued && 0 != atomic_load(&rp_ctx->overflow_cnt)) {
+        pthread_mutex_lock(&rp_ctx->overflow_mutex);
+        dequeued = sr_cbuff_dequeue(rp_ctx->overflow_queue, req);
+        if (dequeued) {
+            atomic_fetch_sub(&rp_ctx->overflow_cnt, 1);
+        }
+        pthread_mutex_unlock(&rp_ctx->overflow_mutex);
+    }
+
+    return dequeued;
+}
+
+/**
+ * @brief Returns the number of requests waiting in the request queue (including the spilled ones).
+ */
+static size_t
+rp_request_queue_depth(rp_ctx_t *rp_ctx)
+{
+    return sr_mpmc_queue_items_in_queue(rp_ctx->request_queue) + atomic_load(&rp_ctx->overflow_cnt);
+}
+
+/**
+ * @brief Processes one message of a session taken from the ready-list. If the session
+ * has more messages waiting, puts it back to the end of the ready-list, so that
+ * the messages of each session are processed in order and the sessions get served fairly.
+ *
+ * While a request of the session is paused (waiting for operational data or verifiers),
+ * further requests of the session are held back and processed once the paused request
+ * is finished. Responses and internal requests are processed immediately, since they
+ * may be the ones resuming the paused request.
+ */
+static void
+rp_session_msg_process(rp_ctx_t *rp_ctx, rp_session_t *session)
+{
+    rp_request_t req = { 0 };
+    Sr__Msg *msg = NULL;
+    bool held = false, paused = false, reschedule = false;
+
+    pthread_mutex_lock(&session->msg_count_mutex);
+    if (NULL == session->paused_req && sr_cbuff_items_in_queue(session->held_queue) > 0) {
+        sr_cbuff_dequeue(session->held_queue, &msg);
+    } else {
+        sr_cbuff_dequeue(session->msg_queue, &msg);
+        if (NULL != msg && NULL != session->paused_req) {
+            if (msg == session->paused_req) {
+                /* the paused request has been resumed */
+                session->paused_req = NULL;
+            } else if (SR__MSG__MSG_TYPE__REQUEST == msg->type) {
+                held = (SR_ERR_OK == sr_cbuff_enqueue(session->held_queue, &msg));
+                if (!held) {
+                    SR_LOG_WRN("Unable to hold a request of session id=%"PRIu32", processing it immediately.", session->id);
+                }
+            }
+        }
+    }
+    session->msg_stats.queued = sr_cbuff_items_in_queue(session->msg_queue) +
+            sr_cbuff_items_in_queue(session->held_queue);
+    pthread_mutex_unlock(&session->msg_count_mutex);
+
+    if (NULL != msg && !held) {
+        bool is_request = (SR__MSG__MSG_TYPE__REQUEST == msg->type);
+        rp_msg_dispatch(rp_ctx, session, msg);
+        if (is_request) {
+            /* a paused request is kept in session->req until it is resumed */
+            pthread_mutex_lock(&session->cur_req_mutex);
+            paused = (msg == session->req && (RP_REQ_WAITING_FOR_DATA == session->state ||
+                    RP_REQ_WAITING_FOR_VERIFIERS == session->state));
+            pthread_mutex_unlock(&session->cur_req_mutex);
+        }
+    }
+
+    /* update message count and release session if needed */
+    pthread_mutex_lock(&session->msg_count_mutex);
+    if (paused) {
+        session->paused_req = msg;
+    }
+    if (NULL != msg && !held) {
+        session->msg_count -= 1;
+        session->msg_stats.processed_cnt += 1;
+    }
+    if (0 == session->msg_count && session->stop_requested) {
+        pthread_mutex_unlock(&session->msg_count_mutex);
+        rp_session_cleanup(rp_ctx, session);
+        return;
+    }
+    if (sr_cbuff_items_in_queue(session->msg_queue) > 0 ||
+            (NULL == session->paused_req && sr_cbuff_items_in_queue(session->held_queue) > 0)) {
+        reschedule = true;
+    } else {
+        session->msg_scheduled = false;
+    }
+    pthread_mutex_unlock(&session->msg_count_mutex);
+
+    if (reschedule) {
+        req.session = session;
+        if (SR_ERR_OK != rp_request_enqueue(rp_ctx, &req)) {
+            /* the messages stay in the session's queue, they will be processed with its next message */
+            pthread_mutex_lock(&session->msg_count_mutex);
+            session->msg_scheduled = false;
+            pthread_mutex_unlock(&session->msg_count_mutex);
+        }
+    }
+}
+
+static void *rp_worker_thread_execute(void *rp_ctx_p);
+
+/**
+ * @brief Spawns a new worker thread into a free slot of the thread pool.
+ * Expects thread_pool_mutex to be locked.
+ */
+static int
+rp_thread_spawn(rp_ctx_t *rp_ctx)
+{
+    rp_thread_slot_t *slot = NULL;
+    int ret = 0;
+
+    CHECK_NULL_ARG(rp_ctx);
+
+    for (size_t i = 0; i < rp_ctx->thread_pool_size; i++) {
+        if (RP_THREAD_RUNNING != rp_ctx->thread_pool[i].state) {
+            slot = &rp_ctx->thread_pool[i];
+            break;
+        }
+    }
+    if (NULL == slot) {
+        SR_LOG_ERR_MSG("No free slot in the RP thread pool.");
+        return SR_ERR_INTERNAL;
+    }
+
+    if (RP_THREAD_EXITED == slot->state) {
+        /* reap the thread that occupied the slot before */
+        pthread_join(slot->thread_id, NULL);
+        slot->state = RP_THREAD_FREE;
+    }
+
+    ret = pthread_create(&slot->thread_id, NULL, rp_worker_thread_execute, rp_ctx);
+    if (0 != ret) {
+        SR_LOG_ERR("Error by creating a new thread: %s", sr_strerror_safe(ret));
+        return SR_ERR_INTERNAL;
+    }
+    slot->state = RP_THREAD_RUNNING;
+    rp_ctx->thread_count++;
+
+    return SR_ERR_OK;
+}
+
+/**
+ * @brief Releases the thread pool slot of the calling thread, the thread will be joined later.
+ * Expects thread_pool_mutex to be locked.
+ */
+static void
+rp_thread_release(rp_ctx_t *rp_ctx)
+{
+    for (size_t i = 0; i < rp_ctx->thread_pool_size; i++) {
+        if ((RP_THREAD_RUNNING == rp_ctx->thread_pool[i].state) &&
+                pthread_equal(rp_ctx->thread_pool[i].thread_id, pthread_self())) {
+            rp_ctx->thread_pool[i].state = RP_THREAD_EXITED;
+            rp_ctx->thread_count--;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Samples the depth of the request queue and grows the thread pool if all threads
+ * are busy and the requests keep piling up.
+ */
+static void
+rp_thread_pool_adjust(rp_ctx_t *rp_ctx)
+{
+    size_t queued = rp_request_queue_depth(rp_ctx);
+    size_t active = atomic_load(&rp_ctx->active_threads);
+
+    if (active < atomic_load(&rp_ctx->thread_count) || queued <= (active * RP_REQ_PER_THREADS)) {
+        /* some threads are sleeping (will be woken up by rp_msg_process) or the load is manageable */
+        return;
+    }
+
+    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+    /* re-check with the mutex locked, some other thread may have already grown the pool */
+    if (!rp_ctx->stop_requested && atomic_load(&rp_ctx->active_threads) >= rp_ctx->thread_count) {
+        if (rp_ctx->thread_count >= rp_ctx->thread_max) {
+            rp_ctx->thread_stats.ceiling_hit_cnt++;
+        } else if (SR_ERR_OK == rp_thread_spawn(rp_ctx)) {
+            rp_ctx->thread_stats.grow_cnt++;
+            SR_LOG_DBG("RP thread pool grown to %zu threads (%zu requests in queue).",
+                    (size_t)rp_ctx->thread_count, queued);
+        }
+    }
+    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+}
+
 /**
  * @brief Executes the work of a worker thread.
  */
@@ -3744,39 +4541,38 @@ rp_worker_thread_execute(void *rp_ctx_p)
     rp_ctx_t *rp_ctx = (rp_ctx_t*)rp_ctx_p;
     rp_request_t req = { 0 };
     bool dequeued = false, dequeued_prev = false, exit = false;
+    int rc = SR_ERR_OK;
 
     SR_LOG_DBG("Starting worker thread id=%lu.", (unsigned long)pthread_self());
 
-    pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-    rp_ctx->active_threads++;
-    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+    atomic_fetch_add(&rp_ctx->active_threads, 1);
 
     do {
         /* process requests while there are some */
         dequeued_prev = false;
         do {
             /* dequeue a request */
-            pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-            dequeued = sr_cbuff_dequeue(rp_ctx->request_queue, &req);
-            pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+            dequeued = rp_request_dequeue(rp_ctx, &req);
 
             if (dequeued) {
                 /* process the request */
-                if (NULL == req.msg) {
+                if (NULL == req.session && NULL == req.msg) {
                     SR_LOG_DBG("Thread id=%lu received an empty request, exiting.", (unsigned long)pthread_self());
+                    atomic_fetch_sub(&rp_ctx->active_threads, 1);
+                    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+                    rp_thread_release(rp_ctx);
+                    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
                     exit = true;
                 } else {
-                    rp_msg_dispatch(rp_ctx, req.session, req.msg);
+                    /* grow the thread pool if the queue is too deep */
+                    rp_thread_pool_adjust(rp_ctx);
+
                     if (NULL != req.session) {
-                        /* update message count and release session if needed */
-                        pthread_mutex_lock(&req.session->msg_count_mutex);
-                        req.session->msg_count -= 1;
-                        if (0 == req.session->msg_count && req.session->stop_requested) {
-                            pthread_mutex_unlock(&req.session->msg_count_mutex);
-                            rp_session_cleanup(rp_ctx, req.session);
-                        } else {
-                            pthread_mutex_unlock(&req.session->msg_count_mutex);
-                        }
+                        /* session from the ready-list */
+                        rp_session_msg_process(rp_ctx, req.session);
+                    } else {
+                        /* session-less message */
+                        rp_msg_dispatch(rp_ctx, NULL, req.msg);
                     }
                 }
                 dequeued_prev = true;
@@ -3784,23 +4580,19 @@ rp_worker_thread_execute(void *rp_ctx_p)
                 /* no items in queue - spin for a while */
                 if (dequeued_prev) {
                     /* only if the thread has actually processed something since the last wakeup */
-                    size_t count = 0;
-                    pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-                    while ((0 == sr_cbuff_items_in_queue(rp_ctx->request_queue)) && (count < rp_ctx->thread_spin_limit)) {
+                    size_t count = 0, spin_limit = atomic_load(&rp_ctx->thread_spin_limit);
+                    while ((0 == rp_request_queue_depth(rp_ctx)) && (count < spin_limit)) {
                         count++;
                     }
-                    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
                 }
-                pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-                if (0 != sr_cbuff_items_in_queue(rp_ctx->request_queue)) {
+                if (0 != rp_request_queue_depth(rp_ctx)) {
                     /* some items are in queue - process them */
-                    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
                     dequeued = true;
                     continue;
                 } else {
-                    /* no items in queue - go to sleep */
-                    rp_ctx->active_threads--;
-                    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+                    /* no items in queue - go to sleep (the queue is checked once more before sleeping,
+                     * so a request enqueued by a producer that still considers this thread active is not missed) */
+                    atomic_fetch_sub(&rp_ctx->active_threads, 1);
                 }
             }
         } while (dequeued && !exit);
@@ -3809,18 +4601,33 @@ rp_worker_thread_execute(void *rp_ctx_p)
             /* wait until new request comes */
             SR_LOG_DBG("Thread id=%lu will wait.",  (unsigned long)pthread_self());
 
-            /* wait for a signal */
-            pthread_mutex_lock(&rp_ctx->request_queue_mutex);
+            pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
             if (rp_ctx->stop_requested) {
                 /* stop has been requested, do not wait anymore */
-                pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+                rp_thread_release(rp_ctx);
+                pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
                 break;
             }
-            pthread_cond_wait(&rp_ctx->request_queue_cv, &rp_ctx->request_queue_mutex);
-            rp_ctx->active_threads++;
+            pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
 
-            SR_LOG_DBG("Thread id=%lu signaled.",  (unsigned long)pthread_self());
-            pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+            /* wait for a signal */
+            /* the spilled requests are checked as well, their producer may skip the notification */
+            rc = sr_mpmc_queue_wait(rp_ctx->request_queue, RP_THREAD_IDLE_TIMEOUT * 1000, &rp_ctx->overflow_cnt);
+
+            pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+            if ((rp_ctx->thread_count > rp_ctx->thread_max) ||
+                    (SR_ERR_TIME_OUT == rc && !rp_ctx->stop_requested && rp_ctx->thread_count > rp_ctx->thread_min &&
+                     0 == rp_request_queue_depth(rp_ctx))) {
+                /* the thread is not needed anymore - shrink the thread pool */
+                rp_thread_release(rp_ctx);
+                rp_ctx->thread_stats.shrink_cnt++;
+                SR_LOG_DBG("RP thread pool shrunk to %zu threads.", (size_t)rp_ctx->thread_count);
+                exit = true;
+            } else {
+                atomic_fetch_add(&rp_ctx->active_threads, 1);
+                SR_LOG_DBG("Thread id=%lu signaled.",  (unsigned long)pthread_self());
+            }
+            pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
         }
     } while (!exit);
 
@@ -3829,6 +4636,64 @@ rp_worker_thread_execute(void *rp_ctx_p)
     return NULL;
 }
 
+/**
+ * @brief Requests all worker threads to exit and waits until they do so.
+ */
+static void
+rp_thread_pool_stop(rp_ctx_t *rp_ctx)
+{
+    rp_request_t req = { 0 };
+    pthread_t *threads = NULL;
+    size_t thread_cnt = 0;
+
+    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+    rp_ctx->stop_requested = true;
+    thread_cnt = rp_ctx->thread_count;
+    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+
+    /* enqueue empty requests to request thread exits (no threads can be spawned from now on) */
+    for (size_t i = 0; i < thread_cnt; i++) {
+        if (SR_ERR_OK != rp_request_enqueue(rp_ctx, &req)) {
+            SR_LOG_ERR_MSG("Unable to request an exit of a worker thread.");
+        }
+    }
+    sr_mpmc_queue_notify(rp_ctx->request_queue, true);
+
+    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+    thread_cnt = 0;
+    if (0 == rp_ctx->thread_pool_size) {
+        /* thread pool has not been initialized */
+        pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+        return;
+    }
+
+    /* collect all threads to be joined */
+    threads = calloc(rp_ctx->thread_pool_size, sizeof(*threads));
+    for (size_t i = 0; NULL != threads && i < rp_ctx->thread_pool_size; i++) {
+        if (RP_THREAD_FREE != rp_ctx->thread_pool[i].state) {
+            threads[thread_cnt++] = rp_ctx->thread_pool[i].thread_id;
+        }
+    }
+    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+
+    if (NULL == threads) {
+        SR_LOG_ERR_MSG("Cannot allocate memory for joining RP threads.");
+        return;
+    }
+
+    /* wait for threads to exit */
+    for (size_t i = 0; i < thread_cnt; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+    for (size_t i = 0; i < rp_ctx->thread_pool_size; i++) {
+        rp_ctx->thread_pool[i].state = RP_THREAD_FREE;
+    }
+    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+}
+
 static void
 rp_cleanup_internal_state_data_records(rp_ctx_t *rp_ctx)
 {
@@ -3883,7 +4748,7 @@ rp_setup_internal_state_data(rp_ctx_t *rp_ctx)
 {
     CHECK_NULL_ARG(rp_ctx);
     nacm_ctx_t *nacm_ctx = NULL;
-    sr_list_t *ietf_netconf_acm = NULL;
+    sr_list_t *ietf_netconf_acm = NULL, *sysrepo_monitoring = NULL;
     int rc = SR_ERR_OK;
 
     rc = dm_get_nacm_ctx(rp_ctx->dm_ctx, &nacm_ctx);
@@ -3916,12 +4781,32 @@ rp_setup_internal_state_data(rp_ctx_t *rp_ctx)
         CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
         ietf_netconf_acm = NULL;
     }
+
+    rc = sr_list_init(&sysrepo_monitoring);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List init failed");
+
+    rc = sr_list_add(sysrepo_monitoring, strdup("/sysrepo-monitoring:notification-delivery"));
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+
+    rc = sr_list_add(sysrepo_monitoring, strdup("/sysrepo-monitoring:commit-verification"));
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+
+    rc = sr_list_add(sysrepo_monitoring, strdup("/sysrepo-monitoring:sessions"));
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+
+    rc = sr_list_add(rp_ctx->modules_incl_intern_op_data, strdup("sysrepo-monitoring"));
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+
+    rc = sr_list_add(rp_ctx->inter_op_data_xpath, sysrepo_monitoring);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "List add failed");
+    sysrepo_monitoring = NULL;
     rc = rp_enable_xps_for_internal_state_data(rp_ctx);
     CHECK_RC_MSG_GOTO(rc, cleanup, "Failed to enable xpaths for internal state data");
 
 cleanup:
     if (SR_ERR_OK != rc) {
         sr_free_list_of_strings(ietf_netconf_acm);
+        sr_free_list_of_strings(sysrepo_monitoring);
         rp_cleanup_internal_state_data_records(rp_ctx);
     }
     return rc;
@@ -3930,8 +4815,8 @@ cleanup:
 int
 rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx_p)
 {
-    size_t i = 0, j = 0;
     rp_ctx_t *ctx = NULL;
+    bool threads_initialized = false;
     int ret = 0, rc = SR_ERR_OK;
 
     CHECK_NULL_ARG(rp_ctx_p);
@@ -3954,11 +4839,24 @@ rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx_p)
     }
 
     /* initialize request queue */
-    rc = sr_cbuff_init(RP_INIT_REQ_QUEUE_SIZE, sizeof(rp_request_t), &ctx->request_queue);
+    rc = sr_mpmc_queue_init(RP_REQ_QUEUE_SIZE, sizeof(rp_request_t), &ctx->request_queue);
     if (SR_ERR_OK != rc) {
         SR_LOG_ERR_MSG("RP request queue initialization failed.");
         goto cleanup;
     }
+    rc = sr_cbuff_init(RP_OVERFLOW_QUEUE_INIT_SIZE, sizeof(rp_request_t), &ctx->overflow_queue);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("RP overflow request queue initialization failed.");
+        goto cleanup;
+    }
+    pthread_mutex_init(&ctx->overflow_mutex, NULL);
+
+    rc = sr_list_init(&ctx->sessions);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("RP session list initialization failed.");
+        goto cleanup;
+    }
+    pthread_mutex_init(&ctx->sessions_mutex, NULL);
 
     pthread_rwlockattr_t attr;
     pthread_rwlockattr_init(&attr);
@@ -4001,30 +4899,35 @@ rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx_p)
     pthread_mutex_init(&ctx->total_req_cnt_mutex, NULL);
 
     /* run worker threads */
-    pthread_mutex_init(&ctx->request_queue_mutex, NULL);
-    pthread_cond_init(&ctx->request_queue_cv, NULL);
-
-    for (i = 0; i < RP_THREAD_COUNT; i++) {
-        rc = pthread_create(&ctx->thread_pool[i], NULL, rp_worker_thread_execute, ctx);
-        if (0 != rc) {
-            SR_LOG_ERR("Error by creating a new thread: %s", sr_strerror_safe(errno));
-            for (j = 0; j < i; j++) {
-                pthread_cancel(ctx->thread_pool[j]);
-            }
-            rc = SR_ERR_INTERNAL;
-            goto cleanup;
-        }
-    }
+    pthread_mutex_init(&ctx->thread_pool_mutex, NULL);
+    threads_initialized = true;
+
+    rc = rp_set_thread_limits(ctx, SR_RP_THREAD_COUNT_MIN, SR_RP_THREAD_COUNT_MAX);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "RP thread pool initialization failed.");
 
     *rp_ctx_p = ctx;
     return SR_ERR_OK;
 
 cleanup:
+    if (threads_initialized) {
+        rp_thread_pool_stop(ctx);
+        pthread_mutex_destroy(&ctx->thread_pool_mutex);
+        pthread_mutex_destroy(&ctx->total_req_cnt_mutex);
+        free(ctx->thread_pool);
+    }
     dm_cleanup(ctx->dm_ctx);
     np_cleanup(ctx->np_ctx);
     pm_cleanup(ctx->pm_ctx);
     ac_cleanup(ctx->ac_ctx);
-    sr_cbuff_cleanup(ctx->request_queue);
+    sr_mpmc_queue_cleanup(ctx->request_queue);
+    if (NULL != ctx->overflow_queue) {
+        sr_cbuff_cleanup(ctx->overflow_queue);
+        pthread_mutex_destroy(&ctx->overflow_mutex);
+    }
+    if (NULL != ctx->sessions) {
+        sr_list_cleanup(ctx->sessions);
+        pthread_mutex_destroy(&ctx->sessions_mutex);
+    }
     free(ctx);
     return rc;
 }
@@ -4032,31 +4935,21 @@ cleanup:
 void
 rp_cleanup(rp_ctx_t *rp_ctx)
 {
-    size_t i = 0;
     rp_request_t req = { 0 };
 
     SR_LOG_DBG_MSG("Request Processor cleanup started, requesting cancel of each worker thread.");
 
     if (NULL != rp_ctx) {
-        /* enqueue RP_THREAD_COUNT "empty" messages and send signal to all threads */
-        pthread_mutex_lock(&rp_ctx->request_queue_mutex);
-        rp_ctx->stop_requested = true;
-        /* enqueue empty requests to request thread exits */
-        for (i = 0; i < RP_THREAD_COUNT; i++) {
-            sr_cbuff_enqueue(rp_ctx->request_queue, &req);
-        }
-        pthread_cond_broadcast(&rp_ctx->request_queue_cv);
-        pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
+        /* enqueue "empty" messages, send signal to all threads and wait for them to exit */
+        rp_thread_pool_stop(rp_ctx);
 
-        /* wait for threads to exit */
-        for (i = 0; i < RP_THREAD_COUNT; i++) {
-            pthread_join(rp_ctx->thread_pool[i], NULL);
-        }
-        pthread_mutex_destroy(&rp_ctx->request_queue_mutex);
-        pthread_cond_destroy(&rp_ctx->request_queue_cv);
+        SR_LOG_DBG("RP thread pool statistics: grown %"PRIu64"x, shrunk %"PRIu64"x, ceiling hit %"PRIu64"x.",
+                rp_ctx->thread_stats.grow_cnt, rp_ctx->thread_stats.shrink_cnt, rp_ctx->thread_stats.ceiling_hit_cnt);
+
+        pthread_mutex_destroy(&rp_ctx->thread_pool_mutex);
         pthread_mutex_destroy(&rp_ctx->total_req_cnt_mutex);
 
-        while (sr_cbuff_dequeue(rp_ctx->request_queue, &req)) {
+        while (rp_request_dequeue(rp_ctx, &req)) {
             if (NULL != req.msg) {
                 sr_msg_free(req.msg);
             }
@@ -4066,8 +4959,13 @@ rp_cleanup(rp_ctx_t *rp_ctx)
         np_cleanup(rp_ctx->np_ctx);
         pm_cleanup(rp_ctx->pm_ctx);
         ac_cleanup(rp_ctx->ac_ctx);
-        sr_cbuff_cleanup(rp_ctx->request_queue);
+        sr_mpmc_queue_cleanup(rp_ctx->request_queue);
+        sr_cbuff_cleanup(rp_ctx->overflow_queue);
+        pthread_mutex_destroy(&rp_ctx->overflow_mutex);
+        sr_list_cleanup(rp_ctx->sessions);
+        pthread_mutex_destroy(&rp_ctx->sessions_mutex);
         rp_cleanup_internal_state_data_records(rp_ctx);
+        free(rp_ctx->thread_pool);
         free(rp_ctx);
     }
 
@@ -4075,7 +4973,64 @@ rp_cleanup(rp_ctx_t *rp_ctx)
 }
 
 int
-rp_session_start(const rp_ctx_t *rp_ctx, const uint32_t session_id, const ac_ucred_t *user_credentials,
+rp_set_thread_limits(rp_ctx_t *rp_ctx, size_t min_threads, size_t max_threads)
+{
+    rp_thread_slot_t *tmp = NULL;
+    int rc = SR_ERR_OK;
+
+    CHECK_NULL_ARG(rp_ctx);
+
+    if (0 == min_threads || min_threads > max_threads || max_threads > RP_THREAD_LIMIT) {
+        SR_LOG_ERR("Invalid RP thread pool limits (min=%zu, max=%zu).", min_threads, max_threads);
+        return SR_ERR_INVAL_ARG;
+    }
+
+    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+
+    if (max_threads > rp_ctx->thread_pool_size) {
+        /* threads access their slots only with the mutex locked, so the pool can be reallocated */
+        tmp = realloc(rp_ctx->thread_pool, max_threads * sizeof(*tmp));
+        CHECK_NULL_NOMEM_GOTO(tmp, rc, cleanup);
+        memset(tmp + rp_ctx->thread_pool_size, 0, (max_threads - rp_ctx->thread_pool_size) * sizeof(*tmp));
+        rp_ctx->thread_pool = tmp;
+        rp_ctx->thread_pool_size = max_threads;
+    }
+    rp_ctx->thread_min = min_threads;
+    rp_ctx->thread_max = max_threads;
+
+    /* fill the pool up to the minimum */
+    while (rp_ctx->thread_count < rp_ctx->thread_min) {
+        rc = rp_thread_spawn(rp_ctx);
+        CHECK_RC_MSG_GOTO(rc, cleanup, "Unable to spawn a new RP thread.");
+    }
+    if (rp_ctx->thread_count > rp_ctx->thread_max) {
+        /* wake up sleeping threads, the redundant ones will exit */
+        sr_mpmc_queue_notify(rp_ctx->request_queue, true);
+    }
+
+    SR_LOG_INF("RP thread pool limits set to min=%zu, max=%zu.", min_threads, max_threads);
+
+cleanup:
+    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+    return rc;
+}
+
+int
+rp_get_thread_pool_stats(rp_ctx_t *rp_ctx, rp_thread_pool_stats_t *stats)
+{
+    CHECK_NULL_ARG2(rp_ctx, stats);
+
+    pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
+    *stats = rp_ctx->thread_stats;
+    stats->thread_count = rp_ctx->thread_count;
+    stats->active_threads = rp_ctx->active_threads;
+    pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
+
+    return SR_ERR_OK;
+}
+
+int
+rp_session_start(rp_ctx_t *rp_ctx, const uint32_t session_id, const ac_ucred_t *user_credentials,
         const sr_datastore_t datastore, const uint32_t session_options, const uint32_t commit_id, rp_session_t **session_p)
 {
     rp_session_t *session = NULL;
@@ -4107,6 +5062,12 @@ rp_session_start(const rp_ctx_t *rp_ctx, const uint32_t session_id, const ac_ucr
         CHECK_RC_LOG_GOTO(rc, cleanup, "List of state xpath initialization failed for session id=%"PRIu32".", session_id);
     }
 
+    rc = sr_cbuff_init(RP_SESSION_QUEUE_INIT_SIZE, sizeof(Sr__Msg*), &session->msg_queue);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Message queue initialization failed for session id=%"PRIu32".", session_id);
+
+    rc = sr_cbuff_init(RP_SESSION_QUEUE_INIT_SIZE, sizeof(Sr__Msg*), &session->held_queue);
+    CHECK_RC_LOG_GOTO(rc, cleanup, "Held requests queue initialization failed for session id=%"PRIu32".", session_id);
+
     if (session_id != 0) {
         /* not for internal sessions */
         rc = ac_session_init(rp_ctx->ac_ctx, user_credentials, &session->ac_session);
@@ -4116,6 +5077,14 @@ rp_session_start(const rp_ctx_t *rp_ctx, const uint32_t session_id, const ac_ucr
     rc = dm_session_start(rp_ctx->dm_ctx, user_credentials, datastore, &session->dm_session);
     CHECK_RC_LOG_GOTO(rc, cleanup, "Init of dm_session failed for session id=%"PRIu32".", session_id);
 
+    if (session_id != 0) {
+        /* published in sysrepo-monitoring */
+        pthread_mutex_lock(&rp_ctx->sessions_mutex);
+        rc = sr_list_add(rp_ctx->sessions, session);
+        pthread_mutex_unlock(&rp_ctx->sessions_mutex);
+        CHECK_RC_LOG_GOTO(rc, cleanup, "Unable to register session id=%"PRIu32".", session_id);
+    }
+
     *session_p = session;
 
     return rc;
@@ -4126,7 +5095,7 @@ cleanup:
 }
 
 int
-rp_session_stop(const rp_ctx_t *rp_ctx, rp_session_t *session)
+rp_session_stop(rp_ctx_t *rp_ctx, rp_session_t *session)
 {
     CHECK_NULL_ARG2(rp_ctx, session);
 
@@ -4151,11 +5120,26 @@ rp_session_stop(const rp_ctx_t *rp_ctx, rp_session_t *session)
     return SR_ERR_OK;
 }
 
+int
+rp_get_session_stats(rp_session_t *session, rp_session_stats_t *stats)
+{
+    CHECK_NULL_ARG2(session, stats);
+
+    pthread_mutex_lock(&session->msg_count_mutex);
+    *stats = session->msg_stats;
+    pthread_mutex_unlock(&session->msg_count_mutex);
+    stats->id = session->id;
+
+    return SR_ERR_OK;
+}
+
 int
 rp_msg_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
 {
     rp_request_t req = { 0 };
     struct timespec now = { 0 };
+    size_t active = 0, queued = 0, thread_count = 0;
+    bool schedule = true;
     int rc = SR_ERR_OK;
 
     CHECK_NULL_ARG_NORET2(rc, rp_ctx, msg);
@@ -4168,22 +5152,50 @@ rp_msg_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
     }
 
     if (NULL != session) {
+        /* append the message to the session's queue, put the session into the ready-list
+         * only if it is not already there or being processed by some thread */
         pthread_mutex_lock(&session->msg_count_mutex);
-        session->msg_count += 1;
+        rc = sr_cbuff_enqueue(session->msg_queue, &msg);
+        if (SR_ERR_OK == rc) {
+            session->msg_count += 1;
+            session->msg_stats.queued = sr_cbuff_items_in_queue(session->msg_queue);
+            if (session->msg_stats.queued > session->msg_stats.max_queued) {
+                session->msg_stats.max_queued = session->msg_stats.queued;
+            }
+            schedule = !session->msg_scheduled;
+            session->msg_scheduled = true;
+        }
         pthread_mutex_unlock(&session->msg_count_mutex);
+        if (SR_ERR_OK != rc) {
+            SR_LOG_ERR("Unable to enqueue the message into the queue of session id=%"PRIu32".", session->id);
+            sr_msg_free(msg);
+            return rc;
+        }
+        req.session = session;
+    } else {
+        req.msg = msg;
     }
 
-    req.session = session;
-    req.msg = msg;
-
-    pthread_mutex_lock(&rp_ctx->request_queue_mutex);
+    if (!schedule) {
+        /* the message will be processed after the preceding messages of the session */
+        return SR_ERR_OK;
+    }
 
-    /* enqueue the request into buffer */
-    rc = sr_cbuff_enqueue(rp_ctx->request_queue, &req);
+    /* enqueue the request, spilled into the overflow queue if the lock-free queue is full */
+    rc = rp_request_enqueue(rp_ctx, &req);
+    if (SR_ERR_OK != rc && NULL != session) {
+        /* the message stays in the session's queue, it will be processed with the next message of the session */
+        pthread_mutex_lock(&session->msg_count_mutex);
+        session->msg_scheduled = false;
+        pthread_mutex_unlock(&session->msg_count_mutex);
+        return rc;
+    }
+    active = atomic_load(&rp_ctx->active_threads);
 
-    if (0 == rp_ctx->active_threads) {
+    if (0 == active) {
         /* there is no active (non-sleeping) thread - if this is happening too
          * frequently, instruct the threads to spin before going to sleep */
+        pthread_mutex_lock(&rp_ctx->thread_pool_mutex);
         sr_clock_get_time(CLOCK_MONOTONIC, &now);
         uint64_t diff = (1000000000L * (now.tv_sec - rp_ctx->last_thread_wakeup.tv_sec)) + now.tv_nsec - rp_ctx->last_thread_wakeup.tv_nsec;
         if (diff < RP_THREAD_SPIN_TIMEOUT) {
@@ -4200,28 +5212,22 @@ rp_msg_process(rp_ctx_t *rp_ctx, rp_session_t *session, Sr__Msg *msg)
             rp_ctx->thread_spin_limit = 0;
         }
         rp_ctx->last_thread_wakeup = now;
+        pthread_mutex_unlock(&rp_ctx->thread_pool_mutex);
     }
 
-    SR_LOG_DBG("Threads: active=%zu/%d, %zu requests in queue", rp_ctx->active_threads, RP_THREAD_COUNT,
-            sr_cbuff_items_in_queue(rp_ctx->request_queue));
+    queued = rp_request_queue_depth(rp_ctx);
+    thread_count = atomic_load(&rp_ctx->thread_count);
+
+    SR_LOG_DBG("Threads: active=%zu/%zu, %zu requests in queue", active, thread_count, queued);
 
     /* send signal if there is no active thread ready to process the request */
-    if (0 == rp_ctx->active_threads ||
-            (((sr_cbuff_items_in_queue(rp_ctx->request_queue) / rp_ctx->active_threads) > RP_REQ_PER_THREADS) &&
-             rp_ctx->active_threads < RP_THREAD_COUNT)) {
-        pthread_cond_signal(&rp_ctx->request_queue_cv);
+    if (SR_ERR_OK == rc && (0 == active || (((queued / active) > RP_REQ_PER_THREADS) && active < thread_count))) {
+        sr_mpmc_queue_notify(rp_ctx->request_queue, false);
     }
 
-    pthread_mutex_unlock(&rp_ctx->request_queue_mutex);
-
     if (SR_ERR_OK != rc) {
         /* release the message by error */
         SR_LOG_ERR_MSG("Unable to process the message, skipping.");
-        if (NULL != session) {
-            pthread_mutex_lock(&session->msg_count_mutex);
-            session->msg_count -= 1;
-            pthread_mutex_unlock(&session->msg_count_mutex);
-        }
         sr_msg_free(msg);
     }
 
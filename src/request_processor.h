@@ -54,6 +54,27 @@ typedef struct rp_ctx_s rp_ctx_t;
  */
 typedef struct rp_session_s rp_session_t;
 
+/**
+ * @brief Statistics of the Request Processor's thread pool.
+ */
+typedef struct rp_thread_pool_stats_s {
+    size_t thread_count;       /**< Number of currently running worker threads. */
+    size_t active_threads;     /**< Number of currently active (non-sleeping) worker threads. */
+    uint64_t grow_cnt;         /**< How many times the pool has grown due to the request queue depth. */
+    uint64_t shrink_cnt;       /**< How many times the pool has shrunk due to idle worker threads. */
+    uint64_t ceiling_hit_cnt;  /**< How many times the pool needed to grow, but it has already reached its maximum size. */
+} rp_thread_pool_stats_t;
+
+/**
+ * @brief Statistics of the message queue of a Request Processor's session.
+ */
+typedef struct rp_session_stats_s {
+    uint32_t id;               /**< Identifier of the session. */
+    size_t queued;             /**< Number of messages currently waiting in the session's queue. */
+    size_t max_queued;         /**< Maximum depth of the session's queue since the session start. */
+    uint64_t processed_cnt;    /**< Number of messages of the session processed so far. */
+} rp_session_stats_t;
+
 /**
  * @brief Initializes a Request Processor instance.
  *
@@ -77,6 +98,31 @@ int rp_init(cm_ctx_t *cm_ctx, rp_ctx_t **rp_ctx);
  */
 void rp_cleanup(rp_ctx_t *rp_ctx);
 
+/**
+ * @brief Sets the limits of the Request Processor's thread pool.
+ *
+ * The pool is filled up to the minimum immediately; between the limits it grows
+ * and shrinks automatically depending on the depth of the request queue.
+ * Worker threads above the new maximum exit as soon as they become idle.
+ *
+ * @param[in] rp_ctx Request Processor context.
+ * @param[in] min_threads Minimum number of worker threads (at least 1).
+ * @param[in] max_threads Maximum number of worker threads (at least min_threads).
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int rp_set_thread_limits(rp_ctx_t *rp_ctx, size_t min_threads, size_t max_threads);
+
+/**
+ * @brief Retrieves the statistics of the Request Processor's thread pool.
+ *
+ * @param[in] rp_ctx Request Processor context.
+ * @param[out] stats Thread pool statistics.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int rp_get_thread_pool_stats(rp_ctx_t *rp_ctx, rp_thread_pool_stats_t *stats);
+
 /**
  * Starts a new Request Processor session.
  *
@@ -93,7 +139,7 @@ void rp_cleanup(rp_ctx_t *rp_ctx);
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int rp_session_start(const rp_ctx_t *rp_ctx, const uint32_t session_id, const ac_ucred_t *user_credentials,
+int rp_session_start(rp_ctx_t *rp_ctx, const uint32_t session_id, const ac_ucred_t *user_credentials,
         const sr_datastore_t datastore, const uint32_t session_options, const uint32_t commit_id, rp_session_t **session);
 
 /**
@@ -106,11 +152,25 @@ int rp_session_start(const rp_ctx_t *rp_ctx, const uint32_t session_id, const ac
  *
  * @return Error code (SR_ERR_OK on success).
  */
-int rp_session_stop(const rp_ctx_t *rp_ctx, rp_session_t *session);
+int rp_session_stop(rp_ctx_t *rp_ctx, rp_session_t *session);
+
+/**
+ * @brief Retrieves the statistics of the message queue of a Request Processor session. The statistics
+ * of all client sessions are provided in the sessions container of the sysrepo-monitoring module.
+ *
+ * @param[in] session Request Processor session context.
+ * @param[out] stats Session's message queue statistics.
+ *
+ * @return Error code (SR_ERR_OK on success).
+ */
+int rp_get_session_stats(rp_session_t *session, rp_session_stats_t *stats);
 
 /**
  * @brief Pass the message for processing in Request Processor.
  *
+ * Messages of one session are processed strictly in the order in which they
+ * were passed, messages of different sessions are processed in parallel.
+ *
  * @param[in] rp_ctx Request Processor context.
  * @param[in] session Request Processor session context related to the message.
  * @param[in] msg GPB Message to be passed. @note Message will be freed.
@@ -187,6 +187,7 @@ rp_dt_delete_item(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, co
     struct ly_set *parents = NULL;
     char *module_name = NULL;
     int ret = 0;
+    bool unconstrained = true;
 
     rc = sr_copy_first_ns(xpath, &module_name);
     CHECK_RC_LOG_RETURN(rc, "Copying module name failed for xpath '%s'", xpath);
@@ -251,6 +252,7 @@ rp_dt_delete_item(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, co
 
     /* unlink nodes and save their parents */
     for (size_t i = 0; i < nodes->number; i++) {
+        unconstrained = unconstrained && dm_is_change_unconstrained(info->schema, nodes->set.d[i]->schema);
         if (NULL != nodes->set.d[i]->parent) {
             ly_set_add(parents, nodes->set.d[i]->parent, 0);
         }
@@ -290,6 +292,7 @@ rp_dt_delete_item(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, co
                 ((LYS_LIST & node->schema->nodetype) ||
                  ((LYS_CONTAINER & node->schema->nodetype) && NULL == ((struct lys_node_container *)schema)->presence))) {
                 /* list or non-presence container with no children */
+                unconstrained = false;
                 parent = node->parent;
                 sr_lyd_unlink(info, node);
                 lyd_free(node);
@@ -304,7 +307,7 @@ cleanup:
     ly_set_free(nodes);
     /* mark to session copy that some change has been made */
     if (SR_ERR_OK == rc && !is_state) {
-        info->modified = true;
+        dm_data_info_set_modified(info, unconstrained);
     }
     return rc;
 }
@@ -452,7 +455,9 @@ cleanup:
     free(new_value);
     if (NULL != info) {
         if (SR_ERR_OK == rc && !is_state) {
-            info->modified = true;
+            /* only the leaf itself may have been created or updated */
+            dm_data_info_set_modified(info, (NULL == node || node->schema == sch_node) &&
+                    dm_is_change_unconstrained(info->schema, sch_node));
         }
     }
     return rc;
@@ -543,7 +548,9 @@ rp_dt_move_list(dm_ctx_t *dm_ctx, dm_session_t *session, const char *xpath, sr_m
     CHECK_RC_MSG_GOTO(rc, cleanup, "Moving of the node failed");
 
 cleanup:
-    info->modified = SR_ERR_OK == rc ? true : info->modified;
+    if (SR_ERR_OK == rc) {
+        dm_data_info_set_modified(info, false);
+    }
     return rc;
 }
 
@@ -803,6 +810,53 @@ rp_dt_reload_nacm(rp_ctx_t *rp_ctx)
     return rc;
 }
 
+/**
+ * @brief Applies the changes made in the session once more on the data trees of the modules committed with subtree
+ * scope whose data files have been written by other processes since they were loaded, and validates the result.
+ * The changes written by the other processes lie in other subtrees, so the changes of this commit (and the notifications
+ * already sent about them) stay the same.
+ */
+static int
+rp_dt_commit_rebase(rp_ctx_t *rp_ctx, rp_session_t *session, dm_commit_context_t *c_ctx, sr_error_info_t **errors,
+        size_t *err_cnt)
+{
+    sr_list_t *models_to_skip = NULL;
+    int rc = SR_ERR_OK;
+
+    rc = dm_commit_reload_stale_models(rp_ctx->dm_ctx, session->dm_session, c_ctx, &models_to_skip);
+    CHECK_RC_MSG_RETURN(rc, "Reloading of the models written by other processes failed");
+    if (NULL == models_to_skip) {
+        return SR_ERR_OK;
+    }
+
+    rc = rp_dt_replay_operations(rp_ctx->dm_ctx, c_ctx->session, c_ctx->operations, c_ctx->oper_count, false,
+            models_to_skip);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "Replay of operations failed");
+
+    rc = dm_validate_session_data_trees(rp_ctx->dm_ctx, c_ctx->session, errors, err_cnt);
+    if (SR_ERR_OK != rc) {
+        SR_LOG_ERR_MSG("Validation after merging with the changes of other processes failed");
+        rc = SR_ERR_VALIDATION_FAILED;
+    }
+
+cleanup:
+    sr_list_cleanup(models_to_skip);
+    return rc;
+}
+
+int
+rp_dt_commit_sync_wait(rp_session_t *session)
+{
+    CHECK_NULL_ARG(session);
+    int rc = SR_ERR_OK;
+
+    if (NULL != session->commit_sync) {
+        rc = dm_commit_sync_wait(session->commit_sync);
+        session->commit_sync = NULL;
+    }
+    return rc;
+}
+
 int
 rp_dt_commit(rp_ctx_t *rp_ctx, rp_session_t *session, dm_commit_context_t **c_ctx, bool copy_config,
         sr_error_info_t **errors, size_t *err_cnt)
@@ -915,12 +969,38 @@ rp_dt_commit(rp_ctx_t *rp_ctx, rp_session_t *session, dm_commit_context_t **c_ct
             return SR_ERR_OK;
         case DM_COMMIT_WRITE:
             rc = dm_commit_writelock_fds(session->dm_session, commit_ctx);
+            if (SR_ERR_OK == rc) {
+                rc = rp_dt_commit_rebase(rp_ctx, session, commit_ctx, errors, err_cnt);
+                if (SR_ERR_OK != rc) {
+                    /* the verifiers have already been notified */
+                    sr_free_errors(commit_ctx->errors, commit_ctx->err_cnt);
+                    commit_ctx->errors = *errors;
+                    commit_ctx->err_cnt = *err_cnt;
+                    *errors = NULL;
+                    *err_cnt = 0;
+                    commit_ctx->result = rc;
+                    state = DM_COMMIT_NOTIFY_ABORT;
+                    break;
+                }
+            }
             if (SR_ERR_OK == rc ) {
                 rc = dm_commit_write_files(session->dm_session, commit_ctx);
                 if (SR_ERR_OK == rc) {
                     SR_LOG_DBG_MSG("Commit (8/10): data write succeeded");
                 }
             }
+            if (NULL != commit_ctx->sync_batch) {
+                if (copy_config || SR_GROUP_COMMIT_DELAY < 0) {
+                    /* flush right away */
+                    int sync_rc = dm_commit_sync_wait(commit_ctx->sync_batch);
+                    rc = (SR_ERR_OK == rc) ? sync_rc : rc;
+                } else {
+                    /* the commit request is replied once the batch is flushed, after the commit lock is released */
+                    rp_dt_commit_sync_wait(session);
+                    session->commit_sync = commit_ctx->sync_batch;
+                }
+                commit_ctx->sync_batch = NULL;
+            }
             if (SR_ERR_OK == rc && commit_ctx->nacm_edited) {
                 /* request to reload NACM configuration if it was edited */
                 rc = dm_get_nacm_ctx(rp_ctx->dm_ctx, &nacm_ctx);
@@ -1122,7 +1202,7 @@ rp_dt_copy_config_to_running(rp_ctx_t *rp_ctx, rp_session_t *session, const char
         /* load data tree if it was not copied from backup session */
         rc = dm_get_data_info(rp_ctx->dm_ctx, session->dm_session, module_name, &info);
         CHECK_RC_MSG_GOTO(rc, cleanup3, "Get data info failed");
-        info->modified = true;
+        dm_data_info_set_modified(info, false);
     } else {
         /* load all enabled models */
         rc = dm_get_all_modules(rp_ctx->dm_ctx, session->dm_session, true, &modules);
@@ -1131,7 +1211,7 @@ rp_dt_copy_config_to_running(rp_ctx_t *rp_ctx, rp_session_t *session, const char
             char *module = modules->data[i];
             rc = dm_get_data_info(rp_ctx->dm_ctx, session->dm_session, module, &info);
             CHECK_RC_LOG_GOTO(rc, cleanup3, "Get data info failed %s", module);
-            info->modified = true;
+            dm_data_info_set_modified(info, false);
         }
     }
 
@@ -1292,3 +1372,30 @@ cleanup:
     sr_free_schemas(schemas, count);
     return rc;
 }
+
+int
+rp_dt_lock_subtree(const rp_ctx_t *rp_ctx, const rp_session_t *session, const char *xpath)
+{
+    CHECK_NULL_ARG3(rp_ctx, session, xpath);
+    int rc = SR_ERR_OK;
+    char *module_name = NULL;
+    bool modif = false;
+
+    SR_LOG_INF("Lock request subtree: '%s', datastore %s", xpath, sr_ds_to_str(session->datastore));
+
+    rc = sr_copy_first_ns(xpath, &module_name);
+    CHECK_RC_LOG_RETURN(rc, "Module name of xpath %s can not be determined", xpath);
+
+    rc = dm_is_model_modified(rp_ctx->dm_ctx, session->dm_session, module_name, &modif);
+    CHECK_RC_MSG_GOTO(rc, cleanup, "is model modified failed");
+    if (modif) {
+        SR_LOG_ERR("Modified model %s can not be locked", module_name);
+        rc = dm_report_error(session->dm_session, "Module has been modified, it can not be locked. Discard or commit changes", xpath, SR_ERR_OPERATION_FAILED);
+        goto cleanup;
+    }
+    rc = dm_lock_subtree(rp_ctx->dm_ctx, session->dm_session, xpath);
+
+cleanup:
+    free(module_name);
+    return rc;
+}
@@ -116,6 +116,9 @@ int rp_dt_delete_item_wrapper(rp_ctx_t *rp_ctx, rp_session_t *session, const cha
  * - validate commit_session's data trees because the merge of the session changes
  * may cause invalidity
  * - write commit session's data trees to the file system
+ *
+ * Unless copy_config is set or group commit is disabled (::SR_GROUP_COMMIT_DELAY), the written files
+ * are not flushed to the disk yet. The commit is durable once ::rp_dt_commit_sync_wait succeeds.
  * @param [in] rp_ctx
  * @param [in] session
  * @param [in] c_ctx - if argument is not NULL it is used as context to continue commit process
@@ -127,6 +130,14 @@ int rp_dt_delete_item_wrapper(rp_ctx_t *rp_ctx, rp_session_t *session, const cha
 int rp_dt_commit(rp_ctx_t *rp_ctx, rp_session_t *session, dm_commit_context_t **c_ctx, bool copy_config,
         sr_error_info_t **errors, size_t *err_cnt);
 
+/**
+ * @brief Waits until the files written by the last commit of the session are flushed to the disk.
+ * Should be called without the commit lock held so that the flush can be shared with concurrent commits.
+ * @param [in] session
+ * @return Error code (SR_ERR_OK on success), SR_ERR_IO if the flush failed.
+ */
+int rp_dt_commit_sync_wait(rp_session_t *session);
+
 /**
  * @brief Tries to merge the current state of session with the file system change.
  * Changes that can not be merged with current data store state are skipped and
@@ -171,6 +182,16 @@ void rp_dt_switch_datastore(rp_ctx_t *rp_ctx, rp_session_t *session, sr_datastor
  * @return Error code (SR_ERR_OK on success)
  */
 int rp_dt_lock(const rp_ctx_t *rp_ctx, const rp_session_t *session, const char *module_name);
+
+/**
+ * @brief Locks a subtree of a model (see ::dm_lock_subtree). Lock can not be acquired if the session
+ * copy of the model has been modified.
+ * @param [in] rp_ctx
+ * @param [in] session
+ * @param [in] xpath xpath of the subtree root
+ * @return Error code (SR_ERR_OK on success)
+ */
+int rp_dt_lock_subtree(const rp_ctx_t *rp_ctx, const rp_session_t *session, const char *xpath);
 #endif /* RP_DT_EDIT_H */
 
 /**
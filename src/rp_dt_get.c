@@ -1202,7 +1202,7 @@ rp_dt_prepare_data(rp_ctx_t *rp_ctx, rp_session_t *rp_session, const char *xpath
         rc = ac_check_node_permissions(rp_session->ac_session, xpath, AC_OPER_READ);
         CHECK_RC_LOG_GOTO(rc, cleanup, "Access control check failed for xpath '%s'", xpath);
 
-        rc = dm_get_data_info(rp_ctx->dm_ctx, rp_session->dm_session, rp_session->module_name, &data_info);
+        rc = dm_get_data_info_rdonly(rp_ctx->dm_ctx, rp_session->dm_session, rp_session->module_name, &data_info);
 
         /* check of data tree's emptiness is performed outside of this function -> ignore SR_ERR_NOT_FOUND */
         rc = SR_ERR_NOT_FOUND == rc ? SR_ERR_OK : rc;
@@ -1352,7 +1352,8 @@ rp_dt_get_values_wrapper_with_opts(rp_ctx_t *rp_ctx, rp_session_t *rp_session, r
     struct ly_set *nodes = NULL;
 
     if (get_items_ctx->xpath != NULL && 0 == strcmp(xpath, get_items_ctx->xpath) &&
-            offset == get_items_ctx->offset) {
+            offset == get_items_ctx->offset &&
+            get_items_ctx->trees_generation == dm_get_session_trees_generation(rp_session->dm_session)) {
         /* cache hit do not load data from data providers */
         rp_session->state = RP_REQ_DATA_LOADED;
     }
@@ -113,7 +113,8 @@ rp_dt_find_nodes_with_opts(dm_ctx_t *dm_ctx, rp_session_t *rp_session, rp_dt_get
     SR_LOG_DBG("Get_nodes opts with args: %s %zu %zu", xpath, limit, offset);
     /* check if we continue where we left */
     if (get_items_ctx->xpath == NULL || 0 != strcmp(xpath, get_items_ctx->xpath) ||
-            offset != get_items_ctx->offset) {
+            offset != get_items_ctx->offset ||
+            get_items_ctx->trees_generation != dm_get_session_trees_generation(rp_session->dm_session)) {
         ly_set_free(get_items_ctx->nodes);
         get_items_ctx->nodes = NULL;
         rc = rp_dt_find_nodes(dm_ctx, data_tree, xpath, dm_is_running_ds_session(rp_session->dm_session),
@@ -135,6 +136,7 @@ rp_dt_find_nodes_with_opts(dm_ctx_t *dm_ctx, rp_session_t *rp_session, rp_dt_get
             return SR_ERR_INTERNAL;
         }
         get_items_ctx->offset = offset;
+        get_items_ctx->trees_generation = dm_get_session_trees_generation(rp_session->dm_session);
 
         /* filter nodes by read access */
         rc = rp_dt_nacm_filtering(dm_ctx, rp_session, data_tree, get_items_ctx->nodes->set.d,
@@ -22,13 +22,31 @@
 #ifndef RP_INTERNAL_H_
 #define RP_INTERNAL_H_
 
+#include <stdatomic.h>
+
 #include "connection_manager.h"
+#include "request_processor.h"
 #include "access_control.h"
 #include "data_manager.h"
 #include "notification_processor.h"
 #include "persistence_manager.h"
 
-#define RP_THREAD_COUNT 4  /**< Number of threads that RP uses for processing. */
+/**
+ * @brief State of a slot in the Request Processor's thread pool.
+ */
+typedef enum rp_thread_state_e {
+    RP_THREAD_FREE = 0,   /**< The slot is not used by any thread. */
+    RP_THREAD_RUNNING,    /**< The thread occupying the slot is running. */
+    RP_THREAD_EXITED,     /**< The thread occupying the slot has exited and has not been joined yet. */
+} rp_thread_state_t;
+
+/**
+ * @brief Slot in the Request Processor's thread pool.
+ */
+typedef struct rp_thread_slot_s {
+    pthread_t thread_id;      /**< ID of the thread occupying the slot. */
+    rp_thread_state_t state;  /**< State of the slot. */
+} rp_thread_slot_t;
 
 /**
  * @brief Structure that holds the context of an instance of Request Processor.
@@ -40,17 +58,28 @@ typedef struct rp_ctx_s {
     np_ctx_t *np_ctx;                        /**< Notification Processor context. */
     pm_ctx_t *pm_ctx;                        /**< Persistence Manager context. */
 
-    pthread_t thread_pool[RP_THREAD_COUNT];  /**< Thread pool. */
-    size_t active_threads;                   /**< Number of active (non-sleeping) threads. */
+    rp_thread_slot_t *thread_pool;           /**< Thread pool (array of thread_pool_size slots). */
+    size_t thread_pool_size;                 /**< Number of allocated slots in the thread pool. */
+    size_t thread_min;                       /**< Minimum number of threads in the pool. */
+    size_t thread_max;                       /**< Maximum number of threads in the pool. */
+    atomic_size_t thread_count;              /**< Number of running threads (modified with thread_pool_mutex locked). */
+    rp_thread_pool_stats_t thread_stats;     /**< Thread pool statistics (grow / shrink / ceiling hit counters). */
+    atomic_size_t active_threads;            /**< Number of active (non-sleeping) threads. */
     struct timespec last_thread_wakeup;      /**< Timestamp of the last thread wake-up event. */
-    size_t thread_spin_limit;                /**< Current limit of thread spinning before going to sleep. */
+    atomic_size_t thread_spin_limit;         /**< Current limit of thread spinning before going to sleep. */
     bool stop_requested;                     /**< Stopping of all threads has been requested. */
+    pthread_mutex_t thread_pool_mutex;       /**< Mutex guarding the thread pool (not taken on the request processing path). */
 
     volatile bool block_further_commits;     /**< Flag that allows commit to be processed */
 
-    sr_cbuff_t *request_queue;               /**< Input request queue. */
-    pthread_mutex_t request_queue_mutex;     /**< Request queue mutex. */
-    pthread_cond_t request_queue_cv;         /**< Request queue condition variable. */
+    sr_mpmc_queue_t *request_queue;          /**< Ready-list of sessions with pending messages and session-less
+                                              *   messages (lock-free). */
+    sr_cbuff_t *overflow_queue;              /**< Requests that did not fit into the full request_queue (grows when needed). */
+    pthread_mutex_t overflow_mutex;          /**< Mutex guarding overflow_queue. */
+    atomic_size_t overflow_cnt;              /**< Number of requests in overflow_queue (can be read without the mutex). */
+
+    sr_list_t *sessions;                     /**< Running client sessions (::rp_session_t), internal sessions are not included. */
+    pthread_mutex_t sessions_mutex;          /**< Mutex guarding sessions. */
 
     sr_list_t *modules_incl_intern_op_data;  /**< List of modules that contains state data that is handled internally in sysrepo
                                               *   and requests are not send to a subscriber */
@@ -71,6 +100,8 @@ typedef struct rp_dt_get_items_ctx {
     char *xpath;            /**< xpath of the request*/
     size_t offset;          /**< index of the node to be processed */
     struct ly_set *nodes;   /**< nodes to be iterated through */
+    uint32_t trees_generation; /**< generation of the session data trees the nodes belong to
+                                * (see ::dm_get_session_trees_generation) */
 } rp_dt_get_items_ctx_t;
 
 /**
@@ -120,7 +151,12 @@ typedef struct rp_session_s {
     uint32_t options;                    /**< Session options used to override default session behavior. */
     uint32_t commit_id;                  /**< Commit ID in case that this is a notification session or session is about to resume commit processing. */
     uint32_t msg_count;                  /**< Count of unprocessed messages (including waiting in queue). */
-    pthread_mutex_t msg_count_mutex;     /**< Mutex for msg_count counter. */
+    pthread_mutex_t msg_count_mutex;     /**< Mutex for msg_count counter, msg_queue and msg_scheduled flag. */
+    sr_cbuff_t *msg_queue;               /**< Queue of the messages waiting for processing within this session. */
+    bool msg_scheduled;                  /**< The session is in the ready-list or its message is being processed. */
+    Sr__Msg *paused_req;                 /**< Request whose processing has been paused (waiting for data or verifiers), NULL if none. */
+    sr_cbuff_t *held_queue;              /**< Requests received while paused_req is set, processed once it is finished. */
+    rp_session_stats_t msg_stats;        /**< Statistics of the session's message queue. */
     bool stop_requested;                 /**< Session stop has been requested. */
     ac_session_t *ac_session;            /**< Access Control module's session context. */
     dm_session_t *dm_session;            /**< Data Manager's session context. */
@@ -139,6 +175,10 @@ typedef struct rp_session_s {
     pthread_mutex_t cur_req_mutex;       /**< mutex guarding information about currently processed request */
     sr_list_t **loaded_state_data;       /**< List of xpath for loaded state data in datastore */
     rp_state_data_ctx_t state_data_ctx;  /**< Context used during state data loading */
+
+    /* group commit */
+    dm_sync_batch_t *commit_sync;        /**< flush the last commit of the session waits for, NULL if none */
+    Sr__Msg *commit_resp;                /**< commit response to be sent once commit_sync is flushed */
 } rp_session_t;
 
 #endif /* RP_INTERNAL_H_ */
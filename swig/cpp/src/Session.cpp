@@ -363,6 +363,22 @@ void Session::unlock_module(const char *module_name)
     }
 }
 
+void Session::lock_subtree(const char *xpath)
+{
+    int ret = sr_lock_subtree(_sess, xpath);
+    if (ret != SR_ERR_OK) {
+        throw_exception(ret);
+    }
+}
+
+void Session::unlock_subtree(const char *xpath)
+{
+    int ret = sr_unlock_subtree(_sess, xpath);
+    if (ret != SR_ERR_OK) {
+        throw_exception(ret);
+    }
+}
+
 void Session::discard_changes()
 {
     int ret = sr_discard_changes(_sess);
@@ -114,6 +114,10 @@ public:
     void lock_module(const char *module_name);
     /** Wrapper for [sr_unlock_module](@ref sr_unlock_module) */
     void unlock_module(const char *module_name);
+    /** Wrapper for [sr_lock_subtree](@ref sr_lock_subtree) */
+    void lock_subtree(const char *xpath);
+    /** Wrapper for [sr_unlock_subtree](@ref sr_unlock_subtree) */
+    void unlock_subtree(const char *xpath);
     /** Wrapper for [sr_discard_changes](@ref sr_discard_changes) */
     void discard_changes();
     /** Wrapper for [sr_copy_config](@ref sr_copy_config) */
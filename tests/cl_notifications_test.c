@@ -26,6 +26,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <string.h>
+#include <errno.h>
 #include <pthread.h>
 
 #include "sysrepo.h"
@@ -241,6 +242,69 @@ cl_get_changes_create_test(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+static void
+cl_get_changes_inline_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    sr_subscription_ctx_t *subscription = NULL;
+    changes_t changes = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cv = PTHREAD_COND_INITIALIZER, 0};
+    struct timespec ts;
+    const char *xpath = NULL;
+    int rc = SR_ERR_OK;
+    xpath = "/example-module:container/list[key1='abc'][key2='def']";
+
+    /* start session */
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* the changes are delivered with the notifications */
+    rc = sr_module_change_subscribe(session, "example-module", list_changes_cb, &changes,
+            0, SR_SUBSCR_INLINE_CHANGES, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_set_item(session, xpath, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    pthread_mutex_lock(&changes.mutex);
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    sr_clock_get_time(CLOCK_REALTIME, &ts);
+    ts.tv_sec += COND_WAIT_SEC;
+    pthread_cond_timedwait(&changes.cv, &changes.mutex, &ts);
+
+    assert_int_equal(changes.events_received, VERIFY_CALLED | APPLY_CALLED);
+    assert_int_equal(changes.cnt, 3);
+    assert_int_equal(changes.oper[0], SR_OP_CREATED);
+    assert_non_null(changes.new_values[0]);
+    assert_null(changes.old_values[0]);
+    assert_string_equal(xpath, changes.new_values[0]->xpath);
+    assert_string_equal("/example-module:container/list[key1='abc'][key2='def']/key1", changes.new_values[1]->xpath);
+    assert_string_equal("/example-module:container/list[key1='abc'][key2='def']/key2", changes.new_values[2]->xpath);
+
+    for (size_t i = 0; i < changes.cnt; i++) {
+        sr_free_val(changes.new_values[i]);
+        sr_free_val(changes.old_values[i]);
+    }
+    pthread_mutex_unlock(&changes.mutex);
+
+    pthread_mutex_destroy(&changes.mutex);
+    pthread_cond_destroy(&changes.cv);
+
+    rc = sr_unsubscribe(NULL, subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_delete_item(session, "/example-module:container", SR_EDIT_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 static void
 cl_get_changes_modified_test(void **state)
 {
@@ -1926,6 +1990,108 @@ cl_no_abort_notifications(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+typedef struct slow_verifier_s {
+    pthread_mutex_t mutex;
+    pthread_cond_t cv;
+    bool released;
+    int events_received;
+} slow_verifier_t;
+
+static int
+slow_verifier_cb(sr_session_ctx_t *session, const char *module_name, sr_notif_event_t ev, void *private_ctx)
+{
+    slow_verifier_t *verifier = (slow_verifier_t *) private_ctx;
+    struct timespec ts;
+
+    pthread_mutex_lock(&verifier->mutex);
+    verifier->events_received |= (SR_EV_VERIFY == ev) ? VERIFY_CALLED : (SR_EV_ABORT == ev ? ABORT_CALLED : APPLY_CALLED);
+    if (SR_EV_VERIFY == ev) {
+        /* hold the verification until the test releases it, the guard exceeds the commit verify timeout */
+        sr_clock_get_time(CLOCK_REALTIME, &ts);
+        ts.tv_sec += 2 * SR_COMMIT_VERIFY_TIMEOUT;
+        while (!verifier->released) {
+            if (ETIMEDOUT == pthread_cond_timedwait(&verifier->cv, &verifier->mutex, &ts)) {
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&verifier->mutex);
+
+    return SR_ERR_OK;
+}
+
+static void
+cl_refused_with_slow_verifier(void **state)
+{
+    /* one verifier rejects the config, the other one is slow - the commit must not wait for the slow one */
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    sr_subscription_ctx_t *subscriptionA = NULL, *subscriptionB = NULL;
+    changes_t changes = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cv = PTHREAD_COND_INITIALIZER, 0};
+    slow_verifier_t slow = {.mutex = PTHREAD_MUTEX_INITIALIZER, .cv = PTHREAD_COND_INITIALIZER, 0};
+    struct timespec start = {0}, end = {0};
+    const char *xpath = "/example-module:container/list[key1='abc'][key2='def']";
+    int rc = SR_ERR_OK;
+
+    /* start session */
+    rc = sr_session_start(conn, SR_DS_CANDIDATE, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* the rejecting verifier has the higher priority so that it is notified before the slow one
+     * occupies the subscription thread */
+    rc = sr_module_change_subscribe(session, "example-module", list_changes_cb, &changes,
+            10, SR_SUBSCR_DEFAULT | SR_SUBSCR_NO_ABORT_FOR_REFUSED_CFG, &subscriptionA);
+    assert_int_equal(rc, SR_ERR_OK);
+    changes.verify_fails = true;
+
+    rc = sr_module_change_subscribe(session, "example-module", slow_verifier_cb, &slow,
+            0, SR_SUBSCR_DEFAULT, &subscriptionB);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* create the list instance */
+    rc = sr_set_item(session, xpath, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* the refused copy returns without waiting for the slow verifier */
+    sr_clock_get_time(CLOCK_MONOTONIC, &start);
+    rc = sr_copy_config(session, "example-module", SR_DS_CANDIDATE, SR_DS_RUNNING);
+    sr_clock_get_time(CLOCK_MONOTONIC, &end);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+    assert_true(end.tv_sec - start.tv_sec < SR_COMMIT_VERIFY_TIMEOUT);
+
+    const sr_error_info_t *err_info = NULL;
+    sr_get_last_error(session, &err_info);
+    assert_non_null(err_info->message);
+    assert_string_equal(err_info->message, "Detailed description of the error.");
+
+    /* release the slow verifier, its acknowledgment is late */
+    pthread_mutex_lock(&slow.mutex);
+    slow.released = true;
+    pthread_cond_signal(&slow.cv);
+    pthread_mutex_unlock(&slow.mutex);
+
+    assert_true(changes.events_received & VERIFY_CALLED);
+    assert_false(changes.events_received & APPLY_CALLED);
+    assert_int_equal(changes.cnt, 0);
+
+    rc = sr_unsubscribe(NULL, subscriptionA);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_unsubscribe(NULL, subscriptionB);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    pthread_mutex_destroy(&changes.mutex);
+    pthread_cond_destroy(&changes.cv);
+    pthread_mutex_destroy(&slow.mutex);
+    pthread_cond_destroy(&slow.cv);
+
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 static void
 cl_one_abort_notification(void **state)
 {
@@ -2880,6 +3046,7 @@ main()
 {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test_setup_teardown(cl_get_changes_create_test, sysrepo_setup, sysrepo_teardown),
+        cmocka_unit_test_setup_teardown(cl_get_changes_inline_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_modified_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_deleted_test, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_get_changes_moved_test, sysrepo_setup, sysrepo_teardown),
@@ -2896,6 +3063,7 @@ main()
         cmocka_unit_test_setup_teardown(cl_successful_verifiers, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_refused_by_verifier, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_no_abort_notifications, sysrepo_setup, sysrepo_teardown),
+        cmocka_unit_test_setup_teardown(cl_refused_with_slow_verifier, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_one_abort_notification, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_subtree_verifier, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_unsuccessfull_subscription, sysrepo_setup, sysrepo_teardown),
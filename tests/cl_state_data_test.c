@@ -2510,6 +2510,133 @@ cl_request_id(void **state)
     sr_session_stop(session);
 }
 
+typedef struct cl_async_result_s {
+    uint32_t tokens[8];
+    int results[8];
+    sr_val_t *values[8];
+    size_t cnt;
+} cl_async_result_t;
+
+static void
+cl_async_result_cb(sr_session_ctx_t *session, uint32_t token, int result, sr_val_t *value, void *private_ctx)
+{
+    cl_async_result_t *res = (cl_async_result_t *) private_ctx;
+
+    assert_true(res->cnt < sizeof(res->tokens) / sizeof(*res->tokens));
+    res->tokens[res->cnt] = token;
+    res->results[res->cnt] = result;
+    res->values[res->cnt] = value;
+    res->cnt++;
+}
+
+static void
+cl_pipelined_state_data_get(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    sr_subscription_ctx_t *subscription = NULL;
+    sr_list_t *xpath_retrieved = NULL;
+    cl_async_result_t res = { { 0, }, };
+    uint32_t tokens[5] = { 0, };
+    sr_val_t *value = NULL;
+    size_t completed = 0;
+    int rc = SR_ERR_OK;
+
+    rc = sr_list_init(&xpath_retrieved);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* start session */
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_module_change_subscribe(session, "state-module", cl_whole_module_cb, NULL,
+            0, SR_SUBSCR_DEFAULT, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* subscribe data provider */
+    rc = sr_dp_get_items_subscribe(session, "/state-module:cpu_load", cl_dp_cpu_load, xpath_retrieved, SR_SUBSCR_CTX_REUSE, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* pipeline requests that wait for the data provider with ones that do not */
+    rc = sr_set_item_async(session, "/state-module:cards/card[dn='pipelined']", NULL, SR_EDIT_DEFAULT,
+            cl_async_result_cb, &res, &tokens[0]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_item_async(session, "/state-module:cpu_load", cl_async_result_cb, &res, &tokens[1]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_item_async(session, "/state-module:cards/card[dn='pipelined']/dn", cl_async_result_cb, &res, &tokens[2]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_item_async(session, "/state-module:cpu_load", cl_async_result_cb, &res, &tokens[3]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_delete_item_async(session, "/state-module:cards/card[dn='pipelined']", SR_EDIT_DEFAULT,
+            cl_async_result_cb, &res, &tokens[4]);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_async_process(session, true, &completed);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(5, completed);
+    assert_int_equal(5, res.cnt);
+
+    /* each request got its own response, delivered in the order of the requests */
+    for (size_t i = 0; i < res.cnt; i++) {
+        assert_int_equal(tokens[i], res.tokens[i]);
+        assert_int_equal(SR_ERR_OK, res.results[i]);
+    }
+    assert_null(res.values[0]);
+    assert_null(res.values[4]);
+    assert_non_null(res.values[1]);
+    assert_string_equal("/state-module:cpu_load", res.values[1]->xpath);
+    assert_int_equal(SR_DECIMAL64_T, res.values[1]->type);
+    assert_non_null(res.values[2]);
+    assert_string_equal("/state-module:cards/card[dn='pipelined']/dn", res.values[2]->xpath);
+    assert_string_equal("pipelined", res.values[2]->data.string_val);
+    assert_non_null(res.values[3]);
+    assert_string_equal("/state-module:cpu_load", res.values[3]->xpath);
+    for (size_t i = 0; i < res.cnt; i++) {
+        sr_free_val(res.values[i]);
+    }
+    assert_int_equal(2, xpath_retrieved->count);
+
+    /* wait for the responses in the reverse order, the card has already been deleted by the pipelined request */
+    rc = sr_get_item_async(session, "/state-module:cpu_load", NULL, NULL, &tokens[0]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_item_async(session, "/state-module:cards/card[dn='pipelined']/dn", NULL, NULL, &tokens[1]);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_async_wait(session, tokens[1], &value);
+    assert_int_equal(rc, SR_ERR_NOT_FOUND);
+    assert_null(value);
+
+    rc = sr_async_wait(session, tokens[0], &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_non_null(value);
+    assert_string_equal("/state-module:cpu_load", value->xpath);
+    sr_free_val(value);
+    value = NULL;
+
+    /* a synchronous request in between outstanding asynchronous ones */
+    rc = sr_get_item_async(session, "/state-module:cpu_load", NULL, NULL, &tokens[0]);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_item(session, "/state-module:cpu_load", &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_string_equal("/state-module:cpu_load", value->xpath);
+    sr_free_val(value);
+    value = NULL;
+    rc = sr_async_wait(session, tokens[0], &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_string_equal("/state-module:cpu_load", value->xpath);
+    sr_free_val(value);
+
+    for (size_t i = 0; i < xpath_retrieved->count; i++) {
+        free(xpath_retrieved->data[i]);
+    }
+    sr_list_cleanup(xpath_retrieved);
+
+    /* cleanup */
+    sr_unsubscribe(session, subscription);
+    sr_session_stop(session);
+}
+
 static void
 cl_partial_covered_dp_subtree(void **state)
 {
@@ -3138,6 +3265,7 @@ main()
         cmocka_unit_test_setup_teardown(cl_nested_data_subscription2_tree, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_all_state_data, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_request_id, sysrepo_setup, sysrepo_teardown),
+        cmocka_unit_test_setup_teardown(cl_pipelined_state_data_get, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_partial_covered_dp_subtree, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_missing_list_dp, sysrepo_setup, sysrepo_teardown),
         cmocka_unit_test_setup_teardown(cl_subscribe_list_in_state_container_dp, sysrepo_setup, sysrepo_teardown),
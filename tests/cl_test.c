@@ -30,6 +30,7 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <semaphore.h>
+#include <sys/wait.h>
 
 #include "sr_constants.h"
 #include "sysrepo.h"
@@ -222,6 +223,83 @@ cl_multiconnect_test(void **state)
     sr_disconnect(conn2);
 }
 
+static void
+cl_module_change_wait_test(void **state)
+{
+    sr_conn_ctx_t *conn = NULL;
+    sr_session_ctx_t *session = NULL;
+    uint32_t change_seq = 0;
+    int pipe_fd[2] = { -1, -1 };
+    int status = 0;
+    char c = 0;
+    pid_t pid = 0;
+    int rc = SR_ERR_OK;
+
+    createDataTreeExampleModule();
+    assert_int_equal(0, pipe(pipe_fd));
+
+    pid = fork();
+    assert_true(pid >= 0);
+    if (0 == pid) {
+        /* another library-mode process writes the data once the parent is waiting */
+        close(pipe_fd[1]);
+        if (1 != read(pipe_fd[0], &c, 1)) {
+            _exit(1);
+        }
+        rc = sr_connect("cl_test_writer", SR_CONN_DEFAULT, &conn);
+        if (SR_ERR_OK == rc) {
+            rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+        }
+        if (SR_ERR_OK == rc) {
+            rc = sr_set_item_str(session, "/example-module:container/list[key1='key1'][key2='key2']/leaf",
+                    "changed by another process", SR_EDIT_DEFAULT);
+        }
+        if (SR_ERR_OK == rc) {
+            rc = sr_commit(session);
+        }
+        sr_session_stop(session);
+        sr_disconnect(conn);
+        _exit(SR_ERR_OK == rc ? 0 : 1);
+    }
+    close(pipe_fd[0]);
+
+    rc = sr_connect("cl_test", SR_CONN_DEFAULT, &conn);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_module_change_seq(conn, "example-module", &change_seq);
+    if (SR_ERR_UNSUPPORTED == rc) {
+        /* connected to sysrepo daemon */
+        close(pipe_fd[1]);
+        assert_int_equal(pid, waitpid(pid, NULL, 0));
+        sr_disconnect(conn);
+        skip();
+    }
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* nothing has changed */
+    rc = sr_module_change_wait(conn, "example-module", change_seq, 10);
+    assert_int_equal(rc, SR_ERR_TIME_OUT);
+
+    /* woken up by the commit of the other process */
+    assert_int_equal(1, write(pipe_fd[1], "x", 1));
+    rc = sr_module_change_wait(conn, "example-module", change_seq, 5000);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    assert_int_equal(pid, waitpid(pid, &status, 0));
+    assert_true(WIFEXITED(status));
+    assert_int_equal(0, WEXITSTATUS(status));
+    close(pipe_fd[1]);
+
+    /* the change has already been seen */
+    rc = sr_module_change_seq(conn, "example-module", &change_seq);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_module_change_wait(conn, "example-module", change_seq, 10);
+    assert_int_equal(rc, SR_ERR_TIME_OUT);
+
+    sr_disconnect(conn);
+    createDataTreeExampleModule();
+}
+
 static void
 cl_disconnect_test(void **state)
 {
@@ -1352,6 +1430,102 @@ cl_move_item_test(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+static void
+cl_edit_batch_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    sr_session_ctx_t *session = NULL;
+    const sr_error_info_t *errors = NULL;
+    size_t error_cnt = 0;
+    sr_val_t value = { 0 }, *values = NULL;
+    size_t cnt = 0;
+    int results[6] = { 0, };
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    value.type = SR_UINT8_T;
+    value.data.uint8_val = 42;
+
+    sr_edit_op_t ops[] = {
+        { .type = SR_EDIT_OP_SET, .xpath = "/test-module:user[name='nameA']" },
+        { .type = SR_EDIT_OP_SET, .xpath = "/test-module:user[name='nameB']" },
+        { .type = SR_EDIT_OP_SET_STR, .xpath = "/test-module:user[name='nameC']" },
+        { .type = SR_EDIT_OP_MOVE, .xpath = "/test-module:user[name='nameA']", .position = SR_MOVE_LAST },
+        { .type = SR_EDIT_OP_SET, .xpath = "/test-module:tpdfs/intval", .value = &value },
+        { .type = SR_EDIT_OP_DELETE, .xpath = "/test-module:user[name='nameB']" },
+    };
+
+    /* all operations succeed */
+    rc = sr_edit_batch(session, ops, 6, false, results);
+    assert_int_equal(rc, SR_ERR_OK);
+    for (size_t i = 0; i < 6; i++) {
+        assert_int_equal(results[i], SR_ERR_OK);
+    }
+
+    rc = sr_get_items(session, "/test-module:user", &values, &cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(2, cnt);
+    assert_string_equal("/test-module:user[name='nameC']", values[0].xpath);
+    assert_string_equal("/test-module:user[name='nameA']", values[1].xpath);
+    sr_free_values(values, cnt);
+
+    /* failing operations, continue on error */
+    sr_edit_op_t failing_ops[] = {
+        { .type = SR_EDIT_OP_SET_STR, .xpath = "/test-module:unknown", .str_value = "abc" },
+        { .type = SR_EDIT_OP_SET, .xpath = "/test-module:user[name='nameD']" },
+        { .type = SR_EDIT_OP_DELETE, .xpath = "/test-module:user[name='nameX']", .options = SR_EDIT_STRICT },
+        { .type = SR_EDIT_OP_SET, .xpath = "/test-module:user[name='nameE']" },
+    };
+
+    rc = sr_edit_batch(session, failing_ops, 4, true, results);
+    assert_int_equal(rc, SR_ERR_BAD_ELEMENT);
+    assert_int_equal(results[0], SR_ERR_BAD_ELEMENT);
+    assert_int_equal(results[1], SR_ERR_OK);
+    assert_int_equal(results[2], SR_ERR_DATA_MISSING);
+    assert_int_equal(results[3], SR_ERR_OK);
+
+    rc = sr_get_last_errors(session, &errors, &error_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(error_cnt, 2);
+
+    rc = sr_get_items(session, "/test-module:user", &values, &cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(4, cnt);
+    sr_free_values(values, cnt);
+
+    /* failing operations, stop on error */
+    rc = sr_discard_changes(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_edit_batch(session, failing_ops, 4, false, results);
+    assert_int_equal(rc, SR_ERR_BAD_ELEMENT);
+    assert_int_equal(results[0], SR_ERR_BAD_ELEMENT);
+    assert_int_equal(results[1], SR_ERR_OPERATION_FAILED);
+    assert_int_equal(results[2], SR_ERR_OPERATION_FAILED);
+    assert_int_equal(results[3], SR_ERR_OPERATION_FAILED);
+
+    rc = sr_get_items(session, "/test-module:user", &values, &cnt);
+    assert_int_equal(SR_ERR_NOT_FOUND, rc);
+
+    /* empty batch is a no-op */
+    rc = sr_edit_batch(session, NULL, 0, false, NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_edit_batch(session, ops, 0, true, results);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_get_items(session, "/test-module:user", &values, &cnt);
+    assert_int_equal(SR_ERR_NOT_FOUND, rc);
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 static void
 cl_validate_test(void **state)
 {
@@ -3651,6 +3825,7 @@ main()
             cmocka_unit_test_setup_teardown(cl_connection_test, logging_setup, NULL),
             cmocka_unit_test_setup_teardown(cl_multiconnect_test, logging_setup, NULL),
             cmocka_unit_test_setup_teardown(cl_disconnect_test, logging_setup, NULL),
+            cmocka_unit_test_setup_teardown(cl_module_change_wait_test, logging_setup, NULL),
             cmocka_unit_test_setup_teardown(cl_list_schemas_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_get_schema_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_get_item_test, sysrepo_setup, sysrepo_teardown),
@@ -3664,6 +3839,7 @@ main()
             cmocka_unit_test_setup_teardown(cl_set_item_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_delete_item_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_move_item_test, sysrepo_setup, sysrepo_teardown),
+            cmocka_unit_test_setup_teardown(cl_edit_batch_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_validate_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_commit_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_discard_changes_test, sysrepo_setup, sysrepo_teardown),
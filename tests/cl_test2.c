@@ -26,6 +26,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <string.h>
+#include <inttypes.h>
 #include <pthread.h>
 #include <signal.h>
 #include <fcntl.h>
@@ -1087,6 +1088,181 @@ cl_event_notif_test(void **state)
     assert_int_equal(0, pthread_cond_destroy(&cb_status.cond));
 }
 
+static void
+test_event_notif_delivery_cb(const sr_ev_notif_type_t notif_type, const char *xpath, const sr_val_t *values,
+        const size_t values_cnt, time_t timestamp, void *private_ctx)
+{
+    cl_test_en_cb_status_t *cb_status = (cl_test_en_cb_status_t*)private_ctx;
+
+    assert_int_equal(0, pthread_mutex_lock(&cb_status->mutex));
+    cb_status->link_removed += 1;
+    assert_int_equal(0, pthread_cond_signal(&cb_status->cond));
+    assert_int_equal(0, pthread_mutex_unlock(&cb_status->mutex));
+}
+
+static void
+cl_notif_delivery_state_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    sr_session_ctx_t *session = NULL;
+    sr_subscription_ctx_t *subscription = NULL;
+    cl_test_en_cb_status_t cb_status = { 0, };
+    sr_val_t values[4], *value = NULL, *dst_values = NULL;
+    size_t dst_value_cnt = 0;
+    struct timespec ts;
+    int rc = SR_ERR_OK;
+
+    memset(&values, '\0', sizeof(values));
+    assert_int_equal(0, pthread_mutex_init(&cb_status.mutex, NULL));
+    assert_int_equal(0, pthread_cond_init(&cb_status.cond, NULL));
+
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = sr_event_notif_subscribe(session, "/test-module:link-removed", test_event_notif_delivery_cb,
+            &cb_status, SR_SUBSCR_DEFAULT, &subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* deliver one notification to the subscriber */
+    values[0].xpath = "/test-module:link-removed/source/address";
+    values[0].type = SR_STRING_T;
+    values[0].data.string_val = "10.10.2.4";
+    values[1].xpath = "/test-module:link-removed/source/interface";
+    values[1].type = SR_STRING_T;
+    values[1].data.string_val = "eth0";
+    values[2].xpath = "/test-module:link-removed/destination/address";
+    values[2].type = SR_STRING_T;
+    values[2].data.string_val = "10.10.2.5";
+    values[3].xpath = "/test-module:link-removed/destination/interface";
+    values[3].type = SR_STRING_T;
+    values[3].data.string_val = "eth2";
+
+    assert_int_equal(0, pthread_mutex_lock(&cb_status.mutex));
+    rc = sr_event_notif_send(session, "/test-module:link-removed", values, 4, SR_EV_NOTIF_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+    sr_clock_get_time(CLOCK_REALTIME, &ts);
+    ts.tv_sec += COND_WAIT_SEC;
+    while (0 == cb_status.link_removed && ETIMEDOUT != pthread_cond_timedwait(&cb_status.cond, &cb_status.mutex, &ts));
+    assert_int_equal(1, cb_status.link_removed);
+    assert_int_equal(0, pthread_mutex_unlock(&cb_status.mutex));
+
+    /* limits of the delivery */
+    rc = sr_get_item(session, "/sysrepo-monitoring:notification-delivery/queue-size", &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(SR_UINT32_T, value->type);
+    assert_int_equal(SR_NOTIF_QUEUE_SIZE, value->data.uint32_val);
+    sr_free_val(value);
+
+    rc = sr_get_item(session, "/sysrepo-monitoring:notification-delivery/overflow-policy", &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(SR_ENUM_T, value->type);
+    assert_string_equal("drop-oldest", value->data.enum_val);
+    sr_free_val(value);
+
+    /* the subscriber keeps up, nothing is queued nor dropped */
+    rc = sr_get_items(session, "/sysrepo-monitoring:notification-delivery/destination/slow-consumer",
+            &dst_values, &dst_value_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_true(dst_value_cnt >= 1);
+    for (size_t i = 0; i < dst_value_cnt; i++) {
+        assert_int_equal(SR_BOOL_T, dst_values[i].type);
+        assert_false(dst_values[i].data.bool_val);
+    }
+    sr_free_values(dst_values, dst_value_cnt);
+
+    rc = sr_get_items(session, "/sysrepo-monitoring:notification-delivery/destination/queued",
+            &dst_values, &dst_value_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_true(dst_value_cnt >= 1);
+    for (size_t i = 0; i < dst_value_cnt; i++) {
+        assert_int_equal(SR_UINT32_T, dst_values[i].type);
+        assert_int_equal(0, dst_values[i].data.uint32_val);
+    }
+    sr_free_values(dst_values, dst_value_cnt);
+
+    rc = sr_get_items(session, "/sysrepo-monitoring:notification-delivery/destination/dropped",
+            &dst_values, &dst_value_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_true(dst_value_cnt >= 1);
+    for (size_t i = 0; i < dst_value_cnt; i++) {
+        assert_int_equal(SR_UINT64_T, dst_values[i].type);
+        assert_int_equal(0, dst_values[i].data.uint64_val);
+    }
+    sr_free_values(dst_values, dst_value_cnt);
+
+    /* no subscription has lost anything */
+    rc = sr_get_items(session, "/sysrepo-monitoring:notification-delivery/destination/subscription",
+            &dst_values, &dst_value_cnt);
+    assert_int_equal(rc, SR_ERR_NOT_FOUND);
+
+    rc = sr_unsubscribe(NULL, subscription);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    assert_int_equal(0, pthread_mutex_destroy(&cb_status.mutex));
+    assert_int_equal(0, pthread_cond_destroy(&cb_status.cond));
+}
+
+static void
+cl_session_stats_state_test(void **state)
+{
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    sr_session_ctx_t *session = NULL, *observed = NULL;
+    sr_val_t *value = NULL;
+    char xpath[128] = { 0, };
+    uint32_t observed_id = 0;
+    int rc = SR_ERR_OK;
+
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_session_start(conn, SR_DS_RUNNING, SR_SESS_DEFAULT, &observed);
+    assert_int_equal(rc, SR_ERR_OK);
+    observed_id = sr_session_get_id(observed);
+
+    /* some requests processed within the observed session */
+    for (size_t i = 0; i < 3; i++) {
+        rc = sr_get_item(observed, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &value);
+        assert_int_equal(rc, SR_ERR_OK);
+        sr_free_val(value);
+    }
+
+    snprintf(xpath, sizeof xpath, "/sysrepo-monitoring:sessions/session[id='%"PRIu32"']/processed", observed_id);
+    rc = sr_get_item(session, xpath, &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(SR_UINT64_T, value->type);
+    assert_true(value->data.uint64_val >= 3);
+    sr_free_val(value);
+
+    snprintf(xpath, sizeof xpath, "/sysrepo-monitoring:sessions/session[id='%"PRIu32"']/max-queued", observed_id);
+    rc = sr_get_item(session, xpath, &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(SR_UINT32_T, value->type);
+    assert_true(value->data.uint32_val >= 1);
+    sr_free_val(value);
+
+    /* nothing is waiting in the idle session */
+    snprintf(xpath, sizeof xpath, "/sysrepo-monitoring:sessions/session[id='%"PRIu32"']/queued", observed_id);
+    rc = sr_get_item(session, xpath, &value);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(SR_UINT32_T, value->type);
+    assert_int_equal(0, value->data.uint32_val);
+    sr_free_val(value);
+
+    /* stopped session is not listed */
+    rc = sr_session_stop(observed);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_get_item(session, xpath, &value);
+    assert_int_equal(rc, SR_ERR_NOT_FOUND);
+
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 static void
 test_event_notif_link_discovery_tree_cb(const sr_ev_notif_type_t notif_type, const char *xpath,
         const sr_node_t *trees, const size_t tree_cnt, time_t timestamp, void *private_ctx)
@@ -2908,6 +3084,8 @@ main()
             cmocka_unit_test_setup_teardown(cl_dp_get_items_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_session_set_opts, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_event_notif_test, sysrepo_setup, sysrepo_teardown),
+            cmocka_unit_test_setup_teardown(cl_notif_delivery_state_test, sysrepo_setup, sysrepo_teardown),
+            cmocka_unit_test_setup_teardown(cl_session_stats_state_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_event_notif_tree_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_event_notif_combo_test, sysrepo_setup, sysrepo_teardown),
             cmocka_unit_test_setup_teardown(cl_event_notif_replay_test, sysrepo_setup, sysrepo_teardown),
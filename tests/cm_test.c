@@ -38,6 +38,7 @@
 #include "system_helper.h"
 
 #define CM_AF_SOCKET_PATH "/tmp/sysrepo-test"  /* unix-domain socket used for the test*/
+#define CM_SUBSCR_SOCKET_PATH "/tmp/sysrepo-test-subscriber"  /* unix-domain socket of a test subscriber */
 
 static int
 cm_setup(void **state)
@@ -60,6 +61,32 @@ cm_setup(void **state)
     return 0;
 }
 
+static int
+cm_setup_io_threads(void **state)
+{
+    createDataTreeExampleModule();
+    cm_ctx_t *ctx = NULL;
+    int rc = 0;
+
+    sr_logger_init("cm_test");
+    sr_log_stderr(SR_LL_ERR); /* log only errors to stderr */
+
+    rc = cm_init(CM_MODE_LOCAL, CM_AF_SOCKET_PATH, &ctx);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_non_null(ctx);
+    *state = ctx;
+
+    rc = cm_set_io_thread_count(ctx, 1000);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+    rc = cm_set_io_thread_count(ctx, 4);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = cm_start(ctx);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    return 0;
+}
+
 static int
 cm_teardown(void **state)
 {
@@ -318,6 +345,33 @@ cm_session_test(void **state) {
     }
 }
 
+/**
+ * Session start / stop test with connections distributed across multiple I/O threads.
+ */
+static void
+cm_io_threads_test(void **state) {
+    cm_ctx_t *ctx = *state;
+    int fd[16] = { 0, };
+    int rc = 0;
+
+    /* cannot be changed while running */
+    rc = cm_set_io_thread_count(ctx, 2);
+    assert_int_equal(rc, SR_ERR_OPERATION_FAILED);
+
+    /* keep all connections open, so they are handled by different I/O threads */
+    for (size_t i = 0; i < 16; i++) {
+        fd[i] = cm_connect_to_server(1);
+    }
+    for (size_t round = 0; round < 3; round++) {
+        for (size_t i = 0; i < 16; i++) {
+            session_start_stop(fd[i]);
+        }
+    }
+    for (size_t i = 0; i < 16; i++) {
+        close(fd[i]);
+    }
+}
+
 /**
  * Session start / stop negative test.
  */
@@ -498,6 +552,8 @@ cm_session_neg_test(void **state) {
 static void
 cm_buffers_test(void **state)
 {
+    cm_ctx_t *ctx = *state;
+    cm_stats_t stats = { 0 };
     Sr__Msg *msg = NULL;
     uint8_t *msg_buf = NULL;
     size_t msg_size = 0;
@@ -547,6 +603,11 @@ cm_buffers_test(void **state)
         sr__msg__free_unpacked(msg, NULL);
     }
 
+    /* all responses so far have been sent */
+    assert_int_equal(cm_get_stats(ctx, &stats), SR_ERR_OK);
+    assert_true(stats.msg_sent_cnt >= 1001);
+    assert_true(stats.send_call_cnt > 0);
+
     /* send many get-item requests */
     for (size_t i = 0; i < 1000; i++) {
         cm_get_item_generate(session_id, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &msg_buf, &msg_size);
@@ -562,6 +623,446 @@ cm_buffers_test(void **state)
     /* let the connection manager to be stopped in teardown before reading responses */
 }
 
+
+/**
+ * Creates a subscriber socket that does not accept nor read anything until the test does so.
+ */
+static int
+cm_notif_subscriber_listen()
+{
+    struct sockaddr_un addr = { 0, };
+    int fd = -1;
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    assert_true(fd >= 0);
+    unlink(CM_SUBSCR_SOCKET_PATH);
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, CM_SUBSCR_SOCKET_PATH, sizeof(addr.sun_path) - 1);
+    assert_int_equal(bind(fd, (struct sockaddr*)&addr, sizeof(addr)), 0);
+    assert_int_equal(listen(fd, 1), 0);
+
+    return fd;
+}
+
+/**
+ * Sends an event notification of the subscription to the test subscriber. The xpath is padded to 1 KiB,
+ * so that the subscriber socket gets full soon.
+ */
+static void
+cm_notif_send(cm_ctx_t *ctx, uint32_t subscription_id, const char *xpath)
+{
+    Sr__Msg *msg = NULL;
+    char padded[1024] = { 0, };
+    int rc = SR_ERR_OK;
+
+    memset(padded, 'x', sizeof(padded) - 1);
+    memcpy(padded, xpath, strlen(xpath));
+
+    rc = sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, 0, &msg);
+    assert_int_equal(rc, SR_ERR_OK);
+    msg->request->event_notif_req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME;
+    msg->request->event_notif_req->do_not_send_reply = true;
+    msg->request->event_notif_req->has_subscription_id = true;
+    msg->request->event_notif_req->subscription_id = subscription_id;
+    rc = sr_mem_edit_string((sr_mem_ctx_t *)msg->_sysrepo_mem_ctx, &msg->request->event_notif_req->xpath, padded);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = sr_mem_edit_string((sr_mem_ctx_t *)msg->_sysrepo_mem_ctx,
+            &msg->request->event_notif_req->subscriber_address, CM_SUBSCR_SOCKET_PATH);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = cm_msg_send(ctx, msg);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
+/**
+ * Waits until all the sent notifications are written, queued or dropped and returns the state of the test subscriber.
+ */
+static void
+cm_notif_wait_settled(cm_ctx_t *ctx, uint64_t sent_cnt, cm_notif_dst_state_t **states, size_t *state_cnt)
+{
+    struct timespec ts = { 0, 10000000L }; /* 10 milliseconds */
+    cm_stats_t stats = { 0 };
+    bool done = false;
+
+    *states = NULL;
+    *state_cnt = 0;
+    for (size_t i = 0; i < 500 && !done; i++) {
+        nanosleep(&ts, NULL);
+        cm_notif_dst_states_free(*states, *state_cnt);
+        assert_int_equal(cm_get_notif_dst_states(ctx, states, state_cnt), SR_ERR_OK);
+        assert_int_equal(cm_get_stats(ctx, &stats), SR_ERR_OK);
+        done = (1 == *state_cnt) && (stats.msg_sent_cnt + (*states)[0].queued_cnt + (*states)[0].dropped_cnt == sent_cnt);
+    }
+    assert_true(done);
+    assert_string_equal((*states)[0].dst_address, CM_SUBSCR_SOCKET_PATH);
+}
+
+/**
+ * Returns the number of dropped notifications of the subscription.
+ */
+static uint64_t
+cm_notif_dropped(const cm_notif_dst_state_t *state, uint32_t subscription_id)
+{
+    for (size_t i = 0; i < state->subscription_cnt; i++) {
+        if (subscription_id == state->subscriptions[i].subscription_id) {
+            return state->subscriptions[i].dropped_cnt;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sends notifications of the subscription until the queue of the test subscriber is full.
+ */
+static void
+cm_notif_fill_queue(cm_ctx_t *ctx, size_t queue_size, uint32_t subscription_id, const char *xpath, uint64_t *sent_cnt)
+{
+    cm_notif_dst_state_t *states = NULL;
+    size_t state_cnt = 0, queued_cnt = 0;
+
+    for (size_t i = 0; i < 100 && queued_cnt < queue_size; i++) {
+        for (size_t j = 0; j < 50; j++) {
+            cm_notif_send(ctx, subscription_id, xpath);
+        }
+        *sent_cnt += 50;
+        cm_notif_wait_settled(ctx, *sent_cnt, &states, &state_cnt);
+        queued_cnt = states[0].queued_cnt;
+        cm_notif_dst_states_free(states, state_cnt);
+    }
+    assert_int_equal(queued_cnt, queue_size);
+}
+
+/**
+ * Event notifications for a subscriber that does not read them are queued up to the limit, the others are dropped.
+ */
+static void
+cm_notif_backpressure_test(void **state)
+{
+    cm_ctx_t *ctx = *state;
+    cm_notif_overflow_policy_t policy = CM_NOTIF_OVERFLOW_BLOCK;
+    cm_notif_dst_state_t *states = NULL;
+    size_t state_cnt = 0, queue_size = 0;
+    uint64_t dropped_cnt = 0;
+    int fd = -1;
+
+    /* overflow policies */
+    assert_int_equal(cm_notif_overflow_policy_from_str("coalesce", &policy), SR_ERR_OK);
+    assert_int_equal(policy, CM_NOTIF_OVERFLOW_COALESCE);
+    assert_string_equal(cm_notif_overflow_policy_to_str(policy), "coalesce");
+    assert_int_equal(cm_notif_overflow_policy_from_str("unknown", &policy), SR_ERR_INVAL_ARG);
+
+    assert_int_equal(cm_set_notif_queue_limits(ctx, 0, CM_NOTIF_OVERFLOW_DROP_NEWEST), SR_ERR_INVAL_ARG);
+    assert_int_equal(cm_set_notif_queue_limits(ctx, 100, CM_NOTIF_OVERFLOW_DROP_NEWEST), SR_ERR_OK);
+    assert_int_equal(cm_get_notif_queue_limits(ctx, &queue_size, &policy), SR_ERR_OK);
+    assert_int_equal(queue_size, 100);
+    assert_int_equal(policy, CM_NOTIF_OVERFLOW_DROP_NEWEST);
+
+    /* subscriber that never reads */
+    fd = cm_notif_subscriber_listen();
+
+    /* send notifications of two subscriptions */
+    for (size_t i = 0; i < 2000; i++) {
+        cm_notif_send(ctx, (i % 2) + 1, "/");
+    }
+    cm_notif_wait_settled(ctx, 2000, &states, &state_cnt);
+
+    assert_true(states[0].slow_consumer);
+    assert_int_equal(states[0].queued_cnt, 100);
+    assert_true(states[0].dropped_cnt > 0);
+    assert_int_equal(states[0].subscription_cnt, 2);
+    for (size_t i = 0; i < states[0].subscription_cnt; i++) {
+        dropped_cnt += states[0].subscriptions[i].dropped_cnt;
+    }
+    assert_int_equal(dropped_cnt, states[0].dropped_cnt);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    close(fd);
+    unlink(CM_SUBSCR_SOCKET_PATH);
+}
+
+/**
+ * With the drop-oldest policy, the notifications that have waited in the full queue for the longest time are dropped.
+ */
+static void
+cm_notif_drop_oldest_test(void **state)
+{
+    cm_ctx_t *ctx = *state;
+    cm_notif_dst_state_t *states = NULL;
+    size_t state_cnt = 0;
+    uint64_t sent_cnt = 0, dropped_a = 0;
+    int fd = -1;
+
+    assert_int_equal(cm_set_notif_queue_limits(ctx, 100, CM_NOTIF_OVERFLOW_DROP_OLDEST), SR_ERR_OK);
+    fd = cm_notif_subscriber_listen();
+
+    /* the queue is full of the notifications of subscription 1 */
+    cm_notif_fill_queue(ctx, 100, 1, "/a", &sent_cnt);
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    dropped_a = cm_notif_dropped(&states[0], 1);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    /* the notifications of subscription 2 replace the oldest ones */
+    for (size_t i = 0; i < 30; i++) {
+        cm_notif_send(ctx, 2, "/b");
+    }
+    sent_cnt += 30;
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(states[0].queued_cnt, 100);
+    assert_int_equal(cm_notif_dropped(&states[0], 1), dropped_a + 30);
+    assert_int_equal(cm_notif_dropped(&states[0], 2), 0);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    close(fd);
+    unlink(CM_SUBSCR_SOCKET_PATH);
+}
+
+/**
+ * With the coalesce policy, a new notification replaces a queued one of the same subscription and xpath,
+ * the oldest notification is dropped only if there is no such one.
+ */
+static void
+cm_notif_coalesce_test(void **state)
+{
+    cm_ctx_t *ctx = *state;
+    cm_notif_dst_state_t *states = NULL;
+    size_t state_cnt = 0;
+    uint64_t sent_cnt = 0, dropped_a = 0;
+    int fd = -1;
+
+    assert_int_equal(cm_set_notif_queue_limits(ctx, 100, CM_NOTIF_OVERFLOW_COALESCE), SR_ERR_OK);
+    fd = cm_notif_subscriber_listen();
+
+    /* the queue is full of the notifications of subscription 1 */
+    cm_notif_fill_queue(ctx, 100, 1, "/a", &sent_cnt);
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    dropped_a = cm_notif_dropped(&states[0], 1);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    /* nothing to coalesce with, the oldest notifications are dropped */
+    for (size_t i = 0; i < 10; i++) {
+        cm_notif_send(ctx, 2, "/b");
+    }
+    sent_cnt += 10;
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(cm_notif_dropped(&states[0], 1), dropped_a + 10);
+    assert_int_equal(cm_notif_dropped(&states[0], 2), 0);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    /* the same subscription and xpath - replaces the queued notification of subscription 2, not the oldest one */
+    for (size_t i = 0; i < 5; i++) {
+        cm_notif_send(ctx, 2, "/b");
+    }
+    sent_cnt += 5;
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(states[0].queued_cnt, 100);
+    assert_int_equal(cm_notif_dropped(&states[0], 1), dropped_a + 10);
+    assert_int_equal(cm_notif_dropped(&states[0], 2), 5);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    /* a different xpath of subscription 2 does not match, the oldest notification is dropped */
+    cm_notif_send(ctx, 2, "/c");
+    sent_cnt += 1;
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(cm_notif_dropped(&states[0], 1), dropped_a + 11);
+    assert_int_equal(cm_notif_dropped(&states[0], 2), 5);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    close(fd);
+    unlink(CM_SUBSCR_SOCKET_PATH);
+}
+
+/**
+ * With the block policy, the sender waits for a slow subscriber at most SR_NOTIF_BLOCK_TIMEOUT. After the timeout,
+ * the notifications are dropped without waiting until the subscriber reads some of them.
+ */
+static void
+cm_notif_block_test(void **state)
+{
+    cm_ctx_t *ctx = *state;
+    cm_notif_dst_state_t *states = NULL;
+    size_t state_cnt = 0;
+    uint64_t sent_cnt = 0, dropped_cnt = 0, elapsed = 0;
+    struct timespec start = { 0, }, end = { 0, };
+    char buff[65536] = { 0, };
+    int fd = -1, conn_fd = -1;
+    ssize_t ret = 0;
+    bool drained = false;
+
+    /* fill the queue without blocking first */
+    assert_int_equal(cm_set_notif_queue_limits(ctx, 100, CM_NOTIF_OVERFLOW_DROP_NEWEST), SR_ERR_OK);
+    fd = cm_notif_subscriber_listen();
+    cm_notif_fill_queue(ctx, 100, 1, "/a", &sent_cnt);
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    dropped_cnt = states[0].dropped_cnt;
+    cm_notif_dst_states_free(states, state_cnt);
+
+    assert_int_equal(cm_set_notif_queue_limits(ctx, 100, CM_NOTIF_OVERFLOW_BLOCK), SR_ERR_OK);
+
+    /* the sender waits for the subscriber, then the notification is dropped */
+    sr_clock_get_time(CLOCK_MONOTONIC, &start);
+    cm_notif_send(ctx, 1, "/a");
+    sr_clock_get_time(CLOCK_MONOTONIC, &end);
+    sent_cnt += 1;
+    elapsed = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    assert_true(elapsed + 10 >= SR_NOTIF_BLOCK_TIMEOUT);
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(states[0].dropped_cnt, dropped_cnt + 1);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    /* the subscriber is still stalled, the next notifications are dropped right away */
+    sr_clock_get_time(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < 10; i++) {
+        cm_notif_send(ctx, 1, "/a");
+    }
+    sr_clock_get_time(CLOCK_MONOTONIC, &end);
+    sent_cnt += 10;
+    elapsed = (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+    assert_true(elapsed < SR_NOTIF_BLOCK_TIMEOUT);
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(states[0].dropped_cnt, dropped_cnt + 11);
+    assert_int_equal(states[0].queued_cnt, 100);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    /* the subscriber reads everything */
+    conn_fd = accept(fd, NULL, NULL);
+    assert_true(conn_fd >= 0);
+    for (size_t i = 0; i < 500 && !drained; i++) {
+        do {
+            ret = recv(conn_fd, buff, sizeof(buff), MSG_DONTWAIT);
+        } while (ret > 0);
+        cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+        drained = (0 == states[0].queued_cnt);
+        cm_notif_dst_states_free(states, state_cnt);
+    }
+    assert_true(drained);
+
+    /* the subscriber keeps up again, the notifications are delivered */
+    cm_notif_send(ctx, 1, "/a");
+    sent_cnt += 1;
+    cm_notif_wait_settled(ctx, sent_cnt, &states, &state_cnt);
+    assert_int_equal(states[0].dropped_cnt, dropped_cnt + 11);
+    assert_false(states[0].slow_consumer);
+    cm_notif_dst_states_free(states, state_cnt);
+
+    close(conn_fd);
+    close(fd);
+    unlink(CM_SUBSCR_SOCKET_PATH);
+}
+
+/**
+ * Large message test - the message is received into an input slab.
+ */
+static void
+cm_large_msg_test(void **state)
+{
+    Sr__Msg *msg = NULL;
+    uint8_t *msg_buf = NULL;
+    size_t msg_size = 0;
+    uint32_t session_id = 0;
+    char *xpath = NULL;
+    const size_t xpath_len = 4 * 1024 * 1024;
+
+    int fd = cm_connect_to_server(1);
+
+    /* send session_start request */
+    cm_session_start_generate(NULL, &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+
+    msg = cm_message_recv(fd);
+    assert_non_null(msg);
+    assert_non_null(msg->response);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    assert_non_null(msg->response->session_start_resp);
+    session_id = msg->response->session_start_resp->session_id;
+    sr__msg__free_unpacked(msg, NULL);
+
+    /* send get-item request with a huge xpath, followed by a small one */
+    xpath = malloc(xpath_len + 1);
+    assert_non_null(xpath);
+    strcpy(xpath, "/example-module:container/list[key1='");
+    memset(xpath + strlen(xpath), 'k', xpath_len - strlen(xpath));
+    xpath[xpath_len] = '\0';
+    cm_get_item_generate(session_id, xpath, &msg_buf, &msg_size);
+    free(xpath);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+    cm_get_item_generate(session_id, "/example-module:container/list[key1='key1'][key2='key2']/leaf", &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+
+    /* both requests are processed, the large one fails on the invalid xpath */
+    for (size_t i = 0; i < 2; i++) {
+        msg = cm_message_recv(fd);
+        assert_non_null(msg);
+        assert_int_equal(msg->type, SR__MSG__MSG_TYPE__RESPONSE);
+        assert_non_null(msg->response);
+        assert_int_equal(msg->response->operation, SR__OPERATION__GET_ITEM);
+        if (0 == i) {
+            assert_int_not_equal(msg->response->result, SR_ERR_OK);
+        } else {
+            assert_int_equal(msg->response->result, SR_ERR_OK);
+        }
+        sr__msg__free_unpacked(msg, NULL);
+    }
+
+    session_start_stop(fd);
+    close(fd);
+}
+
+/**
+ * Internal fields of a received message are not trusted - an event notification request with
+ * the shared body field (a pointer within the sender) set must not be dereferenced by the server.
+ */
+static void
+cm_shared_body_field_test(void **state)
+{
+    Sr__Msg *msg = NULL;
+    uint8_t *msg_buf = NULL;
+    size_t msg_size = 0;
+    uint32_t session_id = 0;
+
+    int fd = cm_connect_to_server(1);
+
+    /* send session_start request */
+    cm_session_start_generate(NULL, &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+
+    msg = cm_message_recv(fd);
+    assert_non_null(msg);
+    assert_non_null(msg->response);
+    assert_int_equal(msg->response->result, SR_ERR_OK);
+    assert_non_null(msg->response->session_start_resp);
+    session_id = msg->response->session_start_resp->session_id;
+    sr__msg__free_unpacked(msg, NULL);
+
+    /* send event notification request with the internal field (tag 30) set to a bogus pointer */
+    sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, session_id, &msg);
+    assert_non_null(msg);
+    assert_non_null(msg->request);
+    assert_non_null(msg->request->event_notif_req);
+    msg->request->event_notif_req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME;
+    msg->request->event_notif_req->xpath = strdup("/test-module:link-removed");
+    msg->request->event_notif_req->timestamp = time(NULL);
+    msg->request->event_notif_req->_shared_body = 0xdeadbeef;
+    msg->request->event_notif_req->has__shared_body = true;
+    cm_msg_pack_to_buff(msg, &msg_buf, &msg_size);
+    cm_message_send(fd, msg_buf, msg_size);
+    free(msg_buf);
+
+    /* the request is processed as any other */
+    msg = cm_message_recv(fd);
+    assert_non_null(msg);
+    assert_int_equal(msg->type, SR__MSG__MSG_TYPE__RESPONSE);
+    assert_non_null(msg->response);
+    assert_int_equal(msg->response->operation, SR__OPERATION__EVENT_NOTIF);
+    sr__msg__free_unpacked(msg, NULL);
+
+    /* the server is still alive */
+    session_start_stop(fd);
+    close(fd);
+}
+
 static void
 cm_test_signal_callback(cm_ctx_t *cm_ctx, int signum)
 {
@@ -596,8 +1097,15 @@ int
 main() {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test_setup_teardown(cm_session_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_io_threads_test, cm_setup_io_threads, cm_teardown),
             cmocka_unit_test_setup_teardown(cm_session_neg_test, cm_setup, NULL),
             cmocka_unit_test_setup_teardown(cm_buffers_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_large_msg_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_shared_body_field_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_notif_backpressure_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_notif_drop_oldest_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_notif_coalesce_test, cm_setup, cm_teardown),
+            cmocka_unit_test_setup_teardown(cm_notif_block_test, cm_setup, cm_teardown),
             cmocka_unit_test_setup_teardown(cm_signals_test, cm_setup, cm_teardown),
     };
 
@@ -21,6 +21,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <setjmp.h>
@@ -450,6 +451,146 @@ circular_buffer_test3(void **state)
     sr_cbuff_cleanup(buffer);
 }
 
+/*
+ * Tests lock-free queue - single thread.
+ */
+static void
+mpmc_queue_test1(void **state)
+{
+    sr_mpmc_queue_t *queue = NULL;
+    int rc = 0, i = 0;
+    int tmp = 0;
+    atomic_size_t pending;
+
+    /* capacity is rounded up to the power of two */
+    rc = sr_mpmc_queue_init(6, sizeof(int), &queue);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    for (i = 1; i <= 8; i++) {
+        rc = sr_mpmc_queue_enqueue(queue, &i);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+    assert_int_equal(sr_mpmc_queue_items_in_queue(queue), 8);
+
+    /* the queue is full */
+    rc = sr_mpmc_queue_enqueue(queue, &i);
+    assert_int_equal(rc, SR_ERR_OPERATION_FAILED);
+
+    /* does not wait if there are some items in the queue */
+    rc = sr_mpmc_queue_wait(queue, 10000, NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    for (i = 1; i <= 4; i++) {
+        assert_true(sr_mpmc_queue_dequeue(queue, &tmp));
+        assert_int_equal(tmp, i);
+    }
+    for (i = 9; i <= 12; i++) {
+        rc = sr_mpmc_queue_enqueue(queue, &i);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+    for (i = 5; i <= 12; i++) {
+        assert_true(sr_mpmc_queue_dequeue(queue, &tmp));
+        assert_int_equal(tmp, i);
+    }
+
+    /* queue should be empty now */
+    assert_false(sr_mpmc_queue_dequeue(queue, &tmp));
+    assert_int_equal(sr_mpmc_queue_items_in_queue(queue), 0);
+
+    rc = sr_mpmc_queue_wait(queue, 10, NULL);
+    assert_int_equal(rc, SR_ERR_TIME_OUT);
+
+    /* does not wait if there are some items kept outside of the queue */
+    atomic_init(&pending, 1);
+    rc = sr_mpmc_queue_wait(queue, 10000, &pending);
+    assert_int_equal(rc, SR_ERR_OK);
+    atomic_store(&pending, 0);
+    rc = sr_mpmc_queue_wait(queue, 10, &pending);
+    assert_int_equal(rc, SR_ERR_TIME_OUT);
+
+    sr_mpmc_queue_cleanup(queue);
+}
+
+#define MPMC_QUEUE_TEST_THREADS 4
+#define MPMC_QUEUE_TEST_ITEMS 100000
+
+static void *
+mpmc_queue_test_producer(void *arg)
+{
+    sr_mpmc_queue_t *queue = (sr_mpmc_queue_t *)arg;
+
+    for (size_t i = 1; i <= MPMC_QUEUE_TEST_ITEMS; i++) {
+        while (SR_ERR_OK != sr_mpmc_queue_enqueue(queue, &i)) {
+            /* queue is full */
+        }
+        sr_mpmc_queue_notify(queue, false);
+    }
+    return NULL;
+}
+
+static void *
+mpmc_queue_test_consumer(void *arg)
+{
+    sr_mpmc_queue_t *queue = (sr_mpmc_queue_t *)arg;
+    size_t item = 0, sum = 0;
+
+    for (;;) {
+        if (sr_mpmc_queue_dequeue(queue, &item)) {
+            if (0 == item) {
+                break;
+            }
+            sum += item;
+        } else {
+            sr_mpmc_queue_wait(queue, 100, NULL);
+        }
+    }
+    return (void *)sum;
+}
+
+/*
+ * Tests lock-free queue - multiple producers & consumers.
+ */
+static void
+mpmc_queue_test2(void **state)
+{
+    sr_mpmc_queue_t *queue = NULL;
+    pthread_t producers[MPMC_QUEUE_TEST_THREADS], consumers[MPMC_QUEUE_TEST_THREADS];
+    size_t item = 0, sum = 0;
+    void *ret = NULL;
+    int rc = 0;
+
+    rc = sr_mpmc_queue_init(64, sizeof(size_t), &queue);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    for (size_t i = 0; i < MPMC_QUEUE_TEST_THREADS; i++) {
+        pthread_create(&consumers[i], NULL, mpmc_queue_test_consumer, queue);
+        pthread_create(&producers[i], NULL, mpmc_queue_test_producer, queue);
+    }
+    for (size_t i = 0; i < MPMC_QUEUE_TEST_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+
+    /* request consumers to exit */
+    item = 0;
+    for (size_t i = 0; i < MPMC_QUEUE_TEST_THREADS; i++) {
+        while (SR_ERR_OK != sr_mpmc_queue_enqueue(queue, &item)) {
+            /* queue is full */
+        }
+    }
+    sr_mpmc_queue_notify(queue, true);
+
+    for (size_t i = 0; i < MPMC_QUEUE_TEST_THREADS; i++) {
+        pthread_join(consumers[i], &ret);
+        sum += (size_t)ret;
+    }
+
+    /* each item has been dequeued exactly once */
+    assert_int_equal(sum, (size_t)MPMC_QUEUE_TEST_THREADS * MPMC_QUEUE_TEST_ITEMS * (MPMC_QUEUE_TEST_ITEMS + 1) / 2);
+    assert_false(sr_mpmc_queue_dequeue(queue, &item));
+
+    sr_mpmc_queue_cleanup(queue);
+}
+
 /*
  * Tests sysrepo bitset DS.
  */
@@ -1427,6 +1568,153 @@ sr_dup_data_tree_to_ctx_test(void **state)
     ly_ctx_destroy(ctx_B, NULL);
 }
 
+static void
+sr_lyd_parse_fd_any_test(void **state)
+{
+    struct ly_ctx *ctx = ly_ctx_new(TEST_SCHEMA_SEARCH_DIR, 0);
+    struct lyd_node *data_tree = NULL, *parsed = NULL;
+    LYD_FORMAT formats[] = {LYD_XML, LYD_JSON, LYD_LYB}, file_format = LYD_UNKNOWN;
+    char file_name[] = "/tmp/sr_parse_fd_XXXXXX";
+    char *page = NULL;
+    long page_size = sysconf(_SC_PAGESIZE);
+    void *addr = NULL;
+    size_t length = 0;
+    int fd = -1;
+
+    assert_true(page_size > 0);
+    page = malloc(page_size);
+    assert_non_null(page);
+
+    ly_ctx_load_module(ctx, "test-module", NULL);
+    data_tree = lyd_new_path(NULL, ctx, "/test-module:list[key='a']", NULL, 0, 0);
+    assert_non_null(data_tree);
+
+    fd = mkstemp(file_name);
+    assert_int_not_equal(-1, fd);
+
+    /* empty file */
+    ly_errno = LY_SUCCESS;
+    assert_null(sr_lyd_parse_fd_any(ctx, fd, SR_FILE_FORMAT_LY, LYD_OPT_CONFIG, &file_format));
+    assert_int_equal(LY_SUCCESS, ly_errno);
+
+    /* mapped content is terminated even if it fills the pages completely */
+    memset(page, 'x', page_size);
+    assert_int_equal(page_size, write(fd, page, page_size));
+    assert_int_equal(SR_ERR_OK, sr_mmap_file(fd, &addr, &length));
+    assert_int_equal(page_size, length);
+    assert_int_equal(page_size, strlen(addr));
+    sr_munmap_file(addr, length);
+    free(page);
+
+    /* file stored in any of the formats */
+    for (size_t i = 0; i < sizeof formats / sizeof *formats; i++) {
+        assert_int_equal(0, ftruncate(fd, 0));
+        assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+        assert_int_equal(0, lyd_print_fd(fd, data_tree, formats[i], LYP_WITHSIBLINGS | LYP_FORMAT));
+
+        parsed = sr_lyd_parse_fd_any(ctx, fd, SR_FILE_FORMAT_LY, LYD_OPT_CONFIG, &file_format);
+        assert_non_null(parsed);
+        assert_int_equal(formats[i], file_format);
+        assert_string_equal("list", parsed->schema->name);
+        lyd_free_withsiblings(parsed);
+    }
+
+    close(fd);
+    unlink(file_name);
+    lyd_free_withsiblings(data_tree);
+    ly_ctx_destroy(ctx, NULL);
+}
+
+/*
+ * Tests full reads and writes at an offset.
+ */
+static void
+sr_pread_pwrite_full_test(void **state)
+{
+    char file_name[] = "/tmp/sr_pread_full_XXXXXX";
+    char buf[16] = { 0, };
+    int fd = -1;
+
+    fd = mkstemp(file_name);
+    assert_int_not_equal(-1, fd);
+
+    assert_int_equal(SR_ERR_OK, sr_pwrite_full(fd, "0123456789", 10, 0));
+    assert_int_equal(SR_ERR_OK, sr_pwrite_full(fd, "abc", 3, 4));
+
+    assert_int_equal(SR_ERR_OK, sr_pread_full(fd, buf, 10, 0));
+    assert_memory_equal("0123abc789", buf, 10);
+    assert_int_equal(SR_ERR_OK, sr_pread_full(fd, buf, 2, 8));
+    assert_memory_equal("89", buf, 2);
+
+    /* reading beyond the end of the file fails */
+    assert_int_equal(SR_ERR_IO, sr_pread_full(fd, buf, 4, 8));
+
+    close(fd);
+    unlink(file_name);
+}
+
+static void
+sr_gpb_shared_body_test(void **state)
+{
+    Sr__Msg *tmpl = NULL, *msg[2] = { NULL, }, *unpacked = NULL;
+    sr_gpb_shared_body_t *body = NULL;
+    sr_val_t value = { 0, };
+    uint8_t *buf = NULL;
+    size_t size = 0;
+    char address[32] = { 0, };
+
+    /* notification data packed once */
+    assert_int_equal(SR_ERR_OK, sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, 0, &tmpl));
+    tmpl->request->event_notif_req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME;
+    tmpl->request->event_notif_req->xpath = strdup("/test-module:link-discovered");
+    tmpl->request->event_notif_req->timestamp = 1234;
+    value.xpath = "/test-module:link-discovered/source/interface";
+    value.type = SR_STRING_T;
+    value.data.string_val = "eth0";
+    assert_int_equal(SR_ERR_OK, sr_values_sr_to_gpb(&value, 1, &tmpl->request->event_notif_req->values,
+            &tmpl->request->event_notif_req->n_values));
+    assert_int_equal(SR_ERR_OK, sr_gpb_shared_body_pack(tmpl->request->event_notif_req, &body));
+    sr_msg_free(tmpl);
+
+    /* messages for two subscribers sharing the data */
+    for (size_t i = 0; i < 2; i++) {
+        assert_int_equal(SR_ERR_OK, sr_gpb_req_alloc(NULL, SR__OPERATION__EVENT_NOTIF, 10 + i, &msg[i]));
+        msg[i]->request->event_notif_req->type = SR__EVENT_NOTIF_REQ__NOTIF_TYPE__REALTIME;
+        msg[i]->request->event_notif_req->xpath = strdup("/test-module:link-discovered");
+        msg[i]->request->event_notif_req->timestamp = 1234;
+        snprintf(address, sizeof address, "addr-%zu", i);
+        msg[i]->request->event_notif_req->subscriber_address = strdup(address);
+        msg[i]->request->event_notif_req->subscription_id = 100 + i;
+        msg[i]->request->event_notif_req->has_subscription_id = true;
+        sr_gpb_shared_body_attach(msg[i], body);
+    }
+    sr_gpb_shared_body_release(body);
+
+    for (size_t i = 0; i < 2; i++) {
+        size = sr_gpb_msg_get_packed_size(msg[i]);
+        buf = malloc(size);
+        assert_non_null(buf);
+        assert_int_equal(size, sr_gpb_msg_pack(msg[i], buf));
+        sr_msg_free(msg[i]);
+
+        unpacked = sr__msg__unpack(NULL, size, buf);
+        assert_non_null(unpacked);
+        assert_int_equal(10 + i, unpacked->session_id);
+        assert_int_equal(SR__OPERATION__EVENT_NOTIF, unpacked->request->operation);
+        assert_string_equal("/test-module:link-discovered", unpacked->request->event_notif_req->xpath);
+        assert_int_equal(1234, unpacked->request->event_notif_req->timestamp);
+        snprintf(address, sizeof address, "addr-%zu", i);
+        assert_string_equal(address, unpacked->request->event_notif_req->subscriber_address);
+        assert_int_equal(100 + i, unpacked->request->event_notif_req->subscription_id);
+        assert_false(unpacked->request->event_notif_req->has__shared_body);
+        assert_int_equal(1, unpacked->request->event_notif_req->n_values);
+        assert_string_equal(value.xpath, unpacked->request->event_notif_req->values[0]->xpath);
+        assert_string_equal("eth0", unpacked->request->event_notif_req->values[0]->string_val);
+        sr__msg__free_unpacked(unpacked, NULL);
+        free(buf);
+    }
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
@@ -1436,6 +1724,8 @@ main() {
             cmocka_unit_test_setup_teardown(circular_buffer_test1, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(circular_buffer_test2, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(circular_buffer_test3, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(mpmc_queue_test1, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(mpmc_queue_test2, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_bitset_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(logger_callback_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_locking_set_test, logging_setup, logging_cleanup),
@@ -1449,6 +1739,9 @@ main() {
             cmocka_unit_test_setup_teardown(sr_get_system_groups_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_free_list_of_strings_test, logging_setup, logging_cleanup),
             cmocka_unit_test_setup_teardown(sr_dup_data_tree_to_ctx_test, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(sr_lyd_parse_fd_any_test, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(sr_pread_pwrite_full_test, logging_setup, logging_cleanup),
+            cmocka_unit_test_setup_teardown(sr_gpb_shared_body_test, logging_setup, logging_cleanup),
     };
 
     watchdog_start(300);
@@ -25,7 +25,18 @@
 #include <cmocka.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <pthread.h>
 #include "data_manager.h"
+#include "dm_journal.h"
+#include "dm_helper_pool.h"
+#include "dm_version_table.h"
 #include "test_data.h"
 #include "sr_common.h"
 #include "test_module_helper.h"
@@ -111,6 +122,52 @@ void dm_get_data_tree(void **state)
 
 }
 
+#ifdef HAVE_STAT_ST_MTIM
+void
+dm_data_cache_test(void **state)
+{
+    int rc;
+    dm_ctx_t *ctx;
+    dm_session_t *ses_a, *ses_b;
+    dm_data_info_t *info_a = NULL, *info_b = NULL;
+    dm_stats_t stats = {0};
+
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_a);
+    dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_b);
+
+    /* the first load parses the data file */
+    rc = dm_get_data_info_rdonly(ctx, ses_a, "example-module", &info_a);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(info_a->node);
+    rc = dm_get_stats(ctx, &stats);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, stats.data_cache_hit_cnt);
+    assert_int_equal(1, stats.data_cache_miss_cnt);
+
+    /* the other session shares the parsed data tree */
+    rc = dm_get_data_info_rdonly(ctx, ses_b, "example-module", &info_b);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(info_a->node, info_b->node);
+    rc = dm_get_stats(ctx, &stats);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, stats.data_cache_hit_cnt);
+    assert_int_equal(1, stats.data_cache_miss_cnt);
+
+    /* editable data tree is a private copy */
+    rc = dm_get_data_info(ctx, ses_b, "example-module", &info_b);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_non_null(info_b->node);
+    assert_ptr_not_equal(info_a->node, info_b->node);
+
+    dm_session_stop(ctx, ses_a);
+    dm_session_stop(ctx, ses_b);
+    dm_cleanup(ctx);
+}
+#endif
+
 void
 dm_list_schema_test(void **state)
 {
@@ -420,6 +477,68 @@ dm_locking_test(void **state)
    dm_cleanup(ctx);
 }
 
+void
+dm_subtree_locking_test(void **state)
+{
+   int rc;
+   dm_ctx_t *ctx = NULL;
+   dm_session_t *sessionA = NULL, *sessionB = NULL;
+
+   rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+   assert_int_equal(SR_ERR_OK, rc);
+
+   dm_session_start(ctx, NULL, SR_DS_STARTUP, &sessionA);
+   dm_session_start(ctx, NULL, SR_DS_STARTUP, &sessionB);
+
+   rc = dm_lock_subtree(ctx, sessionA, "/example-module:container/list[key1='a'][key2='b']");
+   assert_int_equal(SR_ERR_OK, rc);
+
+   /* different list instance */
+   rc = dm_lock_subtree(ctx, sessionB, "/example-module:container/list[key1=\"a\"][key2='c']");
+   assert_int_equal(SR_ERR_OK, rc);
+
+   /* the same instance with different quotes, a descendant and an ancestor */
+   rc = dm_lock_subtree(ctx, sessionB, "/example-module:container/list[key1=\"a\"][key2=\"b\"]");
+   assert_int_equal(SR_ERR_LOCKED, rc);
+   rc = dm_lock_subtree(ctx, sessionB, "/example-module:container/list[key1='a'][key2='b']/leaf");
+   assert_int_equal(SR_ERR_LOCKED, rc);
+   rc = dm_lock_subtree(ctx, sessionB, "/example-module:container");
+   assert_int_equal(SR_ERR_LOCKED, rc);
+
+   /* wildcards are not allowed */
+   rc = dm_lock_subtree(ctx, sessionB, "/example-module:container//leaf");
+   assert_int_equal(SR_ERR_INVAL_ARG, rc);
+
+   /* the module can not be locked as a whole by another session */
+   rc = dm_lock_module(ctx, sessionB, "example-module");
+   assert_int_equal(SR_ERR_LOCKED, rc);
+
+   rc = dm_unlock_subtree(ctx, sessionB, "/example-module:container/list[key1='a'][key2='b']");
+   assert_int_equal(SR_ERR_INVAL_ARG, rc);
+   rc = dm_unlock_subtree(ctx, sessionA, "/example-module:container/list[key1='a'][key2='b']");
+   assert_int_equal(SR_ERR_OK, rc);
+
+   /* subtree locks are released with the module locks */
+   rc = dm_unlock_datastore(ctx, sessionB);
+   assert_int_equal(SR_ERR_OK, rc);
+
+   rc = dm_lock_module(ctx, sessionB, "example-module");
+   assert_int_equal(SR_ERR_OK, rc);
+
+   /* the module is locked by another session */
+   rc = dm_lock_subtree(ctx, sessionA, "/example-module:container/list[key1='a'][key2='b']");
+   assert_int_equal(SR_ERR_LOCKED, rc);
+
+   /* automatically release lock by session stop */
+   dm_session_stop(ctx, sessionB);
+
+   rc = dm_lock_subtree(ctx, sessionA, "/example-module:container/list[key1='a'][key2='b']");
+   assert_int_equal(SR_ERR_OK, rc);
+
+   dm_session_stop(ctx, sessionA);
+   dm_cleanup(ctx);
+}
+
 void
 dm_copy_module_test(void **state)
 {
@@ -455,6 +574,60 @@ dm_copy_module_test(void **state)
    dm_cleanup(ctx);
 }
 
+#ifdef HAVE_STAT_ST_MTIM
+void
+dm_session_copy_uptodate_test(void **state)
+{
+    int rc = SR_ERR_OK;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *sessionA = NULL, *sessionB = NULL;
+    dm_schema_info_t *si = NULL;
+    dm_data_info_t *info = NULL;
+    sr_list_t *up_to_date = NULL;
+
+    rc = dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &sessionA);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_session_start(ctx, NULL, SR_DS_STARTUP, &sessionB);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* make sure the data file is not written again within the same time tick */
+    usleep(20000);
+
+    rc = dm_get_data_info(ctx, sessionA, "test-module", &info);
+    assert_int_equal(SR_ERR_OK, rc);
+    info->modified = true;
+
+    /* nothing has been written, the session copy can be committed directly */
+    rc = dm_update_session_data_trees(ctx, sessionA, &up_to_date);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, up_to_date->count);
+    assert_string_equal("test-module", up_to_date->data[0]);
+    sr_list_cleanup(up_to_date);
+    up_to_date = NULL;
+
+    /* data file written by another session */
+    rc = dm_get_module_without_lock(ctx, "test-module", &si);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = rp_dt_enable_xpath(ctx, sessionB, si, "/test-module:main");
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_copy_module(ctx, sessionB, "test-module", SR_DS_STARTUP, SR_DS_STARTUP, NULL, 0, NULL, NULL);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* the session copy has to be reloaded and the changes replayed */
+    rc = dm_update_session_data_trees(ctx, sessionA, &up_to_date);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(0, up_to_date->count);
+    sr_list_cleanup(up_to_date);
+
+    dm_session_stop(ctx, sessionA);
+    dm_session_stop(ctx, sessionB);
+    dm_cleanup(ctx);
+}
+#endif
+
 void
 dm_rpc_test(void **state)
 {
@@ -1119,6 +1292,486 @@ dm_schema_node_xpath_hash(void **state)
     dm_cleanup(ctx);
 }
 
+static void
+dm_journal_check_value(const char *xpath, const char *expected_value, bool equal)
+{
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_data_info_t *info = NULL;
+    struct lyd_node_leaf_list *leaf = NULL;
+
+    /* new context corresponds to the restarted daemon */
+    assert_int_equal(SR_ERR_OK, dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx));
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx));
+    assert_int_equal(SR_ERR_OK, dm_get_data_info(ctx, ses_ctx, "example-module", &info));
+
+    leaf = (struct lyd_node_leaf_list *) get_single_node(info->node, xpath);
+    if (equal) {
+        assert_string_equal(expected_value, leaf->value_str);
+    } else {
+        assert_string_not_equal(expected_value, leaf->value_str);
+    }
+
+    dm_session_stop(ctx, ses_ctx);
+    dm_cleanup(ctx);
+}
+
+static void
+dm_journal_check_leaf(const char *expected_value, bool equal)
+{
+    dm_journal_check_value("/example-module:container/list[key1='key1'][key2='key2']/leaf", expected_value, equal);
+}
+
+/**
+ * @brief Appends the diff to the journal in a child process that is killed once the journal reaches the limit,
+ * i.e. the commit is interrupted at the exact point of the write. Returns the size of the journal afterwards.
+ */
+static off_t
+dm_journal_append_killed(int fd, const struct lyd_difflist *diff, off_t limit)
+{
+    struct rlimit rl = {0};
+    struct stat st = {0};
+    off_t journal_size = 0;
+    char *journal_file = NULL;
+    int status = 0;
+    pid_t pid = 0;
+
+    pid = fork();
+    assert_int_not_equal(-1, pid);
+    if (0 == pid) {
+        rl.rlim_cur = rl.rlim_max = limit;
+        if (0 != setrlimit(RLIMIT_FSIZE, &rl)) {
+            _exit(1);
+        }
+        dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, diff, &journal_size, NULL);
+        _exit(0);
+    }
+    assert_int_equal(pid, waitpid(pid, &status, 0));
+    assert_true(WIFSIGNALED(status));
+    assert_int_equal(SIGXFSZ, WTERMSIG(status));
+
+    assert_int_equal(SR_ERR_OK, sr_str_join(EXAMPLE_MODULE_DATA_FILE_NAME, SR_JOURNAL_FILE_EXT, &journal_file));
+    assert_int_equal(0, stat(journal_file, &st));
+    free(journal_file);
+    return st.st_size;
+}
+
+static struct lyd_difflist *
+dm_journal_leaf_diff(const struct lyd_node *data_tree, struct ly_ctx *ly_ctx, const char *value, struct lyd_node **modified)
+{
+    struct lyd_difflist *diff = NULL;
+
+    *modified = sr_dup_datatree((struct lyd_node *) data_tree);
+    assert_non_null(*modified);
+    assert_non_null(lyd_new_path(*modified, ly_ctx, "/example-module:container/list[key1='key1'][key2='key2']/leaf",
+            (void *) value, 0, LYD_PATH_OPT_UPDATE));
+    diff = lyd_diff((struct lyd_node *) data_tree, *modified, LYD_DIFFOPT_WITHDEFAULTS);
+    assert_non_null(diff);
+    return diff;
+}
+
+void
+dm_journal_test(void **state)
+{
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_data_info_t *info = NULL;
+    struct lyd_node *modified = NULL, *torn = NULL, *next = NULL;
+    struct lyd_difflist *diff = NULL, *torn_diff = NULL, *next_diff = NULL;
+    char *journal_file = NULL;
+    off_t journal_size = 0, committed_size = 0, torn_block_size = 0;
+    struct stat st = {0};
+    char byte = 0;
+    int fd = -1, journal_fd = -1;
+
+    createDataTreeExampleModule();
+    assert_int_equal(SR_ERR_OK, dm_journal_reset(EXAMPLE_MODULE_DATA_FILE_NAME));
+    assert_int_equal(SR_ERR_OK, sr_str_join(EXAMPLE_MODULE_DATA_FILE_NAME, SR_JOURNAL_FILE_EXT, &journal_file));
+
+    /* changes made by a commit, the value of the leaf-list contains brackets */
+    assert_int_equal(SR_ERR_OK, dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx));
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx));
+    assert_int_equal(SR_ERR_OK, dm_get_data_info(ctx, ses_ctx, "example-module", &info));
+    modified = sr_dup_datatree(info->node);
+    assert_non_null(modified);
+    lyd_new_path(modified, info->schema->ly_ctx, "/example-module:container/list[key1='key1'][key2='key2']/leaf",
+            "journaled", 0, LYD_PATH_OPT_UPDATE);
+    lyd_new_path(modified, info->schema->ly_ctx, "/example-module:container/list[key1='new'][key2='list']/leaf",
+            "created", 0, 0);
+    lyd_new_path(modified, info->schema->ly_ctx, "/example-module:array", "[::1]", 0, 0);
+    diff = lyd_diff(info->node, modified, LYD_DIFFOPT_WITHDEFAULTS);
+    assert_non_null(diff);
+
+    fd = open(EXAMPLE_MODULE_DATA_FILE_NAME, O_RDWR);
+    assert_int_not_equal(-1, fd);
+    assert_int_equal(SR_ERR_OK, dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, diff, &journal_size, NULL));
+    assert_true(journal_size > 0);
+    dm_journal_check_leaf("journaled", true);
+    dm_journal_check_value("/example-module:array[.='[::1]']", "[::1]", true);
+    committed_size = journal_size;
+
+    torn_diff = dm_journal_leaf_diff(modified, info->schema->ly_ctx, "torn", &torn);
+    next_diff = dm_journal_leaf_diff(modified, info->schema->ly_ctx, "recovered", &next);
+
+    /* size of the block of the interrupted commit */
+    assert_int_equal(SR_ERR_OK, dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, torn_diff, &journal_size, NULL));
+    torn_block_size = journal_size - committed_size;
+    assert_int_equal(0, truncate(journal_file, committed_size));
+
+    /* daemon killed while writing the block header */
+    assert_int_equal(committed_size + 4, dm_journal_append_killed(fd, torn_diff, committed_size + 4));
+    dm_journal_check_leaf("journaled", true);
+
+    /* daemon killed before the trailer of the block has been written */
+    assert_int_equal(committed_size + torn_block_size - 2,
+            dm_journal_append_killed(fd, torn_diff, committed_size + torn_block_size - 2));
+    dm_journal_check_leaf("journaled", true);
+
+    /* the whole block has been written, but its payload has been torn */
+    assert_int_equal(SR_ERR_OK, dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, torn_diff, &journal_size, NULL));
+    assert_int_equal(committed_size + torn_block_size, journal_size);
+    journal_fd = open(journal_file, O_RDWR);
+    assert_int_not_equal(-1, journal_fd);
+    assert_int_equal(1, pread(journal_fd, &byte, 1, journal_size - 8));
+    byte ^= 0x5a;
+    assert_int_equal(1, pwrite(journal_fd, &byte, 1, journal_size - 8));
+    close(journal_fd);
+    dm_journal_check_leaf("journaled", true);
+
+    /* the torn block is overwritten by the next commit */
+    assert_int_equal(SR_ERR_OK, dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, next_diff, &journal_size, NULL));
+    assert_true(journal_size > committed_size);
+    dm_journal_check_leaf("recovered", true);
+    dm_journal_check_value("/example-module:array[.='[::1]']", "[::1]", true);
+
+    /* commit interrupted in the middle of the write leaves an incomplete block */
+    assert_int_equal(0, stat(journal_file, &st));
+    assert_int_equal(0, truncate(journal_file, st.st_size - 5));
+    dm_journal_check_leaf("journaled", true);
+
+    /* the incomplete block is overwritten by the next commit */
+    assert_int_equal(SR_ERR_OK, dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, next_diff, &journal_size, NULL));
+    assert_int_equal(st.st_size, journal_size);
+    dm_journal_check_leaf("recovered", true);
+
+#ifdef HAVE_STAT_ST_MTIM
+    /* journal does not apply to the rewritten data file (daemon killed before the journal was reset) */
+    usleep(20000);
+    createDataTreeExampleModule();
+    dm_journal_check_leaf("recovered", false);
+#endif
+
+    assert_int_equal(SR_ERR_OK, dm_journal_reset(EXAMPLE_MODULE_DATA_FILE_NAME));
+    assert_int_equal(SR_ERR_OK, dm_journal_get_size(EXAMPLE_MODULE_DATA_FILE_NAME, &journal_size));
+    assert_int_equal(0, journal_size);
+
+    close(fd);
+    free(journal_file);
+    lyd_free_diff(diff);
+    lyd_free_diff(torn_diff);
+    lyd_free_diff(next_diff);
+    lyd_free_withsiblings(modified);
+    lyd_free_withsiblings(torn);
+    lyd_free_withsiblings(next);
+    dm_session_stop(ctx, ses_ctx);
+    dm_cleanup(ctx);
+}
+
+void
+dm_data_file_format_test(void **state)
+{
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_data_info_t *info = NULL;
+    struct lyd_node *modified = NULL;
+    struct lyd_difflist *diff = NULL;
+    LYD_FORMAT other_format = (LYD_XML == SR_FILE_FORMAT_LY) ? LYD_JSON : LYD_XML, format = LYD_UNKNOWN;
+    off_t journal_size = 0;
+    int fd = -1;
+
+    createDataTreeExampleModule();
+    assert_int_equal(SR_ERR_OK, dm_journal_reset(EXAMPLE_MODULE_DATA_FILE_NAME));
+
+    /* data file stored in a different format than the configured one, with a journal */
+    assert_int_equal(SR_ERR_OK, dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx));
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx));
+    assert_int_equal(SR_ERR_OK, dm_get_data_info(ctx, ses_ctx, "example-module", &info));
+    assert_int_equal(SR_ERR_OK, sr_save_data_tree_file(EXAMPLE_MODULE_DATA_FILE_NAME, info->node, other_format));
+
+    modified = sr_dup_datatree(info->node);
+    assert_non_null(modified);
+    lyd_new_path(modified, info->schema->ly_ctx, "/example-module:container/list[key1='key1'][key2='key2']/leaf",
+            "journaled", 0, LYD_PATH_OPT_UPDATE);
+    diff = lyd_diff(info->node, modified, LYD_DIFFOPT_WITHDEFAULTS);
+    assert_non_null(diff);
+
+    fd = open(EXAMPLE_MODULE_DATA_FILE_NAME, O_RDWR);
+    assert_int_not_equal(-1, fd);
+    assert_int_equal(SR_ERR_OK, dm_journal_append(EXAMPLE_MODULE_DATA_FILE_NAME, fd, diff, &journal_size, NULL));
+
+    /* the data file is loaded as it is, it is not converted until it is written as a whole */
+    dm_journal_check_leaf("journaled", true);
+    assert_int_equal(SR_ERR_OK, sr_get_data_file_format(fd, &format));
+    assert_int_equal(other_format, format);
+    assert_int_equal(SR_ERR_OK, dm_journal_get_size(EXAMPLE_MODULE_DATA_FILE_NAME, &journal_size));
+    assert_true(journal_size > 0);
+
+    close(fd);
+    lyd_free_diff(diff);
+    lyd_free_withsiblings(modified);
+    dm_session_stop(ctx, ses_ctx);
+    dm_cleanup(ctx);
+
+    assert_int_equal(SR_ERR_OK, dm_journal_reset(EXAMPLE_MODULE_DATA_FILE_NAME));
+    createDataTreeExampleModule();
+}
+
+static void
+dm_helper_square(void *task)
+{
+    int *value = (int *) task;
+    *value = *value * *value;
+}
+
+typedef struct dm_helper_submitter_s {
+    dm_helper_pool_t *pool;
+    int values[50];
+} dm_helper_submitter_t;
+
+static void *
+dm_helper_submitter(void *arg)
+{
+    dm_helper_submitter_t *submitter = (dm_helper_submitter_t *) arg;
+
+    for (size_t i = 0; i < 50; i++) {
+        submitter->values[i] = i;
+    }
+    assert_int_equal(SR_ERR_OK, dm_helper_pool_run(submitter->pool, dm_helper_square, submitter->values,
+                sizeof *submitter->values, 50));
+    return NULL;
+}
+
+void
+dm_helper_pool_test(void **state)
+{
+    dm_helper_pool_t *pool = NULL;
+    dm_helper_submitter_t submitters[4] = {{ 0, }};
+    pthread_t threads[4];
+    int values[3] = {2, 3, 4};
+
+    /* without the pool the tasks are processed by the caller */
+    assert_int_equal(SR_ERR_OK, dm_helper_pool_run(NULL, dm_helper_square, values, sizeof *values, 3));
+    assert_int_equal(4, values[0]);
+    assert_int_equal(16, values[2]);
+
+    assert_int_equal(SR_ERR_OK, dm_helper_pool_init(3, &pool));
+    assert_non_null(pool);
+
+    /* concurrent submitters */
+    for (size_t i = 0; i < 4; i++) {
+        submitters[i].pool = pool;
+        assert_int_equal(0, pthread_create(&threads[i], NULL, dm_helper_submitter, &submitters[i]));
+    }
+    for (size_t i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+        for (size_t j = 0; j < 50; j++) {
+            assert_int_equal(j * j, submitters[i].values[j]);
+        }
+    }
+
+    dm_helper_pool_cleanup(pool);
+}
+
+static bool
+dm_test_change_unconstrained(dm_ctx_t *ctx, const char *module_name, const char *path)
+{
+    dm_schema_info_t *schema_info = NULL;
+    struct ly_set *set = NULL;
+    bool result = false;
+
+    assert_int_equal(SR_ERR_OK, dm_get_module_and_lock(ctx, module_name, &schema_info));
+    set = lys_find_path(schema_info->module, NULL, path);
+    assert_non_null(set);
+    assert_int_equal(1, set->number);
+    result = dm_is_change_unconstrained(schema_info, set->set.s[0]);
+    ly_set_free(set);
+    pthread_rwlock_unlock(&schema_info->model_lock);
+
+    return result;
+}
+
+void
+dm_unconstrained_change_test(void **state)
+{
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *ses_ctx = NULL;
+    dm_data_info_t *info = NULL;
+    struct lyd_node *node = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t err_cnt = 0;
+
+    assert_int_equal(SR_ERR_OK, dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx));
+
+    assert_true(dm_test_change_unconstrained(ctx, "test-module", "/test-module:main/string"));
+    assert_true(dm_test_change_unconstrained(ctx, "example-module", "/example-module:container/list/leaf"));
+    /* leaf-list */
+    assert_false(dm_test_change_unconstrained(ctx, "test-module", "/test-module:main/numbers"));
+    /* leafref and the leaf it refers to */
+    assert_false(dm_test_change_unconstrained(ctx, "test-module", "/test-module:leafref-chain/A"));
+    assert_false(dm_test_change_unconstrained(ctx, "test-module", "/test-module:leafref-chain/D"));
+    /* leaf with a default value */
+    assert_false(dm_test_change_unconstrained(ctx, "test-module", "/test-module:top-level-default"));
+
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &ses_ctx));
+    assert_int_equal(SR_ERR_OK, dm_get_data_info(ctx, ses_ctx, "example-module", &info));
+
+    /* an unconstrained change is not validated, make the data tree invalid to see it */
+    node = get_single_node(info->node, "/example-module:container/list[key1='key1'][key2='key2']");
+    assert_non_null(dm_lyd_new_leaf(info, node, info->schema->module, "leaf", "duplicate"));
+    dm_data_info_set_modified(info, true);
+    assert_true(info->unconstrained_changes);
+    assert_int_equal(SR_ERR_OK, dm_validate_session_data_trees(ctx, ses_ctx, &errors, &err_cnt));
+    sr_free_errors(errors, err_cnt);
+
+    /* any other change requires the validation of the whole data tree */
+    dm_data_info_set_modified(info, false);
+    assert_false(info->unconstrained_changes);
+    dm_data_info_set_modified(info, true);
+    assert_false(info->unconstrained_changes);
+    assert_int_equal(SR_ERR_VALIDATION_FAILED, dm_validate_session_data_trees(ctx, ses_ctx, &errors, &err_cnt));
+    sr_free_errors(errors, err_cnt);
+
+    dm_session_stop(ctx, ses_ctx);
+    dm_cleanup(ctx);
+}
+
+void
+dm_version_table_test(void **state)
+{
+    dm_version_table_t *table = NULL, *table2 = NULL;
+    dm_module_versions_t *versions = NULL;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *sessionA = NULL, *sessionB = NULL;
+    dm_schema_info_t *si = NULL;
+    dm_data_info_t *info = NULL;
+    sr_list_t *up_to_date = NULL;
+    char long_name[200] = { 0, };
+    uint64_t version = 0, commit_cnt = 0;
+    uint32_t change_seq = 0;
+    struct timespec last_commit_time = { 0, };
+    pid_t pid = 0;
+
+    /* the table is mapped only once in the process */
+    assert_int_equal(SR_ERR_OK, dm_version_table_open(TEST_DATA_SEARCH_DIR, &table));
+    assert_int_equal(SR_ERR_OK, dm_version_table_open(TEST_DATA_SEARCH_DIR, &table2));
+    assert_ptr_equal(table, table2);
+    dm_version_table_close(table2);
+
+    versions = dm_version_table_get(table, "test-module");
+    assert_non_null(versions);
+    assert_ptr_equal(versions, dm_version_table_get(table, "test-module"));
+    assert_ptr_not_equal(versions, dm_version_table_get(table, "example-module"));
+    memset(long_name, 'a', sizeof long_name - 1);
+    assert_null(dm_version_table_get(table, long_name));
+    assert_null(dm_version_table_get(NULL, "test-module"));
+
+    assert_int_equal(SR_ERR_OK, dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx));
+    assert_int_equal(SR_ERR_OK, dm_get_module_without_lock(ctx, "test-module", &si));
+    assert_true(si->shared_versions);
+    assert_ptr_equal(versions, si->versions);
+
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &sessionA));
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &sessionB));
+
+    /* a write increments the version */
+    version = dm_version_get(versions, SR_DS_STARTUP);
+    assert_int_equal(SR_ERR_OK, rp_dt_enable_xpath(ctx, sessionB, si, "/test-module:main"));
+    assert_int_equal(SR_ERR_OK, dm_copy_module(ctx, sessionB, "test-module", SR_DS_STARTUP, SR_DS_STARTUP, NULL, 0, NULL, NULL));
+    assert_true(dm_version_get(versions, SR_DS_STARTUP) > version);
+
+    /* the copy loaded right after the write is up to date */
+    assert_int_equal(SR_ERR_OK, dm_get_data_info(ctx, sessionA, "test-module", &info));
+    info->modified = true;
+    assert_int_equal(SR_ERR_OK, dm_update_session_data_trees(ctx, sessionA, &up_to_date));
+    assert_int_equal(1, up_to_date->count);
+    sr_list_cleanup(up_to_date);
+    up_to_date = NULL;
+
+    /* nothing written since the last check */
+    commit_cnt = dm_version_table_commit_cnt(table, NULL);
+    assert_int_equal(SR_ERR_OK, dm_update_session_data_trees(ctx, sessionA, &up_to_date));
+    assert_int_equal(1, up_to_date->count);
+    sr_list_cleanup(up_to_date);
+    up_to_date = NULL;
+
+    /* write done by another process */
+    change_seq = dm_version_change_seq(versions);
+    assert_int_equal(SR_ERR_TIME_OUT, dm_version_wait(versions, change_seq, 10));
+    dm_version_increment(table, versions, SR_DS_STARTUP);
+    assert_int_equal(SR_ERR_OK, dm_version_wait(versions, change_seq, 10));
+    assert_int_equal(commit_cnt + 1, dm_version_table_commit_cnt(table, &last_commit_time));
+    assert_true(last_commit_time.tv_sec > 0);
+    assert_int_equal(SR_ERR_OK, dm_update_session_data_trees(ctx, sessionA, &up_to_date));
+    assert_int_equal(0, up_to_date->count);
+    sr_list_cleanup(up_to_date);
+
+    /* idle process woken up by a write of another process */
+    change_seq = dm_version_change_seq(versions);
+    pid = fork();
+    assert_true(pid >= 0);
+    if (0 == pid) {
+        usleep(100000);
+        dm_version_increment(table, versions, SR_DS_RUNNING);
+        _exit(0);
+    }
+    assert_int_equal(SR_ERR_OK, dm_version_wait(versions, change_seq, 5000));
+    assert_int_equal(pid, waitpid(pid, NULL, 0));
+
+    dm_session_stop(ctx, sessionA);
+    dm_session_stop(ctx, sessionB);
+    dm_cleanup(ctx);
+    dm_version_table_close(table);
+}
+
+void
+dm_version_table_unavailable_test(void **state)
+{
+    dm_version_table_t *table = NULL;
+    dm_ctx_t *ctx = NULL;
+    dm_session_t *session = NULL;
+    dm_schema_info_t *si = NULL;
+    char data_dir[] = "/tmp/dm_test_versions_XXXXXX";
+    char dir_path[PATH_MAX] = { 0, }, table_path[PATH_MAX] = { 0, };
+    struct stat st = { 0, };
+
+    /* a new table gets the permissions of the data directory regardless of umask */
+    assert_non_null(mkdtemp(data_dir));
+    assert_int_equal(0, chmod(data_dir, 0750));
+    snprintf(dir_path, PATH_MAX, "%s/", data_dir);
+    snprintf(table_path, PATH_MAX, "%s/%s", data_dir, SR_VERSION_TABLE_FILE);
+    assert_int_equal(SR_ERR_OK, dm_version_table_open(dir_path, &table));
+    assert_int_equal(0, stat(table_path, &st));
+    assert_int_equal(0640, st.st_mode & 0777);
+
+    /* the table of the test data directory can not be opened while another one is mapped in the process */
+    assert_int_equal(SR_ERR_OK, dm_init(NULL, NULL, NULL, CM_MODE_LOCAL, TEST_SCHEMA_SEARCH_DIR, TEST_DATA_SEARCH_DIR, &ctx));
+    assert_true(ctx->writes_disabled);
+    assert_int_equal(SR_ERR_OK, dm_get_module_without_lock(ctx, "test-module", &si));
+    assert_false(si->shared_versions);
+
+    /* the data can be read, but not written - the other processes would not notice the change */
+    assert_int_equal(SR_ERR_OK, dm_session_start(ctx, NULL, SR_DS_STARTUP, &session));
+    assert_int_equal(SR_ERR_OK, rp_dt_enable_xpath(ctx, session, si, "/test-module:main"));
+    assert_int_equal(SR_ERR_OPERATION_FAILED, dm_copy_module(ctx, session, "test-module", SR_DS_STARTUP, SR_DS_RUNNING,
+            NULL, 0, NULL, NULL));
+
+    dm_session_stop(ctx, session);
+    dm_cleanup(ctx);
+    dm_version_table_close(table);
+    unlink(table_path);
+    rmdir(data_dir);
+}
+
 int
 main()
 {
@@ -1127,6 +1780,9 @@ main()
     const struct CMUnitTest tests[] = {
             cmocka_unit_test(dm_create_cleanup),
             cmocka_unit_test(dm_get_data_tree),
+#ifdef HAVE_STAT_ST_MTIM
+            cmocka_unit_test(dm_data_cache_test),
+#endif
             cmocka_unit_test(dm_list_schema_test),
             cmocka_unit_test(dm_validate_data_trees_test),
             cmocka_unit_test(dm_discard_changes_test),
@@ -1134,13 +1790,23 @@ main()
             cmocka_unit_test(dm_get_schema_negative_test),
             cmocka_unit_test(dm_add_operation_test),
             cmocka_unit_test(dm_locking_test),
+            cmocka_unit_test(dm_subtree_locking_test),
             cmocka_unit_test(dm_copy_module_test),
+#ifdef HAVE_STAT_ST_MTIM
+            cmocka_unit_test(dm_session_copy_uptodate_test),
+#endif
             cmocka_unit_test(dm_rpc_test),
             cmocka_unit_test(dm_state_data_test),
             cmocka_unit_test(dm_event_notif_test),
             cmocka_unit_test(dm_event_notif_parse_test),
             cmocka_unit_test(dm_action_test),
             cmocka_unit_test(dm_schema_node_xpath_hash),
+            cmocka_unit_test(dm_journal_test),
+            cmocka_unit_test(dm_data_file_format_test),
+            cmocka_unit_test(dm_helper_pool_test),
+            cmocka_unit_test(dm_unconstrained_change_test),
+            cmocka_unit_test(dm_version_table_test),
+            cmocka_unit_test(dm_version_table_unavailable_test),
     };
 
     watchdog_start(300);
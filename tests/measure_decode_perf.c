@@ -0,0 +1,255 @@
+/**
+ * @file measure_decode_perf.c
+ * @brief Measures throughput of receiving and decoding of GPB messages as done by Connection Manager:
+ * growable input buffer + unpack into a new memory context vs. input slab + unpack into the slab's context.
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sr_common.h"
+
+/** @brief Same as in Connection Manager. */
+#define IN_BUFF_MIN_SPACE 512
+#define BUFF_ALLOC_CHUNK 1024
+#define IN_SLAB_MIN_MSG_SIZE 16384
+
+/**
+ * @brief Raw message to be sent to the reader.
+ */
+typedef struct decode_test_msg_s {
+    uint8_t *data;    /**< Message including the preamble. */
+    size_t size;      /**< Size of the data. */
+    size_t count;     /**< How many times the message should be sent. */
+    int fd;           /**< Socket to write into. */
+} decode_test_msg_t;
+
+static void *
+writer(void *arg)
+{
+    decode_test_msg_t *msg = (decode_test_msg_t *)arg;
+    size_t pos = 0;
+    ssize_t written = 0;
+
+    for (size_t i = 0; i < msg->count; i++) {
+        pos = 0;
+        while (pos < msg->size) {
+            written = send(msg->fd, msg->data + pos, msg->size - pos, 0);
+            if (written <= 0) {
+                return NULL;
+            }
+            pos += written;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Unpacks a message from data into sr_mem (new context if NULL) and frees it.
+ */
+static void
+unpack(sr_mem_ctx_t *sr_mem, const uint8_t *data, size_t size)
+{
+    Sr__Msg *msg = NULL;
+
+    if (NULL == sr_mem) {
+        sr_mem_new(size, &sr_mem);
+    }
+    ProtobufCAllocator allocator = sr_get_protobuf_allocator(sr_mem);
+    msg = sr__msg__unpack(&allocator, size, data);
+    if (NULL == msg) {
+        fprintf(stderr, "Unable to unpack the message.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (NULL != sr_mem) {
+        msg->_sysrepo_mem_ctx = (uint64_t)sr_mem;
+        ++sr_mem->obj_count;
+    }
+    sr_msg_free(msg);
+}
+
+/**
+ * @brief Receives and decodes count messages from fd, returns number of decoded bytes.
+ */
+static size_t
+read_messages(int fd, size_t count, bool use_slab)
+{
+    uint8_t *buff = NULL, *tmp = NULL;
+    size_t buff_size = 0, buff_pos = 0, pos = 0, msg_size = 0, total = 0;
+    sr_mem_ctx_t *slab_mem = NULL;
+    uint8_t *slab = NULL;
+    size_t slab_pos = 0;
+    ssize_t bytes = 0;
+
+    while (count > 0) {
+        if (NULL != slab) {
+            bytes = recv(fd, slab + slab_pos, msg_size - slab_pos, 0);
+            if (bytes <= 0) {
+                break;
+            }
+            slab_pos += bytes;
+            if (slab_pos == msg_size) {
+                unpack(slab_mem, slab, msg_size);
+                if (NULL == slab_mem) {
+                    free(slab);
+                }
+                slab = NULL;
+                total += msg_size;
+                --count;
+            }
+            continue;
+        }
+        if ((buff_size - buff_pos) < IN_BUFF_MIN_SPACE) {
+            tmp = realloc(buff, buff_size + BUFF_ALLOC_CHUNK);
+            if (NULL == tmp) {
+                break;
+            }
+            buff = tmp;
+            buff_size += BUFF_ALLOC_CHUNK;
+        }
+        bytes = recv(fd, buff + buff_pos, buff_size - buff_pos, 0);
+        if (bytes <= 0) {
+            break;
+        }
+        buff_pos += bytes;
+
+        pos = 0;
+        while (count > 0 && (buff_pos - pos) > SR_MSG_PREAM_SIZE) {
+            msg_size = sr_buff_to_uint32(buff + pos);
+            if ((buff_pos - pos) >= (SR_MSG_PREAM_SIZE + msg_size)) {
+                unpack(NULL, buff + pos + SR_MSG_PREAM_SIZE, msg_size);
+                pos += SR_MSG_PREAM_SIZE + msg_size;
+                total += msg_size;
+                --count;
+            } else if (use_slab && msg_size >= IN_SLAB_MIN_MSG_SIZE) {
+                sr_mem_new(2 * msg_size, &slab_mem);
+                slab = sr_malloc(slab_mem, msg_size);
+                slab_pos = buff_pos - pos - SR_MSG_PREAM_SIZE;
+                memcpy(slab, buff + pos + SR_MSG_PREAM_SIZE, slab_pos);
+                pos = buff_pos;
+                break;
+            } else {
+                break;
+            }
+        }
+        if (pos > 0) {
+            memmove(buff, buff + pos, buff_pos - pos);
+            buff_pos -= pos;
+        }
+    }
+
+    free(buff);
+    return total;
+}
+
+/**
+ * @brief Builds a set-item-str request with a value of given length, packed including the preamble.
+ */
+static void
+build_message(size_t value_len, decode_test_msg_t *msg)
+{
+    Sr__Msg *req = NULL;
+    char *value = NULL;
+    size_t size = 0;
+
+    sr_gpb_req_alloc(NULL, SR__OPERATION__SET_ITEM_STR, 1, &req);
+    value = malloc(value_len + 1);
+    memset(value, 'x', value_len);
+    value[value_len] = '\0';
+    req->request->set_item_str_req->xpath = strdup("/example-module:container/list[key1='key1'][key2='key2']/leaf");
+    req->request->set_item_str_req->value = value;
+
+    size = sr__msg__get_packed_size(req);
+    msg->data = malloc(SR_MSG_PREAM_SIZE + size);
+    sr_uint32_to_buff(size, msg->data);
+    sr__msg__pack(req, msg->data + SR_MSG_PREAM_SIZE);
+    msg->size = SR_MSG_PREAM_SIZE + size;
+    sr_msg_free(req);
+}
+
+/**
+ * @brief Sends count messages with a value of given length through a socket pair,
+ * returns the throughput of the receiving side in MB/s.
+ */
+static double
+measure(size_t value_len, size_t count, bool use_slab)
+{
+    decode_test_msg_t msg = { 0 };
+    pthread_t thread;
+    int fds[2] = { -1, -1 };
+    struct timespec ts1 = { 0 }, ts2 = { 0 };
+    size_t total = 0;
+    double seconds = 0.0;
+
+    build_message(value_len, &msg);
+    msg.count = count;
+    if (0 != socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+        fprintf(stderr, "Unable to create a socket pair.\n");
+        exit(EXIT_FAILURE);
+    }
+    msg.fd = fds[0];
+
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    pthread_create(&thread, NULL, writer, &msg);
+    total = read_messages(fds[1], count, use_slab);
+    pthread_join(thread, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &ts2);
+
+    close(fds[0]);
+    close(fds[1]);
+    free(msg.data);
+
+    seconds = (ts2.tv_sec - ts1.tv_sec) + 0.000000001 * (ts2.tv_nsec - ts1.tv_nsec);
+    return ((double) total) / seconds / (1024 * 1024);
+}
+
+int
+main(int argc, char **argv)
+{
+    const struct {
+        const char *name;
+        size_t value_len;
+        size_t count;
+    } sizes[] = {
+        { "1 KB", 1024, 50000 },
+        { "64 KB", 64 * 1024, 2000 },
+        { "4 MB", 4 * 1024 * 1024, 40 },
+    };
+    double buffer = 0.0, slab = 0.0;
+
+    /* turn off all logging */
+    sr_log_stderr(SR_LL_NONE);
+    sr_log_syslog(SR_LL_NONE);
+
+    printf("\n\n\t\t%s", "Message receive + decode throughput");
+    printf("\n%-10s| %18s | %18s | %8s\n", "msg size", "in buffer MB/s", "input slab MB/s", "speedup");
+    printf("---------------------------------------------------------------\n");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        buffer = measure(sizes[i].value_len, sizes[i].count, false);
+        slab = measure(sizes[i].value_len, sizes[i].count, true);
+        printf("%-10s| %18.1f | %18.1f | %7.2fx\n", sizes[i].name, buffer, slab, slab / buffer);
+    }
+
+    return 0;
+}
@@ -26,6 +26,10 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
 #include <libyang/libyang.h>
 #include "sysrepo.h"
 #include "test_module_helper.h"
@@ -42,6 +46,27 @@
 /**@brief constant for commit operation */
 #define OP_COUNT_COMMIT 1000
 
+/**@brief serial vs. pipelined edits */
+#define OP_COUNT_PIPELINE 10000
+
+/**@brief notifications stored into one time window of the notification store */
+#define OP_COUNT_NOTIF_STORE 10000
+
+/**@brief maximum number of asynchronous requests in flight */
+#define PIPELINE_DEPTH 64
+
+/**@brief commits performed by all concurrent committers together */
+#define OP_COUNT_CONCURRENT_COMMIT 2000
+
+/**@brief maximum number of concurrent committers */
+#define COMMITTER_MAX 64
+
+/**@brief interfaces in the data file used to compare the data file formats (about 100k data nodes) */
+#define IF_COUNT_FORMAT 9000
+
+/**@brief parses and prints of the data file performed with each format */
+#define OP_COUNT_FORMAT 20
+
 int instance_cnt = 1;
 
 /* Computes diff of two timeval structures
@@ -396,6 +421,48 @@ perf_get_item_with_data_load_test(void **state, int op_num, int *items) {
     *items = 1;
 }
 
+/**@brief sessions reading the same module, compare with "Get item one leaf" (one session) */
+#define SESSION_COUNT 100
+
+/**
+ * @brief Get-item requests spread over ::SESSION_COUNT sessions of one connection. With the data trees
+ * shared between the sessions the time per operation should stay close to "Get item one leaf" and
+ * the memory of the sysrepo daemon should not grow with the number of sessions.
+ */
+static void
+perf_get_item_sessions_test(void **state, int op_num, int *items) {
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+
+    sr_session_ctx_t *sessions[SESSION_COUNT] = { NULL, };
+    sr_val_t *value = NULL;
+    int rc = 0;
+
+    /* start the sessions */
+    for (size_t i = 0; i < SESSION_COUNT; i++) {
+        rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &sessions[i]);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+
+    /* perform get-item requests, the sessions take turns */
+    for (size_t i = 0; i<op_num; i++){
+
+        /* existing leaf */
+        rc = sr_get_item(sessions[i % SESSION_COUNT], "/example-module:container/list[key1='key1'][key2='key2']/leaf", &value);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_non_null(value);
+        assert_int_equal(SR_STRING_T, value->type);
+        sr_free_val(value);
+    }
+
+    /* stop the sessions */
+    for (size_t i = 0; i < SESSION_COUNT; i++) {
+        rc = sr_session_stop(sessions[i]);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+    *items = 1;
+}
+
 static void
 perf_get_items_test(void **state, int op_num, int *items) {
     sr_conn_ctx_t *conn = *state;
@@ -719,6 +786,69 @@ perf_set_delete_100_test(void **state, int op_num, int *items) {
     *items = 100 /* list instances */ * 3 /* leaves */ * 2 /* set + delete */ ;
 }
 
+static void
+perf_set_leaves_serial_test(void **state, int op_num, int *items) {
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    char xpath[PATH_MAX] = { 0, };
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* set the leaves one by one, waiting for each response */
+    for (size_t i = 0; i < op_num; i++) {
+        sprintf(xpath, "/example-module:container/list[key1='serial'][key2='%zu']/leaf", i);
+        rc = sr_set_item_str(session, xpath, "Leaf", SR_EDIT_DEFAULT);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    *items = 1;
+}
+
+static void
+perf_set_leaves_pipelined_test(void **state, int op_num, int *items) {
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    char xpath[PATH_MAX] = { 0, };
+    uint32_t token = 0;
+    size_t in_flight = 0, completed = 0;
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* set the leaves keeping up to PIPELINE_DEPTH requests in flight */
+    for (size_t i = 0; i < op_num; i++) {
+        sprintf(xpath, "/example-module:container/list[key1='pipelined'][key2='%zu']/leaf", i);
+        rc = sr_set_item_str_async(session, xpath, "Leaf", SR_EDIT_DEFAULT, NULL, NULL, &token);
+        assert_int_equal(rc, SR_ERR_OK);
+        in_flight++;
+        while (in_flight >= PIPELINE_DEPTH) {
+            rc = sr_async_process(session, false, &completed);
+            assert_int_equal(rc, SR_ERR_OK);
+            in_flight -= completed;
+        }
+    }
+    rc = sr_async_process(session, true, &completed);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(in_flight, completed);
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    *items = 1;
+}
+
 static void
 perf_commit_test(void **state, int op_num, int *items) {
     sr_conn_ctx_t *conn = *state;
@@ -754,6 +884,139 @@ perf_commit_test(void **state, int op_num, int *items) {
     *items = 1;
 }
 
+static void
+perf_commit_many_changes_test(void **state, int op_num, int *items) {
+    sr_conn_ctx_t *conn = *state;
+    assert_non_null(conn);
+    sr_session_ctx_t *session = NULL;
+    char xpath[PATH_MAX] = { 0, };
+    int rc = 0;
+
+    /* start a session */
+    rc = sr_session_start(conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* create op_num list instances and commit them at once */
+    for (size_t i = 0; i < op_num; i++) {
+        sprintf(xpath, "/example-module:container/list[key1='commit'][key2='%zu']/leaf", i);
+        rc = sr_set_item_str(session, xpath, "Leaf", SR_EDIT_DEFAULT);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* remove them again */
+    for (size_t i = 0; i < op_num; i++) {
+        sprintf(xpath, "/example-module:container/list[key1='commit'][key2='%zu']", i);
+        rc = sr_delete_item(session, xpath, SR_EDIT_DEFAULT);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+    rc = sr_commit(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* stop the session */
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    *items = 2;
+}
+
+typedef struct committer_s {
+    sr_conn_ctx_t *conn;
+    size_t id;
+    size_t op_count;
+    double *latencies;   /* latency of each commit in milliseconds */
+} committer_t;
+
+static void *
+committer_thread(void *arg)
+{
+    committer_t *committer = arg;
+    sr_session_ctx_t *session = NULL;
+    struct timespec ts1 = {0}, ts2 = {0};
+    char xpath[PATH_MAX] = { 0, };
+    int rc = 0;
+
+    rc = sr_session_start(committer->conn, SR_DS_STARTUP, SR_SESS_DEFAULT, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* each committer changes its own list instance */
+    snprintf(xpath, PATH_MAX, "/example-module:container/list[key1='committer%zu'][key2='key2']/leaf", committer->id);
+    for (size_t i = 0; i < committer->op_count; i++) {
+        sr_val_t value = {0,};
+        value.type = SR_STRING_T;
+        value.data.string_val = (0 == i % 2) ? "Leaf" : "Leaf2";
+        rc = sr_set_item(session, xpath, &value, SR_EDIT_DEFAULT);
+        assert_int_equal(rc, SR_ERR_OK);
+
+        clock_gettime(CLOCK_MONOTONIC, &ts1);
+        rc = sr_commit(session);
+        clock_gettime(CLOCK_MONOTONIC, &ts2);
+        assert_int_equal(rc, SR_ERR_OK);
+        committer->latencies[i] = (ts2.tv_sec - ts1.tv_sec) * 1000.0 + (ts2.tv_nsec - ts1.tv_nsec) / 1000000.0;
+    }
+
+    rc = sr_session_stop(session);
+    assert_int_equal(rc, SR_ERR_OK);
+    return NULL;
+}
+
+static int
+latency_cmp(const void *a, const void *b)
+{
+    double l1 = *(const double *) a, l2 = *(const double *) b;
+    return (l1 > l2) - (l1 < l2);
+}
+
+/**
+ * @brief Measures commits performed by concurrent committers, each using its own connection.
+ * Prints the throughput and the median and 99th percentile commit latency.
+ */
+static void
+perf_concurrent_commits(size_t committer_cnt, size_t op_count)
+{
+    committer_t committers[COMMITTER_MAX] = {{ 0, }};
+    pthread_t threads[COMMITTER_MAX] = { 0, };
+    struct timeval tv1 = {0, }, tv2 = {0, }, diff = {0, };
+    double *latencies = NULL;
+    size_t per_committer = op_count / committer_cnt, total = per_committer * committer_cnt;
+    double seconds = 0.0;
+    int rc = 0;
+
+    assert_true(committer_cnt <= COMMITTER_MAX && per_committer > 0);
+    latencies = calloc(total, sizeof *latencies);
+    assert_non_null(latencies);
+
+    for (size_t i = 0; i < committer_cnt; i++) {
+        rc = sr_connect("perf_test", SR_CONN_DEFAULT, &committers[i].conn);
+        assert_int_equal(rc, SR_ERR_OK);
+        committers[i].id = i;
+        committers[i].op_count = per_committer;
+        committers[i].latencies = latencies + i * per_committer;
+    }
+
+    gettimeofday(&tv1, NULL);
+    for (size_t i = 0; i < committer_cnt; i++) {
+        rc = pthread_create(&threads[i], NULL, committer_thread, &committers[i]);
+        assert_int_equal(rc, 0);
+    }
+    for (size_t i = 0; i < committer_cnt; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    gettimeofday(&tv2, NULL);
+
+    for (size_t i = 0; i < committer_cnt; i++) {
+        sr_disconnect(committers[i].conn);
+    }
+
+    timeval_subtract(&diff, &tv2, &tv1);
+    seconds = diff.tv_sec + 0.000001*diff.tv_usec;
+    qsort(latencies, total, sizeof *latencies, latency_cmp);
+    printf("%-32zu| %10.0f | %10.2f | %10.2f | %13zu | %10.2f\n", committer_cnt, total / seconds,
+            latencies[total / 2], latencies[(total * 99) / 100], total, seconds);
+    free(latencies);
+}
+
 static int
 test_rpc_cb(const char *xpath, const sr_val_t *input, const size_t input_cnt,
         sr_val_t **output, size_t *output_cnt, void *private_ctx)
@@ -776,6 +1039,60 @@ test_rpc_cb(const char *xpath, const sr_val_t *input, const size_t input_cnt,
     return SR_ERR_OK;
 }
 
+/**
+ * @brief Measures parsing (data tree load) and printing (data file write by a commit) of the large
+ * ietf-interfaces data tree stored in the given format. Prints the average times and the file size.
+ */
+static void
+perf_data_file_format(LYD_FORMAT format, const char *format_name, size_t op_count)
+{
+    struct ly_ctx *ctx = NULL;
+    struct lyd_node *data_tree = NULL, *parsed = NULL;
+    struct timespec ts1 = {0}, ts2 = {0}, ts3 = {0};
+    char file_name[] = "/tmp/sr_perf_format_XXXXXX";
+    struct stat st = {0};
+    int fd = -1;
+
+    ctx = ly_ctx_new(TEST_SCHEMA_SEARCH_DIR, 0);
+    assert_non_null(ctx);
+    assert_non_null(ly_ctx_load_module(ctx, "ietf-interfaces", NULL));
+    assert_non_null(ly_ctx_load_module(ctx, "ietf-ip", NULL));
+    assert_non_null(ly_ctx_load_module(ctx, "iana-if-type", "2014-05-08"));
+
+    data_tree = lyd_parse_path(ctx, TEST_DATA_SEARCH_DIR "ietf-interfaces" SR_STARTUP_FILE_EXT, SR_FILE_FORMAT_LY,
+            LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG);
+    assert_non_null(data_tree);
+
+    fd = mkstemp(file_name);
+    assert_int_not_equal(-1, fd);
+
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    for (size_t i = 0; i < op_count; i++) {
+        assert_int_equal(0, ftruncate(fd, 0));
+        assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+        assert_int_equal(0, lyd_print_fd(fd, data_tree, format, LYP_WITHSIBLINGS | LYP_FORMAT));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts2);
+    for (size_t i = 0; i < op_count; i++) {
+        assert_int_equal(0, lseek(fd, 0, SEEK_SET));
+        parsed = lyd_parse_fd(ctx, fd, format, LYD_OPT_TRUSTED | LYD_OPT_STRICT | LYD_OPT_CONFIG);
+        assert_non_null(parsed);
+        lyd_free_withsiblings(parsed);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts3);
+    assert_int_equal(0, fstat(fd, &st));
+
+    printf("%-32s| %10.2f | %10.2f | %13lld\n", format_name,
+            ((ts3.tv_sec - ts2.tv_sec) * 1000.0 + (ts3.tv_nsec - ts2.tv_nsec) / 1000000.0) / op_count,
+            ((ts2.tv_sec - ts1.tv_sec) * 1000.0 + (ts2.tv_nsec - ts1.tv_nsec) / 1000000.0) / op_count,
+            (long long) st.st_size);
+
+    close(fd);
+    unlink(file_name);
+    lyd_free_withsiblings(data_tree);
+    ly_ctx_destroy(ctx, NULL);
+}
+
 static void
 perf_rpc_test(void **state, int op_num, int *items) {
     sr_conn_ctx_t *conn = *state;
@@ -947,6 +1264,7 @@ main (int argc, char **argv)
         {perf_get_item_test, "Get item one leaf", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_get_item_first_test, "Get item first leaf", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_get_item_with_data_load_test, "Get item incl session start", OP_COUNT, sysrepo_setup, sysrepo_teardown},
+        {perf_get_item_sessions_test, "Get item 100 sessions", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_get_items_test, "Get items all lists", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_get_items_iter_test, "Get items iter all lists", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_get_ietf_intefaces_test, "Get items ietf-if config", OP_COUNT, sysrepo_setup, sysrepo_teardown},
@@ -956,11 +1274,15 @@ main (int argc, char **argv)
         {perf_get_ietf_intefaces_tree_test, "Get subtrees ietf-if config", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_set_delete_test, "Set & delete one list", OP_COUNT, sysrepo_setup, sysrepo_teardown},
         {perf_set_delete_100_test, "Set & delete 100 lists", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
+        {perf_set_leaves_serial_test, "Set 10k leaves serially", OP_COUNT_PIPELINE, sysrepo_setup, sysrepo_teardown},
+        {perf_set_leaves_pipelined_test, "Set 10k leaves pipelined", OP_COUNT_PIPELINE, sysrepo_setup, sysrepo_teardown},
         {perf_commit_test, "Commit one leaf change", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
+        {perf_commit_many_changes_test, "Commit 10k changes", OP_COUNT_PIPELINE, sysrepo_setup, sysrepo_teardown},
         {perf_data_provide_test, "Operational data provide", OP_COUNT_COMMIT, data_provide_setup, data_provide_teardown},
         {perf_rpc_test, "RPC", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_ev_notification_ephemeral_test, "Event notification - ephemeral", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
         {perf_ev_notification_store_test, "Event notification - store", OP_COUNT_COMMIT, sysrepo_setup, sysrepo_teardown},
+        {perf_ev_notification_store_test, "Event notification - store 10k", OP_COUNT_NOTIF_STORE, sysrepo_setup, sysrepo_teardown},
         {perf_libyang_get_node, "Libyang get one node", OP_COUNT, libyang_setup, libyang_teardown},
         {perf_libyang_get_all_list, "Libyang get all list", OP_COUNT, libyang_setup, libyang_teardown},
     };
@@ -978,6 +1300,31 @@ main (int argc, char **argv)
     instance_cnt = 1;
     test_perf(tests, test_count, "Data file with one list instance", selection);
 
+    if (-1 == selection) {
+        /* group commit - throughput and latency of concurrent commits */
+        printf("\n\n\t\t%s", "Concurrent commits");
+        printf("\n%-32s| %10s | %10s | %10s | %13s | %10s\n",
+                "Committers", "commits/s", "p50 [ms]", "p99 [ms]", "ops performed", "test time");
+        printf("---------------------------------------------------------------------------------------------------\n");
+        sr_log_stderr(SR_LL_NONE);
+        sr_log_syslog(SR_LL_NONE);
+        perf_concurrent_commits(1, OP_COUNT_CONCURRENT_COMMIT);
+        perf_concurrent_commits(8, OP_COUNT_CONCURRENT_COMMIT);
+        perf_concurrent_commits(64, OP_COUNT_CONCURRENT_COMMIT);
+        createDataTreeExampleModule();
+    }
+
+    if (-1 == selection) {
+        /* data file formats - load and write of about 100k data nodes */
+        createDataTreeLargeIETFinterfacesModule(IF_COUNT_FORMAT);
+        printf("\n\n\t\t%s", "Data file formats (ietf-interfaces, about 100k nodes)");
+        printf("\n%-32s| %10s | %10s | %13s\n", "Format", "load [ms]", "write [ms]", "size [B]");
+        printf("---------------------------------------------------------------------------\n");
+        perf_data_file_format(LYD_XML, "xml", OP_COUNT_FORMAT);
+        perf_data_file_format(LYD_JSON, "json", OP_COUNT_FORMAT);
+        perf_data_file_format(LYD_LYB, "lyb", OP_COUNT_FORMAT);
+    }
+
     /* 20 list instances*/
     createDataTreeLargeExampleModule(20);
     createDataTreeLargeIETFinterfacesModule(20);
@@ -0,0 +1,177 @@
+/**
+ * @file measure_queue_perf.c
+ * @brief Measures throughput of the queues used for passing requests between threads:
+ * mutex-guarded circular buffer (sr_cbuff_t) vs. lock-free queue (sr_mpmc_queue_t).
+ *
+ * @copyright
+ * Copyright 2016 Cisco Systems, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include "sr_common.h"
+
+/** @brief Number of items enqueued by each producer thread. */
+#define OP_COUNT 200000
+
+/** @brief Capacity of the queues. */
+#define QUEUE_SIZE 4096
+
+/** @brief Maximum number of producer (and consumer) threads. */
+#define MAX_THREADS 32
+
+/**
+ * @brief Item passed through the queue (same size as an RP request).
+ */
+typedef struct queue_item_s {
+    void *session;
+    void *msg;
+} queue_item_t;
+
+/**
+ * @brief Context of one measurement.
+ */
+typedef struct queue_test_ctx_s {
+    bool lock_free;               /**< Use lock-free queue (true) or mutex-guarded circular buffer (false). */
+    sr_cbuff_t *cbuff;            /**< Circular buffer. */
+    pthread_mutex_t cbuff_mutex;  /**< Mutex guarding the circular buffer. */
+    sr_mpmc_queue_t *mpmc;        /**< Lock-free queue. */
+    size_t total;                 /**< Total number of items to be passed through the queue. */
+    atomic_size_t dequeued;       /**< Number of already dequeued items. */
+} queue_test_ctx_t;
+
+static void *
+producer(void *arg)
+{
+    queue_test_ctx_t *ctx = (queue_test_ctx_t *)arg;
+    queue_item_t item = { arg, arg };
+    int rc = SR_ERR_OK;
+
+    for (size_t i = 0; i < OP_COUNT; i++) {
+        do {
+            if (ctx->lock_free) {
+                rc = sr_mpmc_queue_enqueue(ctx->mpmc, &item);
+            } else {
+                pthread_mutex_lock(&ctx->cbuff_mutex);
+                if (sr_cbuff_items_in_queue(ctx->cbuff) < QUEUE_SIZE) {
+                    rc = sr_cbuff_enqueue(ctx->cbuff, &item);
+                } else {
+                    /* keep the same bound as the lock-free queue */
+                    rc = SR_ERR_OPERATION_FAILED;
+                }
+                pthread_mutex_unlock(&ctx->cbuff_mutex);
+            }
+            if (SR_ERR_OK != rc) {
+                sched_yield();
+            }
+        } while (SR_ERR_OK != rc);
+    }
+    return NULL;
+}
+
+static void *
+consumer(void *arg)
+{
+    queue_test_ctx_t *ctx = (queue_test_ctx_t *)arg;
+    queue_item_t item = { 0 };
+    bool dequeued = false;
+
+    while (atomic_load(&ctx->dequeued) < ctx->total) {
+        if (ctx->lock_free) {
+            dequeued = sr_mpmc_queue_dequeue(ctx->mpmc, &item);
+        } else {
+            pthread_mutex_lock(&ctx->cbuff_mutex);
+            dequeued = sr_cbuff_dequeue(ctx->cbuff, &item);
+            pthread_mutex_unlock(&ctx->cbuff_mutex);
+        }
+        if (dequeued) {
+            atomic_fetch_add(&ctx->dequeued, 1);
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Passes OP_COUNT items per producer through the queue with given number of producers
+ * and the same number of consumers, returns the number of items per second.
+ */
+static double
+measure(bool lock_free, size_t thread_cnt)
+{
+    queue_test_ctx_t ctx = { 0 };
+    pthread_t producers[MAX_THREADS], consumers[MAX_THREADS];
+    struct timespec ts1 = { 0 }, ts2 = { 0 };
+    double seconds = 0.0;
+
+    ctx.lock_free = lock_free;
+    ctx.total = thread_cnt * OP_COUNT;
+    atomic_init(&ctx.dequeued, 0);
+    if (lock_free) {
+        sr_mpmc_queue_init(QUEUE_SIZE, sizeof(queue_item_t), &ctx.mpmc);
+    } else {
+        sr_cbuff_init(QUEUE_SIZE, sizeof(queue_item_t), &ctx.cbuff);
+        pthread_mutex_init(&ctx.cbuff_mutex, NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    for (size_t i = 0; i < thread_cnt; i++) {
+        pthread_create(&consumers[i], NULL, consumer, &ctx);
+        pthread_create(&producers[i], NULL, producer, &ctx);
+    }
+    for (size_t i = 0; i < thread_cnt; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts2);
+
+    if (lock_free) {
+        sr_mpmc_queue_cleanup(ctx.mpmc);
+    } else {
+        sr_cbuff_cleanup(ctx.cbuff);
+        pthread_mutex_destroy(&ctx.cbuff_mutex);
+    }
+
+    seconds = (ts2.tv_sec - ts1.tv_sec) + 0.000000001 * (ts2.tv_nsec - ts1.tv_nsec);
+    return ((double) ctx.total) / seconds;
+}
+
+int
+main(int argc, char **argv)
+{
+    double cbuff = 0.0, mpmc = 0.0;
+
+    /* turn off all logging */
+    sr_log_stderr(SR_LL_NONE);
+    sr_log_syslog(SR_LL_NONE);
+
+    printf("\n\n\t\t%s", "Request queue throughput (enqueue + dequeue)");
+    printf("\n%-10s| %18s | %18s | %8s\n", "threads", "cbuff+mutex it/s", "lock-free it/s", "speedup");
+    printf("---------------------------------------------------------------\n");
+
+    for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        cbuff = measure(false, threads);
+        mpmc = measure(true, threads);
+        printf("%-10zu| %18.0f | %18.0f | %7.2fx\n", threads, cbuff, mpmc, mpmc / cbuff);
+    }
+
+    return 0;
+}
@@ -321,7 +321,7 @@ np_module_subscriptions_test(void **state)
                 (SR__NOTIFICATION_EVENT__APPLY_EV == subscription->notif_event));
 
         /* notify */
-        rc = np_subscription_notify(np_ctx, subscription, SR_EV_APPLY, 0);
+        rc = np_subscription_notify(np_ctx, subscription, SR_EV_APPLY, 0, NULL, 0);
         assert_int_equal(rc, SR_ERR_OK);
     }
 
@@ -404,6 +404,102 @@ np_dp_subscriptions_test(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+/*
+ * Test that the first verifier error completes the verification and the other verifiers are accounted as late.
+ * The verifiers are identified by their subscriptions, even if they are subscribed to the same xpath.
+ */
+static void
+np_commit_verify_abort_test(void **state)
+{
+    int rc = SR_ERR_OK;
+    test_ctx_t *test_ctx = *state;
+    assert_non_null(test_ctx);
+    np_ctx_t *np_ctx = test_ctx->rp_ctx->np_ctx;
+    assert_non_null(np_ctx);
+    sr_list_t *subscriptions_list = NULL;
+    np_verifier_stats_t *stats = NULL;
+    size_t stats_cnt = 0;
+    uint64_t hist_sum = 0;
+
+    /* delete old subscriptions, if any */
+    np_unsubscribe_destination(np_ctx, "addr6");
+    np_unsubscribe_destination(np_ctx, "addr7");
+
+    rc = np_notification_subscribe(np_ctx, test_ctx->rp_session_ctx, SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS,
+            "addr6", 123, "example-module", NULL, NULL, SR__NOTIFICATION_EVENT__VERIFY_EV, 10, SR_API_VALUES, NP_SUBSCR_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = np_notification_subscribe(np_ctx, test_ctx->rp_session_ctx, SR__SUBSCRIPTION_TYPE__SUBTREE_CHANGE_SUBS,
+            "addr6", 456, "example-module", "/example-module:container", NULL, SR__NOTIFICATION_EVENT__VERIFY_EV, 20,
+            SR_API_VALUES, NP_SUBSCR_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* another verifier of the same module */
+    rc = np_notification_subscribe(np_ctx, test_ctx->rp_session_ctx, SR__SUBSCRIPTION_TYPE__MODULE_CHANGE_SUBS,
+            "addr7", 789, "example-module", NULL, NULL, SR__NOTIFICATION_EVENT__VERIFY_EV, 5, SR_API_VALUES, NP_SUBSCR_DEFAULT);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = np_get_module_change_subscriptions(np_ctx, test_ctx->rp_session_ctx->user_credentials, "example-module",
+            &subscriptions_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(subscriptions_list->count, 3);
+
+    for (size_t i = 0; i < subscriptions_list->count; i++) {
+        rc = np_subscription_notify(np_ctx, subscriptions_list->data[i], SR_EV_VERIFY, 777, NULL, 0);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+    rc = np_commit_notifications_sent(np_ctx, 777, false, subscriptions_list);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* the error completes the verification, there is no commit in DM to be resumed */
+    rc = np_commit_notification_ack(np_ctx, 777, "addr6", 123, "example-module", SR_EV_VERIFY, SR_ERR_VALIDATION_FAILED,
+            false, "invalid value", "/example-module:container");
+    assert_int_equal(rc, SR_ERR_NOT_FOUND);
+
+    /* the other verifiers acknowledge after the verification has completed */
+    rc = np_commit_notification_ack(np_ctx, 777, "addr6", 456, "/example-module:container", SR_EV_VERIFY, SR_ERR_OK,
+            false, NULL, NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = np_commit_notification_ack(np_ctx, 777, "addr7", 789, "example-module", SR_EV_VERIFY, SR_ERR_VALIDATION_FAILED,
+            false, "late error", NULL);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = np_get_verifier_stats(np_ctx, &stats, &stats_cnt);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(stats_cnt, 3);
+    for (size_t i = 0; i < stats_cnt; i++) {
+        assert_int_equal(stats[i].verify_cnt, 1);
+        if (0 == strcmp(stats[i].dst_address, "addr7")) {
+            assert_int_equal(stats[i].dst_id, 789);
+            assert_string_equal(stats[i].subs_xpath, "example-module");
+            assert_int_equal(stats[i].error_cnt, 1);
+            assert_int_equal(stats[i].late_cnt, 1);
+        } else if (123 == stats[i].dst_id) {
+            assert_string_equal(stats[i].dst_address, "addr6");
+            assert_string_equal(stats[i].subs_xpath, "example-module");
+            assert_int_equal(stats[i].error_cnt, 1);
+            assert_int_equal(stats[i].late_cnt, 0);
+        } else {
+            assert_string_equal(stats[i].dst_address, "addr6");
+            assert_int_equal(stats[i].dst_id, 456);
+            assert_string_equal(stats[i].subs_xpath, "/example-module:container");
+            assert_int_equal(stats[i].error_cnt, 0);
+            assert_int_equal(stats[i].late_cnt, 1);
+        }
+        /* every ACK has been matched with its own verify notification */
+        hist_sum = 0;
+        for (size_t j = 0; j < NP_VERIFY_LATENCY_BUCKETS; j++) {
+            hist_sum += stats[i].latency_hist[j];
+        }
+        assert_int_equal(hist_sum, 1);
+    }
+    np_verifier_stats_free(stats, stats_cnt);
+
+    np_subscriptions_list_cleanup(subscriptions_list);
+    np_unsubscribe_destination(np_ctx, "addr6");
+    np_unsubscribe_destination(np_ctx, "addr7");
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
@@ -413,6 +509,7 @@ main() {
             cmocka_unit_test_setup_teardown(np_hello_notify_test, test_setup, test_teardown),
             cmocka_unit_test_setup_teardown(np_module_subscriptions_test, test_setup, test_teardown),
             cmocka_unit_test_setup_teardown(np_dp_subscriptions_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(np_commit_verify_abort_test, test_setup, test_teardown),
     };
 
     watchdog_start(300);
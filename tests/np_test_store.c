@@ -21,13 +21,17 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
 #include "sr_common.h"
 #include "request_processor.h"
 #include "notification_processor.h"
+#include "np_notif_store.h"
 #include "access_control.h"
 #include "persistence_manager.h"
 #include "rp_internal.h"
@@ -133,10 +137,302 @@ np_notif_store_test(void **state)
 #endif
 }
 
+static void
+np_notif_store_same_time_test(void **state)
+{
+#ifndef ENABLE_NOTIF_STORE
+    skip();
+#else
+    int rc = SR_ERR_OK;
+    test_ctx_t *test_ctx = *state;
+    assert_non_null(test_ctx);
+    np_ctx_t *np_ctx = test_ctx->rp_ctx->np_ctx;
+
+    struct ly_ctx *ctx = NULL;
+    const struct lys_module *module = NULL;
+    struct lyd_node *node = NULL;
+    sr_list_t *notif_list = NULL;
+    time_t now = time(NULL);
+    size_t cnt = 0;
+
+    ctx = ly_ctx_new(TEST_SCHEMA_SEARCH_DIR, 0);
+    assert_non_null(ctx);
+    module = ly_ctx_load_module(ctx, "test-module", NULL);
+    assert_non_null(module);
+    node = lyd_new_path(NULL, ctx, "/test-module:link-discovered/source/interface", "eth1", 0, 0);
+    assert_non_null(node);
+
+    /* store several notifications generated at the same time */
+    for (size_t i = 0; i < 5; i++) {
+        rc = np_store_event_notification(np_ctx, test_ctx->rp_session_ctx->user_credentials,
+                "/test-module:link-discovered", now, node);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+
+    /* all of them are retrieved */
+    rc = np_get_event_notifications(np_ctx, test_ctx->rp_session_ctx, "/test-module:link-discovered", now, now,
+            SR_API_VALUES, &notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_non_null(notif_list);
+
+    for (size_t i = 0; i < notif_list->count; i++) {
+        np_ev_notification_t *notification = notif_list->data[i];
+        assert_string_equal(notification->xpath, "/test-module:link-discovered");
+        assert_int_equal(notification->timestamp, now);
+        np_event_notification_cleanup(notification);
+        cnt++;
+    }
+    assert_true(cnt >= 5);
+    sr_list_cleanup(notif_list);
+
+    lyd_free_withsiblings(node);
+    ly_ctx_destroy(ctx, NULL);
+#endif
+}
+
+#define NOTIF_STORE_TEST_XPATH "/test-module:link-discovered"
+
+/**
+ * @brief Creates an empty notification log in /tmp.
+ */
+static void
+notif_store_log_create(char *log_filename, int *log_fd)
+{
+    *log_fd = mkstemp(log_filename);
+    assert_int_not_equal(*log_fd, -1);
+}
+
+/**
+ * @brief Removes the notification log with its index.
+ */
+static void
+notif_store_log_remove(const char *log_filename, int log_fd)
+{
+    char *index_filename = NULL;
+
+    assert_int_equal(SR_ERR_OK, np_notif_store_index_filename(log_filename, &index_filename));
+    unlink(index_filename);
+    unlink(log_filename);
+    free(index_filename);
+    close(log_fd);
+}
+
+/**
+ * @brief Appends a notification with data of the same size for each generation time.
+ */
+static void
+notif_store_append(const char *log_filename, int log_fd, time_t generated_time)
+{
+    char data[32] = { 0, };
+    int rc = SR_ERR_OK;
+
+    snprintf(data, sizeof data, "data-%012lld", (long long) generated_time);
+    rc = np_notif_store_append(log_filename, log_fd, NOTIF_STORE_TEST_XPATH, generated_time, NP_EV_NOTIF_DATA_STRING,
+            data, strlen(data));
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
+/**
+ * @brief Reads the notifications from the time interval, checks their data and returns their count.
+ */
+static size_t
+notif_store_read_cnt(const char *log_filename, int log_fd, time_t time_from, time_t time_to)
+{
+    sr_list_t *notif_list = NULL;
+    char data[32] = { 0, };
+    size_t cnt = 0;
+    int rc = SR_ERR_OK;
+
+    rc = sr_list_init(&notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = np_notif_store_read(log_filename, log_fd, NULL, time_from, time_to, notif_list);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    for (size_t i = 0; i < notif_list->count; i++) {
+        np_ev_notification_t *notification = notif_list->data[i];
+        assert_string_equal(notification->xpath, NOTIF_STORE_TEST_XPATH);
+        assert_true(notification->timestamp >= time_from && notification->timestamp <= time_to);
+        snprintf(data, sizeof data, "data-%012lld", (long long) notification->timestamp);
+        assert_string_equal(notification->data.string, data);
+        np_event_notification_cleanup(notification);
+    }
+    cnt = notif_list->count;
+    sr_list_cleanup(notif_list);
+    return cnt;
+}
+
+static off_t
+notif_store_file_size(const char *filename)
+{
+    struct stat st = { 0, };
+
+    assert_int_equal(0, stat(filename, &st));
+    return st.st_size;
+}
+
+static void
+np_notif_store_torn_record_test(void **state)
+{
+    char log_filename[] = "/tmp/np_notif_store_XXXXXX";
+    char *index_filename = NULL;
+    off_t record_size = 0, entry_size = 0, log_size = 0;
+    time_t now = time(NULL);
+    int log_fd = -1;
+
+    notif_store_log_create(log_filename, &log_fd);
+    assert_int_equal(SR_ERR_OK, np_notif_store_index_filename(log_filename, &index_filename));
+
+    for (size_t i = 0; i < 3; i++) {
+        notif_store_append(log_filename, log_fd, now + i);
+    }
+    log_size = notif_store_file_size(log_filename);
+    record_size = log_size / 3;
+    entry_size = notif_store_file_size(index_filename) / 3;
+
+    /* crash while the fourth record is being written - the log ends with a part of it, the index points beyond */
+    notif_store_append(log_filename, log_fd, now + 3);
+    assert_int_equal(0, truncate(log_filename, log_size + record_size / 2));
+    assert_int_equal(3, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+
+    /* the next append drops the torn record and its index entry */
+    notif_store_append(log_filename, log_fd, now + 4);
+    assert_int_equal(log_size + record_size, notif_store_file_size(log_filename));
+    assert_int_equal(4 * entry_size, notif_store_file_size(index_filename));
+    assert_int_equal(4, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(0, notif_store_read_cnt(log_filename, log_fd, now + 3, now + 3));
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now + 4, now + 4));
+
+    /* a record with only a part of its header written is dropped as well */
+    notif_store_append(log_filename, log_fd, now + 5);
+    assert_int_equal(0, truncate(log_filename, log_size + record_size + 4));
+    notif_store_append(log_filename, log_fd, now + 6);
+    assert_int_equal(log_size + 2 * record_size, notif_store_file_size(log_filename));
+    assert_int_equal(5 * entry_size, notif_store_file_size(index_filename));
+    assert_int_equal(5, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(0, notif_store_read_cnt(log_filename, log_fd, now + 5, now + 5));
+
+    notif_store_log_remove(log_filename, log_fd);
+    free(index_filename);
+}
+
+static void
+np_notif_store_index_completion_test(void **state)
+{
+    char log_filename[] = "/tmp/np_notif_store_XXXXXX";
+    char *index_filename = NULL;
+    off_t entry_size = 0;
+    time_t now = time(NULL);
+    int log_fd = -1;
+
+    notif_store_log_create(log_filename, &log_fd);
+    assert_int_equal(SR_ERR_OK, np_notif_store_index_filename(log_filename, &index_filename));
+
+    for (size_t i = 0; i < 4; i++) {
+        notif_store_append(log_filename, log_fd, now + i);
+    }
+    entry_size = notif_store_file_size(index_filename) / 4;
+
+    /* index with one complete and one partial entry, the rest is found in the log */
+    assert_int_equal(0, truncate(index_filename, entry_size + entry_size / 2));
+    assert_int_equal(4, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(2, notif_store_read_cnt(log_filename, log_fd, now + 2, now + 3));
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now, now));
+
+    /* no index at all */
+    assert_int_equal(0, unlink(index_filename));
+    assert_int_equal(4, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now + 1, now + 1));
+
+    /* the next append writes the missing entries into the index */
+    notif_store_append(log_filename, log_fd, now + 4);
+    assert_int_equal(5 * entry_size, notif_store_file_size(index_filename));
+    assert_int_equal(5, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(3, notif_store_read_cnt(log_filename, log_fd, now + 2, now + 4));
+
+    notif_store_log_remove(log_filename, log_fd);
+    free(index_filename);
+}
+
+static void
+np_notif_store_corrupted_test(void **state)
+{
+    char log_filename[] = "/tmp/np_notif_store_XXXXXX";
+    char *index_filename = NULL;
+    char garbage[8] = { 0, };
+    off_t record_size = 0, entry_size = 0;
+    time_t now = time(NULL);
+    int log_fd = -1, index_fd = -1;
+
+    notif_store_log_create(log_filename, &log_fd);
+    assert_int_equal(SR_ERR_OK, np_notif_store_index_filename(log_filename, &index_filename));
+
+    for (size_t i = 0; i < 3; i++) {
+        notif_store_append(log_filename, log_fd, now + i);
+    }
+    record_size = notif_store_file_size(log_filename) / 3;
+    entry_size = notif_store_file_size(index_filename) / 3;
+
+    /* damaged payload of the second record, the checksum does not match */
+    memset(garbage, 'X', sizeof garbage);
+    assert_int_equal(sizeof garbage, pwrite(log_fd, garbage, sizeof garbage, 2 * record_size - sizeof garbage - 1));
+    assert_int_equal(2, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(0, notif_store_read_cnt(log_filename, log_fd, now + 1, now + 1));
+
+    /* index entry of the first record overwritten */
+    memset(garbage, 0xff, sizeof garbage);
+    index_fd = open(index_filename, O_RDWR);
+    assert_int_not_equal(index_fd, -1);
+    for (off_t offset = 0; offset < entry_size; offset += sizeof garbage) {
+        assert_int_equal(sizeof garbage, pwrite(index_fd, garbage, sizeof garbage, offset));
+    }
+    close(index_fd);
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+
+    /* the store stays usable */
+    notif_store_append(log_filename, log_fd, now + 3);
+    assert_int_equal(4 * entry_size, notif_store_file_size(index_filename));
+    assert_int_equal(2, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now + 3, now + 3));
+
+    notif_store_log_remove(log_filename, log_fd);
+    free(index_filename);
+}
+
+static void
+np_notif_store_out_of_order_test(void **state)
+{
+    char log_filename[] = "/tmp/np_notif_store_XXXXXX";
+    time_t now = time(NULL);
+    time_t times[] = { now + 5, now + 1, now + 6, now + 2, now + 7, now + 3, now + 8 };
+    int log_fd = -1;
+
+    notif_store_log_create(log_filename, &log_fd);
+
+    /* notifications are not necessarily stored in the order they have been generated */
+    for (size_t i = 0; i < sizeof times / sizeof *times; i++) {
+        notif_store_append(log_filename, log_fd, times[i]);
+    }
+
+    assert_int_equal(7, notif_store_read_cnt(log_filename, log_fd, now, now + 10));
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now + 1, now + 1));
+    assert_int_equal(1, notif_store_read_cnt(log_filename, log_fd, now + 3, now + 3));
+    assert_int_equal(3, notif_store_read_cnt(log_filename, log_fd, now + 2, now + 5));
+    assert_int_equal(4, notif_store_read_cnt(log_filename, log_fd, now + 5, now + 10));
+    assert_int_equal(0, notif_store_read_cnt(log_filename, log_fd, now + 4, now + 4));
+    assert_int_equal(0, notif_store_read_cnt(log_filename, log_fd, now + 9, now + 10));
+
+    notif_store_log_remove(log_filename, log_fd);
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test_setup_teardown(np_notif_store_test, test_setup, test_teardown),
+            cmocka_unit_test_setup_teardown(np_notif_store_same_time_test, test_setup, test_teardown),
+            cmocka_unit_test(np_notif_store_torn_record_test),
+            cmocka_unit_test(np_notif_store_index_completion_test),
+            cmocka_unit_test(np_notif_store_corrupted_test),
+            cmocka_unit_test(np_notif_store_out_of_order_test),
     };
 
     watchdog_start(300);
@@ -1519,6 +1519,71 @@ get_nodes_with_opts_cache_missed_test(void **state)
     test_rp_session_cleanup(ctx, ses_ctx);
 }
 
+void
+get_nodes_with_opts_tree_replaced_test(void **state)
+{
+    int rc = 0;
+    rp_ctx_t *ctx = *state;
+    rp_session_t *ses_ctx = NULL;
+    sr_val_t *values = NULL;
+    size_t count = 0, total = 0;
+    uint32_t generation = 0;
+
+#define LIST_K1_CHILDREN "/test-module:list[key='k1']/*"
+    test_rp_session_create(ctx, SR_DS_STARTUP, &ses_ctx);
+    rp_dt_get_items_ctx_t get_items_ctx;
+    get_items_ctx.nodes = NULL;
+    get_items_ctx.xpath = NULL;
+    get_items_ctx.offset = 0;
+    get_items_ctx.trees_generation = 0;
+
+    rc = rp_dt_get_values_wrapper(ctx, ses_ctx, NULL, LIST_K1_CHILDREN, &values, &total);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_true(total > 1);
+    sr_free_values(values, total);
+
+    /* the first page is looked up in the shared snapshot */
+    ses_ctx->state = RP_REQ_NEW;
+    rc = rp_dt_get_values_wrapper_with_opts(ctx, ses_ctx, &get_items_ctx, NULL, LIST_K1_CHILDREN, 0, 1, &values, &count);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, count);
+    sr_free_values(values, count);
+    generation = get_items_ctx.trees_generation;
+    assert_int_equal(generation, dm_get_session_trees_generation(ses_ctx->dm_session));
+
+    /* the write makes the session tree private, the cached nodes must not be used anymore */
+    rc = rp_dt_set_item_wrapper(ctx, ses_ctx, "/test-module:main/string", NULL, strdup("replaced"), SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_not_equal(generation, dm_get_session_trees_generation(ses_ctx->dm_session));
+
+    ses_ctx->state = RP_REQ_NEW;
+    rc = rp_dt_get_values_wrapper_with_opts(ctx, ses_ctx, &get_items_ctx, NULL, LIST_K1_CHILDREN, 1, 10, &values, &count);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(total - 1, count);
+    for (size_t i = 0; i < count; i++) {
+        assert_int_equal(0, strncmp(values[i].xpath, "/test-module:list[key='k1']/", strlen("/test-module:list[key='k1']/")));
+    }
+    sr_free_values(values, count);
+    assert_int_equal(dm_get_session_trees_generation(ses_ctx->dm_session), get_items_ctx.trees_generation);
+
+    /* discarding the changes replaces the tree again */
+    generation = get_items_ctx.trees_generation;
+    rc = dm_discard_changes(ctx->dm_ctx, ses_ctx->dm_session, NULL);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_not_equal(generation, dm_get_session_trees_generation(ses_ctx->dm_session));
+
+    ses_ctx->state = RP_REQ_NEW;
+    rc = rp_dt_get_values_wrapper_with_opts(ctx, ses_ctx, &get_items_ctx, NULL, LIST_K1_CHILDREN, 1, 10, &values, &count);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(total - 1, count);
+    sr_free_values(values, count);
+
+    free(get_items_ctx.xpath);
+    ly_set_free(get_items_ctx.nodes);
+
+    test_rp_session_cleanup(ctx, ses_ctx);
+}
+
 void
 default_nodes_test(void **state)
 {
@@ -1919,6 +1984,7 @@ int main(){
             cmocka_unit_test(get_value_wrapper_test),
             cmocka_unit_test(get_tree_wrapper_test),
             cmocka_unit_test(get_nodes_with_opts_cache_missed_test),
+            cmocka_unit_test(get_nodes_with_opts_tree_replaced_test),
             cmocka_unit_test(default_nodes_test),
             cmocka_unit_test(default_nodes_toplevel_test),
             cmocka_unit_test_setup(union_test, createData),
@@ -1880,6 +1880,69 @@ edit_commit4_test(void **state)
     createDataTreeTestModule();
 }
 
+void
+group_commit_test(void **state)
+{
+    int rc = 0;
+    rp_ctx_t *ctx = *state;
+    rp_session_t *sessionA = NULL, *sessionB = NULL;
+    dm_commit_context_t *c_ctx = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t e_cnt = 0;
+    sr_val_t *v = NULL;
+
+    test_rp_session_create(ctx, SR_DS_STARTUP, &sessionA);
+    test_rp_session_create(ctx, SR_DS_STARTUP, &sessionB);
+
+    v = calloc(1, sizeof(*v));
+    assert_non_null(v);
+    v->type = SR_STRING_T;
+    v->data.string_val = strdup("group A");
+    assert_non_null(v->data.string_val);
+    rc = rp_dt_set_item_wrapper(ctx, sessionA, "/test-module:main/string", v, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = rp_dt_commit(ctx, sessionA, &c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    v = calloc(1, sizeof(*v));
+    assert_non_null(v);
+    v->type = SR_ENUM_T;
+    v->data.enum_val = strdup("maybe");
+    assert_non_null(v->data.enum_val);
+    rc = rp_dt_set_item_wrapper(ctx, sessionB, "/test-module:main/enum", v, NULL, SR_EDIT_DEFAULT);
+    assert_int_equal(SR_ERR_OK, rc);
+    c_ctx = NULL;
+    rc = rp_dt_commit(ctx, sessionB, &c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    if (SR_GROUP_COMMIT_DELAY >= 0) {
+        /* none of the commits has been flushed yet, they are flushed together */
+        assert_non_null(sessionA->commit_sync);
+        assert_ptr_equal(sessionA->commit_sync, sessionB->commit_sync);
+    }
+    assert_int_equal(SR_ERR_OK, rp_dt_commit_sync_wait(sessionB));
+    assert_null(sessionB->commit_sync);
+    assert_int_equal(SR_ERR_OK, rp_dt_commit_sync_wait(sessionA));
+    assert_null(sessionA->commit_sync);
+
+    /* both changes are committed */
+    rc = rp_dt_refresh_session(ctx, sessionA, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = rp_dt_get_value_wrapper(ctx, sessionA, NULL, "/test-module:main/string", &v);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_string_equal("group A", v->data.string_val);
+    sr_free_val(v);
+    rc = rp_dt_get_value_wrapper(ctx, sessionA, NULL, "/test-module:main/enum", &v);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_string_equal("maybe", v->data.enum_val);
+    sr_free_val(v);
+
+    test_rp_session_cleanup(ctx, sessionA);
+    test_rp_session_cleanup(ctx, sessionB);
+
+    createDataTreeTestModule();
+}
+
 void
 edit_move_test(void **state)
 {
@@ -2261,6 +2324,201 @@ lock_commit_test(void **state)
    test_rp_session_cleanup(ctx, sessionB);
 }
 
+static void
+subtree_lock_set_leaf(rp_ctx_t *ctx, rp_session_t *session, const char *xpath, const char *value)
+{
+    sr_val_t *v = NULL;
+
+    v = calloc(1, sizeof(*v));
+    assert_non_null(v);
+    v->type = SR_STRING_T;
+    v->data.string_val = strdup(value);
+    assert_non_null(v->data.string_val);
+    assert_int_equal(SR_ERR_OK, rp_dt_set_item_wrapper(ctx, session, xpath, v, NULL, SR_EDIT_DEFAULT));
+}
+
+#define XP_LIST_A "/example-module:container/list[key1='a'][key2='a']"
+#define XP_LIST_B "/example-module:container/list[key1='b'][key2='b']"
+#define XP_LIST_LEAF "/example-module:container/list[key1='key1'][key2='key2']/leaf"
+void
+subtree_lock_commit_test(void **state)
+{
+    int rc = 0;
+    rp_ctx_t *ctx = *state;
+    rp_session_t *sessionA = NULL, *sessionB = NULL, *sessionC = NULL;
+    dm_commit_context_t *c_ctx = NULL, *c_ctxB = NULL;
+    dm_schema_info_t *si = NULL;
+    sr_error_info_t *errors = NULL;
+    size_t e_cnt = 0;
+    sr_val_t *v = NULL;
+
+    rc = dm_get_module_without_lock(ctx->dm_ctx, "example-module", &si);
+    assert_int_equal(SR_ERR_OK, rc);
+    if (!si->shared_versions) {
+        /* the commits with subtree scope require the shared version table */
+        skip();
+    }
+
+    test_rp_session_create(ctx, SR_DS_STARTUP, &sessionA);
+    test_rp_session_create(ctx, SR_DS_STARTUP, &sessionB);
+    test_rp_session_create(ctx, SR_DS_STARTUP, &sessionC);
+
+    rc = rp_dt_lock_subtree(ctx, sessionA, XP_LIST_A);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = rp_dt_lock_subtree(ctx, sessionB, XP_LIST_B);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    /* commit touching a subtree locked by another session fails */
+    subtree_lock_set_leaf(ctx, sessionC, XP_LIST_A "/leaf", "C");
+    rc = rp_dt_commit(ctx, sessionC, &c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_LOCKED, rc);
+    assert_int_equal(1, e_cnt);
+    assert_string_equal(XP_LIST_A, errors[0].xpath);
+    sr_free_errors(errors, e_cnt);
+    errors = NULL;
+    e_cnt = 0;
+    c_ctx = NULL;
+    dm_discard_changes(ctx->dm_ctx, sessionC->dm_session, NULL);
+
+    /* commit of A is stopped after its data file has been loaded */
+    subtree_lock_set_leaf(ctx, sessionA, XP_LIST_A "/leaf", "A");
+    rc = dm_commit_prepare_context(ctx->dm_ctx, sessionA->dm_session, &c_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    c_ctx->init_session = sessionA;
+    c_ctx->disabled_config_change = ctx->do_not_generate_config_change;
+    pthread_mutex_lock(&c_ctx->mutex);
+    rc = dm_commit_load_modified_models(ctx->dm_ctx, sessionA->dm_session, c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_ptr_equal(si, c_ctx->scoped_schemas[0]);
+    assert_int_equal(1, si->scoped_commit_cnt[SR_DS_STARTUP]);
+    assert_false(si->scoped_file_locked[SR_DS_STARTUP]);
+
+    /* commit of a disjoint subtree in B writes the data file meanwhile */
+    subtree_lock_set_leaf(ctx, sessionB, XP_LIST_B "/leaf", "B");
+    rc = rp_dt_commit(ctx, sessionB, &c_ctxB, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(SR_ERR_OK, rp_dt_commit_sync_wait(sessionB));
+
+    /* commit of A reloads the data file and applies its changes once more before writing */
+    c_ctx->state = DM_COMMIT_REPLAY_OPS;
+    rc = rp_dt_commit(ctx, sessionA, &c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(SR_ERR_OK, rp_dt_commit_sync_wait(sessionA));
+    assert_int_equal(0, si->scoped_commit_cnt[SR_DS_STARTUP]);
+    c_ctx = NULL;
+
+    /* both changes are committed */
+    rc = rp_dt_refresh_session(ctx, sessionC, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    sessionC->state = RP_REQ_NEW;
+    rc = rp_dt_get_value_wrapper(ctx, sessionC, NULL, XP_LIST_A "/leaf", &v);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_string_equal("A", v->data.string_val);
+    sr_free_val(v);
+    sessionC->state = RP_REQ_NEW;
+    rc = rp_dt_get_value_wrapper(ctx, sessionC, NULL, XP_LIST_B "/leaf", &v);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_string_equal("B", v->data.string_val);
+    sr_free_val(v);
+
+    /* module lock of another session is not mistaken for the lock file held by a commit with subtree scope */
+    subtree_lock_set_leaf(ctx, sessionA, XP_LIST_A "/leaf", "A2");
+    rc = dm_commit_prepare_context(ctx->dm_ctx, sessionA->dm_session, &c_ctx);
+    assert_int_equal(SR_ERR_OK, rc);
+    pthread_mutex_lock(&c_ctx->mutex);
+    rc = dm_commit_load_modified_models(ctx->dm_ctx, sessionA->dm_session, c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(1, si->scoped_commit_cnt[SR_DS_STARTUP]);
+
+    rc = dm_unlock_subtree(ctx->dm_ctx, sessionA->dm_session, XP_LIST_A);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_unlock_subtree(ctx->dm_ctx, sessionB->dm_session, XP_LIST_B);
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = dm_lock_module(ctx->dm_ctx, sessionC->dm_session, "example-module");
+    assert_int_equal(SR_ERR_OK, rc);
+
+    rc = rp_dt_lock_subtree(ctx, sessionB, XP_LIST_B);
+    assert_int_equal(SR_ERR_LOCKED, rc);
+
+    rc = dm_unlock_module(ctx->dm_ctx, sessionC->dm_session, "example-module");
+    assert_int_equal(SR_ERR_OK, rc);
+    rc = rp_dt_lock_subtree(ctx, sessionB, XP_LIST_B);
+    assert_int_equal(SR_ERR_OK, rc);
+
+    pthread_mutex_unlock(&c_ctx->mutex);
+    dm_free_commit_context(c_ctx);
+    assert_int_equal(0, si->scoped_commit_cnt[SR_DS_STARTUP]);
+
+    test_rp_session_cleanup(ctx, sessionA);
+    test_rp_session_cleanup(ctx, sessionB);
+    test_rp_session_cleanup(ctx, sessionC);
+
+    createDataTreeExampleModule();
+}
+
+static void
+commit_cache_read_leaf(rp_ctx_t *ctx, const char *expected, dm_stats_t *before, dm_stats_t *after)
+{
+    rp_session_t *session = NULL;
+    sr_val_t *v = NULL;
+
+    test_rp_session_create(ctx, SR_DS_STARTUP, &session);
+    assert_int_equal(SR_ERR_OK, dm_get_stats(ctx->dm_ctx, before));
+    assert_int_equal(SR_ERR_OK, rp_dt_get_value_wrapper(ctx, session, NULL, XP_LIST_LEAF, &v));
+    assert_int_equal(SR_ERR_OK, dm_get_stats(ctx->dm_ctx, after));
+    assert_string_equal(expected, v->data.string_val);
+    sr_free_val(v);
+    test_rp_session_cleanup(ctx, session);
+}
+
+void
+commit_cache_update_test(void **state)
+{
+    int rc = 0;
+    rp_ctx_t *ctx = *state;
+    rp_session_t *session = NULL;
+    dm_commit_context_t *c_ctx = NULL;
+    dm_schema_info_t *si = NULL;
+    dm_stats_t before = {0}, after = {0};
+    sr_error_info_t *errors = NULL;
+    size_t e_cnt = 0;
+    bool shared_versions = false;
+
+    rc = dm_get_module_without_lock(ctx->dm_ctx, "example-module", &si);
+    assert_int_equal(SR_ERR_OK, rc);
+    shared_versions = si->shared_versions;
+
+    /* the committed data tree is cached and used by the following reads */
+    test_rp_session_create(ctx, SR_DS_STARTUP, &session);
+    subtree_lock_set_leaf(ctx, session, XP_LIST_LEAF, "cached");
+    rc = rp_dt_commit(ctx, session, &c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(SR_ERR_OK, rp_dt_commit_sync_wait(session));
+
+    commit_cache_read_leaf(ctx, "cached", &before, &after);
+    if (shared_versions) {
+        assert_int_equal(before.data_cache_hit_cnt + 1, after.data_cache_hit_cnt);
+        assert_int_equal(before.data_cache_miss_cnt, after.data_cache_miss_cnt);
+    }
+
+    /* without the shared versions, the data file written just now is not cached - it could be
+     * written again by another process without changing its modification time */
+    si->shared_versions = false;
+    c_ctx = NULL;
+    subtree_lock_set_leaf(ctx, session, XP_LIST_LEAF, "not cached");
+    rc = rp_dt_commit(ctx, session, &c_ctx, false, &errors, &e_cnt);
+    assert_int_equal(SR_ERR_OK, rc);
+    assert_int_equal(SR_ERR_OK, rp_dt_commit_sync_wait(session));
+
+    commit_cache_read_leaf(ctx, "not cached", &before, &after);
+    assert_int_equal(before.data_cache_hit_cnt, after.data_cache_hit_cnt);
+    assert_int_equal(before.data_cache_miss_cnt + 1, after.data_cache_miss_cnt);
+    si->shared_versions = shared_versions;
+
+    test_rp_session_cleanup(ctx, session);
+    createDataTreeExampleModule();
+}
+
 
 void
 empty_string_leaf_test(void **state)
@@ -2776,8 +3034,11 @@ int main(){
             cmocka_unit_test(edit_commit2_test),
             cmocka_unit_test(edit_commit3_test),
             cmocka_unit_test(edit_commit4_test),
+            cmocka_unit_test(group_commit_test),
             cmocka_unit_test(operation_logging_test),
             cmocka_unit_test(lock_commit_test),
+            cmocka_unit_test(subtree_lock_commit_test),
+            cmocka_unit_test(commit_cache_update_test),
             cmocka_unit_test(empty_string_leaf_test),
             cmocka_unit_test(candidate_edit_test),
             cmocka_unit_test(copy_to_running_test),
@@ -21,6 +21,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <setjmp.h>
@@ -142,11 +143,168 @@ rp_msg_neg_test(void **state)
     assert_int_equal(rc, SR_ERR_OK);
 }
 
+/**
+ * Test setting the limits of the RP thread pool.
+ */
+static void
+rp_thread_pool_test(void **state)
+{
+    int rc = 0;
+    rp_thread_pool_stats_t stats = { 0 };
+
+    rp_ctx_t *rp_ctx = *state;
+    assert_non_null(rp_ctx);
+
+    /* invalid limits */
+    rc = rp_set_thread_limits(rp_ctx, 0, 4);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+    rc = rp_set_thread_limits(rp_ctx, 8, 4);
+    assert_int_equal(rc, SR_ERR_INVAL_ARG);
+
+    /* the pool is filled up to the minimum */
+    rc = rp_set_thread_limits(rp_ctx, 6, 12);
+    assert_int_equal(rc, SR_ERR_OK);
+    rc = rp_get_thread_pool_stats(rp_ctx, &stats);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_int_equal(stats.thread_count, 6);
+    assert_int_equal(stats.grow_cnt, 0);
+    assert_int_equal(stats.shrink_cnt, 0);
+
+    /* lowering the maximum below the current count (let the new threads fall asleep first) */
+    sleep(1);
+    rc = rp_set_thread_limits(rp_ctx, 1, 2);
+    assert_int_equal(rc, SR_ERR_OK);
+    sleep(1);
+    rc = rp_get_thread_pool_stats(rp_ctx, &stats);
+    assert_int_equal(rc, SR_ERR_OK);
+    assert_true(stats.thread_count <= 2);
+    assert_true(stats.shrink_cnt >= 4);
+}
+
+/**
+ * Test per-session message queues of RP.
+ */
+static void
+rp_session_queue_test(void **state)
+{
+    int rc = 0;
+    rp_session_t *session[2] = { NULL, };
+    rp_session_stats_t stats = { 0 };
+    Sr__Msg *msg = NULL;
+    size_t processed = 0;
+
+    rp_ctx_t *rp_ctx = *state;
+    assert_non_null(rp_ctx);
+
+    ac_ucred_t credentials = { 0 };
+    credentials.e_uid = getuid();
+    credentials.e_gid = getgid();
+
+    for (size_t s = 0; s < 2; s++) {
+        rc = rp_session_start(rp_ctx, 123456 + s, &credentials, SR_DS_STARTUP, SR_SESS_DEFAULT, 0, &session[s]);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_non_null(session[s]);
+    }
+
+    /* interleave the messages of both sessions */
+    for (size_t i = 0; i < 50; i++) {
+        for (size_t s = 0; s < 2; s++) {
+            rc = sr_gpb_req_alloc(NULL, SR__OPERATION__SESSION_START, 123456 + s, &msg);
+            assert_int_equal(rc, SR_ERR_OK);
+            rc = rp_msg_process(rp_ctx, session[s], msg);
+            assert_int_equal(rc, SR_ERR_OK);
+        }
+    }
+
+    /* wait until all messages are processed */
+    for (size_t i = 0; i < 100 && processed < 100; i++) {
+        processed = 0;
+        for (size_t s = 0; s < 2; s++) {
+            rc = rp_get_session_stats(session[s], &stats);
+            assert_int_equal(rc, SR_ERR_OK);
+            processed += stats.processed_cnt;
+        }
+        usleep(100000);
+    }
+
+    for (size_t s = 0; s < 2; s++) {
+        rc = rp_get_session_stats(session[s], &stats);
+        assert_int_equal(rc, SR_ERR_OK);
+        assert_int_equal(stats.id, 123456 + s);
+        assert_int_equal(stats.processed_cnt, 50);
+        assert_int_equal(stats.queued, 0);
+        assert_true(stats.max_queued >= 1 && stats.max_queued <= 50);
+
+        rc = rp_session_stop(rp_ctx, session[s]);
+        assert_int_equal(rc, SR_ERR_OK);
+    }
+}
+
+/**
+ * Test that no request is lost when the RP request queue fills up.
+ */
+static void
+rp_request_queue_overflow_test(void **state)
+{
+    int rc = 0;
+    rp_session_t *session = NULL;
+    rp_session_stats_t stats = { 0 };
+    Sr__Msg *msg = NULL;
+
+    rp_ctx_t *rp_ctx = *state;
+    assert_non_null(rp_ctx);
+
+    ac_ucred_t credentials = { 0 };
+    credentials.e_uid = getuid();
+    credentials.e_gid = getgid();
+
+    /* a single worker, so that the queue fills up faster than it is drained */
+    rc = rp_set_thread_limits(rp_ctx, 1, 1);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    rc = rp_session_start(rp_ctx, 123456, &credentials, SR_DS_STARTUP, SR_SESS_DEFAULT, 0, &session);
+    assert_int_equal(rc, SR_ERR_OK);
+
+    /* more session-less messages than the capacity of the lock-free queue, interleaved with session messages */
+    for (size_t i = 0; i < 10000; i++) {
+        rc = sr_gpb_internal_req_alloc(NULL, SR__OPERATION__UNSUBSCRIBE_DESTINATION, &msg);
+        assert_int_equal(rc, SR_ERR_OK);
+        msg->internal_request->unsubscribe_dst_req->destination = strdup("/tmp/rp-test-no-such-destination.sock");
+        assert_non_null(msg->internal_request->unsubscribe_dst_req->destination);
+        rc = rp_msg_process(rp_ctx, NULL, msg);
+        assert_int_equal(rc, SR_ERR_OK);
+        if (0 == i % 100) {
+            rc = sr_gpb_req_alloc(NULL, SR__OPERATION__SESSION_START, 123456, &msg);
+            assert_int_equal(rc, SR_ERR_OK);
+            rc = rp_msg_process(rp_ctx, session, msg);
+            assert_int_equal(rc, SR_ERR_OK);
+        }
+    }
+
+    /* wait until all messages of the session are processed */
+    for (size_t i = 0; i < 300; i++) {
+        rc = rp_get_session_stats(session, &stats);
+        assert_int_equal(rc, SR_ERR_OK);
+        if (100 == stats.processed_cnt) {
+            break;
+        }
+        usleep(100000);
+    }
+    assert_int_equal(stats.processed_cnt, 100);
+    assert_int_equal(stats.queued, 0);
+
+    rc = rp_session_stop(rp_ctx, session);
+    assert_int_equal(rc, SR_ERR_OK);
+}
+
 int
 main() {
     const struct CMUnitTest tests[] = {
             cmocka_unit_test_setup_teardown(rp_session_test, rp_setup, rp_teardown),
             cmocka_unit_test_setup_teardown(rp_msg_neg_test, rp_setup, rp_teardown),
+            cmocka_unit_test_setup_teardown(rp_thread_pool_test, rp_setup, rp_teardown),
+            cmocka_unit_test_setup_teardown(rp_session_queue_test, rp_setup, rp_teardown),
+            cmocka_unit_test_setup_teardown(rp_request_queue_overflow_test, rp_setup, rp_teardown),
     };
 
     watchdog_start(300);